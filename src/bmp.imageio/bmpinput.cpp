@@ -89,6 +89,8 @@ bmp_input_imageio_create()
 }
 
 OIIO_EXPORT const char* bmp_input_extensions[] = { "bmp", "dib", nullptr };
+// Magic numbers: "BM"
+OIIO_EXPORT const char* bmp_input_signatures[] = { "0:424d", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -379,6 +379,8 @@ dds_imageio_library_version()
 }
 
 OIIO_EXPORT const char* dds_input_extensions[] = { "dds", nullptr };
+// Magic numbers: "DDS "
+OIIO_EXPORT const char* dds_input_signatures[] = { "0:44445320", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
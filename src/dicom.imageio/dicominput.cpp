@@ -81,6 +81,8 @@ dicom_input_imageio_create()
 }
 
 OIIO_EXPORT const char* dicom_input_extensions[] = { "dcm", nullptr };
+// Magic numbers: "DICM" after the preamble
+OIIO_EXPORT const char* dicom_input_signatures[] = { "128:4449434d", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
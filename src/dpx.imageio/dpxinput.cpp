@@ -24,11 +24,15 @@
 #include "libdpx/DPX.h"
 #include "libdpx/DPXColorConverter.h"
 #include "libdpx/DPXHeader.h"
+#include "libdpx/ElementReadStream.h"
+#include "libdpx/ReaderInternal.h"
 
 #include <OpenImageIO/imageio.h>
 #include <OpenImageIO/strutil.h>
 #include <OpenImageIO/typedesc.h>
 
+#include "imageio_pvt.h"
+
 OIIO_PLUGIN_NAMESPACE_BEGIN
 
 
@@ -59,7 +63,8 @@ private:
     dpx::Reader m_dpx;
     std::vector<unsigned char> m_userBuf;
     bool m_rawcolor;
-    std::vector<unsigned char> m_decodebuf;  // temporary decode buffer
+    bool m_mmap;  // map the file when we open it by name ("dpx:mmap")
+    std::unique_ptr<Filesystem::IOMemMapFile> m_mmap_io;
 
     /// Reset everything to initial state
     ///
@@ -73,9 +78,25 @@ private:
         }
         m_userBuf.clear();
         m_rawcolor = false;
+        m_mmap     = false;
         ioproxy_clear();
+        m_mmap_io.reset();
     }
 
+    /// Helper: decode native scanlines [ybegin,yend) of the current
+    /// subimage into data. Unlike m_dpx.ReadBlock(), this only uses pread
+    /// and local buffers, so it can be called concurrently.
+    bool decode_scanlines(int ybegin, int yend, void* data);
+
+    /// Is the current element a 10- or 12-bit layout that
+    /// unpack_scanlines() can handle?
+    bool can_unpack() const;
+
+    /// Helper: unpack native scanlines [ybegin,yend) of a 10- or 12-bit
+    /// element with our own vectorized kernels, straight from memory if the
+    /// file is mapped.
+    bool unpack_scanlines(int ybegin, int yend, uint16_t* data);
+
     /// Helper function - retrieve string for libdpx characteristic
     ///
     std::string get_characteristic_string(dpx::Characteristic c);
@@ -95,6 +116,38 @@ private:
 
 
 
+// A libdpx element reader that uses pread rather than seeking the shared
+// stream, so that several threads can read blocks of the image at once.
+class DPXPreadStream final : public dpx::ElementReadStream {
+public:
+    DPXPreadStream(Filesystem::IOProxy* io)
+        : dpx::ElementReadStream(nullptr)
+        , m_io(io)
+    {
+    }
+
+    bool Read(const dpx::Header& header, const int element, const long offset,
+              void* buf, const size_t size) override
+    {
+        int64_t pos = int64_t(header.DataOffset(element)) + offset;
+        if (m_io->pread(buf, size, pos) != size)
+            return false;
+        EndianDataCheck(header, element, buf, size);
+        return true;
+    }
+
+    bool ReadDirect(const dpx::Header& header, const int element,
+                    const long offset, void* buf, const size_t size) override
+    {
+        return Read(header, element, offset, buf, size);
+    }
+
+private:
+    Filesystem::IOProxy* m_io;
+};
+
+
+
 // Obligatory material to make this a recognizable imageio plugin:
 OIIO_PLUGIN_EXPORTS_BEGIN
 
@@ -113,6 +166,9 @@ dpx_imageio_library_version()
 }
 
 OIIO_EXPORT const char* dpx_input_extensions[] = { "dpx", nullptr };
+// Magic numbers: "SDPX", either byte order
+OIIO_EXPORT const char* dpx_input_signatures[] = { "0:53445058", "0:58504453",
+                                                   nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -134,6 +190,17 @@ DPXInput::valid_file(Filesystem::IOProxy* ioproxy) const
 bool
 DPXInput::open(const std::string& name, ImageSpec& newspec)
 {
+    // Uncompressed DPX scanlines sit at known offsets, so when asked to,
+    // map a file opened by name and let the reads come straight from the
+    // map. Not by default: if the file is truncated or replaced while it's
+    // open, touching the map raises SIGBUS rather than a read error.
+    if (!ioproxy() && m_mmap) {
+        m_mmap_io.reset(new Filesystem::IOMemMapFile(name));
+        if (m_mmap_io->opened())
+            set_ioproxy(m_mmap_io.get());
+        else
+            m_mmap_io.reset();  // fall back to ordinary file reads
+    }
     if (!ioproxy_use_or_open(name))
         return false;
 
@@ -168,6 +235,7 @@ DPXInput::open(const std::string& name, ImageSpec& newspec,
     m_rawcolor = config.get_int_attribute("dpx:RawColor")
                  || config.get_int_attribute("dpx:RawData")  // deprecated
                  || config.get_int_attribute("oiio:RawColor");
+    m_mmap = config.get_int_attribute("dpx:mmap");
     ioproxy_retrieve_from_config(config);
     return open(name, newspec);
 }
@@ -578,10 +646,13 @@ DPXInput::close()
 
 
 bool
-DPXInput::read_native_scanline(int subimage, int miplevel, int y, int z,
+DPXInput::read_native_scanline(int subimage, int miplevel, int y, int /*z*/,
                                void* data)
 {
-    return read_native_scanlines(subimage, miplevel, y, y + 1, z, data);
+    lock_guard lock(*this);
+    if (!seek_subimage(subimage, miplevel))
+        return false;
+    return decode_scanlines(y, y + 1, data);
 }
 
 
@@ -594,28 +665,141 @@ DPXInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
     if (!seek_subimage(subimage, miplevel))
         return false;
 
-    dpx::Block block(0, ybegin - m_spec.y, m_dpx.header.Width() - 1,
+    // Every scanline is at a known offset, so the unpacking and color
+    // conversion of big ranges can be spread over several threads.
+    return read_native_scanlines_parallel(ybegin, yend, 1, data,
+                                          [&](int y0, int y1, void* buf) {
+                                              return decode_scanlines(y0, y1,
+                                                                      buf);
+                                          });
+}
+
+
+
+bool
+DPXInput::decode_scanlines(int ybegin, int yend, void* data)
+{
+    const dpx::Header& header = m_dpx.header;
+    int element               = m_subimage;
+    dpx::Block block(0, ybegin - m_spec.y, header.Width() - 1,
                      yend - 1 - m_spec.y);
 
-    if (m_rawcolor) {
-        // fast path - just read the scanline in
-        if (!m_dpx.ReadBlock(subimage, (unsigned char*)data, block))
-            return false;
-    } else {
-        // read the scanline and convert to RGB
-        unsigned char* ptr = (unsigned char*)data;
-        int bufsize = dpx::QueryRGBBufferSize(m_dpx.header, subimage, block);
+    // libdpx can't decode RLE (Reader::ReadBlock fails for it, too)
+    if (header.ImageEncoding(element) == dpx::kRLE) {
+        errorfmt("DPX RLE encoding is not supported");
+        return false;
+    }
+
+    // Unless we're asked for the raw color, read into a temporary buffer
+    // and convert to RGB (if the conversion can't be done in place).
+    std::vector<unsigned char> decodebuf;
+    unsigned char* ptr = (unsigned char*)data;
+    if (!m_rawcolor) {
+        int bufsize = dpx::QueryRGBBufferSize(header, element, block);
         if (bufsize > 0) {
-            m_decodebuf.resize(bufsize);
-            ptr = m_decodebuf.data();
+            decodebuf.resize(bufsize);
+            ptr = decodebuf.data();
         }
+    }
 
-        if (!m_dpx.ReadBlock(subimage, ptr, block))
+    if (can_unpack()) {
+        if (!unpack_scanlines(ybegin, yend, (uint16_t*)ptr))
             return false;
-        if (!dpx::ConvertToRGB(m_dpx.header, subimage, ptr, data, block))
+    } else {
+        // Scanline buffer for unpacking, sized as in dpx::Codec::Read
+        int bitdepth = header.BitDepth(element);
+        int ncomps   = header.ImageElementComponentCount(element);
+        size_t words = (ncomps * header.Width()
+                        * (bitdepth / 8 + (bitdepth % 8 ? 1 : 0)))
+                           / sizeof(dpx::U32)
+                       + 1;
+        std::vector<dpx::U32> scanline(words);
+        DPXPreadStream stream(ioproxy());
+        if (!dpx::ReadImageBlock(header, scanline.data(), &stream, element,
+                                 block, ptr, header.ComponentDataSize(element)))
             return false;
     }
+    if (!m_rawcolor
+        && !dpx::ConvertToRGB(header, element, ptr, data, block))
+        return false;
+    return true;
+}
+
 
+
+bool
+DPXInput::can_unpack() const
+{
+    const dpx::Header& header = m_dpx.header;
+    int element               = m_subimage;
+    int bitdepth              = header.BitDepth(element);
+    dpx::Packing packing      = header.ImagePacking(element);
+    if (bitdepth == 10)
+        // libdpx reverses the datums of filled 1-channel files; leave
+        // those to it.
+        return packing == dpx::kPacked
+               || (header.ImageElementComponentCount(element) > 1
+                   && (packing == dpx::kFilledMethodA
+                       || packing == dpx::kFilledMethodB));
+    if (bitdepth == 12)
+        return packing == dpx::kPacked || packing == dpx::kFilledMethodB;
+    return false;
+}
+
+
+
+bool
+DPXInput::unpack_scanlines(int ybegin, int yend, uint16_t* data)
+{
+    const dpx::Header& header = m_dpx.header;
+    int element               = m_subimage;
+    int bitdepth              = header.BitDepth(element);
+    dpx::Packing packing      = header.ImagePacking(element);
+    bool swap                 = header.RequiresByteSwap();
+    size_t datums = size_t(header.Width())
+                    * header.ImageElementComponentCount(element);
+    size_t linebytes;
+    if (packing == dpx::kPacked)
+        linebytes = (datums * bitdepth + 31) / 32 * 4;
+    else if (bitdepth == 12)
+        linebytes = datums * 2;
+    else
+        linebytes = (datums + 2) / 3 * 4;
+    size_t stride  = linebytes + header.EndOfLinePadding(element);
+    int64_t offset = int64_t(header.DataOffset(element))
+                     + int64_t(ybegin - m_spec.y) * stride;
+    size_t size    = size_t(yend - ybegin - 1) * stride + linebytes;
+
+    // Unpack straight from the file if it's in memory. Otherwise read the
+    // whole range at once.
+    const unsigned char* rows = nullptr;
+    std::unique_ptr<unsigned char[]> buf;
+    if (auto mem = dynamic_cast<Filesystem::IOMemReader*>(ioproxy())) {
+        cspan<unsigned char> file = mem->buffer();
+        if (offset + size > file.size()) {
+            errorfmt("Read error: hit end of file in dpx reader");
+            return false;
+        }
+        rows = file.data() + offset;
+    } else {
+        buf.reset(new unsigned char[size]);
+        if (!iopread(buf.get(), size, offset))
+            return false;
+        rows = buf.get();
+    }
+
+    for (int y = 0; y < yend - ybegin; ++y) {
+        const unsigned char* src = rows + y * stride;
+        uint16_t* dst            = data + y * datums;
+        if (packing == dpx::kPacked)
+            pvt::unpack_packed_bits(src, dst, datums, bitdepth, swap);
+        else if (bitdepth == 12)
+            pvt::unpack_12bit_filled(src, dst, datums, swap);
+        else
+            pvt::unpack_10bit_filled(src, dst, datums,
+                                     packing == dpx::kFilledMethodA ? 2 : 0,
+                                     swap);
+    }
     return true;
 }
 
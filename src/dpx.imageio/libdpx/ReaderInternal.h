@@ -146,7 +146,7 @@ namespace dpx
 			long offset = actline * lineLength;
 
 			// add in eoln padding
-			offset += line * eolnPad;
+			offset += actline * eolnPad;
 			
 			// add in offset within the current line, rounding down so to catch any components within the word
 			offset += block.x1 * numberOfComponents / 3 * 4;
@@ -277,7 +277,7 @@ namespace dpx
 		{
 			// determine offset into image element
 			long offset = (line + block.y1) * (lineSize * sizeof(U32)) +
-						(block.x1 * numberOfComponents * dataSize / 32 * sizeof(U32)) + (line * eolnPad);
+						(block.x1 * numberOfComponents * dataSize / 32 * sizeof(U32)) + ((line + block.y1) * eolnPad);
 	
 			// calculate read size
 			int readSize = ((block.x2 - block.x1 + 1) * numberOfComponents * dataSize);
@@ -339,7 +339,7 @@ namespace dpx
 			
 			// determine offset into image element
 			long offset = (line + block.y1) * imageWidth * numberOfComponents * bytes +
-						block.x1 * numberOfComponents * bytes + (line * eolnPad);
+						block.x1 * numberOfComponents * bytes + ((line + block.y1) * eolnPad);
 						
 			if (BUFTYPE == SRCTYPE)
 			{
@@ -383,7 +383,7 @@ namespace dpx
 		{
 			// determine offset into image element
 			long offset = (line + block.y1) * imageWidth * numberOfComponents * 2 +
-						block.x1 * numberOfComponents * 2 + (line * eolnPad);
+						block.x1 * numberOfComponents * 2 + ((line + block.y1) * eolnPad);
 	
 			fd->Read(dpxHeader, element, offset, readBuf, width*2);
 				
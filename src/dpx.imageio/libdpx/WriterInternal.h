@@ -39,6 +39,8 @@
 
 #include "BaseTypeConverter.h"
 
+#include "imageio_pvt.h"
+
 
 namespace dpx 
 {
@@ -158,6 +160,15 @@ namespace dpx
 		else if (BITDEPTH == 8)
 			return;
 
+		// OIIO: use the vectorized packer for U16 sources
+		if (sizeof(IB) == sizeof(U16))
+		{
+			OIIO::pvt::pack_packed_bits(reinterpret_cast<U16 *>(src + access.offset), dst, len, BITDEPTH, false);
+			access.offset = 0;
+			access.length = (((len * BITDEPTH) / 32) + ((len * BITDEPTH) % 32 ? 1 : 0)) * 2;
+			return;
+		}
+
 		int i, entry;
 		for (i = 0; i < len; i++)
 		{
@@ -218,6 +229,16 @@ namespace dpx
 		
 		// shift bits over 2 if Method A
 		const int method_shift = (METHOD == kFilledMethodA ? 2 : 0);
+
+		// OIIO: the usual datum order (first datum in the high bits) has a
+		// vectorized packer
+		if (reverse && sizeof(IB) == sizeof(U16))
+		{
+			OIIO::pvt::pack_10bit_filled(reinterpret_cast<U16 *>(src + access.offset), dst, len, method_shift, false);
+			access.offset = 0;
+			access.length = ((len / 3) + (len % 3 ? 1 : 0)) * 2;
+			return;
+		}
 		
 		// loop through the buffer
 		int i;
@@ -331,8 +352,8 @@ namespace dpx
 				else if (packing == dpx::kFilledMethodB)
 				{
 					// shift 4 MSB down, so 0x0f00 would become 0x00f0
-					for (int w = 0; w < bufaccess.length; w++)
-						dst[w] = src[bufaccess.offset+w] >> 4;
+					// OIIO: use the vectorized packer
+					OIIO::pvt::pack_12bit_filled(reinterpret_cast<U16 *>(src + bufaccess.offset), dst, bufaccess.length, false);
 					bufaccess.offset = 0;
 				}
 				// a bitdepth of 12 by default is packed with dpx::kFilledMethodA
@@ -189,6 +189,7 @@ ffmpeg_input_imageio_create()
 OIIO_EXPORT const char* ffmpeg_input_extensions[] = {
     "avi", "mov", "qt", "mp4", "m4a", "3gp", "3g2", "mj2", "m4v", "mpg", nullptr
 };
+OIIO_EXPORT const char* ffmpeg_input_signatures[] = { nullptr };
 
 
 OIIO_PLUGIN_EXPORTS_END
@@ -32,6 +32,8 @@ fits_input_imageio_create()
 }
 
 OIIO_EXPORT const char* fits_input_extensions[] = { "fits", nullptr };
+// Magic numbers: "SIMPLE"
+OIIO_EXPORT const char* fits_input_signatures[] = { "0:53494d504c45", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
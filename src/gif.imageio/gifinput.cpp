@@ -128,6 +128,9 @@ gif_input_imageio_create()
     return new GIFInput;
 }
 OIIO_EXPORT const char* gif_input_extensions[] = { "gif", NULL };
+// Magic numbers: "GIF87a", "GIF89a"
+OIIO_EXPORT const char* gif_input_signatures[] = { "0:474946383761",
+                                                   "0:474946383961", nullptr };
 
 OIIO_EXPORT const char*
 gif_imageio_library_version()
@@ -112,6 +112,8 @@ hdr_input_imageio_create()
 }
 
 OIIO_EXPORT const char* hdr_input_extensions[] = { "hdr", "rgbe", nullptr };
+// Magic numbers: "#?"
+OIIO_EXPORT const char* hdr_input_signatures[] = { "0:233f", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -36,7 +36,7 @@ public:
     const char* format_name(void) const override { return "heif"; }
     int supports(string_view feature) const override
     {
-        return feature == "exif";
+        return feature == "exif" || feature == "reduce";
     }
 #if LIBHEIF_HAVE_VERSION(1, 4, 0)
     bool valid_file(const std::string& filename) const override;
@@ -60,6 +60,7 @@ private:
     bool m_keep_unassociated_alpha = false;
     bool m_do_associate            = false;
     bool m_reorient                = true;
+    int m_reduce                   = 1;  // Requested "oiio:reduce" factor
     std::unique_ptr<heif::Context> m_ctx;
     heif_item_id m_primary_id;             // id of primary image
     std::vector<heif_item_id> m_item_ids;  // ids of all other images
@@ -104,6 +105,12 @@ OIIO_EXPORT const char* heif_input_extensions[] = { "heic",  "heif",
                                                     "avif",
 #endif
                                                     nullptr };
+// Magic numbers: ISO BMFF "ftyp" box with a HEIF/AVIF brand
+OIIO_EXPORT const char* heif_input_signatures[] = { "4:6674797068656963",
+                                                    "4:6674797068656978",
+                                                    "4:667479706d696631",
+                                                    "4:6674797061766966",
+                                                    nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -148,6 +155,7 @@ HeifInput::open(const std::string& name, ImageSpec& newspec,
     m_keep_unassociated_alpha
         = (config.get_int_attribute("oiio:UnassociatedAlpha") != 0);
     m_reorient = config.get_int_attribute("oiio:reorient", 1);
+    m_reduce   = config.get_int_attribute("oiio:reduce", 1);
 
     try {
         m_ctx->read_from_file(name);
@@ -192,6 +200,7 @@ HeifInput::close()
     m_associated_alpha        = true;
     m_keep_unassociated_alpha = false;
     m_do_associate            = false;
+    m_reduce                  = 1;
     return true;
 }
 
@@ -211,9 +220,28 @@ HeifInput::seek_subimage(int subimage, int miplevel)
         return false;
     }
 
-    auto id     = (subimage == 0) ? m_primary_id : m_item_ids[subimage - 1];
-    m_ihandle   = m_ctx->get_image_handle(id);
-    m_has_alpha = m_ihandle.has_alpha_channel();
+    auto id   = (subimage == 0) ? m_primary_id : m_item_ids[subimage - 1];
+    m_ihandle = m_ctx->get_image_handle(id);
+
+    // HEIF can't decode at reduced resolution, but files often embed
+    // thumbnails of the primary image. For a reduced resolution request,
+    // decode the smallest one that is at least 1/m_reduce of the full size.
+    heif::ImageHandle dhandle = m_ihandle;  // the image we will decode
+    if (subimage == 0 && m_reduce > 1) {
+        try {
+            int minw = (m_ihandle.get_width() + m_reduce - 1) / m_reduce;
+            int minh = (m_ihandle.get_height() + m_reduce - 1) / m_reduce;
+            for (auto tid : m_ihandle.get_list_of_thumbnail_IDs()) {
+                heif::ImageHandle thumb = m_ihandle.get_thumbnail(tid);
+                if (thumb.get_width() >= minw && thumb.get_height() >= minh
+                    && thumb.get_width() < dhandle.get_width())
+                    dhandle = thumb;
+            }
+        } catch (const heif::Error&) {
+            dhandle = m_ihandle;  // Just decode the full image
+        }
+    }
+    m_has_alpha = dhandle.has_alpha_channel();
     auto chroma = m_has_alpha ? heif_chroma_interleaved_RGBA
                               : heif_chroma_interleaved_RGB;
 #if 0
@@ -234,7 +262,7 @@ HeifInput::seek_subimage(int subimage, int miplevel)
     options->ignore_transformations = !m_reorient;
     // print("Got decoding options version {}\n", options->version);
     struct heif_image* img_tmp = nullptr;
-    struct heif_error herr = heif_decode_image(m_ihandle.get_raw_image_handle(),
+    struct heif_error herr = heif_decode_image(dhandle.get_raw_image_handle(),
                                                &img_tmp, heif_colorspace_RGB,
                                                chroma, options.get());
     if (img_tmp)
@@ -247,10 +275,13 @@ HeifInput::seek_subimage(int subimage, int miplevel)
 #endif
 
     int bits = m_himage.get_bits_per_pixel(heif_channel_interleaved);
-    m_spec = ImageSpec(m_ihandle.get_width(), m_ihandle.get_height(), bits / 8,
+    m_spec = ImageSpec(dhandle.get_width(), dhandle.get_height(), bits / 8,
                        TypeUInt8);
 
     m_spec.attribute("oiio:ColorSpace", "sRGB");
+    if (dhandle.get_width() < m_ihandle.get_width())
+        m_spec.attribute("oiio:reduce",
+                         m_ihandle.get_width() / dhandle.get_width());
 
 #if LIBHEIF_HAVE_VERSION(1, 12, 0)
     // Libheif >= 1.12 added API call to find out if the image is associated
@@ -5,6 +5,8 @@
 
 #include <cmath>
 
+#include <OpenImageIO/parallel.h>
+
 OIIO_PLUGIN_NAMESPACE_BEGIN
 
 using namespace iff_pvt;
@@ -46,9 +48,20 @@ private:
     // read_header wil. issue error messages and return false.
     bool read_header();
 
+    // One RGBA chunk of the image, read but not yet decoded
+    struct IffTile {
+        uint16_t xmin, ymin, xmax, ymax;  // pixel bounds, inclusive
+        uint32_t size;                    // chunk size, unaligned
+        std::vector<uint8_t> data;        // chunk data after the bounds
+    };
+
     // helper to read an image
     bool readimg(void);
 
+    // helper to decode one tile into m_buf; safe to call concurrently for
+    // different tiles
+    void decode_tile(const IffTile& tile);
+
     // helper to uncompress a rle channel
     size_t uncompress_rle_channel(const uint8_t* in, uint8_t* out, int size);
 
@@ -116,6 +129,8 @@ iff_input_imageio_create()
 }
 
 OIIO_EXPORT const char* iff_input_extensions[] = { "iff", "z", nullptr };
+// Magic numbers: "CIMG" inside "FOR4"
+OIIO_EXPORT const char* iff_input_signatures[] = { "8:43494d47", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -498,6 +513,17 @@ IffInput::readimg()
     // resize buffer
     m_buf.resize(m_spec.image_bytes());
 
+    if (m_iff_header.tiles && m_iff_header.pixel_bits != 8
+        && m_iff_header.pixel_bits != 16) {
+        errorfmt("\"{}\": unsupported number of bits per pixel for tile",
+                 m_filename);
+        return false;
+    }
+
+    // The tiles have to be found by reading through the chunks in order,
+    // but once read, each one decodes independently into its own part of
+    // the image. So read them all, then decode them in parallel.
+    std::vector<IffTile> tiles(m_iff_header.tiles);
     for (unsigned int t = 0; t < m_iff_header.tiles;) {
         // get type and length
         if (!ioread(&type, 1, sizeof(type)) || !read(&size))
@@ -509,235 +535,229 @@ IffInput::readimg()
         if (type[0] == 'R' && type[1] == 'G' && type[2] == 'B'
             && type[3] == 'A') {
             // get tile coordinates.
-            uint16_t xmin, xmax, ymin, ymax;
-            if (!read(&xmin) || !read(&ymin) || !read(&xmax) || !read(&ymax))
+            IffTile& tile(tiles[t]);
+            if (!read(&tile.xmin) || !read(&tile.ymin) || !read(&tile.xmax)
+                || !read(&tile.ymax))
                 return false;
 
-            // get tile width/height
-            uint32_t tw = xmax - xmin + 1;
-            uint32_t th = ymax - ymin + 1;
+            // check tile
+            if (tile.xmin > tile.xmax || tile.ymin > tile.ymax
+                || tile.xmax >= m_spec.width || tile.ymax >= m_spec.height) {
+                return false;
+            }
 
             // get image size
             // skip coordinates, uint16_t (2) * 4 = 8
-            uint32_t image_size = chunksize - 8;
+            tile.size = size;
+            tile.data.resize(chunksize - 8);
+            if (!ioread(tile.data.data(), 1, tile.data.size()))
+                return false;
 
-            // check tile
-            if (xmin > xmax || ymin > ymax || xmax >= m_spec.width
-                || ymax >= m_spec.height || !tw || !th) {
+            // tile
+            t++;
+
+        } else {
+            // skip to the next block
+            if (!ioseek(chunksize))
                 return false;
-            }
+        }
+    }
 
-            // tile compress
-            bool tile_compress = false;
+    parallel_for(
+        int64_t(0), int64_t(tiles.size()),
+        [&](int64_t t) { decode_tile(tiles[t]); },
+        paropt(threads()).minitems(1));
 
-            // if tile compression fails to be less than image data stored
-            // uncompressed the tile is written uncompressed
+    // flip buffer to make read_native_tile easier,
+    // from tga.imageio:
 
-            // set channels
-            uint8_t channels = m_iff_header.pixel_channels;
+    int bytespp = m_spec.pixel_bytes();
 
-            // set tile size
-            uint32_t tile_size = tw * th * channels * m_spec.channel_bytes()
-                                 + 8;
+    std::vector<unsigned char> flip(m_spec.width * bytespp);
+    unsigned char *src, *dst, *tmp = &flip[0];
+    for (int y = 0; y < m_spec.height / 2; y++) {
+        src = &m_buf[(m_spec.height - y - 1) * m_spec.width * bytespp];
+        dst = &m_buf[y * m_spec.width * bytespp];
 
-            // test if compressed
-            // we use the non aligned size
-            if (tile_size > size) {
-                tile_compress = true;
-            }
+        memcpy(tmp, src, m_spec.width * bytespp);
+        memcpy(src, dst, m_spec.width * bytespp);
+        memcpy(dst, tmp, m_spec.width * bytespp);
+    }
 
-            // handle 8-bit data.
-            if (m_iff_header.pixel_bits == 8) {
-                std::vector<uint8_t> scratch;
+    return true;
+}
 
-                // set bytes.
-                scratch.resize(image_size);
 
-                if (!ioread(scratch.data(), 1, scratch.size()))
-                    return false;
 
-                // set tile data
-                uint8_t* p = static_cast<uint8_t*>(&scratch[0]);
+void
+IffInput::decode_tile(const IffTile& tile)
+{
+    uint16_t xmin = tile.xmin;
+    uint16_t ymin = tile.ymin;
+    uint16_t xmax = tile.xmax;
+    uint16_t ymax = tile.ymax;
 
-                // tile compress.
-                if (tile_compress) {
-                    // map BGR(A) to RGB(A)
-                    for (int c = (channels * m_spec.channel_bytes()) - 1;
-                         c >= 0; --c) {
-                        std::vector<uint8_t> in(tw * th);
-                        uint8_t* in_p = &in[0];
-
-                        // uncompress and increment
-                        p += uncompress_rle_channel(p, in_p, tw * th);
-
-                        // set tile
-                        for (uint16_t py = ymin; py <= ymax; py++) {
-                            uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
-                                              + (py * m_spec.width)
-                                                    * m_spec.pixel_bytes();
-
-                            for (uint16_t px = xmin; px <= xmax; px++) {
-                                uint8_t* out_p
-                                    = out_dy + px * m_spec.pixel_bytes() + c;
-                                *out_p++ = *in_p++;
-                            }
-                        }
-                    }
-                } else {
-                    int sy = 0;
-                    for (uint16_t py = ymin; py <= ymax; py++) {
-                        uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
-                                          + (py * m_spec.width + xmin)
-                                                * m_spec.pixel_bytes();
-
-                        // set tile
-                        int sx = 0;
-                        for (uint16_t px = xmin; px <= xmax; px++) {
-                            uint8_t* in_p
-                                = p + (sy * tw + sx) * m_spec.pixel_bytes();
-
-                            // map BGR(A) to RGB(A)
-                            for (int c = channels - 1; c >= 0; --c) {
-                                uint8_t* out_p = in_p
-                                                 + (c * m_spec.channel_bytes());
-                                *out_dy++ = *out_p;
-                            }
-                            sx++;
-                        }
-                        sy++;
-                    }
-                }
-            }
-            // handle 16-bit data.
-            else if (m_iff_header.pixel_bits == 16) {
-                std::vector<uint8_t> scratch;
-
-                // set bytes.
-                scratch.resize(image_size);
-
-                if (!ioread(scratch.data(), 1, scratch.size()))
-                    return false;
-
-                // set tile data
-                uint8_t* p = static_cast<uint8_t*>(&scratch[0]);
-
-                if (tile_compress) {
-                    // set map
-                    std::vector<uint8_t> map;
-                    if (littleendian()) {
-                        int rgb16[]  = { 0, 2, 4, 1, 3, 5 };
-                        int rgba16[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
-                        if (m_iff_header.pixel_channels == 3) {
-                            map = std::vector<uint8_t>(rgb16, &rgb16[6]);
-                        } else {
-                            map = std::vector<uint8_t>(rgba16, &rgba16[8]);
-                        }
+    // get tile width/height
+    uint32_t tw = xmax - xmin + 1;
+    uint32_t th = ymax - ymin + 1;
 
-                    } else {
-                        int rgb16[]  = { 1, 3, 5, 0, 2, 4 };
-                        int rgba16[] = { 1, 3, 5, 7, 0, 2, 4, 6 };
-                        if (m_iff_header.pixel_channels == 3) {
-                            map = std::vector<uint8_t>(rgb16, &rgb16[6]);
-                        } else {
-                            map = std::vector<uint8_t>(rgba16, &rgba16[8]);
-                        }
-                    }
+    // tile compress
+    bool tile_compress = false;
 
-                    // map BGR(A)BGR(A) to RRGGBB(AA)
-                    for (int c = (channels * m_spec.channel_bytes()) - 1;
-                         c >= 0; --c) {
-                        int mc = map[c];
+    // if tile compression fails to be less than image data stored
+    // uncompressed the tile is written uncompressed
 
-                        std::vector<uint8_t> in(tw * th);
-                        uint8_t* in_p = &in[0];
+    // set channels
+    uint8_t channels = m_iff_header.pixel_channels;
 
-                        // uncompress and increment
-                        p += uncompress_rle_channel(p, in_p, tw * th);
+    // set tile size
+    uint32_t tile_size = tw * th * channels * m_spec.channel_bytes() + 8;
 
-                        // set tile
-                        for (uint16_t py = ymin; py <= ymax; py++) {
-                            uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
-                                              + (py * m_spec.width)
-                                                    * m_spec.pixel_bytes();
+    // test if compressed
+    // we use the non aligned size
+    if (tile_size > tile.size) {
+        tile_compress = true;
+    }
 
-                            for (uint16_t px = xmin; px <= xmax; px++) {
-                                uint8_t* out_p
-                                    = out_dy + px * m_spec.pixel_bytes() + mc;
-                                *out_p++ = *in_p++;
-                            }
-                        }
+    // handle 8-bit data.
+    if (m_iff_header.pixel_bits == 8) {
+        // set tile data
+        const uint8_t* p = tile.data.data();
+
+        // tile compress.
+        if (tile_compress) {
+            // map BGR(A) to RGB(A)
+            for (int c = (channels * m_spec.channel_bytes()) - 1; c >= 0; --c) {
+                std::vector<uint8_t> in(tw * th);
+                uint8_t* in_p = &in[0];
+
+                // uncompress and increment
+                p += uncompress_rle_channel(p, in_p, tw * th);
+
+                // set tile
+                for (uint16_t py = ymin; py <= ymax; py++) {
+                    uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
+                                      + (py * m_spec.width)
+                                            * m_spec.pixel_bytes();
+
+                    for (uint16_t px = xmin; px <= xmax; px++) {
+                        uint8_t* out_p = out_dy + px * m_spec.pixel_bytes() + c;
+                        *out_p++ = *in_p++;
                     }
-                } else {
-                    int sy = 0;
-                    for (uint16_t py = ymin; py <= ymax; py++) {
-                        uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
-                                          + (py * m_spec.width + xmin)
-                                                * m_spec.pixel_bytes();
-
-                        // set scanline, make copy easier
-                        std::vector<uint16_t> scanline(tw
-                                                       * m_spec.pixel_bytes());
-                        uint16_t* sl_p = &scanline[0];
-
-                        // set tile
-                        int sx = 0;
-                        for (uint16_t px = xmin; px <= xmax; px++) {
-                            uint8_t* in_p
-                                = p + (sy * tw + sx) * m_spec.pixel_bytes();
-
-                            // map BGR(A) to RGB(A)
-                            for (int c = channels - 1; c >= 0; --c) {
-                                uint16_t pixel;
-                                uint8_t* out_p = in_p
-                                                 + (c * m_spec.channel_bytes());
-                                memcpy(&pixel, out_p, 2);
-                                // swap endianness
-                                if (littleendian()) {
-                                    swap_endian(&pixel);
-                                }
-                                *sl_p++ = pixel;
-                            }
-                            sx++;
-                        }
-                        // copy data
-                        memcpy(out_dy, &scanline[0], tw * m_spec.pixel_bytes());
-                        sy++;
+                }
+            }
+        } else {
+            int sy = 0;
+            for (uint16_t py = ymin; py <= ymax; py++) {
+                uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
+                                  + (py * m_spec.width + xmin)
+                                        * m_spec.pixel_bytes();
+
+                // set tile
+                int sx = 0;
+                for (uint16_t px = xmin; px <= xmax; px++) {
+                    const uint8_t* in_p
+                        = p + (sy * tw + sx) * m_spec.pixel_bytes();
+
+                    // map BGR(A) to RGB(A)
+                    for (int c = channels - 1; c >= 0; --c) {
+                        const uint8_t* out_p
+                            = in_p + (c * m_spec.channel_bytes());
+                        *out_dy++ = *out_p;
                     }
+                    sx++;
+                }
+                sy++;
+            }
+        }
+    }
+    // handle 16-bit data.
+    else {
+        // set tile data
+        const uint8_t* p = tile.data.data();
+
+        if (tile_compress) {
+            // set map
+            std::vector<uint8_t> map;
+            if (littleendian()) {
+                int rgb16[]  = { 0, 2, 4, 1, 3, 5 };
+                int rgba16[] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+                if (m_iff_header.pixel_channels == 3) {
+                    map = std::vector<uint8_t>(rgb16, &rgb16[6]);
+                } else {
+                    map = std::vector<uint8_t>(rgba16, &rgba16[8]);
                 }
 
             } else {
-                errorfmt("\"{}\": unsupported number of bits per pixel for tile",
-                         m_filename);
-                return false;
+                int rgb16[]  = { 1, 3, 5, 0, 2, 4 };
+                int rgba16[] = { 1, 3, 5, 7, 0, 2, 4, 6 };
+                if (m_iff_header.pixel_channels == 3) {
+                    map = std::vector<uint8_t>(rgb16, &rgb16[6]);
+                } else {
+                    map = std::vector<uint8_t>(rgba16, &rgba16[8]);
+                }
             }
 
-            // tile
-            t++;
+            // map BGR(A)BGR(A) to RRGGBB(AA)
+            for (int c = (channels * m_spec.channel_bytes()) - 1; c >= 0; --c) {
+                int mc = map[c];
 
-        } else {
-            // skip to the next block
-            if (!ioseek(chunksize))
-                return false;
-        }
-    }
+                std::vector<uint8_t> in(tw * th);
+                uint8_t* in_p = &in[0];
 
-    // flip buffer to make read_native_tile easier,
-    // from tga.imageio:
+                // uncompress and increment
+                p += uncompress_rle_channel(p, in_p, tw * th);
 
-    int bytespp = m_spec.pixel_bytes();
+                // set tile
+                for (uint16_t py = ymin; py <= ymax; py++) {
+                    uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
+                                      + (py * m_spec.width)
+                                            * m_spec.pixel_bytes();
 
-    std::vector<unsigned char> flip(m_spec.width * bytespp);
-    unsigned char *src, *dst, *tmp = &flip[0];
-    for (int y = 0; y < m_spec.height / 2; y++) {
-        src = &m_buf[(m_spec.height - y - 1) * m_spec.width * bytespp];
-        dst = &m_buf[y * m_spec.width * bytespp];
+                    for (uint16_t px = xmin; px <= xmax; px++) {
+                        uint8_t* out_p
+                            = out_dy + px * m_spec.pixel_bytes() + mc;
+                        *out_p++ = *in_p++;
+                    }
+                }
+            }
+        } else {
+            int sy = 0;
+            for (uint16_t py = ymin; py <= ymax; py++) {
+                uint8_t* out_dy = static_cast<uint8_t*>(&m_buf[0])
+                                  + (py * m_spec.width + xmin)
+                                        * m_spec.pixel_bytes();
+
+                // set scanline, make copy easier
+                std::vector<uint16_t> scanline(tw * m_spec.pixel_bytes());
+                uint16_t* sl_p = &scanline[0];
+
+                // set tile
+                int sx = 0;
+                for (uint16_t px = xmin; px <= xmax; px++) {
+                    const uint8_t* in_p
+                        = p + (sy * tw + sx) * m_spec.pixel_bytes();
 
-        memcpy(tmp, src, m_spec.width * bytespp);
-        memcpy(src, dst, m_spec.width * bytespp);
-        memcpy(dst, tmp, m_spec.width * bytespp);
+                    // map BGR(A) to RGB(A)
+                    for (int c = channels - 1; c >= 0; --c) {
+                        uint16_t pixel;
+                        const uint8_t* out_p
+                            = in_p + (c * m_spec.channel_bytes());
+                        memcpy(&pixel, out_p, 2);
+                        // swap endianness
+                        if (littleendian()) {
+                            swap_endian(&pixel);
+                        }
+                        *sl_p++ = pixel;
+                    }
+                    sx++;
+                }
+                // copy data
+                memcpy(out_dy, &scanline[0], tw * m_spec.pixel_bytes());
+                sy++;
+            }
+        }
     }
-
-    return true;
 }
 
 
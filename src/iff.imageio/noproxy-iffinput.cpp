@@ -27,6 +27,8 @@ iff_input_imageio_create()
 }
 
 OIIO_EXPORT const char* iff_input_extensions[] = { "iff", "z", nullptr };
+// Magic numbers: "CIMG" inside "FOR4"
+OIIO_EXPORT const char* iff_input_signatures[] = { "8:43494d47", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
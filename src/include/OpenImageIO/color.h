@@ -409,6 +409,17 @@ Rec709_to_linear(float x)
         return powf((x + 0.099f) * (1.0f / 1.099f), (1.0f / 0.45f));
 }
 
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+Rec709_to_linear(const simd::vfloat4& x)
+{
+    return simd::select(x < 0.081f, x * (1.0f / 4.5f),
+                        fast_pow_pos(madd(x, (1.0f / 1.099f),
+                                          0.099f * (1.0f / 1.099f)),
+                                     (1.0f / 0.45f)));
+}
+#endif
+
 /// Utility -- convert linear value to Rec709 transfer function, without
 /// any change in color primaries.
 inline float
@@ -420,5 +431,170 @@ linear_to_Rec709(float x)
         return 1.099f * powf(x, 0.45f) - 0.099f;
 }
 
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+linear_to_Rec709(const simd::vfloat4& x)
+{
+    return simd::select(x < 0.018f, x * 4.5f,
+                        madd(1.099f, fast_pow_pos(x, 0.45f), -0.099f));
+}
+#endif
+
+
+// Constants of the SMPTE ST 2084 ("PQ") curve.
+namespace pvt {
+static constexpr float PQ_m1 = 0.1593017578125f;  // 2610 / 16384
+static constexpr float PQ_m2 = 78.84375f;         // 2523 / 4096 * 128
+static constexpr float PQ_c1 = 0.8359375f;        // 3424 / 4096
+static constexpr float PQ_c2 = 18.8515625f;       // 2413 / 4096 * 32
+static constexpr float PQ_c3 = 18.6875f;          // 2392 / 4096 * 32
+}  // namespace pvt
+
+/// Utility -- convert SMPTE ST 2084 ("PQ") encoded value to linear,
+/// without any change in color primaries. Linear 1.0 corresponds to
+/// 100 cd/m^2, so the full PQ range decodes to [0,100].
+///    https://en.wikipedia.org/wiki/Perceptual_quantizer
+inline float
+PQ_to_linear(float x)
+{
+    using namespace pvt;
+    float e = powf(std::max(x, 0.0f), 1.0f / PQ_m2);
+    return 100.0f
+           * powf(std::max(e - PQ_c1, 0.0f) / (PQ_c2 - PQ_c3 * e),
+                  1.0f / PQ_m1);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+PQ_to_linear(const simd::vfloat4& x)
+{
+    using namespace pvt;
+    simd::vfloat4 e = fast_pow_pos(simd::max(x, simd::vfloat4::Zero()),
+                                   1.0f / PQ_m2);
+    return 100.0f
+           * fast_pow_pos(simd::max(e - PQ_c1, simd::vfloat4::Zero())
+                              / simd::nmadd(PQ_c3, e, PQ_c2),
+                          1.0f / PQ_m1);
+}
+#endif
+
+/// Utility -- convert linear value to SMPTE ST 2084 ("PQ") encoding,
+/// without any change in color primaries. Linear 1.0 corresponds to
+/// 100 cd/m^2.
+inline float
+linear_to_PQ(float x)
+{
+    using namespace pvt;
+    float y = powf(std::max(x * 0.01f, 0.0f), PQ_m1);
+    return powf((PQ_c1 + PQ_c2 * y) / (1.0f + PQ_c3 * y), PQ_m2);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+linear_to_PQ(const simd::vfloat4& x)
+{
+    using namespace pvt;
+    simd::vfloat4 y = fast_pow_pos(simd::max(x * 0.01f,
+                                             simd::vfloat4::Zero()),
+                                   PQ_m1);
+    return fast_pow_pos(madd(PQ_c2, y, PQ_c1) / madd(PQ_c3, y, 1.0f), PQ_m2);
+}
+#endif
+
+
+// Constants of the ARIB STD-B67 / Rec.2100 Hybrid Log-Gamma curve.
+namespace pvt {
+static constexpr float HLG_a = 0.17883277f;
+static constexpr float HLG_b = 0.28466892f;  // 1 - 4a
+static constexpr float HLG_c = 0.55991073f;  // 0.5 - a * ln(4a)
+}  // namespace pvt
+
+/// Utility -- convert Hybrid Log-Gamma encoded value to (scene) linear,
+/// without any change in color primaries. The HLG range [0,1] decodes to
+/// linear [0,1].
+///    https://en.wikipedia.org/wiki/Hybrid_log%E2%80%93gamma
+inline float
+HLG_to_linear(float x)
+{
+    using namespace pvt;
+    return (x <= 0.5f) ? (x * x * (1.0f / 3.0f))
+                       : (expf((x - HLG_c) * (1.0f / HLG_a)) + HLG_b)
+                             * (1.0f / 12.0f);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+HLG_to_linear(const simd::vfloat4& x)
+{
+    using namespace pvt;
+    return simd::select(x <= 0.5f, x * x * (1.0f / 3.0f),
+                        (fast_exp((x - HLG_c) * (1.0f / HLG_a)) + HLG_b)
+                            * (1.0f / 12.0f));
+}
+#endif
+
+/// Utility -- convert (scene) linear value to Hybrid Log-Gamma encoding,
+/// without any change in color primaries.
+inline float
+linear_to_HLG(float x)
+{
+    using namespace pvt;
+    return (x <= 1.0f / 12.0f) ? sqrtf(3.0f * std::max(x, 0.0f))
+                               : madd(HLG_a, logf(12.0f * x - HLG_b), HLG_c);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+linear_to_HLG(const simd::vfloat4& x)
+{
+    using namespace pvt;
+    return simd::select(x <= 1.0f / 12.0f,
+                        simd::sqrt(3.0f * simd::max(x, simd::vfloat4::Zero())),
+                        madd(HLG_a, fast_log(madd(12.0f, x, -HLG_b)), HLG_c));
+}
+#endif
+
+
+/// Utility -- convert ACEScct log encoded value to linear, without any
+/// change in color primaries (both are AP1, i.e. this is the transfer
+/// function between ACEScct and ACEScg).
+inline float
+ACEScct_to_linear(float x)
+{
+    return (x <= 0.155251141552511f)
+               ? (x - 0.0729055341958355f) * (1.0f / 10.5402377416545f)
+               : std::min(exp2f(x * 17.52f - 9.72f), 65504.0f);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+ACEScct_to_linear(const simd::vfloat4& x)
+{
+    return simd::select(x <= 0.155251141552511f,
+                        (x - 0.0729055341958355f) * (1.0f / 10.5402377416545f),
+                        simd::min(fast_exp2(madd(x, 17.52f, -9.72f)),
+                                  65504.0f));
+}
+#endif
+
+/// Utility -- convert linear value to ACEScct log encoding, without any
+/// change in color primaries.
+inline float
+linear_to_ACEScct(float x)
+{
+    return (x <= 0.0078125f) ? madd(10.5402377416545f, x, 0.0729055341958355f)
+                             : (log2f(x) + 9.72f) * (1.0f / 17.52f);
+}
+
+#ifndef __CUDA_ARCH__
+inline simd::vfloat4
+linear_to_ACEScct(const simd::vfloat4& x)
+{
+    return simd::select(x <= 0.0078125f,
+                        madd(10.5402377416545f, x, 0.0729055341958355f),
+                        (fast_log2(x) + 9.72f) * (1.0f / 17.52f));
+}
+#endif
+
 
 OIIO_NAMESPACE_END
@@ -121,6 +121,23 @@ public:
     /// pixel index.
     int capacity(int64_t pixel) const;
 
+    /// Switch to (or from, if `pixels_per_chunk` is 0) chunked storage, in
+    /// which each run of `pixels_per_chunk` consecutive pixels (such as a
+    /// scanline or a tile) keeps its samples in a separate arena. This
+    /// must be called after init(). When growing the capacity of pixels
+    /// of an already allocated DeepData, the default contiguous layout
+    /// moves the data of all subsequent pixels and serializes all threads,
+    /// whereas chunked storage only touches that pixel, at amortized O(1)
+    /// cost, and only locks its chunk, so threads working on different
+    /// chunks don't contend. The price is some slack memory in each chunk.
+    /// `all_data()` gathers the chunks back into the contiguous layout
+    /// when it is called; the next growth re-chunks.
+    void set_chunked(int64_t pixels_per_chunk);
+
+    /// Return the number of pixels per chunk, or 0 if the storage is
+    /// contiguous.
+    int64_t chunked() const;
+
     /// Insert `n` samples of the specified pixel, betinning at the sample
     /// position index. After insertion, the new samples will have
     /// uninitialized values.
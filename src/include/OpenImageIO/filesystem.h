@@ -566,6 +566,25 @@ protected:
     cspan<unsigned char> m_buf;
 };
 
+
+
+/// IOMemReader subclass that memory-maps a whole file for reading. Readers
+/// of formats with fixed-size rows at known offsets can use buffer() to
+/// decode directly from the mapped file, without the intermediate copy
+/// that read() or pread() would make. If the file can't be mapped,
+/// opened() is false and error() explains why.
+class OIIO_UTIL_API IOMemMapFile : public IOMemReader {
+public:
+    IOMemMapFile(string_view filename);
+    ~IOMemMapFile() override;
+    const char* proxytype() const override { return "memmap"; }
+    void close() override;
+
+private:
+    void* m_map     = nullptr;  // start of the mapped view
+    void* m_mapping = nullptr;  // Windows file mapping handle
+};
+
 };  // namespace Filesystem
 
 OIIO_NAMESPACE_END
@@ -179,7 +179,13 @@ public:
     /// @param config
     ///             Optionally, a pointer to an ImageSpec whose metadata
     ///             contains configuration hints that set options related
-    ///             to the opening and reading of the file.
+    ///             to the opening and reading of the file. Besides the
+    ///             hints understood by the ImageInput, the ImageBuf itself
+    ///             honors `"oiio:ConvertToColorSpace"` (string), which
+    ///             color converts the pixels to the named color space as
+    ///             they are read, from the color space given by
+    ///             `"oiio:ConvertFromColorSpace"` if present, or else the
+    ///             file's `"oiio:ColorSpace"` metadata.
     /// @param ioproxy
     ///         Optional pointer to an IOProxy to use when reading from the
     ///         file. The caller retains ownership of the proxy, and must
@@ -391,7 +397,13 @@ public:
     /// @param  convert
     ///             If set to a specific type (not`UNKNOWN`), the ImageBuf
     ///             memory will be allocated for that type specifically and
-    ///             converted upon read.
+    ///             converted upon read. If the configuration hints
+    ///             requested `"oiio:ConvertToColorSpace"`, the color
+    ///             transformation is applied as the file is decoded, one
+    ///             band of scanlines or tiles at a time, before the
+    ///             conversion to this type (so no precision is lost to an
+    ///             intermediate full-image buffer). This always implies
+    ///             `force`.
     /// @param  progress_callback/progress_callback_data
     ///             If `progress_callback` is non-NULL, the underlying
     ///             read, if expensive, may make several calls to
@@ -1578,6 +1590,176 @@ public:
     };
 
 
+    /// RowReader gives read access to a region of an ImageBuf one whole
+    /// scanline at a time, as a contiguous span of `roi.width() *
+    /// roi.nchannels()` values of type USERT (channels interleaved). This
+    /// lets kernels operate on an entire row at once -- and lets the
+    /// compiler vectorize them -- rather than paying the per-pixel
+    /// overhead of an Iterator.
+    ///
+    /// If the buffer holds local pixels of type USERT and the requested
+    /// row is within the data window and covers all channels, the span
+    /// refers directly to the buffer's memory. Otherwise (ImageCache
+    /// backed, a different pixel type, a channel subset, or a row partly
+    /// outside the data window), the values are converted into a scratch
+    /// row owned by the RowReader, with black for any pixels outside the
+    /// data window. Either way, the span is only valid until the next call
+    /// to `row()`. A RowReader is not thread-safe; make one per thread
+    /// (e.g., within the lambda passed to `parallel_image`).
+    /// \code
+    ///   ImageBuf::RowReader<float> a(A, roi);
+    ///   ImageBuf::RowWriter<float> r(R, roi);
+    ///   for (int y = roi.ybegin; y < roi.yend; ++y) {
+    ///       cspan<float> arow = a.row(y);
+    ///       span<float> rrow  = r.row(y);
+    ///       for (size_t i = 0; i < rrow.size(); ++i)
+    ///           rrow[i] = 2.0f * arow[i];
+    ///   }
+    /// \endcode
+    template<typename USERT = float> class RowReader {
+    public:
+        RowReader(const ImageBuf& ib, const ROI& roi)
+            : m_ib(ib)
+            , m_roi(roi)
+            , m_nvalues(size_t(roi.width()) * size_t(roi.nchannels()))
+        {
+            const ImageSpec& spec(ib.spec());
+            m_direct = ib.localpixels() && spec.format == usertype()
+                       && roi.chbegin == 0 && roi.chend == spec.nchannels
+                       && ib.pixel_stride()
+                              == stride_t(spec.nchannels * sizeof(USERT));
+        }
+
+        /// Return the values of row y (plane z) of the region.
+        cspan<USERT> row(int y, int z = 0)
+        {
+            const ImageSpec& spec(m_ib.spec());
+            bool inside = y >= spec.y && y < spec.y + spec.height
+                          && z >= spec.z && z < spec.z + spec.depth;
+            int x0      = std::max(m_roi.xbegin, spec.x);
+            int x1      = std::min(m_roi.xend, spec.x + spec.width);
+            if (m_direct && inside && x0 == m_roi.xbegin && x1 == m_roi.xend)
+                return cspan<USERT>((const USERT*)m_ib.pixeladdr(x0, y, z),
+                                    m_nvalues);
+            if (!m_scratch)
+                m_scratch.reset(new USERT[m_nvalues]);
+            if (!m_ib.localpixels()) {
+                m_ib.get_pixels(ROI(m_roi.xbegin, m_roi.xend, y, y + 1, z,
+                                    z + 1, m_roi.chbegin, m_roi.chend),
+                                usertype(), m_scratch.get());
+                return cspan<USERT>(m_scratch.get(), m_nvalues);
+            }
+            if (!inside || x0 > m_roi.xbegin || x1 < m_roi.xend)
+                memset((void*)m_scratch.get(), 0, m_nvalues * sizeof(USERT));
+            if (inside && x0 < x1) {
+                int nc = m_roi.nchannels();
+                convert_image(nc, x1 - x0, 1, 1,
+                              m_ib.pixeladdr(x0, y, z, m_roi.chbegin),
+                              spec.format, m_ib.pixel_stride(), AutoStride,
+                              AutoStride,
+                              m_scratch.get() + size_t(x0 - m_roi.xbegin) * nc,
+                              usertype(), AutoStride, AutoStride, AutoStride);
+            }
+            return cspan<USERT>(m_scratch.get(), m_nvalues);
+        }
+
+        const ROI& roi() const { return m_roi; }
+
+    private:
+        static TypeDesc usertype() { return BaseTypeFromC<USERT>::value; }
+
+        const ImageBuf& m_ib;
+        ROI m_roi;
+        size_t m_nvalues;
+        bool m_direct;
+        std::unique_ptr<USERT[]> m_scratch;
+    };
+
+
+    /// RowWriter is the writable counterpart to RowReader: `row()` returns
+    /// a span of `roi.width() * roi.nchannels()` values of type USERT for
+    /// the caller to fill in. If it can't refer directly to the buffer's
+    /// memory, it's a scratch row, which is converted and stored into the
+    /// buffer upon the next call to `row()`, an explicit `flush()`, or
+    /// destruction of the RowWriter. Values for pixels outside the data
+    /// window are discarded. The buffer must already hold local pixels:
+    /// if it may be backed by an ImageCache, call `make_writable(true)`
+    /// once before making RowWriters, and in particular before any
+    /// parallel loop that makes one per thread, since `make_writable()`
+    /// is not thread-safe. (IBAprep does this for the destination of an
+    /// ImageBufAlgo function.)
+    template<typename USERT = float> class RowWriter {
+    public:
+        RowWriter(ImageBuf& ib, const ROI& roi)
+            : m_ib(ib)
+            , m_roi(roi)
+            , m_nvalues(size_t(roi.width()) * size_t(roi.nchannels()))
+        {
+            OIIO_DASSERT(ib.localpixels());  // precondition
+            const ImageSpec& spec(ib.spec());
+            m_direct = spec.format == usertype() && roi.chbegin == 0
+                       && roi.chend == spec.nchannels
+                       && ib.pixel_stride()
+                              == stride_t(spec.nchannels * sizeof(USERT));
+        }
+        ~RowWriter() { flush(); }
+
+        /// Return the span to fill in with the values of row y (plane z)
+        /// of the region, first storing any pending scratch row.
+        span<USERT> row(int y, int z = 0)
+        {
+            flush();
+            const ImageSpec& spec(m_ib.spec());
+            if (m_direct && y >= spec.y && y < spec.y + spec.height
+                && z >= spec.z && z < spec.z + spec.depth
+                && m_roi.xbegin >= spec.x
+                && m_roi.xend <= spec.x + spec.width)
+                return span<USERT>((USERT*)m_ib.pixeladdr(m_roi.xbegin, y, z),
+                                   m_nvalues);
+            if (!m_scratch)
+                m_scratch.reset(new USERT[m_nvalues]);
+            m_pending = true;
+            m_y       = y;
+            m_z       = z;
+            return span<USERT>(m_scratch.get(), m_nvalues);
+        }
+
+        /// Store the pending scratch row, if any, into the buffer.
+        void flush()
+        {
+            if (!m_pending)
+                return;
+            m_pending = false;
+            const ImageSpec& spec(m_ib.spec());
+            int x0 = std::max(m_roi.xbegin, spec.x);
+            int x1 = std::min(m_roi.xend, spec.x + spec.width);
+            if (m_y < spec.y || m_y >= spec.y + spec.height || m_z < spec.z
+                || m_z >= spec.z + spec.depth || x0 >= x1)
+                return;
+            int nc = m_roi.nchannels();
+            convert_image(nc, x1 - x0, 1, 1,
+                          m_scratch.get() + size_t(x0 - m_roi.xbegin) * nc,
+                          usertype(), AutoStride, AutoStride, AutoStride,
+                          m_ib.pixeladdr(x0, m_y, m_z, m_roi.chbegin),
+                          spec.format, m_ib.pixel_stride(), AutoStride,
+                          AutoStride);
+        }
+
+        const ROI& roi() const { return m_roi; }
+
+    private:
+        static TypeDesc usertype() { return BaseTypeFromC<USERT>::value; }
+
+        ImageBuf& m_ib;
+        ROI m_roi;
+        size_t m_nvalues;
+        bool m_direct;
+        bool m_pending = false;
+        int m_y = 0, m_z = 0;
+        std::unique_ptr<USERT[]> m_scratch;
+    };
+
+
 protected:
     // PIMPL idiom
     static void impl_deleter(ImageBufImpl*);
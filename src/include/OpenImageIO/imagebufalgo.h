@@ -21,6 +21,7 @@
 #include <OpenImageIO/span.h>
 #include <OpenImageIO/vecparam.h>
 
+#include <functional>
 #include <limits>
 
 #if !defined(__OPENCV_CORE_TYPES_H__) && !defined(OPENCV_CORE_TYPES_H)
@@ -847,6 +848,15 @@ bool OIIO_API fit(ImageBuf &dst, const ImageBuf &src, KWArgs options = {},
 ///     `make_pv("filterptr", raw_filter_ptr)`.
 ///     Use with caution!
 ///
+///   - "fast" : int (default: 0)
+///
+///     If nonzero, use a faster implementation that traverses the output
+///     in tiles (so the source region each tile samples stays in cache),
+///     evaluates separable filters through lookup tables, and has
+///     specialized bilinear/bicubic kernels for areas that are not
+///     minified. Results match the default to within the precision of the
+///     filter tables, but are not bit-for-bit identical.
+///
 
 ImageBuf OIIO_API warp(const ImageBuf &src, M33fParam M,
                        KWArgs options = {}, ROI roi = {}, int nthreads = 0);
@@ -1883,6 +1893,13 @@ bool OIIO_API erode (ImageBuf &dst, const ImageBuf &src,
 /// OpenColorIO support enabled, then the only transformations available are
 /// from "sRGB" to "linear" and vice versa.
 ///
+/// For large `uint8` or `uint16` source images of up to four channels
+/// (without unpremultiplication), the transformation is baked into a lookup
+/// table over the source code values: exact per-channel tables for
+/// transformations without channel crosstalk, or an interpolated 3D LUT
+/// for those with crosstalk if it reproduces the transformation to within
+/// 1/1024 (otherwise every pixel is transformed, as usual).
+///
 /// @param  fromspace/tospace
 ///             For the varieties of `colorconvert()` that use named color
 ///             spaces, these specify the color spaces by name.
@@ -2417,6 +2434,94 @@ bool OIIO_API make_texture (MakeTextureMode mode,
 /// @}
 
 
+/// @defgroup stream_pointwise (stream_pointwise -- stream files through ops)
+/// @{
+///
+/// A `PointwiseOp` computes `dst` (which will be uninitialized) from `src`,
+/// which will hold one horizontal band of whole scanlines of an image, in
+/// `float`. It must be a strictly pointwise operation, i.e., each output
+/// pixel may depend only on the input pixel at the same position. Typical
+/// examples are wrappers around `colorconvert()`, `channels()`, `mad()`,
+/// `clamp()`, or `premult()`. It should return `true` for success, or
+/// `false` and record an error in `dst` upon failure.
+using PointwiseOp = std::function<bool(ImageBuf& dst, const ImageBuf& src)>;
+
+/// Read the image file `infilename`, apply each of the `ops` in turn, and
+/// write the result to `outfilename`, without ever holding the whole image
+/// in memory. The image is processed in bands of scanlines: while one band
+/// is being computed (the ops themselves are free to use multiple
+/// threads), the next band is read and the previous one is written on
+/// other threads, so memory use stays bounded to a handful of bands and
+/// the reading, computing, and writing overlap.
+///
+/// Only the first subimage is processed, and deep and volume images are not
+/// supported. The output has the channels and metadata resulting from the
+/// ops applied to the first band, and is written as a scanline file.
+///
+/// Optional `options` recognized:
+///
+///   - `"format"` (string) : Data type of the output file (default: same
+///     as the input file).
+///   - `"bandheight"` (int) : Number of scanlines per band. The default (0)
+///     picks a band of roughly 4M pixels. For tiled inputs, it is rounded
+///     up to a whole number of tile rows.
+///
+/// The return value is `true` for success, `false` if an error occurred.
+/// If there was an error, any error message will be retrievable via the
+/// global `OIIO::geterror()` call (since there is no destination
+/// `ImageBuf` in which to store it).
+bool OIIO_API stream_pointwise (string_view outfilename,
+                                string_view infilename,
+                                cspan<PointwiseOp> ops,
+                                KWArgs options = {});
+
+/// A `DeepStreamOp` computes `dst` from `src`, which holds the same band of
+/// whole scanlines of each of the deep input images. Typical examples are
+/// wrappers around `flatten()`, `deep_holdout()`, `deep_merge()`, or
+/// `deep_reduce()`. The result must cover the same pixels as the band, and
+/// may be deep or flat. To reuse its memory, `dst` may still hold the
+/// result of an earlier band, moved to this band's position and with its
+/// deep samples removed, so the op should write every pixel (as IBA
+/// functions do). It should return `true` for success, or `false` and
+/// record an error in `dst` upon failure.
+using DeepStreamOp = std::function<bool(ImageBuf& dst, cspan<ImageBuf> src)>;
+
+/// Read the deep image files `infilenames` (one or more, which must all
+/// have the same data window) in bands of scanlines, apply `op` to each
+/// band, and write the results to `outfilename`, without ever holding
+/// whole images in memory. This works like `stream_pointwise()`: reading,
+/// computing, and writing of successive bands overlap, and the buffers
+/// (including the `DeepData` arenas) of each band are reused for later
+/// bands, so memory use stays bounded by a couple of bands. The output is
+/// a deep file if `op` makes deep results, or else a flat one, and is
+/// written as scanlines.
+///
+/// Only the first subimage of each input is processed, and volumes are not
+/// supported.
+///
+/// Optional `options` recognized:
+///
+///   - `"format"` (string) : Data type of the output file (default: as
+///     made by the op).
+///   - `"bandheight"` (int) : Number of scanlines per band. The default (0)
+///     picks a band of roughly 1M pixels. For tiled inputs, it is rounded
+///     up to a whole number of tile rows.
+///
+/// For example, to flatten a huge deep file:
+///
+///     ImageBufAlgo::stream_deep("flat.exr", { "deep.exr" },
+///         [](ImageBuf& dst, cspan<ImageBuf> src) {
+///             return ImageBufAlgo::flatten(dst, src[0]);
+///         });
+///
+/// The return value is `true` for success, `false` if an error occurred,
+/// in which case the message will be retrievable via `OIIO::geterror()`.
+bool OIIO_API stream_deep (string_view outfilename,
+                           cspan<std::string> infilenames,
+                           const DeepStreamOp& op, KWArgs options = {});
+/// @}
+
+
 /// Convert an OpenCV cv::Mat into an ImageBuf, copying the pixels (optionally
 /// converting to the pixel data type specified by `convert`, if not UNKNOWN,
 /// which means to preserve the original data type if possible).  Return true
@@ -2531,6 +2636,44 @@ bool OIIO_API deep_holdout (ImageBuf &dst, const ImageBuf &src,
                             ROI roi={}, int nthreads=0);
 
 
+/// Sample counts and sizes of the sample data (in the ROI) before and
+/// after `deep_reduce()`.
+struct DeepReduceStats {
+    int64_t samples_in = 0, samples_out = 0;    ///< Total samples
+    int64_t bytes_in = 0, bytes_out = 0;        ///< Total sample data size
+    int maxsamples_in = 0, maxsamples_out = 0;  ///< Most samples in a pixel
+};
+
+/// Return a copy of deep image `src` with fewer samples, by the following
+/// lossy reductions of each (depth sorted) pixel:
+///
+/// * A sample that begins no farther than `ztolerance` beyond the back of
+///   the sample in front of it, and whose unpremultiplied color channels
+///   all differ from that sample's by no more than `colortolerance`, is
+///   composited into it ("over"), leaving one sample that spans both.
+///   Non-color channels (such as object IDs) must match exactly.
+/// * Once the accumulated opacity of the samples reaches `opacity`, all
+///   the samples behind are dropped.
+///
+/// Since the merged samples are composited front to back, flattening the
+/// result gives the same image as flattening `src`, apart from the
+/// samples dropped behind the opacity threshold. With the defaults, only
+/// samples that abut exactly with identical color are merged, and only
+/// samples behind a fully opaque accumulation are dropped. If `stats` is
+/// not null, it receives the sample counts and sizes before and after.
+ImageBuf OIIO_API deep_reduce (const ImageBuf &src, float ztolerance = 0.0f,
+                               float colortolerance = 0.0f,
+                               float opacity = 1.0f,
+                               DeepReduceStats *stats = nullptr,
+                               ROI roi={}, int nthreads=0);
+/// Write to an existing image `dst` (allocating if it is uninitialized).
+bool OIIO_API deep_reduce (ImageBuf &dst, const ImageBuf &src,
+                           float ztolerance = 0.0f,
+                           float colortolerance = 0.0f, float opacity = 1.0f,
+                           DeepReduceStats *stats = nullptr,
+                           ROI roi={}, int nthreads=0);
+
+
 
 
 ///////////////////////////////////////////////////////////////////////
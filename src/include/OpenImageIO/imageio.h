@@ -30,6 +30,7 @@
 
 #include <OpenImageIO/span.h>
 #include <OpenImageIO/export.h>
+#include <OpenImageIO/function_view.h>
 #include <OpenImageIO/oiioversion.h>
 #include <OpenImageIO/paramlist.h>
 #include <OpenImageIO/platform.h>
@@ -999,6 +1000,11 @@ public:
     ///       Can this format create images without reading from a disk
     ///       file?
     ///
+    /// - `"reduce"` :
+    ///       Does this format reader honor the `"oiio:reduce"` open
+    ///       configuration hint, decoding the image at reduced resolution
+    ///       more cheaply than reading it at full resolution and resizing?
+    ///
     /// - `"thumbnail"` :
     ///       Does this format reader support retrieving a reduced
     ///       resolution copy of the image via the `thumbnail()` method?
@@ -1796,6 +1802,12 @@ protected:
     /// items read.
     bool ioread(void* buf, size_t itemsize, size_t nitems = 1);
 
+    /// Helper: read `size` bytes starting at position `offset` of the
+    /// proxy, akin to pread(). This does not move the current position of
+    /// the proxy, and is safe to call concurrently. Return true on success,
+    /// false upon failure and issue a helpful error message.
+    bool iopread(void* buf, size_t size, int64_t offset);
+
     /// Helper: seek the proxy, akin to fseek. Return true on success, false
     /// upon failure and issue an error message. (NOTE: this is not the same
     /// return value as std::fseek, which returns 0 on success.)
@@ -1853,6 +1865,27 @@ protected:
 
     /// @}
 
+    /// Helper for implementing `read_native_scanlines()` in formats whose
+    /// scanlines, or strips of `rowsperstrip` scanlines (counted from
+    /// `spec.y`), can each be located and decoded independently -- for
+    /// example, because the file has a table of their offsets. Native
+    /// scanlines [ybegin,yend) of the current subimage are stored
+    /// contiguously at `data`, by calling `decode(y0, y1, buf)`, which must
+    /// decode native scanlines [y0,y1) into `buf`. Each `[y0,y1)` starts
+    /// and ends on a strip boundary (or the end of the image); strips that
+    /// stick out of [ybegin,yend) are decoded to scratch memory and
+    /// trimmed by the helper.
+    ///
+    /// The calls to `decode` are spread across the thread pool (subject to
+    /// `threads()`), so it must be safe to call concurrently: it should
+    /// read with `ioproxy()->pread()` rather than `ioread()` and
+    /// `ioseek()`, and must not use member scratch buffers. Errors issued
+    /// by `decode` are forwarded to this ImageInput. Return true if every
+    /// call succeeded.
+    bool read_native_scanlines_parallel(
+        int ybegin, int yend, int rowsperstrip, void* data,
+        function_view<bool(int y0, int y1, void* buf)> decode);
+
 private:
     // PIMPL idiom -- this lets us hide details of the internals of the
     // ImageInput parent class so that changing them does not break the
@@ -2861,6 +2894,16 @@ OIIO_API std::string geterror(bool clear = true);
 ///    Colon-separated (or semicolon-separated) list of directories to search
 ///    for dynamically-loaded format plugins.
 ///
+/// - `string plugin_cache` ("")
+///
+///    If set to a file name, what each dynamically-loaded format plugin
+///    declares (its extensions, magic numbers, and whether it can read and
+///    write) is recorded in that file, keyed by the plugin's path,
+///    modification time, and size. Later processes declare those formats
+///    from the file, and load each plugin only when its format is first
+///    used. The default is the value of environment variable
+///    `OIIO_PLUGIN_CACHE`, or empty (no plugin cache).
+///
 /// - `int try_all_readers`
 ///
 ///    When nonzero (the default), a call to `ImageInput::create()` or
@@ -2920,11 +2963,37 @@ OIIO_API std::string geterror(bool clear = true);
 ///    When nonzero, treats BC5/ATI2 format files as normal maps (loads as
 ///    3 channels, computes blue from red and green). Default is 0.
 ///
+/// - `int color:fast_transfer` (1)
+///
+///    When nonzero, the built-in color transformations that are used when
+///    there is no OCIO configuration (sRGB, Rec709, gamma, PQ, HLG, and
+///    ACEScct transfer functions) use SIMD polynomial approximations of
+///    pow/log/exp, with relative error under 1e-4. When zero, they use
+///    the slower but exact scalar math.
+///
+/// - `string color:processor_cache` ("")
+///
+///    If set to a directory, color processors made by OpenColorIO (color
+///    space, look, display, and file transforms) are baked to files in
+///    that directory, keyed by the OCIO config, the request, and (for file
+///    transforms) the modification time of the LUT file. Later requests,
+///    including those by other processes, load the baked processor instead
+///    of building it again. The default is the value of environment
+///    variable `OIIO_COLOR_PROCESSOR_CACHE`, or empty (no disk cache).
+///    (Requires OpenColorIO 2.0 or later.)
+///
 /// - `int openexr:core`
 ///
 ///    When nonzero, use the new "OpenEXR core C library" when available,
 ///    for OpenEXR >= 3.1. This is experimental, and currently defaults to 0.
 ///
+/// - `int openexr:core_output` (0)
+///
+///    When nonzero, write single-part, single-level, non-deep OpenEXR files
+///    through the "OpenEXR core C library" (when available), compressing
+///    chunks in parallel on OIIO's thread pool rather than OpenEXR's own.
+///    This is experimental, and currently defaults to 0.
+///
 /// - `int limits:channels` (1024)
 ///
 ///    When nonzero, the maximum number of color channels in an image. Image
@@ -3082,6 +3151,15 @@ inline bool attribute (string_view name, string_view val) {
 ///   that they opened and read themselves (that is, excluding I/O from IBs
 ///   that were backed by ImageCach.  (Added in OpenImageIO 2.5.)
 ///
+/// - int64_t color:processor_cache_hits
+/// - int64_t color:processor_cache_misses
+/// - int64_t color:processor_cache_bytes
+///
+///   Statistics of the on-disk color processor cache (see
+///   `color:processor_cache`): the number of processors that were loaded
+///   from the cache, the number that had to be built (and were then
+///   baked), and the total size in bytes of the baked files written.
+///
 /// - `string opencolorio_version`
 ///
 ///   Returns the version (such as "2.2.0") of OpenColorIO that is used by
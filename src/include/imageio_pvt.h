@@ -33,6 +33,8 @@ extern atomic_int oiio_read_chunk;
 extern atomic_int oiio_try_all_readers;
 extern ustring font_searchpath;
 extern ustring plugin_searchpath;
+extern ustring plugin_cache_file;
+extern ustring colorproc_cache_dir;
 extern std::string format_list;
 extern std::string input_format_list;
 extern std::string output_format_list;
@@ -41,8 +43,10 @@ extern std::string library_list;
 extern OIIO_UTIL_API int oiio_print_debug;
 extern int oiio_log_times;
 extern int openexr_core;
+extern int openexr_core_output;
 extern int limit_channels;
 extern int limit_imagesize_MB;
+extern int color_fast_transfer;
 extern int opencv_version;
 extern int imagebuf_print_uncaught_errors;
 extern int imagebuf_use_imagecache;
@@ -50,6 +54,9 @@ extern atomic_ll IB_local_mem_current;
 extern atomic_ll IB_local_mem_peak;
 extern std::atomic<float> IB_total_open_time;
 extern std::atomic<float> IB_total_image_read_time;
+extern atomic_ll colorproc_cache_hits;
+extern atomic_ll colorproc_cache_misses;
+extern atomic_ll colorproc_cache_bytes;
 extern OIIO_UTIL_API int oiio_use_tbb;  // This lives in libOpenImageIO_Util
 OIIO_API const std::vector<std::string>&
 font_dirs();
@@ -114,6 +121,45 @@ const void*
 parallel_convert_from_float(const float* src, void* dst, size_t nvals,
                             TypeDesc format);
 
+/// Unpack `n` 10-bit values stored "filled" as DPX and Cineon do: three to
+/// a 32-bit word, the first in the highest bits, above `padbits` bits of
+/// padding (2 for DPX method A or Cineon left justified, 0 for method B or
+/// right justified). Values are expanded to 16 bits by replicating their
+/// high bits into the low ones. If `swap` is true, the words are in the
+/// opposite byte order from this machine.
+OIIO_API void
+unpack_10bit_filled(const void* src, uint16_t* dst, size_t n, int padbits,
+                    bool swap);
+
+/// The reverse of unpack_10bit_filled: pack the high 10 bits of each of
+/// `n` 16-bit values. Packing in place (`dst == src`) is allowed.
+OIIO_API void
+pack_10bit_filled(const uint16_t* src, void* dst, size_t n, int padbits,
+                  bool swap);
+
+/// Unpack `n` values of `bits` (10 or 12) bits stored "packed": a continuous
+/// stream of values in 32-bit words, least significant bits first, with no
+/// padding between words. Values are expanded to 16 bits.
+OIIO_API void
+unpack_packed_bits(const void* src, uint16_t* dst, size_t n, int bits,
+                   bool swap);
+
+/// The reverse of unpack_packed_bits, keeping the high `bits` bits of each
+/// 16-bit value. Packing in place is allowed.
+OIIO_API void
+pack_packed_bits(const uint16_t* src, void* dst, size_t n, int bits,
+                 bool swap);
+
+/// Unpack `n` 12-bit values held in the low bits of 16-bit words (DPX
+/// "filled method B"), expanding them to 16 bits. If `swap` is true, the
+/// 16-bit words are in the opposite byte order from this machine.
+OIIO_API void
+unpack_12bit_filled(const void* src, uint16_t* dst, size_t n, bool swap);
+
+/// The reverse of unpack_12bit_filled. Packing in place is allowed.
+OIIO_API void
+pack_12bit_filled(const uint16_t* src, void* dst, size_t n, bool swap);
+
 /// Internal utility: Error checking on the spec -- if it contains texture-
 /// specific metadata but there are clues it's not actually a texture file
 /// written by maketx or `oiiotool -otex`, then assume these metadata are
@@ -230,6 +276,19 @@ OIIO_API bool
 print_stats(std::ostream& out, string_view indent, const ImageBuf& input,
             const ImageSpec& spec, ROI roi, std::string& err);
 
+/// Return a row's worth of a per-channel constant, for use with
+/// ImageBuf::RowReader/RowWriter kernels: `roi.width()` copies of the
+/// values of `vals` for channels [roi.chbegin, roi.chend).
+inline std::vector<float>
+constant_row(cspan<float> vals, const ROI& roi)
+{
+    std::vector<float> row(size_t(roi.width()) * size_t(roi.nchannels()));
+    for (size_t i = 0; i < row.size();)
+        for (int c = roi.chbegin; c < roi.chend; ++c)
+            row[i++] = vals[c];
+    return row;
+}
+
 }  // namespace pvt
 
 OIIO_NAMESPACE_END
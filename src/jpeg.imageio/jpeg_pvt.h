@@ -60,7 +60,8 @@ public:
     const char* format_name(void) const override { return "jpeg"; }
     int supports(string_view feature) const override
     {
-        return (feature == "exif" || feature == "iptc" || feature == "ioproxy");
+        return (feature == "exif" || feature == "iptc" || feature == "ioproxy"
+                || feature == "reduce");
     }
     bool valid_file(Filesystem::IOProxy* ioproxy) const override;
 
@@ -69,6 +70,8 @@ public:
               const ImageSpec& config) override;
     bool read_native_scanline(int subimage, int miplevel, int y, int z,
                               void* data) override;
+    bool read_native_scanlines(int subimage, int miplevel, int ybegin,
+                               int yend, int z, void* data) override;
     bool close() override;
 
     const std::string& filename() const { return m_filename; }
@@ -86,6 +89,7 @@ public:
 private:
     std::string m_filename;
     int m_next_scanline;   // Which scanline is the next to read?
+    int m_reduce;          // Requested "oiio:reduce" factor
     bool m_raw;            // Read raw coefficients, not scanlines
     bool m_cmyk;           // The input file is cmyk
     bool m_fatalerr;       // JPEG reader hit a fatal error
@@ -96,16 +100,36 @@ private:
     std::vector<unsigned char> m_cmyk_buf;  // For CMYK translation
     std::unique_ptr<ImageSpec> m_config;    // Saved copy of configuration spec
 
+    // Where the restart intervals of a sequential JPEG lie, so that bands
+    // of MCU rows can be decoded independently of each other.
+    struct RestartLayout {
+        std::vector<unsigned char> file;    // The whole JPEG file
+        std::vector<unsigned char> header;  // SOI, tables, SOF, DRI, SOS
+        // Byte range of the entropy-coded data of each restart interval
+        std::vector<std::pair<size_t, size_t>> intervals;
+        size_t sof_height  = 0;      // Offset of SOF image height in header
+        int mcu_height     = 8;      // MCU height, in full-res pixels
+        int mcu_rows       = 0;      // Number of MCU rows in the image
+        int unit_rows      = 1;      // MCU rows per independent unit
+        int unit_intervals = 1;      // Restart intervals per unit
+        bool overlap       = false;  // Decode neighbors (for upsampling)
+    };
+    std::unique_ptr<RestartLayout> m_restart;
+    bool m_restart_checked;  // Have we looked for restart markers?
+
     void init()
     {
-        m_raw           = false;
-        m_cmyk          = false;
-        m_fatalerr      = false;
-        m_decomp_create = false;
-        m_coeffs        = NULL;
-        m_jerr.jpginput = this;
+        m_reduce          = 1;
+        m_raw             = false;
+        m_cmyk            = false;
+        m_fatalerr        = false;
+        m_decomp_create   = false;
+        m_restart_checked = false;
+        m_coeffs          = NULL;
+        m_jerr.jpginput   = this;
         ioproxy_clear();
         m_config.reset();
+        m_restart.reset();
     }
 
     // Rummage through the JPEG "APP1" marker pointed to by buf, decoding
@@ -117,6 +141,15 @@ private:
 
     bool read_icc_profile(j_decompress_ptr cinfo, ImageSpec& spec);
 
+    // Parse the file to fill in m_restart, if it's a single-scan Huffman
+    // JPEG with restart markers. Return false if it isn't.
+    bool find_restart_layout();
+
+    // Decode scanlines [ybegin,yend) as independent bands in parallel.
+    // Return false if that's not possible, and the caller should fall
+    // back to sequential reads.
+    bool read_restart_bands(int ybegin, int yend, void* data);
+
     void close_file() { init(); }
 
     friend class JpgOutput;
@@ -3,12 +3,16 @@
 // https://github.com/AcademySoftwareFoundation/OpenImageIO
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
+#include <numeric>
 
 #include <OpenImageIO/filesystem.h>
 #include <OpenImageIO/fmath.h>
 #include <OpenImageIO/imageio.h>
+#include <OpenImageIO/parallel.h>
 #include <OpenImageIO/tiffutils.h>
 
 #include "jpeg_pvt.h"
@@ -44,6 +48,8 @@ jpeg_input_imageio_create()
 
 OIIO_EXPORT const char* jpeg_input_extensions[]
     = { "jpg", "jpe", "jpeg", "jif", "jfif", "jfi", nullptr };
+// Magic numbers: SOI marker
+OIIO_EXPORT const char* jpeg_input_signatures[] = { "0:ffd8", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -154,8 +160,9 @@ bool
 JpgInput::open(const std::string& name, ImageSpec& newspec,
                const ImageSpec& config)
 {
-    auto p = config.find_attribute("_jpeg:raw", TypeInt);
-    m_raw  = p && *(int*)p->data();
+    auto p   = config.find_attribute("_jpeg:raw", TypeInt);
+    m_raw    = p && *(int*)p->data();
+    m_reduce = config.get_int_attribute("oiio:reduce", 1);
     ioproxy_retrieve_from_config(config);
     m_config.reset(new ImageSpec(config));  // save config spec
     return open(name, newspec);
@@ -242,6 +249,16 @@ JpgInput::open(const std::string& name, ImageSpec& newspec)
         m_cmyk                  = true;
     }
 
+    // A reduced resolution request can be satisfied directly by the DCT,
+    // which is much cheaper than decoding everything and resizing.
+    int scale_denom = 1;
+    while (scale_denom < 8 && scale_denom * 2 <= m_reduce)
+        scale_denom *= 2;
+    if (scale_denom > 1 && !m_raw) {
+        m_cinfo.scale_num   = 1;
+        m_cinfo.scale_denom = scale_denom;
+    }
+
     if (m_raw)
         m_coeffs = jpeg_read_coefficients(&m_cinfo);
     else
@@ -255,6 +272,8 @@ JpgInput::open(const std::string& name, ImageSpec& newspec)
 
     // Assume JPEG is in sRGB unless the Exif or XMP tags say otherwise.
     m_spec.attribute("oiio:ColorSpace", "sRGB");
+    if (scale_denom > 1 && !m_raw)
+        m_spec.attribute("oiio:reduce", scale_denom);
 
     if (m_cinfo.jpeg_color_space == JCS_CMYK)
         m_spec.attribute("jpeg:ColorSpace", "CMYK");
@@ -483,6 +502,295 @@ JpgInput::read_native_scanline(int subimage, int miplevel, int y, int /*z*/,
 
 
 
+bool
+JpgInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
+                                int yend, int z, void* data)
+{
+    lock_guard lock(*this);
+    if (!seek_subimage(subimage, miplevel))
+        return false;
+    // Big reads of a file with restart markers can decode bands of MCU rows
+    // concurrently. Anything else goes a scanline at a time.
+    yend = std::min(yend, m_spec.height);
+    if (m_decomp_create && !m_fatalerr && !m_raw && !m_cmyk && ybegin >= 0
+        && ybegin < yend) {
+        if (!m_restart_checked) {
+            m_restart_checked = true;
+            if (!find_restart_layout())
+                m_restart.reset();
+        }
+        if (m_restart && read_restart_bands(ybegin, yend, data))
+            return true;
+    }
+    return ImageInput::read_native_scanlines(subimage, miplevel, ybegin, yend,
+                                             z, data);
+}
+
+
+
+bool
+JpgInput::find_restart_layout()
+{
+    // Only a single interleaved scan of Huffman-coded sequential data, with
+    // a restart interval, can be split up.
+    if (m_cinfo.restart_interval == 0 || m_cinfo.progressive_mode
+        || m_cinfo.arith_code
+        || m_cinfo.comps_in_scan != m_cinfo.num_components)
+        return false;
+
+    m_restart.reset(new RestartLayout);
+    RestartLayout& layout           = *m_restart;
+    std::vector<unsigned char>& buf = layout.file;
+    Filesystem::IOProxy* io         = ioproxy();
+    buf.resize(io->size());
+    if (buf.size() < 4 || io->pread(buf.data(), buf.size(), 0) != buf.size())
+        return false;
+    size_t n = buf.size();
+
+    // Walk the markers up to the SOS, keeping just what a decoder needs to
+    // reproduce the same pixels: the quantization and Huffman tables, frame
+    // and scan headers, restart interval, and the JFIF and Adobe markers
+    // that determine the color transform.
+    layout.header.assign(buf.begin(), buf.begin() + 2);  // SOI
+    int ncomps  = 0;
+    size_t pos  = 2;
+    size_t scan = 0;
+    while (!scan) {
+        if (pos + 4 > n || buf[pos] != 0xff)
+            return false;
+        int marker = buf[pos + 1];
+        if (marker == 0xff) {  // fill byte
+            ++pos;
+            continue;
+        }
+        size_t len = (size_t(buf[pos + 2]) << 8) | buf[pos + 3];
+        if (len < 2 || pos + 2 + len > n)
+            return false;
+        const unsigned char* seg = &buf[pos];
+        bool keep                = true;
+        switch (marker) {
+        case 0xc0:  // SOF0, baseline
+        case 0xc1:  // SOF1, extended sequential
+            ncomps = seg[9];
+            if (len < 8 + 3 * size_t(ncomps))
+                return false;
+            layout.sof_height = layout.header.size() + 5;
+            break;
+        case 0xc4:  // DHT
+        case 0xdb:  // DQT
+        case 0xdd:  // DRI
+        case 0xe0:  // APP0 (JFIF)
+        case 0xee:  // APP14 (Adobe)
+            break;
+        case 0xda:  // SOS
+            if (ncomps == 0 || seg[4] != ncomps)
+                return false;
+            scan = pos + 2 + len;
+            break;
+        default:
+            // Any other frame type, or arithmetic coding conditioning,
+            // can't be handled. Everything else is skipped.
+            if (marker >= 0xc2 && marker <= 0xcf)
+                return false;
+            keep = false;
+            break;
+        }
+        if (keep)
+            layout.header.insert(layout.header.end(), seg, seg + 2 + len);
+        pos += 2 + len;
+    }
+
+    // Find the RSTn markers, which are the only markers allowed in the
+    // entropy-coded data (0xff is otherwise stuffed with a 0x00).
+    size_t begin = scan;
+    for (pos = scan;;) {
+        auto ff = (const unsigned char*)memchr(&buf[pos], 0xff, n - pos);
+        if (!ff || size_t(ff - buf.data()) + 1 >= n)
+            return false;  // no EOI
+        pos        = size_t(ff - buf.data());
+        int marker = buf[pos + 1];
+        if (marker == 0x00) {
+            pos += 2;
+        } else if (marker == 0xff) {
+            pos += 1;
+        } else if (marker >= 0xd0 && marker <= 0xd7) {
+            layout.intervals.emplace_back(begin, pos);
+            begin = pos + 2;
+            pos += 2;
+        } else if (marker == 0xd9) {
+            layout.intervals.emplace_back(begin, pos);
+            break;
+        } else {
+            return false;  // DNL, or more scans
+        }
+    }
+
+    // Units of MCU rows that begin exactly on a restart boundary can be
+    // decoded without the data preceding them.
+    bool gray = (ncomps == 1);
+    int mcu_w = gray ? 8 : 8 * m_cinfo.max_h_samp_factor;
+    int mcu_h = gray ? 8 : 8 * m_cinfo.max_v_samp_factor;
+    int64_t mcus_per_row  = (m_cinfo.image_width + mcu_w - 1) / mcu_w;
+    int64_t mcu_rows      = (m_cinfo.image_height + mcu_h - 1) / mcu_h;
+    int64_t ri            = m_cinfo.restart_interval;
+    layout.mcu_height     = mcu_h;
+    layout.mcu_rows       = int(mcu_rows);
+    layout.unit_rows      = int(ri / std::gcd(ri, mcus_per_row));
+    layout.unit_intervals = int(layout.unit_rows * mcus_per_row / ri);
+    // Fancy upsampling of vertically subsampled chroma blends with the
+    // rows above and below, so bands must decode a unit of context.
+    layout.overlap = !gray && m_cinfo.max_v_samp_factor > 1;
+    return layout.intervals.size()
+           == size_t((mcus_per_row * mcu_rows + ri - 1) / ri);
+}
+
+
+
+namespace {
+
+// Error handling for the decoders of the independent bands. Any error or
+// warning just makes us fall back to the sequential decode, which will
+// report it properly.
+struct BandErrorMgr {
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmp_buffer;
+};
+
+}  // namespace
+
+
+
+static void
+band_error_exit(j_common_ptr cinfo)
+{
+    longjmp(((BandErrorMgr*)cinfo->err)->setjmp_buffer, 1);
+}
+
+
+
+static void
+band_output_message(j_common_ptr /*cinfo*/)
+{
+}
+
+
+
+// Decode the whole-JPEG stream jpg (one band of the real image), whose
+// first scanline is image row y0, storing rows [keepbegin,keepend) at dst
+// and discarding the rest. Decoding settings are copied from ref.
+static bool
+decode_band(cspan<unsigned char> jpg, const jpeg_decompress_struct& ref,
+            int y0, int keepbegin, int keepend, unsigned char* dst,
+            size_t ystride)
+{
+    struct jpeg_decompress_struct cinfo;
+    BandErrorMgr jerr;
+    std::vector<unsigned char> scratch(ystride);
+    cinfo.err               = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit     = band_error_exit;
+    jerr.pub.output_message = band_output_message;
+    if (setjmp(jerr.setjmp_buffer)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(jpg.data()), jpg.size());
+    bool ok = (jpeg_read_header(&cinfo, TRUE) == JPEG_HEADER_OK);
+    if (ok) {
+        cinfo.out_color_space     = ref.out_color_space;
+        cinfo.scale_num           = ref.scale_num;
+        cinfo.scale_denom         = ref.scale_denom;
+        cinfo.dct_method          = ref.dct_method;
+        cinfo.do_fancy_upsampling = ref.do_fancy_upsampling;
+        jpeg_start_decompress(&cinfo);
+        ok = (cinfo.output_width == ref.output_width
+              && cinfo.output_components == ref.output_components
+              && keepend - y0 <= int(cinfo.output_height));
+    }
+    for (int y = y0; ok && y < keepend; ++y) {
+        JSAMPROW row = y < keepbegin ? scratch.data()
+                                     : dst + (y - keepbegin) * ystride;
+        ok           = (jpeg_read_scanlines(&cinfo, &row, 1) == 1);
+    }
+    ok &= (jerr.pub.num_warnings == 0);
+    jpeg_destroy_decompress(&cinfo);
+    return ok;
+}
+
+
+
+bool
+JpgInput::read_restart_bands(int ybegin, int yend, void* data)
+{
+    const RestartLayout& layout = *m_restart;
+    int nthreads = threads() ? threads() : OIIO::get_int_attribute("threads");
+    if (nthreads < 2 || m_cinfo.scale_num != 1
+        || (layout.mcu_height % int(m_cinfo.scale_denom)))
+        return false;
+
+    // Output scanlines per unit, and the units we need to cover the range
+    int unit_height = layout.unit_rows * layout.mcu_height
+                      / int(m_cinfo.scale_denom);
+    int nunits = (layout.mcu_rows + layout.unit_rows - 1) / layout.unit_rows;
+    int ubegin = ybegin / unit_height;
+    int uend   = std::min(nunits, (yend + unit_height - 1) / unit_height);
+    int nbands = std::min(uend - ubegin, 2 * nthreads);
+    if (nbands < 2)
+        return false;
+
+    size_t ystride = m_spec.scanline_bytes();
+    std::atomic<bool> ok(true);
+    parallel_for(
+        0, nbands,
+        [&](int64_t b) {
+            // Units [ua,ub) are ours; decode [da,db) to give upsampling
+            // the same neighbors it would have in the full image.
+            int ua = ubegin + int(b * (uend - ubegin) / nbands);
+            int ub = ubegin + int((b + 1) * (uend - ubegin) / nbands);
+            int da = layout.overlap ? std::max(ua - 1, 0) : ua;
+            int db = layout.overlap ? std::min(ub + 1, nunits) : ub;
+            size_t ibegin = size_t(da) * layout.unit_intervals;
+            size_t iend   = std::min(size_t(db) * layout.unit_intervals,
+                                     layout.intervals.size());
+            int height    = std::min(int(m_cinfo.image_height),
+                                     db * layout.unit_rows * layout.mcu_height)
+                         - da * layout.unit_rows * layout.mcu_height;
+
+            // Make a standalone JPEG of just this band, with its restart
+            // markers renumbered from RST0.
+            std::vector<unsigned char> jpg(layout.header);
+            jpg[layout.sof_height]     = (unsigned char)(height >> 8);
+            jpg[layout.sof_height + 1] = (unsigned char)(height & 0xff);
+            for (size_t i = ibegin; i < iend; ++i) {
+                auto range = layout.intervals[i];
+                jpg.insert(jpg.end(), layout.file.begin() + range.first,
+                           layout.file.begin() + range.second);
+                if (i + 1 < iend) {
+                    jpg.push_back(0xff);
+                    jpg.push_back((unsigned char)(0xd0 + ((i - ibegin) & 7)));
+                }
+            }
+            jpg.push_back(0xff);
+            jpg.push_back(0xd9);
+
+            int keepbegin = std::max(ybegin, ua * unit_height);
+            int keepend   = std::min(yend, ub * unit_height);
+            if (!decode_band(jpg, m_cinfo, da * unit_height, keepbegin,
+                             keepend,
+                             (unsigned char*)data
+                                 + size_t(keepbegin - ybegin) * ystride,
+                             ystride))
+                ok = false;
+        },
+        paropt(nthreads).minitems(1));
+
+    if (!ok)
+        m_restart.reset();  // Something is amiss, don't try this again
+    return ok;
+}
+
+
+
 bool
 JpgInput::close()
 {
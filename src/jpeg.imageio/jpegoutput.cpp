@@ -218,6 +218,13 @@ JpgOutput::open(const std::string& name, const ImageSpec& newspec,
             jpeg_simple_progression(&m_cinfo);
         }
 
+        // Restart markers let a reader decode bands of MCU rows
+        // independently, and hence in parallel. They change the bytes of
+        // the file and cost a little space, so only write them on request.
+        int restart = m_spec.get_int_attribute("jpeg:restart_interval");
+        if (restart > 0)
+            m_cinfo.restart_in_rows = std::min(restart, 65535);
+
         jpeg_start_compress(&m_cinfo, TRUE);  // start working
         DBG std::cout << "out open: start_compress\n";
     }
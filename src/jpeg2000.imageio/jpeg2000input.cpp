@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 // https://github.com/AcademySoftwareFoundation/OpenImageIO
 
+#include <algorithm>
 #include <cstdio>
 #include <vector>
 
@@ -32,6 +33,16 @@ OIIO_PLUGIN_NAMESPACE_BEGIN
 namespace {
 
 
+// Divide by 2^n, rounding up, as OpenJPEG does for image bounds when
+// decoding at reduced resolution.
+inline unsigned int
+ceildivpow2(unsigned int a, int n)
+{
+    return (unsigned int)((uint64_t(a) + (uint64_t(1) << n) - 1) >> n);
+}
+
+
+
 // TODO(sergey): This actually a straight duplication from the png reader,
 // consider de-duplicating the code somehow?
 template<class T>
@@ -77,7 +88,7 @@ public:
     const char* format_name(void) const override { return "jpeg2000"; }
     int supports(string_view feature) const override
     {
-        return feature == "ioproxy";
+        return feature == "ioproxy" || feature == "reduce";
         // FIXME: we should support Exif/IPTC, but currently don't.
     }
     bool open(const std::string& name, ImageSpec& spec) override;
@@ -94,6 +105,7 @@ private:
     opj_codec_t* m_codec;
     opj_stream_t* m_stream;
     bool m_keep_unassociated_alpha;  // Do not convert unassociated alpha
+    int m_reduce;                    // Requested "oiio:reduce" factor
 
     void init(void);
 
@@ -194,6 +206,9 @@ jpeg2000_input_imageio_create()
 }
 OIIO_EXPORT const char* jpeg2000_input_extensions[] = { "jp2", "j2k", "j2c",
                                                         nullptr };
+// Magic numbers: JP2 box, J2K codestream
+OIIO_EXPORT const char* jpeg2000_input_signatures[] = { "0:0000000c6a502020",
+                                                        "0:ff4fff51", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -205,6 +220,7 @@ Jpeg2000Input::init(void)
     m_codec                   = NULL;
     m_stream                  = NULL;
     m_keep_unassociated_alpha = false;
+    m_reduce                  = 1;
     ioproxy_clear();
 }
 
@@ -261,6 +277,28 @@ Jpeg2000Input::open(const std::string& name, ImageSpec& p_spec)
         if (!has_error())
             errorfmt("Could not read Jpeg2000 header");
     }
+
+    // For a reduced resolution request, skip decoding the finest wavelet
+    // resolution levels: each one we drop halves the size. We can't drop
+    // all of them, so check how many the codestream has.
+    int reduce_levels = 0;
+    if (!has_error() && m_reduce > 1) {
+        int maxlevels = 0;
+        if (opj_codestream_info_v2_t* info = opj_get_cstr_info(m_codec)) {
+            const opj_tile_info_v2_t& tile(info->m_default_tile_info);
+            for (OPJ_UINT32 c = 0; tile.tccp_info && c < info->nbcomps; ++c) {
+                int n     = int(tile.tccp_info[c].numresolutions) - 1;
+                maxlevels = c ? std::min(maxlevels, n) : n;
+            }
+            opj_destroy_cstr_info(&info);
+        }
+        while (reduce_levels < maxlevels && (2 << reduce_levels) <= m_reduce)
+            ++reduce_levels;
+        if (reduce_levels
+            && !opj_set_decoded_resolution_factor(m_codec, reduce_levels))
+            reduce_levels = 0;
+    }
+
     if (!has_error()) {
         if (!opj_decode(m_codec, m_stream, m_image)) {
             if (!has_error())
@@ -324,10 +362,14 @@ Jpeg2000Input::open(const std::string& name, ImageSpec& p_spec)
                          format);
     m_spec.x = datawindow.xbegin;
     m_spec.y = datawindow.ybegin;
-    m_spec.full_x      = m_image->x0;
-    m_spec.full_y      = m_image->y0;
-    m_spec.full_width  = m_image->x1;
-    m_spec.full_height = m_image->y1;
+    // The image's own bounds stay at full resolution, so scale them to
+    // match any reduced resolution levels we decoded.
+    m_spec.full_x      = int(ceildivpow2(m_image->x0, reduce_levels));
+    m_spec.full_y      = int(ceildivpow2(m_image->y0, reduce_levels));
+    m_spec.full_width  = int(ceildivpow2(m_image->x1, reduce_levels));
+    m_spec.full_height = int(ceildivpow2(m_image->y1, reduce_levels));
+    if (reduce_levels)
+        m_spec.attribute("oiio:reduce", 1 << reduce_levels);
 
     m_spec.attribute("oiio:BitsPerSample", maxPrecision);
     m_spec.attribute("oiio:ColorSpace", "sRGB");
@@ -361,6 +403,7 @@ Jpeg2000Input::open(const std::string& name, ImageSpec& newspec,
     // Check 'config' for any special requests
     if (config.get_int_attribute("oiio:UnassociatedAlpha", 0) == 1)
         m_keep_unassociated_alpha = true;
+    m_reduce = config.get_int_attribute("oiio:reduce", 1);
     ioproxy_retrieve_from_config(config);
     return open(name, newspec);
 }
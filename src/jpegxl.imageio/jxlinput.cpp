@@ -96,6 +96,10 @@ jpegxl_input_imageio_create()
 }
 
 OIIO_EXPORT const char* jpegxl_input_extensions[] = { "jxl", nullptr };
+// Magic numbers: codestream, container
+OIIO_EXPORT const char* jpegxl_input_signatures[] = { "0:ff0a",
+                                                      "0:0000000c4a584c20",
+                                                      nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
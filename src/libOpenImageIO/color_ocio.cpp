@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -14,6 +16,7 @@
 
 #include <OpenImageIO/color.h>
 #include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/hash.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imagebufalgo_util.h>
 #include <OpenImageIO/strutil.h>
@@ -60,6 +63,14 @@ static bool colordebug = Strutil::stoi(Sysutil::getenv("OIIO_DEBUG_COLOR"))
 #endif
 
 
+namespace pvt {
+// Statistics of the on-disk ColorProcessor cache
+atomic_ll colorproc_cache_hits(0);
+atomic_ll colorproc_cache_misses(0);
+atomic_ll colorproc_cache_bytes(0);
+}  // namespace pvt
+
+
 static int disable_ocio = Strutil::stoi(Sysutil::getenv("OIIO_DISABLE_OCIO"));
 static int disable_builtin_configs = Strutil::stoi(
     Sysutil::getenv("OIIO_DISABLE_BUILTIN_OCIO_CONFIGS"));
@@ -90,6 +101,8 @@ public:
         , context_key(key)
         , context_value(val)
         , looks(looks)
+        , display(display)
+        , view(view)
         , file(file)
         , inverse(inverse)
     {
@@ -356,6 +369,17 @@ public:
 #if OCIO_VERSION_HEX >= MAKE_OCIO_VERSION_HEX(2, 2, 0)
     OCIO::ConstCPUProcessorRcPtr
     get_to_builtin_cpu_proc(const char* my_from, const char* builtin_to) const;
+#endif
+#ifdef OCIO_v2
+    // Ask OCIO for the processor of `transform`, by way of the on-disk
+    // cache of baked processors if the "color:processor_cache" attribute
+    // names a directory. May throw OCIO::Exception.
+    OCIO::ConstProcessorRcPtr
+    get_processor(const ColorProcCacheKey& key,
+                  const OCIO::ConstConfigRcPtr& config,
+                  const OCIO::ConstContextRcPtr& context,
+                  const OCIO::ConstTransformRcPtr& transform,
+                  OCIO::TransformDirection dir) const;
 #endif
     bool isColorSpaceLinear(string_view name) const;
 
@@ -528,6 +552,207 @@ ColorConfig::Impl::get_to_builtin_cpu_proc(const char* my_from,
 
 
 
+#ifdef OCIO_v2
+
+// Add to `files` the sources of every FileTransform that `transform` may
+// use, following color spaces, looks, displays/views, and named transforms
+// through the config. `visited` keeps config items from being followed
+// twice (and configs that refer to themselves from looping).
+static void
+collect_lut_files(const OCIO::ConstConfigRcPtr& config,
+                  const OCIO::ConstTransformRcPtr& transform,
+                  std::set<std::string>& visited,
+                  std::set<std::string>& files);
+
+static void
+collect_colorspace_lut_files(const OCIO::ConstConfigRcPtr& config,
+                             const char* name, std::set<std::string>& visited,
+                             std::set<std::string>& files)
+{
+    if (!name || !name[0] || !visited.insert(std::string("cs:") + name).second)
+        return;
+    if (auto cs = config->getColorSpace(name)) {
+        collect_lut_files(config,
+                          cs->getTransform(OCIO::COLORSPACE_DIR_TO_REFERENCE),
+                          visited, files);
+        collect_lut_files(config,
+                          cs->getTransform(OCIO::COLORSPACE_DIR_FROM_REFERENCE),
+                          visited, files);
+    }
+    if (auto nt = config->getNamedTransform(name)) {
+        collect_lut_files(config, nt->getTransform(OCIO::TRANSFORM_DIR_FORWARD),
+                          visited, files);
+        collect_lut_files(config, nt->getTransform(OCIO::TRANSFORM_DIR_INVERSE),
+                          visited, files);
+    }
+}
+
+static void
+collect_looks_lut_files(const OCIO::ConstConfigRcPtr& config,
+                        const char* looks, std::set<std::string>& visited,
+                        std::set<std::string>& files)
+{
+    // Look lists are like "+look1, -look2|look3"
+    std::string names = looks ? looks : "";
+    for (char& c : names)
+        if (c == ',' || c == ':' || c == '|' || c == '+' || c == '-')
+            c = ' ';
+    for (auto name : Strutil::splits(names)) {
+        if (!visited.insert("look:" + name).second)
+            continue;
+        if (auto look = config->getLook(name.c_str())) {
+            collect_lut_files(config, look->getTransform(), visited, files);
+            collect_lut_files(config, look->getInverseTransform(), visited,
+                              files);
+            collect_colorspace_lut_files(config, look->getProcessSpace(),
+                                         visited, files);
+        }
+    }
+}
+
+static void
+collect_lut_files(const OCIO::ConstConfigRcPtr& config,
+                  const OCIO::ConstTransformRcPtr& transform,
+                  std::set<std::string>& visited,
+                  std::set<std::string>& files)
+{
+    if (!transform)
+        return;
+    if (auto t = OCIO::DynamicPtrCast<const OCIO::FileTransform>(transform)) {
+        if (t->getSrc())
+            files.insert(t->getSrc());
+    } else if (auto t = OCIO::DynamicPtrCast<const OCIO::GroupTransform>(
+                   transform)) {
+        for (int i = 0, n = t->getNumTransforms(); i < n; ++i)
+            collect_lut_files(config, t->getTransform(i), visited, files);
+    } else if (auto t = OCIO::DynamicPtrCast<const OCIO::ColorSpaceTransform>(
+                   transform)) {
+        collect_colorspace_lut_files(config, t->getSrc(), visited, files);
+        collect_colorspace_lut_files(config, t->getDst(), visited, files);
+    } else if (auto t = OCIO::DynamicPtrCast<const OCIO::LookTransform>(
+                   transform)) {
+        collect_colorspace_lut_files(config, t->getSrc(), visited, files);
+        collect_colorspace_lut_files(config, t->getDst(), visited, files);
+        collect_looks_lut_files(config, t->getLooks(), visited, files);
+    } else if (auto t = OCIO::DynamicPtrCast<const OCIO::DisplayViewTransform>(
+                   transform)) {
+        const char* display = t->getDisplay();
+        const char* view    = t->getView();
+        collect_colorspace_lut_files(config, t->getSrc(), visited, files);
+        collect_colorspace_lut_files(
+            config, config->getDisplayViewColorSpaceName(display, view),
+            visited, files);
+        collect_looks_lut_files(config,
+                                config->getDisplayViewLooks(display, view),
+                                visited, files);
+        // Any view transform may be used to get between the scene and
+        // display references, so follow them all.
+        for (int i = 0, n = config->getNumViewTransforms(); i < n; ++i) {
+            const char* name = config->getViewTransformNameByIndex(i);
+            if (!visited.insert(std::string("vt:") + name).second)
+                continue;
+            if (auto vt = config->getViewTransform(name)) {
+                collect_lut_files(config,
+                                  vt->getTransform(
+                                      OCIO::VIEWTRANSFORM_DIR_TO_REFERENCE),
+                                  visited, files);
+                collect_lut_files(config,
+                                  vt->getTransform(
+                                      OCIO::VIEWTRANSFORM_DIR_FROM_REFERENCE),
+                                  visited, files);
+            }
+        }
+    }
+}
+
+
+
+OCIO::ConstProcessorRcPtr
+ColorConfig::Impl::get_processor(const ColorProcCacheKey& key,
+                                 const OCIO::ConstConfigRcPtr& config,
+                                 const OCIO::ConstContextRcPtr& context,
+                                 const OCIO::ConstTransformRcPtr& transform,
+                                 OCIO::TransformDirection dir) const
+{
+    std::string cachedir = pvt::colorproc_cache_dir.string();
+    if (cachedir.empty())
+        return config->getProcessor(context, transform, dir);
+
+    // The cache file is named by a hash of everything that determines the
+    // processor: the OCIO version, the config and context (which OCIO
+    // summarizes as its cache ID), the request itself, and the path and
+    // modification time of every LUT file it may read. (The config's cache
+    // ID doesn't change when a LUT it refers to is edited in place.)
+    std::set<std::string> visited, lutfiles;
+    collect_lut_files(config, transform, visited, lutfiles);
+    std::string filetimes;
+    for (const auto& f : lutfiles) {
+        try {
+            std::string path = context->resolveFileLocation(f.c_str());
+            filetimes += Strutil::fmt::format("|{}@{}", path,
+                                              Filesystem::last_write_time(
+                                                  path));
+        } catch (...) {
+            // Leave it to getProcessor to report the missing file
+            return config->getProcessor(context, transform, dir);
+        }
+    }
+    std::string keystring = Strutil::fmt::format(
+        "{}|{}|{}|{}|{}|{}|{}|{}|{}|{}|{}{}", OCIO_VERSION_HEX,
+        config->getCacheID(context), key.inputColorSpace,
+        key.outputColorSpace, key.context_key, key.context_value, key.looks,
+        key.display, key.view, key.file, key.inverse, filetimes);
+    std::string cachefile = Strutil::fmt::format(
+        "{}/{:016x}.ctf", Filesystem::abspath(cachedir),
+        farmhash::Hash64(keystring.data(), keystring.size()));
+
+    if (Filesystem::exists(cachefile)) {
+        try {
+            auto cached = OCIO::FileTransform::Create();
+            cached->setSrc(cachefile.c_str());
+            auto p = config->getProcessor(context, cached,
+                                          OCIO::TRANSFORM_DIR_FORWARD);
+            ++pvt::colorproc_cache_hits;
+            return p;
+        } catch (...) {
+            // A damaged or unreadable cache file: rebake it below.
+        }
+    }
+
+    ++pvt::colorproc_cache_misses;
+    OCIO::ConstProcessorRcPtr p = config->getProcessor(context, transform,
+                                                       dir);
+    try {
+        // Bake the optimized ops, as a CTF file. Write to a temporary name
+        // and rename, so that other processes never see a partial file.
+        std::ostringstream baked;
+        p->getOptimizedProcessor(OCIO::OPTIMIZATION_DEFAULT)
+            ->createGroupTransform()
+            ->write(config, "Color Transform Format", baked);
+        std::string tmpfile = Strutil::fmt::format(
+            "{}.{}.tmp", cachefile, Filesystem::unique_path());
+        std::string err;
+        if (!Filesystem::is_directory(cachedir))
+            Filesystem::create_directory(cachedir, err);
+        if (Filesystem::write_text_file(tmpfile, baked.str())
+            && Filesystem::rename(tmpfile, cachefile, err)) {
+            pvt::colorproc_cache_bytes += (long long)baked.str().size();
+        } else {
+            Filesystem::remove(tmpfile, err);
+            DBG("Could not write color processor cache file {}: {}\n",
+                cachefile, err);
+        }
+    } catch (...) {
+        // Not every processor can be written as CTF. That only means it
+        // won't be cached.
+    }
+    return p;
+}
+
+#endif
+
+
+
 // Is this config's `my_from` color space equivalent to the built-in
 // `builtin_to` color space? Find out by transforming the primaries, white,
 // and half white and see if the results indicate that it was the identity
@@ -1499,17 +1724,29 @@ private:
 
 
 
-#if OCIO_VERSION_HEX < MAKE_OCIO_VERSION_HEX(2, 2, 0)
-// For version 2.2 and later, missing OCIO config will always fall back on
-// built-in configs, so we don't need any of these secondary fallback
-// heuristics.
+// Built-in ColorProcessors, used when there is no OCIO config (either OCIO
+// is disabled, or OCIO < 2.2 couldn't find one). They only know a handful
+// of transfer functions, and never change the color primaries.
 
-// ColorProcessor that hard-codes sRGB-to-linear
-class ColorProcessor_sRGB_to_linear final : public ColorProcessor {
+// ColorProcessor that applies one of the transfer functions from color.h,
+// to RGB only. With the "color:fast_transfer" attribute set (the default),
+// it uses the SIMD versions of the curves, whose polynomial approximations
+// of pow/log/exp have relative error under 1e-4. Otherwise, it uses the
+// scalar libm-based versions.
+class ColorProcessor_Transfer final : public ColorProcessor {
 public:
-    ColorProcessor_sRGB_to_linear()
-        : ColorProcessor() {};
-    ~ColorProcessor_sRGB_to_linear() override {}
+    enum Curve { sRGB, Rec709, Gamma, PQ, HLG, ACEScct };
+
+    // If `to_linear` is true, decode from the curve to linear, otherwise
+    // encode linear with the curve. For Gamma, it computes pow(x,gamma).
+    ColorProcessor_Transfer(Curve curve, bool to_linear, float gamma = 1.0f)
+        : ColorProcessor()
+        , m_curve(curve)
+        , m_to_linear(to_linear)
+        , m_gamma(gamma)
+    {
+    }
+    ~ColorProcessor_Transfer() override {}
 
     void apply(float* data, int width, int height, int channels,
                stride_t chanstride, stride_t xstride,
@@ -1517,51 +1754,38 @@ public:
     {
         if (channels > 3)
             channels = 3;
-        if (channels == 3 && chanstride == sizeof(float)) {
+        if (!pvt::color_fast_transfer) {
             for (int y = 0; y < height; ++y) {
                 char* d = (char*)data + y * ystride;
                 for (int x = 0; x < width; ++x, d += xstride) {
-                    simd::vfloat4 r;
-                    r.load((float*)d, 3);
-                    r = sRGB_to_linear(r);
-                    r.store((float*)d, 3);
+                    char* dc = d;
+                    for (int c = 0; c < channels; ++c, dc += chanstride)
+                        *(float*)dc = eval(*(float*)dc);
                 }
             }
-        } else {
+        } else if (chanstride == sizeof(float)
+                   && xstride == stride_t(channels * sizeof(float))) {
+            // Contiguous RGB (or fewer channels): every value in the
+            // scanline gets the curve, so do them four at a time.
+            int n = width * channels;
             for (int y = 0; y < height; ++y) {
-                char* d = (char*)data + y * ystride;
-                for (int x = 0; x < width; ++x, d += xstride) {
-                    char* dc = d;
-                    for (int c = 0; c < channels; ++c, dc += chanstride)
-                        ((float*)dc)[c] = sRGB_to_linear(((float*)dc)[c]);
+                float* d = (float*)((char*)data + y * ystride);
+                int i = 0;
+                for (; i + 4 <= n; i += 4)
+                    eval(simd::vfloat4(d + i)).store(d + i);
+                if (i < n) {
+                    simd::vfloat4 r;
+                    r.load(d + i, n - i);
+                    eval(r).store(d + i, n - i);
                 }
             }
-        }
-    }
-};
-
-
-// ColorProcessor that hard-codes linear-to-sRGB
-class ColorProcessor_linear_to_sRGB final : public ColorProcessor {
-public:
-    ColorProcessor_linear_to_sRGB()
-        : ColorProcessor() {};
-    ~ColorProcessor_linear_to_sRGB() override {}
-
-    void apply(float* data, int width, int height, int channels,
-               stride_t chanstride, stride_t xstride,
-               stride_t ystride) const override
-    {
-        if (channels > 3)
-            channels = 3;
-        if (channels == 3 && chanstride == sizeof(float)) {
+        } else if (chanstride == sizeof(float)) {
             for (int y = 0; y < height; ++y) {
                 char* d = (char*)data + y * ystride;
                 for (int x = 0; x < width; ++x, d += xstride) {
                     simd::vfloat4 r;
-                    r.load((float*)d, 3);
-                    r = linear_to_sRGB(r);
-                    r.store((float*)d, 3);
+                    r.load((float*)d, channels);
+                    eval(r).store((float*)d, channels);
                 }
             }
         } else {
@@ -1569,109 +1793,46 @@ public:
                 char* d = (char*)data + y * ystride;
                 for (int x = 0; x < width; ++x, d += xstride) {
                     char* dc = d;
+                    simd::vfloat4 r = simd::vfloat4::Zero();
+                    for (int c = 0; c < channels; ++c)
+                        r[c] = *(float*)(dc + c * chanstride);
+                    r = eval(r);
                     for (int c = 0; c < channels; ++c, dc += chanstride)
-                        ((float*)dc)[c] = linear_to_sRGB(((float*)dc)[c]);
+                        *(float*)dc = r[c];
                 }
             }
         }
     }
-};
 
+private:
+    Curve m_curve;
+    bool m_to_linear;
+    float m_gamma;
 
-
-// ColorProcessor that hard-codes Rec709-to-linear
-class ColorProcessor_Rec709_to_linear final : public ColorProcessor {
-public:
-    ColorProcessor_Rec709_to_linear()
-        : ColorProcessor() {};
-    ~ColorProcessor_Rec709_to_linear() override {}
-
-    void apply(float* data, int width, int height, int channels,
-               stride_t chanstride, stride_t xstride,
-               stride_t ystride) const override
+    // Evaluate the curve. T is float (exact) or vfloat4 (fast).
+    template<typename T> T eval(const T& x) const
     {
-        if (channels > 3)
-            channels = 3;
-        for (int y = 0; y < height; ++y) {
-            char* d = (char*)data + y * ystride;
-            for (int x = 0; x < width; ++x, d += xstride) {
-                char* dc = d;
-                for (int c = 0; c < channels; ++c, dc += chanstride)
-                    ((float*)d)[c] = Rec709_to_linear(((float*)d)[c]);
-            }
+        switch (m_curve) {
+        case sRGB: return m_to_linear ? sRGB_to_linear(x) : linear_to_sRGB(x);
+        case Rec709:
+            return m_to_linear ? Rec709_to_linear(x) : linear_to_Rec709(x);
+        case Gamma: return gamma(x);
+        case PQ: return m_to_linear ? PQ_to_linear(x) : linear_to_PQ(x);
+        case HLG: return m_to_linear ? HLG_to_linear(x) : linear_to_HLG(x);
+        case ACEScct:
+            return m_to_linear ? ACEScct_to_linear(x) : linear_to_ACEScct(x);
         }
+        return x;
     }
-};
-
-
-// ColorProcessor that hard-codes linear-to-Rec709
-class ColorProcessor_linear_to_Rec709 final : public ColorProcessor {
-public:
-    ColorProcessor_linear_to_Rec709()
-        : ColorProcessor() {};
-    ~ColorProcessor_linear_to_Rec709() override {}
-
-    void apply(float* data, int width, int height, int channels,
-               stride_t chanstride, stride_t xstride,
-               stride_t ystride) const override
+    float gamma(float x) const { return powf(x, m_gamma); }
+    simd::vfloat4 gamma(const simd::vfloat4& x) const
     {
-        if (channels > 3)
-            channels = 3;
-        for (int y = 0; y < height; ++y) {
-            char* d = (char*)data + y * ystride;
-            for (int x = 0; x < width; ++x, d += xstride) {
-                char* dc = d;
-                for (int c = 0; c < channels; ++c, dc += chanstride)
-                    ((float*)d)[c] = linear_to_Rec709(((float*)d)[c]);
-            }
-        }
+        return fast_pow_pos(x, m_gamma);
     }
 };
 
 
 
-// ColorProcessor that performs gamma correction
-class ColorProcessor_gamma final : public ColorProcessor {
-public:
-    ColorProcessor_gamma(float gamma)
-        : ColorProcessor()
-        , m_gamma(gamma) {};
-    ~ColorProcessor_gamma() override {}
-
-    void apply(float* data, int width, int height, int channels,
-               stride_t chanstride, stride_t xstride,
-               stride_t ystride) const override
-    {
-        if (channels > 3)
-            channels = 3;
-        if (channels == 3 && chanstride == sizeof(float)) {
-            simd::vfloat4 g = m_gamma;
-            for (int y = 0; y < height; ++y) {
-                char* d = (char*)data + y * ystride;
-                for (int x = 0; x < width; ++x, d += xstride) {
-                    simd::vfloat4 r;
-                    r.load((float*)d, 3);
-                    r = fast_pow_pos(r, g);
-                    r.store((float*)d, 3);
-                }
-            }
-        } else {
-            for (int y = 0; y < height; ++y) {
-                char* d = (char*)data + y * ystride;
-                for (int x = 0; x < width; ++x, d += xstride) {
-                    char* dc = d;
-                    for (int c = 0; c < channels; ++c, dc += chanstride)
-                        ((float*)d)[c] = powf(((float*)d)[c], m_gamma);
-                }
-            }
-        }
-    }
-
-private:
-    float m_gamma;
-};
-
-
 // ColorProcessor that does nothing (identity transform)
 class ColorProcessor_Ident final : public ColorProcessor {
 public:
@@ -1686,7 +1847,6 @@ public:
     {
     }
 };
-#endif
 
 
 
@@ -1699,9 +1859,16 @@ public:
     {
         if (inverse)
             m_M = m_M.inverse();
+        Imath::M44f M = inverse ? Matrix.inverse() : Matrix;
+        for (int j = 0; j < 4; ++j)
+            for (int i = 0; i < 4; ++i)
+                if (i != j && M[j][i] != 0.0f)
+                    m_crosstalk = true;
     }
     ~ColorProcessor_Matrix() override {}
 
+    bool hasChannelCrosstalk() const override { return m_crosstalk; }
+
     void apply(float* data, int width, int height, int channels,
                stride_t chanstride, stride_t xstride,
                stride_t ystride) const override
@@ -1746,6 +1913,7 @@ public:
 
 private:
     simd::matrix44 m_M;
+    bool m_crosstalk = false;
 };
 
 
@@ -1803,9 +1971,17 @@ ColorConfig::createColorProcessor(ustring inputColorSpace,
 
         try {
             // Get the processor corresponding to this transform.
+#    ifdef OCIO_v2
+            auto transform = OCIO::ColorSpaceTransform::Create();
+            transform->setSrc(inputColorSpace.c_str());
+            transform->setDst(outputColorSpace.c_str());
+            p = getImpl()->get_processor(prockey, config, context, transform,
+                                         OCIO::TRANSFORM_DIR_FORWARD);
+#    else
             p = getImpl()->config_->getProcessor(context,
                                                  inputColorSpace.c_str(),
                                                  outputColorSpace.c_str());
+#    endif
             getImpl()->clear_error();
             // DBG("Created OCIO processor '{}' -> '{}'\n",
             //                inputColorSpace, outputColorSpace);
@@ -1833,46 +2009,64 @@ ColorConfig::createColorProcessor(ustring inputColorSpace,
     }
 #endif
 
-#if OCIO_VERSION_HEX < MAKE_OCIO_VERSION_HEX(2, 2, 0)
-    // For version 2.2 and later, missing OCIO config will always fall back on
-    // built-in configs, so we don't need any of these secondary fallback
-    // heuristics.
-    if (!handle) {
+    // For OCIO 2.2 and later, a missing OCIO config will always fall back
+    // on the OCIO built-in configs, so we only need these secondary
+    // fallback heuristics if OCIO is disabled or we have an older OCIO.
+#ifdef USE_OCIO
+    bool builtin_fallback = (OCIO_VERSION_HEX < MAKE_OCIO_VERSION_HEX(2, 2, 0)
+                             || !getImpl()->config_ || disable_ocio);
+#else
+    bool builtin_fallback = true;
+#endif
+    if (!handle && builtin_fallback) {
         // Either not compiled with OCIO support, or no OCIO configuration
         // was found at all.  There are a few color conversions we know
         // about even in such dire conditions.
         using namespace Strutil;
+        using Curve = ColorProcessor_Transfer::Curve;
+        auto is_linear = [&](ustring cs) {
+            return equivalent(cs, "linear") || equivalent(cs, "lin_srgb");
+        };
+        // A transfer curve alone is only right between spaces that share
+        // primaries, so never pair a curve with a linear space of other
+        // primaries: Rec709-primaries linear goes only with sRGB or Rec709,
+        // and ACEScg only with ACEScct.
+        auto linear_curve = [&](ustring lin, ustring cs, Curve& curve) {
+            if (is_linear(lin) && equivalent(cs, "sRGB"))
+                curve = ColorProcessor_Transfer::sRGB;
+            else if (is_linear(lin) && equivalent(cs, "Rec709"))
+                curve = ColorProcessor_Transfer::Rec709;
+            else if (iequals(lin, "ACEScg") && iequals(cs, "ACEScct"))
+                curve = ColorProcessor_Transfer::ACEScct;
+            else
+                return false;
+            return true;
+        };
+        Curve curve;
         if (equivalent(inputColorSpace, outputColorSpace)) {
             handle = ColorProcessorHandle(new ColorProcessor_Ident);
-        } else if ((equivalent(inputColorSpace, "lin_srgb")
-                    || equivalent(inputColorSpace, "linear"))
-                   && equivalent(outputColorSpace, "sRGB")) {
-            handle = ColorProcessorHandle(new ColorProcessor_linear_to_sRGB);
-        } else if (equivalent(inputColorSpace, "sRGB")
-                   && (equivalent(outputColorSpace, "lin_srgb")
-                       || equivalent(outputColorSpace, "linear"))) {
-            handle = ColorProcessorHandle(new ColorProcessor_sRGB_to_linear);
-        } else if ((equivalent(inputColorSpace, "lin_srgb")
-                    || equivalent(inputColorSpace, "linear"))
-                   && equivalent(outputColorSpace, "Rec709")) {
-            handle = ColorProcessorHandle(new ColorProcessor_linear_to_Rec709);
-        } else if (equivalent(inputColorSpace, "Rec709")
-                   && equivalent(outputColorSpace, "lin_srgb")) {
-            handle = ColorProcessorHandle(new ColorProcessor_Rec709_to_linear);
-        } else if ((equivalent(inputColorSpace, "linear")
-                    || equivalent(inputColorSpace, "lin_srgb"))
+        } else if (linear_curve(inputColorSpace, outputColorSpace, curve)) {
+            handle = ColorProcessorHandle(
+                new ColorProcessor_Transfer(curve, false));
+        } else if (linear_curve(outputColorSpace, inputColorSpace, curve)) {
+            handle = ColorProcessorHandle(
+                new ColorProcessor_Transfer(curve, true));
+        } else if (is_linear(inputColorSpace)
                    && istarts_with(outputColorSpace, "Gamma")) {
             string_view gamstr = outputColorSpace;
             Strutil::parse_word(gamstr);
             float g = from_string<float>(gamstr);
-            handle  = ColorProcessorHandle(new ColorProcessor_gamma(1.0f / g));
+            handle  = ColorProcessorHandle(
+                new ColorProcessor_Transfer(ColorProcessor_Transfer::Gamma,
+                                            false, 1.0f / g));
         } else if (istarts_with(inputColorSpace, "Gamma")
-                   && (equivalent(outputColorSpace, "linear")
-                       || iequals(outputColorSpace, "lin_srgb"))) {
+                   && is_linear(outputColorSpace)) {
             string_view gamstr = inputColorSpace;
             Strutil::parse_word(gamstr);
             float g = from_string<float>(gamstr);
-            handle  = ColorProcessorHandle(new ColorProcessor_gamma(g));
+            handle  = ColorProcessorHandle(
+                new ColorProcessor_Transfer(ColorProcessor_Transfer::Gamma,
+                                            true, g));
         } else {
             DBG("No heuristic non-OCIO color processor for '{}' -> '{}'\n",
                 inputColorSpace, outputColorSpace);
@@ -1884,7 +2078,6 @@ ColorConfig::createColorProcessor(ustring inputColorSpace,
         if (handle)
             pending_error.clear();
     }
-#endif
 
 #ifdef USE_OCIO
     if (!handle && p) {
@@ -1965,7 +2158,12 @@ ColorConfig::createLookTransform(ustring looks, ustring inputColorSpace,
         OCIO::ConstProcessorRcPtr p;
         try {
             // Get the processor corresponding to this transform.
+#    ifdef OCIO_v2
+            p = getImpl()->get_processor(prockey, config, context, transform,
+                                         dir);
+#    else
             p = getImpl()->config_->getProcessor(context, transform, dir);
+#    endif
             getImpl()->clear_error();
             handle = ColorProcessorHandle(new ColorProcessor_OCIO(p));
         } catch (OCIO::Exception& e) {
@@ -2055,7 +2253,12 @@ ColorConfig::createDisplayTransform(ustring display, ustring view,
         OCIO::ConstProcessorRcPtr p;
         try {
             // Get the processor corresponding to this transform.
+#    ifdef OCIO_v2
+            p = getImpl()->get_processor(prockey, config, context, transform,
+                                         dir);
+#    else
             p = config->getProcessor(context, transform, dir);
+#    endif
             getImpl()->clear_error();
             handle = ColorProcessorHandle(new ColorProcessor_OCIO(p));
         } catch (OCIO::Exception& e) {
@@ -2138,7 +2341,12 @@ ColorConfig::createFileTransform(ustring name, bool inverse) const
         OCIO::ConstProcessorRcPtr p;
         try {
             // Get the processor corresponding to this transform.
+#    ifdef OCIO_v2
+            p = getImpl()->get_processor(prockey, config, context, transform,
+                                         dir);
+#    else
             p = config->getProcessor(context, transform, dir);
+#    endif
             getImpl()->clear_error();
             handle = ColorProcessorHandle(new ColorProcessor_OCIO(p));
         } catch (OCIO::Exception& e) {
@@ -2486,6 +2694,238 @@ colorconvert_impl_float_rgba(ImageBuf& R, const ImageBuf& A,
 
 
 
+namespace {
+
+// For uint8 and uint16 sources, the result for each pixel can be looked up
+// rather than computed, since there are only 256 or 65536 possible values
+// of each channel. Processors without channel crosstalk are baked into a
+// table holding the result for every code value of each channel, which is
+// exact. Processors with crosstalk are baked into a 3D LUT over RGB,
+// interpolated tetrahedrally, which is only used if its error (measured
+// against the processor itself at a set of sample colors) is small enough.
+class ColorLUT {
+public:
+    // Maximum error, relative to the processor, of the 3D LUT that we will
+    // accept. This is about a quarter of an 8-bit code value.
+    static constexpr float max_lut3d_error = 1.0f / 1024.0f;
+    static constexpr int lut3d_res         = 33;
+
+    // Number of processor evaluations it takes to build the LUT for
+    // `ncodes` code values.
+    static imagesize_t build_cost(int ncodes, bool crosstalk)
+    {
+        return crosstalk ? imagesize_t(lut3d_res) * lut3d_res * lut3d_res
+                         : imagesize_t(ncodes);
+    }
+
+    // Build the LUT for `processor`, applied to the first `nchannels`
+    // channels of images whose values are integer codes in [0, ncodes).
+    // Return false if it's not accurate enough to use.
+    bool init(const ColorProcessor* processor, int ncodes, int nchannels)
+    {
+        using namespace simd;
+        m_nchannels = nchannels;
+        m_scale     = 1.0f / float(ncodes - 1);
+        m_crosstalk = processor->hasChannelCrosstalk();
+        if (!m_crosstalk) {
+            // The result of every code value, for each channel
+            m_table.resize(ncodes);
+            for (int v = 0; v < ncodes; ++v)
+                m_table[v] = vfloat4(float(v) * m_scale);
+            processor->apply((float*)m_table.data(), ncodes, 1, 4,
+                             sizeof(float), sizeof(vfloat4),
+                             ncodes * sizeof(vfloat4));
+            return true;
+        }
+
+        // The lattice of the 3D LUT (r varies fastest), with alpha 1.
+        const int n = lut3d_res;
+        m_table.resize(size_t(n) * n * n);
+        for (int b = 0, i = 0; b < n; ++b)
+            for (int g = 0; g < n; ++g)
+                for (int r = 0; r < n; ++r, ++i)
+                    m_table[i] = vfloat4(float(r), float(g), float(b),
+                                         float(n - 1))
+                                 / float(n - 1);
+        processor->apply((float*)m_table.data(), int(m_table.size()), 1, 4,
+                         sizeof(float), sizeof(vfloat4),
+                         m_table.size() * sizeof(vfloat4));
+        // Lattice cell and position within it, of every code value
+        m_cell.resize(ncodes);
+        m_frac.resize(ncodes);
+        for (int v = 0; v < ncodes; ++v) {
+            float f   = float(v) * m_scale * float(n - 1);
+            m_cell[v] = std::min(int(f), n - 2);
+            m_frac[v] = f - float(m_cell[v]);
+        }
+
+        // Measure the error at a set of pseudo-random code values, with
+        // random alpha (the LUT assumes that alpha passes through
+        // unchanged and doesn't affect the color).
+        const int nsamples = 1024;
+        std::vector<vfloat4> exact(nsamples);
+        std::vector<int> codes(4 * nsamples);
+        for (int i = 0; i < 4 * nsamples; ++i)
+            codes[i] = int(bjhash::bjfinal(i, 13) % uint32_t(ncodes));
+        for (int i = 0; i < nsamples; ++i)
+            exact[i] = sample_input(&codes[4 * i]);
+        processor->apply((float*)exact.data(), nsamples, 1, 4, sizeof(float),
+                         sizeof(vfloat4), nsamples * sizeof(vfloat4));
+        float maxerr = 0.0f;
+        for (int i = 0; i < nsamples; ++i) {
+            vfloat4 err = abs(lookup(&codes[4 * i]) - exact[i]);
+            for (int c = 0; c < nchannels; ++c)
+                maxerr = std::max(maxerr, err[c]);
+        }
+        OIIO::debugfmt("colorconvert: 3D LUT max error {} ({})\n", maxerr,
+                       maxerr <= max_lut3d_error ? "using it"
+                                                 : "using the processor");
+        return maxerr <= max_lut3d_error;
+    }
+
+    // Convert `npixels` pixels of integer codes, with m_nchannels channels,
+    // to float results.
+    template<typename T> void apply(const T* in, float* out, int npixels) const
+    {
+        using namespace simd;
+        const int nc = m_nchannels;
+        if (!m_crosstalk) {
+            const float* table = (const float*)m_table.data();
+            for (int i = 0, e = npixels * nc; i < e; i += nc)
+                for (int c = 0; c < nc; ++c)
+                    out[i + c] = table[4 * in[i + c] + c];
+            return;
+        }
+        int codes[4] = { 0, 0, 0, 0 };
+        for (int x = 0; x < npixels; ++x, in += nc, out += nc) {
+            for (int c = 0; c < nc; ++c)
+                codes[c] = in[c];
+            if (nc == 1)
+                codes[2] = codes[1] = codes[0];
+            vfloat4 v = lookup(codes);
+            v.store(out, nc);
+        }
+    }
+
+private:
+    // The input to the processor for a pixel of codes, in the same way
+    // that colorconvert_impl presents it.
+    simd::vfloat4 sample_input(const int* codes) const
+    {
+        simd::vfloat4 v(0.0f);
+        for (int c = 0; c < m_nchannels; ++c)
+            v[c] = float(codes[c]) * m_scale;
+        if (m_nchannels == 1)
+            v[2] = v[1] = v[0];
+        return v;
+    }
+
+    // Tetrahedral interpolation of the 3D LUT at RGB codes[0..2]. Alpha
+    // (codes[3]) passes through.
+    simd::vfloat4 lookup(const int* codes) const
+    {
+        using namespace simd;
+        const int n = lut3d_res;
+        const int r = m_cell[codes[0]], g = m_cell[codes[1]],
+                  b = m_cell[codes[2]];
+        const float fr = m_frac[codes[0]], fg = m_frac[codes[1]],
+                    fb = m_frac[codes[2]];
+        const vfloat4* c000 = &m_table[(size_t(b) * n + g) * n + r];
+        const int dr = 1, dg = n, db = n * n;
+        vfloat4 c0 = c000[0], c1 = c000[dr + dg + db], c2, c3;
+        float f0, f1, f2;
+        if (fr > fg) {
+            if (fg > fb) {  // r > g > b
+                c2 = c000[dr], c3 = c000[dr + dg];
+                f0 = fr, f1 = fg, f2 = fb;
+            } else if (fr > fb) {  // r > b >= g
+                c2 = c000[dr], c3 = c000[dr + db];
+                f0 = fr, f1 = fb, f2 = fg;
+            } else {  // b >= r > g
+                c2 = c000[db], c3 = c000[dr + db];
+                f0 = fb, f1 = fr, f2 = fg;
+            }
+        } else {
+            if (fb > fg) {  // b > g >= r
+                c2 = c000[db], c3 = c000[dg + db];
+                f0 = fb, f1 = fg, f2 = fr;
+            } else if (fb > fr) {  // g >= b > r
+                c2 = c000[dg], c3 = c000[dg + db];
+                f0 = fg, f1 = fb, f2 = fr;
+            } else {  // g >= r >= b
+                c2 = c000[dg], c3 = c000[dr + dg];
+                f0 = fg, f1 = fr, f2 = fb;
+            }
+        }
+        // Walk from c0 through c2 and c3 to c1 (the far corner)
+        vfloat4 v = madd(vfloat4(f0), c2 - c0, c0);
+        v         = madd(vfloat4(f1), c3 - c2, v);
+        v         = madd(vfloat4(f2), c1 - c3, v);
+        if (m_nchannels == 4)
+            v[3] = float(codes[3]) * m_scale;
+        return v;
+    }
+
+    std::vector<simd::vfloat4> m_table;
+    std::vector<int> m_cell;
+    std::vector<float> m_frac;
+    float m_scale   = 1.0f;
+    int m_nchannels = 4;
+    bool m_crosstalk = false;
+};
+
+
+
+// Look-up version of colorconvert_impl, for uint8 and uint16 sources.
+template<typename Atype>
+static bool
+colorconvert_impl_lut(ImageBuf& R, const ImageBuf& A, const ColorLUT& lut,
+                      ROI roi, int nthreads)
+{
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        ImageBuf::RowReader<Atype> a(A, roi);
+        ImageBuf::RowWriter<float> r(R, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y)
+                lut.apply(a.row(y, z).data(), r.row(y, z).data(),
+                          roi.width());
+    });
+    return true;
+}
+
+
+
+// If the LUT method applies to this conversion -- integer source, at most
+// 4 channels starting with the first, no unpremultiplying (which would make
+// the values no longer codes), enough pixels to amortize building the LUT,
+// and an accurate enough LUT -- do the conversion and return true.
+// Otherwise, return false without touching dst.
+static bool
+colorconvert_lut(ImageBuf& dst, const ImageBuf& src,
+                 const ColorProcessor* processor, bool unpremult, ROI roi,
+                 int nthreads)
+{
+    TypeDesc srcformat = src.spec().format;
+    if ((srcformat != TypeUInt8 && srcformat != TypeUInt16)
+        || !src.spec().channelformats.empty() || roi.chbegin != 0
+        || roi.chend > 4 || (unpremult && roi.nchannels() == 4))
+        return false;
+    int ncodes = srcformat == TypeUInt8 ? 256 : 65536;
+    if (roi.npixels() < 4 * ColorLUT::build_cost(
+            ncodes, processor->hasChannelCrosstalk()))
+        return false;
+    ColorLUT lut;
+    if (!lut.init(processor, ncodes, roi.nchannels()))
+        return false;
+    if (srcformat == TypeUInt8)
+        return colorconvert_impl_lut<uint8_t>(dst, src, lut, roi, nthreads);
+    return colorconvert_impl_lut<uint16_t>(dst, src, lut, roi, nthreads);
+}
+
+}  // namespace
+
+
+
 bool
 ImageBufAlgo::colorconvert(ImageBuf& dst, const ImageBuf& src,
                            const ColorProcessor* processor, bool unpremult,
@@ -2521,6 +2961,9 @@ ImageBufAlgo::colorconvert(ImageBuf& dst, const ImageBuf& src,
         unpremult = false;
     }
 
+    if (colorconvert_lut(dst, src, processor, unpremult, roi, nthreads))
+        return true;
+
     if (dst.localpixels() && src.localpixels() && dst.spec().format == TypeFloat
         && src.spec().format == TypeFloat && dst.nchannels() == 4
         && src.nchannels() == 4) {
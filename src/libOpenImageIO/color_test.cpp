@@ -11,6 +11,9 @@
 #include <OpenImageIO/argparse.h>
 #include <OpenImageIO/benchmark.h>
 #include <OpenImageIO/color.h>
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imagebuf.h>
+#include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/simd.h>
 #include <OpenImageIO/strutil.h>
 #include <OpenImageIO/timer.h>
@@ -120,6 +123,214 @@ test_Rec709_conversion()
 
 
 
+// Check that the SIMD version of a transfer function matches the scalar one
+// within the advertised error bound, over [lo,hi].
+template<typename F, typename VF>
+static void
+check_simd_transfer(string_view name, F func, VF vfunc, float lo, float hi)
+{
+    float maxrel = 0.0f;
+    for (int i = 0; i <= 1000; ++i) {
+        float x = lo + (hi - lo) * float(i) / 1000.0f;
+        float a = func(x);
+        float b = vfunc(vfloat4(x))[0];
+        maxrel  = std::max(maxrel, std::abs(a - b) / std::max(std::abs(a),
+                                                             1.0e-3f));
+    }
+    if (verbose)
+        Strutil::print("  {} simd max relative error {:g}\n", name, maxrel);
+    OIIO_CHECK_LT(maxrel, 1.0e-4f);
+}
+
+
+
+static void
+test_hdr_transfer_functions()
+{
+    // Round trips and a few well known values
+    OIIO_CHECK_EQUAL_THRESH(linear_to_PQ(0.0f), 0.0f, 1.0e-6);
+    OIIO_CHECK_EQUAL_THRESH(linear_to_PQ(100.0f), 1.0f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(linear_to_PQ(1.0f), 0.508078421517399f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(PQ_to_linear(linear_to_PQ(0.18f)), 0.18f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(linear_to_HLG(1.0f / 12.0f), 0.5f, 1.0e-6);
+    OIIO_CHECK_EQUAL_THRESH(linear_to_HLG(1.0f), 1.0f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(HLG_to_linear(linear_to_HLG(0.3f)), 0.3f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(linear_to_ACEScct(0.18f), 0.4135884f, 1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(ACEScct_to_linear(linear_to_ACEScct(0.18f)), 0.18f,
+                            1.0e-5);
+    OIIO_CHECK_EQUAL_THRESH(ACEScct_to_linear(linear_to_ACEScct(0.001f)),
+                            0.001f, 1.0e-6);
+
+    check_simd_transfer(
+        "Rec709_to_linear", [](float x) { return Rec709_to_linear(x); },
+        [](const vfloat4& x) { return Rec709_to_linear(x); }, 0.0f, 1.0f);
+    check_simd_transfer(
+        "linear_to_Rec709", [](float x) { return linear_to_Rec709(x); },
+        [](const vfloat4& x) { return linear_to_Rec709(x); }, 0.0f, 1.0f);
+    check_simd_transfer(
+        "PQ_to_linear", [](float x) { return PQ_to_linear(x); },
+        [](const vfloat4& x) { return PQ_to_linear(x); }, 0.0f, 1.0f);
+    check_simd_transfer(
+        "linear_to_PQ", [](float x) { return linear_to_PQ(x); },
+        [](const vfloat4& x) { return linear_to_PQ(x); }, 0.0f, 100.0f);
+    check_simd_transfer(
+        "HLG_to_linear", [](float x) { return HLG_to_linear(x); },
+        [](const vfloat4& x) { return HLG_to_linear(x); }, 0.0f, 1.0f);
+    check_simd_transfer(
+        "linear_to_HLG", [](float x) { return linear_to_HLG(x); },
+        [](const vfloat4& x) { return linear_to_HLG(x); }, 0.0f, 1.0f);
+    check_simd_transfer(
+        "ACEScct_to_linear", [](float x) { return ACEScct_to_linear(x); },
+        [](const vfloat4& x) { return ACEScct_to_linear(x); }, 0.0f, 1.4f);
+    check_simd_transfer(
+        "linear_to_ACEScct", [](float x) { return linear_to_ACEScct(x); },
+        [](const vfloat4& x) { return linear_to_ACEScct(x); }, 0.0f, 100.0f);
+}
+
+
+
+static void
+test_builtin_processors()
+{
+    // A config that can't be found leaves us with only the built-in
+    // (non-OCIO) color processors.
+    ColorConfig builtin("no_such_ocio_config.ocio");
+    builtin.geterror();
+
+    const int res = 1024;
+    ImageBuf fsrc(ImageSpec(res, res, 4, TypeFloat));
+    const float tl[] = { 0.0f, 0.2f, 0.9f, 1.0f };
+    const float br[] = { 1.0f, 0.7f, 0.1f, 0.5f };
+    ImageBufAlgo::fill(fsrc, tl, tl, br, br);
+    ImageBuf hsrc = ImageBufAlgo::copy(fsrc, TypeHalf);
+
+    // Pairs of (encoded, linear) spaces that share primaries
+    for (auto cs : { std::make_pair("sRGB", "linear"),
+                     std::make_pair("Rec709", "lin_srgb"),
+                     std::make_pair("ACEScct", "ACEScg") }) {
+        ColorProcessorHandle proc = builtin.createColorProcessor(cs.first,
+                                                                 cs.second);
+        OIIO_CHECK_ASSERT(proc);
+        if (!proc)
+            continue;
+        ColorProcessorHandle inv = builtin.createColorProcessor(cs.second,
+                                                                cs.first);
+        OIIO_CHECK_ASSERT(inv);
+
+        // The fast path must agree with the exact one, and the inverse
+        // must get us back where we started.
+        OIIO::attribute("color:fast_transfer", 0);
+        ImageBuf exact = ImageBufAlgo::colorconvert(fsrc, proc.get(), false);
+        OIIO::attribute("color:fast_transfer", 1);
+        ImageBuf fast = ImageBufAlgo::colorconvert(fsrc, proc.get(), false);
+        // The error bound is relative, and ACEScct decodes to values much
+        // larger than 1.
+        auto stats  = ImageBufAlgo::computePixelStats(exact);
+        float scale = std::max(1.0f, *std::max_element(stats.max.begin(),
+                                                       stats.max.end()));
+        auto comp   = ImageBufAlgo::compare(fast, exact, 1.0e-4f * scale,
+                                            1.0e-4f * scale);
+        OIIO_CHECK_EQUAL(comp.nfail, 0);
+        if (inv) {
+            ImageBuf back = ImageBufAlgo::colorconvert(fast, inv.get(), false);
+            comp          = ImageBufAlgo::compare(back, fsrc, 5.0e-4f, 5.0e-4f);
+            OIIO_CHECK_EQUAL(comp.nfail, 0);
+        }
+    }
+
+    // A transfer curve alone can't change primaries, so conversions that
+    // would need that have no built-in processor.
+    for (auto cs : { std::make_pair("ACEScg", "sRGB"),
+                     std::make_pair("lin_srgb", "ACEScct"),
+                     std::make_pair("ACEScct", "linear"),
+                     std::make_pair("linear", "PQ") }) {
+        OIIO_CHECK_ASSERT(!builtin.createColorProcessor(cs.first, cs.second));
+        OIIO_CHECK_ASSERT(!builtin.createColorProcessor(cs.second, cs.first));
+        builtin.geterror();
+    }
+
+    // Compare the built-in transfer functions, exact and fast, with the
+    // default (OCIO, if available) processor for the same conversion.
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    ImageBuf dst;
+    ColorProcessorHandle ocioproc
+        = ColorConfig::default_colorconfig().createColorProcessor("sRGB",
+                                                                  "linear");
+    ColorProcessorHandle proc = builtin.createColorProcessor("sRGB", "linear");
+    for (auto src : { &fsrc, &hsrc }) {
+        std::string type = src->spec().format.c_str();
+        if (ocioproc)
+            bench(Strutil::fmt::format("colorconvert sRGB {} default", type),
+                  [&]() {
+                      ImageBufAlgo::colorconvert(dst, *src, ocioproc.get(),
+                                                 false);
+                  });
+        OIIO::attribute("color:fast_transfer", 0);
+        bench(Strutil::fmt::format("colorconvert sRGB {} builtin exact", type),
+              [&]() {
+                  ImageBufAlgo::colorconvert(dst, *src, proc.get(), false);
+              });
+        OIIO::attribute("color:fast_transfer", 1);
+        bench(Strutil::fmt::format("colorconvert sRGB {} builtin fast", type),
+              [&]() {
+                  ImageBufAlgo::colorconvert(dst, *src, proc.get(), false);
+              });
+    }
+}
+
+
+
+static void
+test_processor_disk_cache()
+{
+    if (!ColorConfig::supportsOpenColorIO()
+        || ColorConfig::OpenColorIO_version_hex() < 0x02000000)
+        return;
+    std::cout << "Testing the on-disk color processor cache\n";
+    std::string cachedir = "colorproc_cache_test";
+    Filesystem::remove_all(cachedir);
+    OIIO::attribute("color:processor_cache", cachedir);
+
+    auto stat = [](const char* name) {
+        long long val = 0;
+        OIIO::getattribute(name, TypeInt64, &val);
+        return val;
+    };
+    long long hits0 = stat("color:processor_cache_hits");
+    long long miss0 = stat("color:processor_cache_misses");
+
+    // A fresh ColorConfig has an empty in-memory cache, so each one has
+    // to ask OCIO for the processor. The first one bakes it, the second
+    // one should find it on disk, with the same results.
+    float first[3] = { 0.5f, 0.25f, 0.125f }, second[3];
+    std::copy(first, first + 3, second);
+    {
+        ColorConfig config;
+        auto proc = config.createColorProcessor("sRGB", "linear");
+        OIIO_CHECK_ASSERT(proc);
+        if (proc)
+            proc->apply(first);
+    }
+    OIIO_CHECK_EQUAL(stat("color:processor_cache_misses"), miss0 + 1);
+    OIIO_CHECK_GT(stat("color:processor_cache_bytes"), 0);
+    {
+        ColorConfig config;
+        auto proc = config.createColorProcessor("sRGB", "linear");
+        OIIO_CHECK_ASSERT(proc);
+        if (proc)
+            proc->apply(second);
+    }
+    OIIO_CHECK_EQUAL(stat("color:processor_cache_hits"), hits0 + 1);
+    for (int c = 0; c < 3; ++c)
+        OIIO_CHECK_EQUAL_THRESH(first[c], second[c], 1.0e-5f);
+
+    OIIO::attribute("color:processor_cache", "");
+    Filesystem::remove_all(cachedir);
+}
+
+
+
 int
 main(int argc, char* argv[])
 {
@@ -135,6 +346,9 @@ main(int argc, char* argv[])
 
     test_sRGB_conversion();
     test_Rec709_conversion();
+    test_hdr_transfer_functions();
+    test_builtin_processors();
+    test_processor_disk_cache();
 
     return unit_test_failures != 0;
 }
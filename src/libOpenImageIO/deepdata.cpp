@@ -3,6 +3,7 @@
 // https://github.com/AcademySoftwareFoundation/OpenImageIO
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <numeric>
@@ -28,6 +29,17 @@ OIIO_NAMESPACE_BEGIN
 // need to lock the mutex. As long as capacity is not changing, threads may
 // change number of samples (inserting or deleting) as well as altering
 // data, simultaneously, as long as they are working on separate pixels.
+//
+// Optionally (set_chunked()), the samples are kept in separate arenas, each
+// holding a fixed run of pixels (such as a scanline or tile). In that
+// layout, m_cumcapacity[p] is the offset of pixel p within its own chunk
+// rather than a running sum, and a pixel that must grow is moved to the
+// end of its chunk's arena (or grown in place if it's already there). So
+// growing capacity costs amortized O(1) rather than moving all the data
+// of every subsequent pixel, and it locks only that one chunk. The holes
+// left behind are squeezed out once they add up to the live capacity of
+// the chunk, and all_data() compacts the whole thing back to the
+// contiguous layout on demand.
 
 
 
@@ -55,10 +67,41 @@ public:
     int m_AG_channel;
     int m_AB_channel;
     bool m_allocated;
+    bool m_float_or_half;  // every channel is float or half
     spin_mutex m_mutex;
 
+    // Chunked storage. m_chunks is empty when the data is contiguous in
+    // m_data. m_has_chunks mirrors !m_chunks.empty(), so that the
+    // double-checked tests made before taking m_mutex don't read m_chunks
+    // while another thread is (re)building it.
+    struct Chunk {
+        std::vector<char> data;  // arena for the chunk's pixels
+        size_t capacity = 0;     // total capacity (in samples) of its pixels
+        spin_mutex mutex;
+    };
+    std::vector<Chunk> m_chunks;
+    int64_t m_chunkpixels = 0;  // pixels per chunk, or 0 for contiguous
+    // Copyable, like spin_mutex, so that Impl keeps its implicit copy.
+    struct Flag : std::atomic<bool> {
+        Flag()
+            : std::atomic<bool>(false)
+        {
+        }
+        Flag(const Flag& f)
+            : std::atomic<bool>(f.load())
+        {
+        }
+        Flag& operator=(const Flag& f)
+        {
+            store(f.load());
+            return *this;
+        }
+    };
+    Flag m_has_chunks;
+
     Impl()
         : m_allocated(false)
+        , m_float_or_half(false)
     {
         clear();
     }
@@ -82,6 +125,10 @@ public:
         m_AG_channel    = -1;
         m_AB_channel    = -1;
         m_allocated     = false;
+        m_float_or_half = false;
+        m_chunks.clear();
+        m_chunkpixels = 0;
+        m_has_chunks.store(false, std::memory_order_release);
     }
 
     // If not already done, allocate data and cumcapacity
@@ -90,33 +137,177 @@ public:
         if (!m_allocated) {
             spin_lock lock(m_mutex);
             if (!m_allocated) {
-                // m_cumcapacity.resize (npixels);
-                size_t totalcapacity = 0;
-                for (size_t i = 0; i < npixels; ++i) {
-                    m_cumcapacity[i] = totalcapacity;
-                    totalcapacity += m_capacity[i];
+                if (m_chunkpixels > 0) {
+                    to_chunks(npixels);
+                } else {
+                    // m_cumcapacity.resize (npixels);
+                    size_t totalcapacity = 0;
+                    for (size_t i = 0; i < npixels; ++i) {
+                        m_cumcapacity[i] = totalcapacity;
+                        totalcapacity += m_capacity[i];
+                    }
+                    m_data.resize(totalcapacity * m_samplesize);
                 }
-                m_data.resize(totalcapacity * m_samplesize);
                 m_allocated = true;
             }
         }
     }
 
-    size_t data_offset(int64_t pixel, int channel, int sample)
+    // Move the data from the contiguous m_data (if allocated) into chunks
+    // of m_chunkpixels pixels each. The caller holds m_mutex.
+    void to_chunks(int64_t npixels)
+    {
+        int64_t nchunks = (npixels + m_chunkpixels - 1) / m_chunkpixels;
+        m_chunks.resize(nchunks);
+        for (int64_t c = 0; c < nchunks; ++c) {
+            int64_t pbegin = c * m_chunkpixels;
+            int64_t pend   = std::min(pbegin + m_chunkpixels, npixels);
+            size_t start   = m_allocated ? m_cumcapacity[pbegin] : 0;
+            size_t cap     = 0;
+            for (int64_t p = pbegin; p < pend; ++p) {
+                m_cumcapacity[p] = cap;
+                cap += m_capacity[p];
+            }
+            Chunk& chunk(m_chunks[c]);
+            chunk.capacity = cap;
+            if (m_allocated)
+                chunk.data.assign(m_data.begin() + start * m_samplesize,
+                                  m_data.begin()
+                                      + (start + cap) * m_samplesize);
+            else
+                chunk.data.resize(cap * m_samplesize);
+        }
+        std::vector<char>().swap(m_data);
+        m_has_chunks.store(true, std::memory_order_release);
+    }
+
+    // Gather the chunks back into the contiguous m_data. The caller holds
+    // m_mutex.
+    void to_contiguous(int64_t npixels)
+    {
+        std::vector<char> data(
+            std::accumulate(m_capacity.begin(), m_capacity.end(), size_t(0))
+            * m_samplesize);
+        size_t totalcapacity = 0;
+        for (int64_t p = 0; p < npixels; ++p) {
+            const char* src = pixel_data(p);
+            std::copy(src, src + m_capacity[p] * m_samplesize,
+                      data.begin() + totalcapacity * m_samplesize);
+            m_cumcapacity[p] = totalcapacity;
+            totalcapacity += m_capacity[p];
+        }
+        m_data.swap(data);
+        m_chunks.clear();
+        m_has_chunks.store(false, std::memory_order_release);
+    }
+
+    // Squeeze the holes out of one chunk. The caller holds its mutex.
+    void compact_chunk(int64_t c, int64_t npixels)
+    {
+        Chunk& chunk(m_chunks[c]);
+        std::vector<char> data(chunk.capacity * m_samplesize);
+        int64_t pbegin = c * m_chunkpixels;
+        int64_t pend   = std::min(pbegin + m_chunkpixels, npixels);
+        size_t cap     = 0;
+        for (int64_t p = pbegin; p < pend; ++p) {
+            const char* src = pixel_data(p);
+            std::copy(src, src + m_capacity[p] * m_samplesize,
+                      data.begin() + cap * m_samplesize);
+            m_cumcapacity[p] = cap;
+            cap += m_capacity[p];
+        }
+        chunk.data.swap(data);
+    }
+
+    // Grow the capacity of a pixel in chunked storage. Only that pixel's
+    // chunk is locked.
+    void grow_chunked(int64_t pixel, int samps, int64_t npixels)
+    {
+        int64_t c = pixel / m_chunkpixels;
+        Chunk& chunk(m_chunks[c]);
+        spin_lock lock(chunk.mutex);
+        size_t n = m_capacity[pixel];
+        if (size_t(samps) <= n)
+            return;
+        size_t end = (m_cumcapacity[pixel] + n) * m_samplesize;
+        if (end == chunk.data.size()) {
+            // Already at the end of the arena: just extend it.
+            chunk.data.resize(chunk.data.size() + (samps - n) * m_samplesize);
+        } else {
+            // Move the pixel to the end of the arena, leaving a hole where
+            // it used to be.
+            size_t oldoffset = m_cumcapacity[pixel] * m_samplesize;
+            size_t newoffset = chunk.data.size();
+            chunk.data.resize(newoffset + samps * m_samplesize);
+            std::copy(chunk.data.begin() + oldoffset,
+                      chunk.data.begin() + oldoffset + n * m_samplesize,
+                      chunk.data.begin() + newoffset);
+            m_cumcapacity[pixel] = newoffset / m_samplesize;
+        }
+        m_capacity[pixel] = samps;
+        chunk.capacity += samps - n;
+        if (chunk.data.size() > 2 * chunk.capacity * m_samplesize)
+            compact_chunk(c, npixels);
+    }
+
+    // Pointer to the first sample of the pixel
+    char* pixel_data(int64_t pixel)
+    {
+        OIIO_DASSERT(int64_t(m_cumcapacity.size()) > pixel);
+        size_t offset = m_cumcapacity[pixel] * m_samplesize;
+        if (m_chunks.size())
+            return m_chunks[pixel / m_chunkpixels].data.data() + offset;
+        return m_data.data() + offset;
+    }
+
+    void* data_ptr(int64_t pixel, int channel, int sample)
     {
-        OIIO_DASSERT(int(m_cumcapacity.size()) > pixel);
         OIIO_DASSERT(m_capacity[pixel] >= m_nsamples[pixel]);
-        return (m_cumcapacity[pixel] + sample) * m_samplesize
+        return pixel_data(pixel) + sample * m_samplesize
                + m_channeloffsets[channel];
     }
 
-    void* data_ptr(int64_t pixel, int channel, int sample)
+    // For the all float/half layout: copy the first n samples of a pixel to
+    // or from float scratch space holding nchannels floats per sample.
+    void load_floats(int64_t pixel, int n, float* dst)
+    {
+        const char* data = pixel_data(pixel);
+        size_t nc        = m_channeltypes.size();
+        if (m_samplesize == nc * sizeof(float)) {  // all float
+            memcpy(dst, data, n * m_samplesize);
+            return;
+        }
+        for (int s = 0; s < n; ++s, data += m_samplesize)
+            for (size_t c = 0; c < nc; ++c, ++dst) {
+                const char* v = data + m_channeloffsets[c];
+                if (m_channeltypes[c] == TypeDesc::FLOAT)
+                    memcpy(dst, v, sizeof(float));
+                else
+                    *dst = float(*(const half*)v);
+            }
+    }
+
+    void store_floats(int64_t pixel, int n, const float* src)
     {
-        size_t offset = data_offset(pixel, channel, sample);
-        OIIO_DASSERT(offset < m_data.size());
-        return &m_data[offset];
+        char* data = pixel_data(pixel);
+        size_t nc  = m_channeltypes.size();
+        if (m_samplesize == nc * sizeof(float)) {  // all float
+            memcpy(data, src, n * m_samplesize);
+            return;
+        }
+        for (int s = 0; s < n; ++s, data += m_samplesize)
+            for (size_t c = 0; c < nc; ++c, ++src) {
+                char* v = data + m_channeloffsets[c];
+                if (m_channeltypes[c] == TypeDesc::FLOAT)
+                    memcpy(v, src, sizeof(float));
+                else
+                    *(half*)v = half(*src);
+            }
     }
 
+    void merge_floats(DeepData& dd, int64_t pixel, Impl& src,
+                      int64_t srcpixel);
+
     size_t total_capacity() const
     {
         return m_cumcapacity.back() + m_capacity.back();
@@ -130,7 +321,7 @@ public:
         int64_t npixels = int64_t(m_capacity.size());
         OIIO_ASSERT(m_nsamples.size() == m_capacity.size());
         OIIO_ASSERT(m_cumcapacity.size() == m_capacity.size());
-        if (m_allocated) {
+        if (m_allocated && m_chunks.empty()) {
             size_t totalcapacity = 0;
             for (int64_t p = 0; p < npixels; ++p) {
                 OIIO_ASSERT(m_cumcapacity[p] == totalcapacity);
@@ -362,6 +553,11 @@ DeepData::init(int64_t npix, int nchan, cspan<TypeDesc> channeltypes,
         m_impl->m_channeltypes.clear();
         m_impl->m_channeltypes.resize(m_nchannels, channeltypes[0]);
     }
+    m_impl->m_float_or_half = std::all_of(
+        m_impl->m_channeltypes.begin(), m_impl->m_channeltypes.end(),
+        [](TypeDesc t) {
+            return t == TypeDesc::FLOAT || t == TypeDesc::HALF;
+        });
     m_impl->m_channelsizes.resize(m_nchannels);
     m_impl->m_channeloffsets.resize(m_nchannels);
     m_impl->m_channelnames.resize(m_nchannels);
@@ -505,6 +701,17 @@ DeepData::set_capacity(int64_t pixel, int samps)
     if (pixel < 0 || pixel >= m_npixels)
         return;
     OIIO_DASSERT(m_impl);
+    if (m_impl->m_allocated && m_impl->m_chunkpixels > 0) {
+        // Chunked storage: only the pixel's own chunk is locked. But first
+        // re-chunk, if all_data() gathered the data up.
+        if (!m_impl->m_has_chunks.load(std::memory_order_acquire)) {
+            spin_lock lock(m_impl->m_mutex);
+            if (m_impl->m_chunks.empty())
+                m_impl->to_chunks(m_npixels);
+        }
+        m_impl->grow_chunked(pixel, samps, m_npixels);
+        return;
+    }
     spin_lock lock(m_impl->m_mutex);
     if (m_impl->m_allocated) {
         // Data already allocated. Expand capacity if necessary, don't
@@ -516,7 +723,8 @@ DeepData::set_capacity(int64_t pixel, int samps)
                 size_t newtotal = (m_impl->total_capacity() + toadd);
                 m_impl->m_data.resize(newtotal * samplesize());
             } else {
-                size_t offset = m_impl->data_offset(pixel, 0, n);
+                size_t offset = (m_impl->m_cumcapacity[pixel] + n)
+                                * samplesize();
                 m_impl->m_data.insert(m_impl->m_data.begin() + offset,
                                       toadd * samplesize(), 0);
             }
@@ -597,11 +805,10 @@ DeepData::insert_samples(int64_t pixel, int samplepos, int n)
     if (m_impl->m_allocated) {
         // Move the data
         if (samplepos < oldsamps) {
-            size_t offset = m_impl->data_offset(pixel, 0, samplepos);
-            size_t end    = m_impl->data_offset(pixel, 0, oldsamps);
-            std::copy_backward(m_impl->m_data.begin() + offset,
-                               m_impl->m_data.begin() + end,
-                               m_impl->m_data.begin() + end + n * samplesize());
+            char* data = m_impl->pixel_data(pixel);
+            std::copy_backward(data + samplepos * samplesize(),
+                               data + oldsamps * samplesize(),
+                               data + (oldsamps + n) * samplesize());
         }
     }
     // Add to this pixel's sample count
@@ -619,12 +826,11 @@ DeepData::erase_samples(int64_t pixel, int samplepos, int n)
     n = std::min(n, int(m_impl->m_nsamples[pixel]));
     if (m_impl->m_allocated) {
         // Move the data
-        int oldsamps  = samples(pixel);
-        size_t offset = m_impl->data_offset(pixel, 0, samplepos);
-        size_t end    = m_impl->data_offset(pixel, 0, oldsamps);
-        std::copy(m_impl->m_data.begin() + offset + n * samplesize(),
-                  m_impl->m_data.begin() + end,
-                  m_impl->m_data.begin() + offset);
+        int oldsamps = samples(pixel);
+        char* data   = m_impl->pixel_data(pixel);
+        std::copy(data + (samplepos + n) * samplesize(),
+                  data + oldsamps * samplesize(),
+                  data + samplepos * samplesize());
     }
     m_impl->m_nsamples[pixel] -= n;
 }
@@ -647,7 +853,7 @@ const void*
 DeepData::data_ptr(int64_t pixel, int channel, int sample) const
 {
     if (pixel < 0 || pixel >= m_npixels || channel < 0 || channel >= m_nchannels
-        || !m_impl || !m_impl->m_data.size() || sample < 0
+        || !m_impl || !m_impl->m_allocated || sample < 0
         || sample >= int(m_impl->m_nsamples[pixel]))
         return NULL;
     return m_impl->data_ptr(pixel, channel, sample);
@@ -844,11 +1050,41 @@ DeepData::all_data() const
 {
     OIIO_DASSERT(m_impl);
     m_impl->alloc(m_npixels);
+    if (m_impl->m_has_chunks.load(std::memory_order_acquire)) {
+        spin_lock lock(m_impl->m_mutex);
+        if (m_impl->m_chunks.size())
+            m_impl->to_contiguous(m_npixels);
+    }
     return m_impl->m_data;
 }
 
 
 
+void
+DeepData::set_chunked(int64_t pixels_per_chunk)
+{
+    OIIO_DASSERT(m_impl);
+    spin_lock lock(m_impl->m_mutex);
+    pixels_per_chunk = std::max(int64_t(0), pixels_per_chunk);
+    if (pixels_per_chunk == m_impl->m_chunkpixels)
+        return;
+    if (m_impl->m_chunks.size())
+        m_impl->to_contiguous(m_npixels);
+    m_impl->m_chunkpixels = pixels_per_chunk;
+    if (pixels_per_chunk > 0 && m_impl->m_allocated)
+        m_impl->to_chunks(m_npixels);
+}
+
+
+
+int64_t
+DeepData::chunked() const
+{
+    return m_impl ? m_impl->m_chunkpixels : 0;
+}
+
+
+
 void
 DeepData::get_pointers(std::vector<void*>& pointers) const
 {
@@ -1172,6 +1408,189 @@ DeepData::merge_overlaps(int64_t pixel)
 
 
 
+namespace {
+
+// Scratch space for merge_floats, reused by each thread.
+struct DeepMergeScratch {
+    std::vector<float> samples;  // both pixels' samples
+    std::vector<float> pieces;   // the samples after splitting
+    std::vector<float> merged;   // the result
+    std::vector<float> depths;   // depths at which samples must be split
+    std::vector<int> order;      // depth order of the samples or pieces
+};
+
+static thread_local DeepMergeScratch merge_scratch;
+
+}  // namespace
+
+
+
+// Fast path of merge_deep_pixels() for the all float/half layout. Rather
+// than appending src's samples one at a time and then sorting, splitting,
+// and merging in place through the generic accessors, both pixels are
+// loaded into float scratch and processed there: the two sample lists
+// (which are almost always sorted by depth already) are merged in one
+// linear pass, each sample is cut at every depth inside it where another
+// sample begins or ends, and coincident pieces are combined as they are
+// emitted. The result is stored back with a single resize of the pixel.
+void
+DeepData::Impl::merge_floats(DeepData& dd, int64_t pixel, Impl& src,
+                             int64_t srcpixel)
+{
+    using std::expm1;
+    using std::log1p;
+    DeepMergeScratch& scratch(merge_scratch);
+    const int nc        = int(m_channeltypes.size());
+    const int zchan     = m_z_channel;
+    const int zbackchan = m_zback_channel >= 0 ? m_zback_channel : zchan;
+    const int n1        = int(m_nsamples[pixel]);
+    const int n2        = int(src.m_nsamples[srcpixel]);
+    std::vector<float>& in(scratch.samples);
+    in.resize(size_t(n1 + n2) * nc);
+    load_floats(pixel, n1, in.data());
+    src.load_floats(srcpixel, n2, in.data() + size_t(n1) * nc);
+
+    const float* base = in.data();  // the samples we're ordering
+    int n             = n1 + n2;
+    auto zf = [&](int i) { return base[size_t(i) * nc + zchan]; };
+    auto zb = [&](int i) { return base[size_t(i) * nc + zbackchan]; };
+    auto less = [&](int i, int j) {
+        return zf(i) < zf(j) || (zf(i) == zf(j) && zb(i) < zb(j));
+    };
+    auto sorted = [&](int begin, int end) {
+        for (int i = begin + 1; i < end; ++i)
+            if (less(i, i - 1))
+                return false;
+        return true;
+    };
+
+    // Put the samples in depth order. If each pixel's list is already
+    // sorted, that's a linear merge (our own sample goes first on ties).
+    std::vector<int>& order(scratch.order);
+    order.resize(n);
+    if (sorted(0, n1) && sorted(n1, n)) {
+        for (int i = 0, a = 0, b = n1; i < n; ++i)
+            order[i] = (b == n || (a < n1 && !less(b, a))) ? a++ : b++;
+    } else {
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), less);
+    }
+
+    // Samples only need splitting if one begins before an earlier one
+    // ends. If so, cut each sample at every Z or Zback of the combined list
+    // that falls inside it, apportioning its color and alpha to the pieces
+    // as split() would, and put the pieces in depth order.
+    bool overlaps = false;
+    float zmax    = -std::numeric_limits<float>::max();
+    for (int i : order) {
+        overlaps |= (zf(i) < zmax);
+        zmax = std::max(zmax, zb(i));
+    }
+    if (overlaps) {
+        std::vector<float>& depths(scratch.depths);
+        depths.resize(2 * size_t(n));
+        for (int i = 0; i < n; ++i) {
+            depths[2 * i]     = zf(i);
+            depths[2 * i + 1] = zb(i);
+        }
+        std::sort(depths.begin(), depths.end());
+        depths.erase(std::unique(depths.begin(), depths.end()), depths.end());
+        std::vector<float>& pieces(scratch.pieces);
+        pieces.clear();
+        for (int i : order) {
+            const float* v = base + size_t(i) * nc;
+            float z0 = zf(i), z1 = zb(i);
+            auto d   = std::upper_bound(depths.begin(), depths.end(), z0);
+            if (d == depths.end() || *d >= z1) {  // nothing inside
+                pieces.insert(pieces.end(), v, v + nc);
+                continue;
+            }
+            for (float front = z0; front < z1;) {
+                float back = (d != depths.end() && *d < z1) ? *d++ : z1;
+                float x    = (back - front) / (z1 - z0);
+                size_t p   = pieces.size();
+                pieces.resize(p + nc);
+                for (int c = 0; c < nc; ++c) {
+                    int alphachan = m_myalphachannel[c];
+                    float val     = v[c];
+                    float a       = alphachan < 0
+                                        ? 1.0f
+                                        : clamp(v[alphachan], 0.0f, 1.0f);
+                    if (a == 1.0f)
+                        ;  // Opaque or not a color: copied as is
+                    else if (a > std::numeric_limits<float>::min()) {
+                        float ap = -expm1(x * log1p(-a));
+                        val      = (alphachan == c) ? ap : (ap / a) * val;
+                    } else {
+                        val = (alphachan == c) ? a * x : val * x;
+                    }
+                    pieces[p + c] = val;
+                }
+                pieces[p + zchan]     = front;
+                pieces[p + zbackchan] = back;
+                front                 = back;
+            }
+        }
+        base = pieces.data();
+        n    = int(pieces.size() / nc);
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), less);
+    }
+
+    // Emit the samples in order, combining any that exactly coincide with
+    // the previous one, as merge_overlaps() does.
+    std::vector<float>& out(scratch.merged);
+    out.clear();
+    for (int i : order) {
+        const float* v = base + size_t(i) * nc;
+        float* prev    = out.size() ? &out[out.size() - nc] : nullptr;
+        if (!prev || v[zchan] != prev[zchan]
+            || v[zbackchan] != prev[zbackchan]) {
+            out.insert(out.end(), v, v + nc);
+            continue;
+        }
+        for (int c = 0; c < nc; ++c) {  // set the colors
+            int alphachan = m_myalphachannel[c];
+            if (alphachan < 0 || alphachan == c)
+                continue;  // Not color, or alpha (done in the second pass)
+            float a1 = clamp(prev[alphachan], 0.0f, 1.0f);
+            float a2 = clamp(v[alphachan], 0.0f, 1.0f);
+            float c1 = prev[c], c2 = v[c];
+            float am = a1 + a2 - a1 * a2;
+            if (a1 == 1.0f && a2 == 1.0f)
+                prev[c] = (c1 + c2) / 2.0f;
+            else if (a1 == 1.0f)
+                prev[c] = c1;
+            else if (a2 == 1.0f)
+                prev[c] = c2;
+            else {
+                static const float MAX = std::numeric_limits<float>::max();
+                float u1               = -log1p(-a1);
+                float v1               = (u1 < a1 * MAX) ? u1 / a1 : 1.0f;
+                float u2               = -log1p(-a2);
+                float v2               = (u2 < a2 * MAX) ? u2 / a2 : 1.0f;
+                float u                = u1 + u2;
+                float w = (u > 1.0f || am < u * MAX) ? am / u : 1.0f;
+                prev[c] = (c1 * v1 + c2 * v2) * w;
+            }
+        }
+        for (int c = 0; c < nc; ++c) {  // set the alphas
+            if (m_myalphachannel[c] != c)
+                continue;
+            float a1 = clamp(prev[c], 0.0f, 1.0f);
+            float a2 = clamp(v[c], 0.0f, 1.0f);
+            prev[c]  = a1 + a2 - a1 * a2;
+        }
+    }
+
+    int nout = int(out.size() / nc);
+    dd.set_samples(pixel, nout);
+    store_floats(pixel, nout, out.data());
+}
+
+
+
 void
 DeepData::merge_deep_pixels(int64_t pixel, const DeepData& src, int srcpixel)
 {
@@ -1187,6 +1606,13 @@ DeepData::merge_deep_pixels(int64_t pixel, const DeepData& src, int srcpixel)
 
     // Need to merge the pixels
 
+    if (m_impl->m_float_or_half && same_channeltypes(src)
+        && m_impl->m_z_channel >= 0 && src.m_impl->m_allocated) {
+        m_impl->alloc(m_npixels);
+        m_impl->merge_floats(*this, pixel, *src.m_impl, srcpixel);
+        return;
+    }
+
     // First, merge all of src's samples into our pixel
     set_samples(pixel, dstsamples + srcsamples);
     for (int i = 0; i < srcsamples; ++i)
@@ -8,6 +8,7 @@
 
 #include <OpenImageIO/half.h>
 
+#include <OpenImageIO/color.h>
 #include <OpenImageIO/dassert.h>
 #include <OpenImageIO/deepdata.h>
 #include <OpenImageIO/fmath.h>
@@ -118,6 +119,13 @@ public:
               ProgressCallback progress_callback = nullptr,
               void* progress_callback_data       = nullptr,
               DoLock do_lock                     = DoLock(true));
+    // Helper for read(): read all the pixels from `in` into m_localpixels
+    // a band at a time, applying the color processor to each band.
+    bool read_colorconverted(ImageInput* in, int subimage, int miplevel,
+                             int chbegin, int chend,
+                             const ColorProcessor* processor,
+                             ProgressCallback progress_callback,
+                             void* progress_callback_data);
     void copy_metadata(const ImageBufImpl& src);
 
     // Note: Uses std::format syntax
@@ -1141,6 +1149,39 @@ ImageBufImpl::read(int subimage, int miplevel, int chbegin, int chend,
 
     m_pixelaspect = m_spec.get_float_attribute("pixelaspectratio", 1.0f);
 
+    // Color conversion of the pixels as they are read, requested by the
+    // "oiio:ConvertToColorSpace" config hint. It happens a band at a time
+    // in the direct read below, so it needs to bypass the cache.
+    ColorProcessorHandle colorprocessor;
+    string_view convert_to = m_configspec ? m_configspec->get_string_attribute(
+                                 "oiio:ConvertToColorSpace")
+                                          : string_view();
+    if (convert_to.size()) {
+        string_view convert_from = m_configspec->get_string_attribute(
+            "oiio:ConvertFromColorSpace", m_nativespec.get_string_attribute(
+                                              "oiio:ColorSpace"));
+        if (convert_from.empty()) {
+            error("Cannot convert {} to color space \"{}\": unknown "
+                  "color space of the file",
+                  m_name, convert_to);
+            m_pixels_valid = false;
+            return false;
+        }
+        const ColorConfig& colorconfig(ColorConfig::default_colorconfig());
+        if (!colorconfig.equivalent(convert_from, convert_to)) {
+            colorprocessor = colorconfig.createColorProcessor(convert_from,
+                                                              convert_to);
+            if (!colorprocessor) {
+                error("Could not construct the color transform {} -> {}: {}",
+                      convert_from, convert_to, colorconfig.geterror());
+                m_pixels_valid = false;
+                return false;
+            }
+            force = true;
+        }
+        m_spec.set_colorspace(convert_to);
+    }
+
     if (m_imagecache) {
         // If we don't already have "local" pixels, and we aren't asking to
         // convert the pixels to a specific (and different) type, then take an
@@ -1230,10 +1271,17 @@ ImageBufImpl::read(int subimage, int miplevel, int chbegin, int chend,
                                    m_rioproxy);
         if (in) {
             in->threads(threads());  // Pass on our thread policy
-            bool ok = in->read_image(subimage, miplevel, chbegin, chend,
-                                     m_spec.format, m_localpixels, AutoStride,
-                                     AutoStride, AutoStride, progress_callback,
-                                     progress_callback_data);
+            bool ok;
+            if (colorprocessor)
+                ok = read_colorconverted(in.get(), subimage, miplevel, chbegin,
+                                         chend, colorprocessor.get(),
+                                         progress_callback,
+                                         progress_callback_data);
+            else
+                ok = in->read_image(subimage, miplevel, chbegin, chend,
+                                    m_spec.format, m_localpixels, AutoStride,
+                                    AutoStride, AutoStride, progress_callback,
+                                    progress_callback_data);
             in->close();
             if (ok) {
                 m_pixels_valid = true;
@@ -1288,6 +1336,88 @@ ImageBufImpl::read(int subimage, int miplevel, int chbegin, int chend,
 
 
 
+bool
+ImageBufImpl::read_colorconverted(ImageInput* in, int subimage, int miplevel,
+                                  int chbegin, int chend,
+                                  const ColorProcessor* processor,
+                                  ProgressCallback progress_callback,
+                                  void* progress_callback_data)
+{
+    // Bands are whole rows of tiles, or enough scanlines for about 256K
+    // pixels, so that each band is still in cache when it's converted to
+    // the buffer's type after the color transform.
+    const ImageSpec& spec(m_spec);
+    int bandheight = std::max(1, (1 << 18) / std::max(1, spec.width));
+    if (m_nativespec.tile_width)
+        bandheight = round_to_multiple(bandheight, m_nativespec.tile_height);
+    bandheight = std::min(bandheight, spec.height);
+    if (m_nativespec.tile_depth > 1) {
+        // Volume tiles can't be read a plane at a time. Read everything,
+        // then color convert in place.
+        bool ok = in->read_image(subimage, miplevel, chbegin, chend,
+                                 spec.format, m_localpixels, AutoStride,
+                                 AutoStride, AutoStride, progress_callback,
+                                 progress_callback_data);
+        if (ok) {
+            ImageBuf wrapper(spec, m_localpixels);
+            ok = ImageBufAlgo::colorconvert(wrapper, wrapper, processor, true,
+                                            ROI(), threads());
+            if (!ok)
+                error("{}", wrapper.geterror());
+        }
+        return ok;
+    }
+
+    ImageSpec bandspec(spec);
+    bandspec.height = bandheight;
+    bandspec.set_format(TypeFloat);
+    bandspec.channelformats.clear();
+    bandspec.tile_width  = 0;
+    bandspec.tile_height = 0;
+    bandspec.tile_depth  = 1;
+    std::unique_ptr<float[]> band(new float[bandspec.image_pixels()
+                                            * bandspec.nchannels]);
+    if (progress_callback && progress_callback(progress_callback_data, 0.0f))
+        return false;
+    for (int z = spec.z; z < spec.z + spec.depth; ++z) {
+        for (int y = spec.y; y < spec.y + spec.height; y += bandheight) {
+            int yend = std::min(y + bandheight, spec.y + spec.height);
+            bool ok;
+            if (m_nativespec.tile_width)
+                ok = in->read_tiles(subimage, miplevel, spec.x,
+                                    spec.x + spec.width, y, yend, z, z + 1,
+                                    chbegin, chend, TypeFloat, band.get());
+            else
+                ok = in->read_scanlines(subimage, miplevel, y, yend, z,
+                                        chbegin, chend, TypeFloat, band.get());
+            if (!ok)
+                return false;  // caller will report the ImageInput error
+            bandspec.y      = y;
+            bandspec.z      = z;
+            bandspec.height = yend - y;
+            ImageBuf bandbuf(bandspec, band.get());
+            if (!ImageBufAlgo::colorconvert(bandbuf, bandbuf, processor, true,
+                                            ROI(), threads())) {
+                error("{}", bandbuf.geterror());
+                return false;
+            }
+            convert_image(spec.nchannels, spec.width, yend - y, 1, band.get(),
+                          TypeFloat, AutoStride, AutoStride, AutoStride,
+                          pixeladdr(spec.x, y, z, 0), spec.format, m_xstride,
+                          m_ystride, m_zstride);
+            if (progress_callback
+                && progress_callback(progress_callback_data,
+                                     float(yend - spec.y + (z - spec.z)
+                                                                * spec.height)
+                                         / float(spec.height * spec.depth)))
+                return false;
+        }
+    }
+    return true;
+}
+
+
+
 bool
 ImageBuf::read(int subimage, int miplevel, bool force, TypeDesc convert,
                ProgressCallback progress_callback, void* progress_callback_data)
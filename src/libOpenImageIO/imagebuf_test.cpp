@@ -426,6 +426,48 @@ test_read_channel_subset()
 
 
 
+void
+test_read_colorconvert()
+{
+    std::cout << "\nTesting color conversion at read time\n";
+
+    // Write an sRGB uint8 image tall enough to be read in several bands.
+    ImageSpec spec(300, 1000, 4, TypeUInt8);
+    spec.alpha_channel = 3;
+    spec.set_colorspace("sRGB");
+    ImageBuf A(spec);
+    const float tl[] = { 0.1f, 0.2f, 0.9f, 1.0f };
+    const float tr[] = { 0.9f, 0.5f, 0.1f, 0.5f };
+    const float bl[] = { 0.0f, 0.7f, 0.3f, 1.0f };
+    const float br[] = { 1.0f, 1.0f, 1.0f, 0.25f };
+    ImageBufAlgo::fill(A, tl, tr, bl, br);
+    A.write("colorconvert_imagebuf_test.tif");
+
+    // Reference: read as float, then color convert the whole image.
+    ImageBuf R("colorconvert_imagebuf_test.tif");
+    R.read(0, 0, true, TypeFloat);
+    R = ImageBufAlgo::colorconvert(R, "sRGB", "linear");
+
+    ImageSpec config;
+    config.attribute("oiio:ConvertToColorSpace", "linear");
+    ImageBuf B("colorconvert_imagebuf_test.tif", 0, 0, nullptr, &config);
+    OIIO_CHECK_ASSERT(B.read(0, 0, false, TypeFloat));
+    OIIO_CHECK_EQUAL(B.spec().get_string_attribute("oiio:ColorSpace"),
+                     "linear");
+    auto comp = ImageBufAlgo::compare(B, R, 1.0e-5f, 1.0e-5f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+
+    // Converting to half must give the same result as converting the
+    // float reference to half.
+    ImageBuf H("colorconvert_imagebuf_test.tif", 0, 0, nullptr, &config);
+    OIIO_CHECK_ASSERT(H.read(0, 0, false, TypeHalf));
+    OIIO_CHECK_EQUAL(H.spec().format, TypeHalf);
+    comp = ImageBufAlgo::compare(H, R, 2.0e-3f, 2.0e-3f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+}
+
+
+
 void
 test_roi()
 {
@@ -599,6 +641,14 @@ time_iterators()
             }
     });
     OIIO_CHECK_EQUAL(sum, 2.5 * rez * rez);
+    bench("Read traversal with RowReader", [&]() {
+        sum = 0.0f;
+        ImageBuf::RowReader<float> r(img, img.roi());
+        for (int y = 0; y < rez; ++y)
+            for (float v : r.row(y))
+                sum += v;
+    });
+    OIIO_CHECK_EQUAL(sum, 2.5 * rez * rez);
     bench("Write traversal with Iterator", [&]() {
         ImageBuf::Iterator<float> it(img);
         for (ImageBuf::Iterator<float> it(img); !it.done(); ++it) {
@@ -606,6 +656,12 @@ time_iterators()
                 it[c] = 0.5f;
         }
     });
+    bench("Write traversal with RowWriter", [&]() {
+        ImageBuf::RowWriter<float> w(img, img.roi());
+        for (int y = 0; y < rez; ++y)
+            for (float& v : w.row(y))
+                v = 0.5f;
+    });
     bench("Write traversal with pointer", [&]() {
         float* it = (float*)img.localpixels();
         for (int y = 0; y < rez; ++y)
@@ -618,6 +674,53 @@ time_iterators()
 
 
 
+void
+test_row_access()
+{
+    print("Testing RowReader/RowWriter\n");
+    const int xres  = 8, yres = 4, nchans = 3;
+    const float eps = 1.0f / 255.0f;  // uint8 quantization
+    for (TypeDesc t : { TypeFloat, TypeHalf, TypeUInt8 }) {
+        ImageSpec spec(xres, yres, nchans, t);
+        ImageBuf A(spec);
+        ImageBufAlgo::fill(A, { 0.25f, 0.5f, 1.0f });
+
+        // Whole rows, all channels
+        ImageBuf::RowReader<float> a(A, A.roi());
+        cspan<float> row = a.row(1);
+        OIIO_CHECK_EQUAL(row.size(), size_t(xres * nchans));
+        OIIO_CHECK_EQUAL_THRESH(row[3], 0.25f, eps);
+        OIIO_CHECK_EQUAL_THRESH(row[5], 1.0f, eps);
+
+        // A channel subset, partly outside the data window
+        ImageBuf::RowReader<float> b(A, ROI(-2, 2, 0, yres, 0, 1, 1, 3));
+        row = b.row(0);
+        OIIO_CHECK_EQUAL(row.size(), size_t(4 * 2));
+        OIIO_CHECK_EQUAL_THRESH(row[0], 0.0f, eps);
+        OIIO_CHECK_EQUAL_THRESH(row[3], 0.0f, eps);
+        OIIO_CHECK_EQUAL_THRESH(row[4], 0.5f, eps);
+        OIIO_CHECK_EQUAL_THRESH(row[5], 1.0f, eps);
+        row = b.row(yres);  // entirely outside
+        OIIO_CHECK_EQUAL_THRESH(row[4], 0.0f, eps);
+
+        // Write one channel of a region that hangs off the right edge
+        {
+            ImageBuf::RowWriter<float> r(A, ROI(6, 10, 2, 3, 0, 1, 2, 3));
+            span<float> wrow = r.row(2);
+            for (auto& v : wrow)
+                v = 0.75f;
+        }
+        float pixel[nchans];
+        A.getpixel(7, 2, pixel);
+        OIIO_CHECK_EQUAL_THRESH(pixel[0], 0.25f, eps);
+        OIIO_CHECK_EQUAL_THRESH(pixel[2], 0.75f, eps);
+        A.getpixel(5, 2, pixel);
+        OIIO_CHECK_EQUAL_THRESH(pixel[2], 1.0f, eps);
+    }
+}
+
+
+
 void
 test_iterator_concurrency()
 {
@@ -698,12 +801,14 @@ main(int /*argc*/, char* /*argv*/[])
                                                        "mirror");
     test_mutable_iterator_with_imagecache();
     time_iterators();
+    test_row_access();
     test_iterator_concurrency();
 
     ImageBuf_test_appbuffer();
     ImageBuf_test_appbuffer_strided();
     test_open_with_config();
     test_read_channel_subset();
+    test_read_colorconvert();
 
     test_set_get_pixels();
     time_get_pixels();
@@ -4,6 +4,7 @@
 
 #include <cmath>
 #include <memory>
+#include <vector>
 
 #include <OpenImageIO/half.h>
 
@@ -13,6 +14,7 @@
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imagebufalgo_util.h>
 #include <OpenImageIO/platform.h>
+#include <OpenImageIO/simd.h>
 #include <OpenImageIO/thread.h>
 
 #include "imageio_pvt.h"
@@ -1150,85 +1152,216 @@ ImageBufAlgo::complex_to_polar(const ImageBuf& src, ROI roi, int nthreads)
 
 
 
-// Helper for fillholes_pp: for any nonzero alpha pixels in dst, divide
-// all components by alpha.
-static bool
-divide_by_alpha(ImageBuf& dst, ROI roi, int nthreads)
+// Helpers for fillholes_pushpull. The whole pyramid lives in one
+// preallocated float buffer, each level a contiguous, channel-interleaved
+// w x h image. Levels are built and consumed with dedicated separable
+// kernels rather than general filtered resizes.
+namespace {
+
+struct PushPullLevel {
+    int w, h;
+    float* pixels;
+};
+
+
+// Per-output-coordinate taps for scaling an axis of length `srcres` to
+// `dstres`, as a tent filter of source-pixel radius `radius`. These are the
+// taps resize() uses with the "triangle" filter, which the push-pull was
+// originally built on: a radius of srcres/dstres for the reduction (the
+// classic 1-3-3-1 kernel for an exact 2x, wider for odd sizes), and 1 for
+// the expansion, which is bilinear. Indices are clamped to the source and
+// weights are normalized.
+struct PushPullTaps {
+    int taps;
+    std::vector<int> index;
+    std::vector<float> weight;
+
+    PushPullTaps(int dstres, int srcres, float radius)
+        : taps(2 * int(ceilf(radius)))
+        , index(size_t(dstres) * taps)
+        , weight(size_t(dstres) * taps)
+    {
+        float scale = float(srcres) / float(dstres);
+        for (int i = 0; i < dstres; ++i) {
+            // Center of output pixel i, in continuous source pixel coords
+            float center = (i + 0.5f) * scale - 0.5f;
+            int first    = ifloor(center) - taps / 2 + 1;
+            float total  = 0.0f;
+            for (int t = 0; t < taps; ++t) {
+                float d = fabsf(float(first + t) - center);
+                float w = std::max(0.0f, 1.0f - d / radius);
+                index[i * taps + t]  = clamp(first + t, 0, srcres - 1);
+                weight[i * taps + t] = w;
+                total += w;
+            }
+            for (int t = 0; t < taps; ++t)
+                weight[i * taps + t] /= total;
+        }
+    }
+};
+
+
+// out[0..nc) += w * in[0..nc), specialized for RGBA.
+template<int NC>
+inline void
+pushpull_madd(float* out, float w, const float* in, int nc)
 {
-    OIIO_ASSERT(dst.spec().format == TypeDesc::FLOAT);
-    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        const ImageSpec& spec(dst.spec());
-        int nc = spec.nchannels;
-        int ac = spec.alpha_channel;
-        for (ImageBuf::Iterator<float> d(dst, roi); !d.done(); ++d) {
-            float alpha = d[ac];
-            if (alpha != 0.0f) {
+    if (NC == 4) {
+        simd::madd(simd::vfloat4(w), simd::vfloat4(in), simd::vfloat4(out))
+            .store(out);
+    } else {
+        for (int c = 0; c < nc; ++c)
+            out[c] += w * in[c];
+    }
+}
+
+
+// Push: reduce level `big` into level `small`, then divide each pixel by
+// its alpha, which "spreads out" the defined part of the image.
+template<int NC>
+void
+pushpull_reduce(const PushPullLevel& big, PushPullLevel& small, int nc,
+                int alpha, int nthreads)
+{
+    PushPullTaps xtaps(small.w, big.w, float(big.w) / float(small.w));
+    PushPullTaps ytaps(small.h, big.h, float(big.h) / float(small.h));
+    ROI levelroi(0, small.w, 0, small.h);
+    ImageBufAlgo::parallel_image(levelroi, nthreads, [&](ROI roi) {
+        std::unique_ptr<float[]> row(new float[size_t(big.w) * nc]);
+        for (int y = roi.ybegin; y < roi.yend; ++y) {
+            // Vertical pass into one full-width row of the big level
+            memset(row.get(), 0, size_t(big.w) * nc * sizeof(float));
+            for (int t = 0, n = ytaps.taps; t < n; ++t) {
+                float w = ytaps.weight[y * n + t];
+                if (w == 0.0f)
+                    continue;
+                const float* in = big.pixels
+                                  + size_t(ytaps.index[y * n + t]) * big.w * nc;
+                for (int x = 0; x < big.w; ++x)
+                    pushpull_madd<NC>(row.get() + x * nc, w, in + x * nc, nc);
+            }
+            // Horizontal pass, then divide by alpha
+            float* out = small.pixels + (size_t(y) * small.w + roi.xbegin) * nc;
+            for (int x = roi.xbegin; x < roi.xend; ++x, out += nc) {
                 for (int c = 0; c < nc; ++c)
-                    d[c] = d[c] / alpha;
+                    out[c] = 0.0f;
+                for (int t = 0, n = xtaps.taps; t < n; ++t)
+                    pushpull_madd<NC>(out, xtaps.weight[x * n + t],
+                                      row.get() + xtaps.index[x * n + t] * nc,
+                                      nc);
+                float a = out[alpha];
+                if (a != 0.0f) {
+                    float inva = 1.0f / a;
+                    for (int c = 0; c < nc; ++c)
+                        out[c] *= inva;
+                }
             }
         }
     });
-    return true;
 }
 
 
+// Pull: composite level `big` over the bilinear expansion of level
+// `small`, in place, filling the alpha holes of `big`.
+template<int NC>
+void
+pushpull_expand(PushPullLevel& big, const PushPullLevel& small, int nc,
+                int alpha, int nthreads)
+{
+    PushPullTaps xtaps(big.w, small.w, 1.0f);
+    PushPullTaps ytaps(big.h, small.h, 1.0f);
+    ROI levelroi(0, big.w, 0, big.h);
+    ImageBufAlgo::parallel_image(levelroi, nthreads, [&](ROI roi) {
+        float* blowup = OIIO_ALLOCA(float, nc);
+        for (int y = roi.ybegin; y < roi.yend; ++y) {
+            const float* r0 = small.pixels
+                              + size_t(ytaps.index[y * 2]) * small.w * nc;
+            const float* r1 = small.pixels
+                              + size_t(ytaps.index[y * 2 + 1]) * small.w * nc;
+            float wy0 = ytaps.weight[y * 2];
+            float wy1 = ytaps.weight[y * 2 + 1];
+            float* p  = big.pixels + (size_t(y) * big.w + roi.xbegin) * nc;
+            for (int x = roi.xbegin; x < roi.xend; ++x, p += nc) {
+                float a = p[alpha];
+                if (a == 1.0f)
+                    continue;  // Fully opaque, nothing to fill
+                int x0    = xtaps.index[x * 2] * nc;
+                int x1    = xtaps.index[x * 2 + 1] * nc;
+                float wx0 = xtaps.weight[x * 2];
+                float wx1 = xtaps.weight[x * 2 + 1];
+                for (int c = 0; c < nc; ++c)
+                    blowup[c] = 0.0f;
+                pushpull_madd<NC>(blowup, wy0 * wx0, r0 + x0, nc);
+                pushpull_madd<NC>(blowup, wy0 * wx1, r0 + x1, nc);
+                pushpull_madd<NC>(blowup, wy1 * wx0, r1 + x0, nc);
+                pushpull_madd<NC>(blowup, wy1 * wx1, r1 + x1, nc);
+                // p = p over blowup
+                pushpull_madd<NC>(p, 1.0f - a, blowup, nc);
+            }
+        }
+    });
+}
+
+}  // namespace
+
+
 
 bool
 ImageBufAlgo::fillholes_pushpull(ImageBuf& dst, const ImageBuf& src, ROI roi,
                                  int nthreads)
 {
-    // N.B. Don't log time, it will be caught by the constituent parts
+    pvt::LoggedTimer logtime("IBA::fillholes_pushpull");
     const int req = (IBAprep_REQUIRE_SAME_NCHANNELS | IBAprep_REQUIRE_ALPHA
                      | IBAprep_NO_SUPPORT_VOLUME);
     if (!IBAprep(roi, &dst, &src, req))
         return false;
-    // We generate a bunch of temp images to form an image pyramid.
-    // These give us a place to stash them and make sure they are
-    // auto-deleted when the function exits.
-    std::vector<std::shared_ptr<ImageBuf>> pyramid;
-
-    // First, make a writable copy of the original image (converting
-    // to float as a convenience) as the top level of the pyramid.
-    ImageSpec topspec = src.spec();
-    topspec.set_format(TypeDesc::FLOAT);
-    ImageBuf* top = new ImageBuf(topspec);
-    paste(*top, topspec.x, topspec.y, topspec.z, 0, src);
-    pyramid.emplace_back(top);
-
-    // Construct the rest of the pyramid by successive x/2 resizing and
-    // then dividing nonzero alpha pixels by their alpha (this "spreads
-    // out" the defined part of the image).
-    int w = src.spec().width, h = src.spec().height;
-    while (w > 1 || h > 1) {
-        w = std::max(1, w / 2);
-        h = std::max(1, h / 2);
-        ImageSpec smallspec(w, h, src.nchannels(), TypeDesc::FLOAT);
-        smallspec.alpha_channel = topspec.alpha_channel;
-        ImageBuf* small         = new ImageBuf(smallspec);
-        ImageBufAlgo::resize(*small, *pyramid.back(), "triangle");
-        divide_by_alpha(*small, get_roi(smallspec), nthreads);
-        pyramid.emplace_back(small);
-        // small->write(Strutil::fmt::format("push{:04d}.exr", small->spec().width));
+    const ImageSpec& srcspec(src.spec());
+    const int nc    = srcspec.nchannels;
+    const int alpha = srcspec.alpha_channel;
+
+    // Lay out all the levels of the pyramid (each x/2 in size) in one
+    // float buffer, so there is just a single allocation.
+    std::vector<PushPullLevel> pyramid;
+    size_t total = 0;
+    for (int w = srcspec.width, h = srcspec.height;;
+         w = std::max(1, w / 2), h = std::max(1, h / 2)) {
+        pyramid.push_back({ w, h, nullptr });
+        total += size_t(w) * size_t(h) * nc;
+        if (w == 1 && h == 1)
+            break;
+    }
+    std::unique_ptr<float[]> buffer(new float[total]);
+    float* p = buffer.get();
+    for (auto& level : pyramid) {
+        level.pixels = p;
+        p += size_t(level.w) * size_t(level.h) * nc;
     }
 
-    // Now pull back up the pyramid by doing an alpha composite of level
-    // i over a resized level i+1, thus filling in the alpha holes.  By
-    // time we get to the top, pixels whose original alpha are
-    // unchanged, those with alpha < 1 are replaced by the blended
-    // colors of the higher pyramid levels.
-    for (int i = (int)pyramid.size() - 2; i >= 0; --i) {
-        ImageBuf &big(*pyramid[i]), &small(*pyramid[i + 1]);
-        ImageBuf blowup(big.spec());
-        ImageBufAlgo::resize(blowup, small, "triangle");
-        ImageBufAlgo::over(big, big, blowup);
-        // big.write(Strutil::sprintf("pull{:04}.exr", big.spec().width));
+    // The top level is a float copy of the original image.
+    if (!src.get_pixels(src.roi(), TypeFloat, pyramid[0].pixels)) {
+        dst.errorfmt("{}", src.geterror());
+        return false;
     }
 
-    // Now copy the completed base layer of the pyramid back to the
-    // original requested output.
-    paste(dst, src.spec().x, src.spec().y, src.spec().z, 0, *pyramid[0]);
+    auto reduce = nc == 4 ? pushpull_reduce<4> : pushpull_reduce<0>;
+    auto expand = nc == 4 ? pushpull_expand<4> : pushpull_expand<0>;
 
-    return true;
+    // Push: construct the rest of the pyramid by successive reductions.
+    for (size_t i = 1; i < pyramid.size(); ++i)
+        reduce(pyramid[i - 1], pyramid[i], nc, alpha, nthreads);
+
+    // Pull: back up the pyramid, compositing level i over the expanded
+    // level i+1, thus filling in the alpha holes. By the time we get to
+    // the top, pixels whose original alpha was 1 are unchanged, and those
+    // with alpha < 1 are blended with the colors of the higher levels.
+    for (int i = (int)pyramid.size() - 2; i >= 0; --i)
+        expand(pyramid[i], pyramid[i + 1], nc, alpha, nthreads);
+
+    // Copy the completed base layer of the pyramid to the requested output.
+    ImageSpec topspec = srcspec;
+    topspec.set_format(TypeDesc::FLOAT);
+    ImageBuf top(topspec, pyramid[0].pixels);
+    return paste(dst, srcspec.x, srcspec.y, srcspec.z, 0, top);
 }
 
 
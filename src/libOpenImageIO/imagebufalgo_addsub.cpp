@@ -24,34 +24,43 @@
 OIIO_NAMESPACE_BEGIN
 
 
-template<class Rtype, class Atype, class Btype>
 static bool
 add_impl(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, ROI roi,
          int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        ImageBuf::ConstIterator<Btype> b(B, roi);
-        for (; !r.done(); ++r, ++a, ++b)
-            for (int c = roi.chbegin; c < roi.chend; ++c)
-                r[c] = a[c] + b[c];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        size_t nvalues = size_t(roi.width()) * size_t(roi.nchannels());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                for (size_t i = 0; i < nvalues; ++i)
+                    rrow[i] = arow[i] + brow[i];
+            }
     });
     return true;
 }
 
 
 
-template<class Rtype, class Atype>
 static bool
 add_impl(ImageBuf& R, const ImageBuf& A, cspan<float> b, ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        for (; !r.done(); ++r, ++a)
-            for (int c = roi.chbegin; c < roi.chend; ++c)
-                r[c] = a[c] + b[c];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        std::vector<float> brow = pvt::constant_row(b, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                for (size_t i = 0, n = brow.size(); i < n; ++i)
+                    rrow[i] = arow[i] + brow[i];
+            }
     });
     return true;
 }
@@ -95,10 +104,7 @@ ImageBufAlgo::add(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             return false;
         ROI origroi = roi;
         roi.chend = std::min(roi.chend, std::min(A.nchannels(), B.nchannels()));
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES3(ok, "add", add_impl, dst.spec().format,
-                                    A.spec().format, B.spec().format, dst, A, B,
-                                    roi, nthreads);
+        bool ok = add_impl(dst, A, B, roi, nthreads);
         if (roi.chend < origroi.chend && A.nchannels() != B.nchannels()) {
             // Edge case: A and B differed in nchannels, we allocated dst to be
             // the bigger of them, but adjusted roi to be the lesser. Now handle
@@ -129,10 +135,7 @@ ImageBufAlgo::add(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             dst.deepdata()->set_all_samples(A.deepdata()->all_samples());
             return add_impl_deep(dst, A, b, roi, nthreads);
         }
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES2(ok, "add", add_impl, dst.spec().format,
-                                    A.spec().format, dst, A, b, roi, nthreads);
-        return ok;
+        return add_impl(dst, A, b, roi, nthreads);
     }
     // Remaining cases: error
     dst.errorfmt("ImageBufAlgo::add(): at least one argument must be an image");
@@ -153,18 +156,23 @@ ImageBufAlgo::add(Image_or_Const A, Image_or_Const B, ROI roi, int nthreads)
 
 
 
-template<class Rtype, class Atype, class Btype>
 static bool
 sub_impl(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, ROI roi,
          int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        ImageBuf::ConstIterator<Btype> b(B, roi);
-        for (; !r.done(); ++r, ++a, ++b)
-            for (int c = roi.chbegin; c < roi.chend; ++c)
-                r[c] = a[c] - b[c];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        size_t nvalues = size_t(roi.width()) * size_t(roi.nchannels());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                for (size_t i = 0; i < nvalues; ++i)
+                    rrow[i] = arow[i] - brow[i];
+            }
     });
     return true;
 }
@@ -182,10 +190,7 @@ ImageBufAlgo::sub(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             return false;
         ROI origroi = roi;
         roi.chend = std::min(roi.chend, std::min(A.nchannels(), B.nchannels()));
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES3(ok, "sub", sub_impl, dst.spec().format,
-                                    A.spec().format, B.spec().format, dst, A, B,
-                                    roi, nthreads);
+        bool ok = sub_impl(dst, A, B, roi, nthreads);
         if (roi.chend < origroi.chend && A.nchannels() != B.nchannels()) {
             // Edge case: A and B differed in nchannels, we allocated dst to be
             // the bigger of them, but adjusted roi to be the lesser. Now handle
@@ -222,10 +227,7 @@ ImageBufAlgo::sub(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             dst.deepdata()->set_all_samples(A.deepdata()->all_samples());
             return add_impl_deep(dst, A, b, roi, nthreads);
         }
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES2(ok, "sub", add_impl, dst.spec().format,
-                                    A.spec().format, dst, A, b, roi, nthreads);
-        return ok;
+        return add_impl(dst, A, b, roi, nthreads);
     }
     // Remaining cases: error
     dst.errorfmt("ImageBufAlgo::sub(): at least one argument must be an image");
@@ -14,6 +14,7 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imagebufalgo_util.h>
+#include <OpenImageIO/simd.h>
 #include <OpenImageIO/thread.h>
 #include <OpenImageIO/timer.h>
 
@@ -23,16 +24,37 @@
 OIIO_NAMESPACE_BEGIN
 
 
+// Deep operations change the sample counts of the pixels they touch, and
+// in the default contiguous storage of DeepData that isn't safe to do from
+// several threads at once. With chunked storage, growing a pixel only moves
+// data within its own chunk, so use one chunk per scanline: parallel_image
+// splits in y, so each thread owns whole rows of dst. Return the number of
+// threads to use (only one, if dst already had a chunking of its own that
+// doesn't line up with the rows).
+static int
+deep_parallel_prep(ImageBuf& dst, int nthreads)
+{
+    DeepData& dd(*dst.deepdata());
+    int64_t width = dst.spec().width;
+    if (!dd.chunked())
+        dd.set_chunked(width);
+    return (width % dd.chunked() == 0) ? nthreads : 1;
+}
+
+
+
 // FIXME -- NOT CORRECT!  This code assumes sorted, non-overlapping samples.
 // That is not a valid assumption in general. We will come back to fix this.
 template<class DSTTYPE>
 static bool
 flatten_(ImageBuf& dst, const ImageBuf& src, ROI roi, int nthreads)
 {
+    using namespace simd;
     ImageBufAlgo::parallel_image(roi, nthreads, [=, &dst, &src](ROI roi) {
         const ImageSpec& srcspec(src.spec());
         const DeepData* dd = src.deepdata();
         int nc             = srcspec.nchannels;
+        int nc4            = round_to_multiple(nc, 4);
         int AR_channel     = dd->AR_channel();
         int AG_channel     = dd->AG_channel();
         int AB_channel     = dd->AB_channel();
@@ -41,16 +63,40 @@ flatten_(ImageBuf& dst, const ImageBuf& src, ROI roi, int nthreads)
         int R_channel      = srcspec.channelindex("R");
         int G_channel      = srcspec.channelindex("G");
         int B_channel      = srcspec.channelindex("B");
-        float* val         = OIIO_ALLOCA(float, nc);
+        bool allfloat      = (dd->samplesize() == nc * sizeof(float));
+        float* val         = OIIO_ALLOCA(float, nc4);
+        float* sampleval   = OIIO_ALLOCA(float, nc4);
         float& ARval(val[AR_channel]);
         float& AGval(val[AG_channel]);
         float& ABval(val[AB_channel]);
 
+        // Each sample is composited over all channels at once, 4 at a time.
+        // The opacity used for channel c is
+        //     selR[c]*AR + selG[c]*AG + selB[c]*AB + selA[c]*alpha
+        // and the Z channels (which are not premultiplied) are scaled by
+        // alpha where selZ[c] is 1.
+        float* sel = OIIO_ALLOCA(float, 5 * nc4);
+        memset(sel, 0, 5 * nc4 * sizeof(float));
+        float *selR = sel, *selG = sel + nc4, *selB = sel + 2 * nc4;
+        float *selA = sel + 3 * nc4, *selZ = sel + 4 * nc4;
+        for (int c = 0; c < nc; ++c) {
+            if (c == R_channel)
+                selR[c] = 1.0f;
+            else if (c == G_channel)
+                selG[c] = 1.0f;
+            else if (c == B_channel)
+                selB[c] = 1.0f;
+            else
+                selA[c] = 1.0f;
+            if (c == Z_channel || c == Zback_channel)
+                selZ[c] = 1.0f;
+        }
+
         for (ImageBuf::Iterator<DSTTYPE> r(dst, roi); !r.done(); ++r) {
-            int x = r.x(), y = r.y(), z = r.z();
-            int samps = src.deep_samples(x, y, z);
+            int64_t pixel = src.pixelindex(r.x(), r.y(), r.z(), true);
+            int samps     = dd->samples(pixel);
             // Clear accumulated values for this pixel (0 for colors, big for Z)
-            memset(val, 0, nc * sizeof(float));
+            memset(val, 0, nc4 * sizeof(float));
             if (Z_channel >= 0 && samps == 0)
                 val[Z_channel] = 1.0e30;
             if (Zback_channel >= 0 && samps == 0)
@@ -60,20 +106,23 @@ flatten_(ImageBuf& dst, const ImageBuf& src, ROI roi, int nthreads)
                 float alpha = (AR + AG + AB) / 3.0f;
                 if (alpha >= 1.0f)
                     break;
-                for (int c = 0; c < nc; ++c) {
-                    float v = src.deep_value(x, y, z, c, s);
-                    if (c == Z_channel || c == Zback_channel)
-                        val[c] *= alpha;  // because Z are not premultiplied
-                    float a;
-                    if (c == R_channel)
-                        a = AR;
-                    else if (c == G_channel)
-                        a = AG;
-                    else if (c == B_channel)
-                        a = AB;
-                    else
-                        a = alpha;
-                    val[c] += (1.0f - a) * v;
+                const float* v = sampleval;
+                if (allfloat)
+                    v = (const float*)dd->data_ptr(pixel, 0, s);
+                else
+                    for (int c = 0; c < nc; ++c)
+                        sampleval[c] = dd->deep_value(pixel, c, s);
+                vfloat4 one(1.0f), vAR(AR), vAG(AG), vAB(AB), valpha(alpha);
+                for (int c = 0; c < nc; c += 4) {
+                    vfloat4 sv;
+                    sv.load(v + c, std::min(4, nc - c));
+                    vfloat4 a = vfloat4(selR + c) * vAR
+                                + vfloat4(selG + c) * vAG
+                                + vfloat4(selB + c) * vAB
+                                + vfloat4(selA + c) * valpha;
+                    vfloat4 zscale = one + vfloat4(selZ + c) * (valpha - one);
+                    vfloat4 acc    = vfloat4(val + c) * zscale + (one - a) * sv;
+                    acc.store(val + c);
                 }
             }
 
@@ -256,94 +305,37 @@ ImageBufAlgo::deep_merge(ImageBuf& dst, const ImageBuf& A, const ImageBuf& B,
         return false;
     }
 
-    // First, set the capacity of the dst image to reserve enough space for
-    // the segments of both source images, including any splits that may
-    // occur.
+    // First, reserve enough space in each dst pixel for the samples of
+    // both source images. Any splits will grow it further, but with the
+    // chunked storage set up here that doesn't disturb other pixels.
+    nthreads = deep_parallel_prep(dst, nthreads);
     DeepData& dstdd(*dst.deepdata());
     const DeepData& Add(*A.deepdata());
     const DeepData& Bdd(*B.deepdata());
-    int Azchan     = Add.Z_channel();
-    int Azbackchan = Add.Zback_channel();
-    int Bzchan     = Bdd.Z_channel();
-    int Bzbackchan = Bdd.Zback_channel();
     for (int z = roi.zbegin; z < roi.zend; ++z)
         for (int y = roi.ybegin; y < roi.yend; ++y)
             for (int x = roi.xbegin; x < roi.xend; ++x) {
-                int dstpixel            = dst.pixelindex(x, y, z, true);
-                int Apixel              = A.pixelindex(x, y, z, true);
-                int Bpixel              = B.pixelindex(x, y, z, true);
-                int Asamps              = Add.samples(Apixel);
-                int Bsamps              = Bdd.samples(Bpixel);
-                int nsplits             = 0;
-                int self_overlap_splits = 0;
-                for (int s = 0; s < Asamps; ++s) {
-                    float src_z     = Add.deep_value(Apixel, Azchan, s);
-                    float src_zback = Add.deep_value(Apixel, Azbackchan, s);
-                    for (int d = 0; d < Bsamps; ++d) {
-                        float dst_z     = Bdd.deep_value(Bpixel, Bzchan, d);
-                        float dst_zback = Bdd.deep_value(Bpixel, Bzbackchan, d);
-                        if (src_z > dst_z && src_z < dst_zback)
-                            ++nsplits;
-                        if (src_zback > dst_z && src_zback < dst_zback)
-                            ++nsplits;
-                        if (dst_z > src_z && dst_z < src_zback)
-                            ++nsplits;
-                        if (dst_zback > src_z && dst_zback < src_zback)
-                            ++nsplits;
-                    }
-                    // Check for splits src vs src -- in case they overlap!
-                    for (int ss = s; ss < Asamps; ++ss) {
-                        float src_z2     = Add.deep_value(Apixel, Azchan, ss);
-                        float src_zback2 = Add.deep_value(Apixel, Azbackchan,
-                                                          ss);
-                        if (src_z2 > src_z && src_z2 < src_zback)
-                            ++self_overlap_splits;
-                        if (src_zback2 > src_z && src_zback2 < src_zback)
-                            ++self_overlap_splits;
-                        if (src_z > src_z2 && src_z < src_zback2)
-                            ++self_overlap_splits;
-                        if (src_zback > src_z2 && src_zback < src_zback2)
-                            ++self_overlap_splits;
-                    }
-                }
-                // Check for splits dst vs dst -- in case they overlap!
-                for (int d = 0; d < Bsamps; ++d) {
-                    float dst_z     = Bdd.deep_value(Bpixel, Bzchan, d);
-                    float dst_zback = Bdd.deep_value(Bpixel, Bzbackchan, d);
-                    for (int dd = d; dd < Bsamps; ++dd) {
-                        float dst_z2     = Bdd.deep_value(Bpixel, Bzchan, dd);
-                        float dst_zback2 = Bdd.deep_value(Bpixel, Bzbackchan,
-                                                          dd);
-                        if (dst_z2 > dst_z && dst_z2 < dst_zback)
-                            ++self_overlap_splits;
-                        if (dst_zback2 > dst_z && dst_zback2 < dst_zback)
-                            ++self_overlap_splits;
-                        if (dst_z > dst_z2 && dst_z < dst_zback2)
-                            ++self_overlap_splits;
-                        if (dst_zback > dst_z2 && dst_zback < dst_zback2)
-                            ++self_overlap_splits;
-                    }
-                }
-
-                dstdd.set_capacity(dstpixel, Asamps + Bsamps + nsplits
-                                                 + self_overlap_splits);
+                int dstpixel = dst.pixelindex(x, y, z, true);
+                int Apixel   = A.pixelindex(x, y, z, true);
+                int Bpixel   = B.pixelindex(x, y, z, true);
+                dstdd.set_capacity(dstpixel,
+                                   Add.samples(Apixel) + Bdd.samples(Bpixel));
             }
 
     bool ok = ImageBufAlgo::copy(dst, A, TypeDesc::UNKNOWN, roi, nthreads);
 
-    for (int z = roi.zbegin; z < roi.zend; ++z)
-        for (int y = roi.ybegin; y < roi.yend; ++y)
-            for (int x = roi.xbegin; x < roi.xend; ++x) {
-                int dstpixel = dst.pixelindex(x, y, z, true);
-                int Bpixel   = B.pixelindex(x, y, z, true);
-                OIIO_DASSERT(dstpixel >= 0);
-                // OIIO_UNUSED_OK int oldcap = dstdd.capacity (dstpixel);
-                dstdd.merge_deep_pixels(dstpixel, Bdd, Bpixel);
-                // OIIO_DASSERT (oldcap == dstdd.capacity(dstpixel) &&
-                //          "Broken: we did not preallocate enough capacity");
-                if (occlusion_cull)
-                    dstdd.occlusion_cull(dstpixel);
-            }
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y)
+                for (int x = roi.xbegin; x < roi.xend; ++x) {
+                    int dstpixel = dst.pixelindex(x, y, z, true);
+                    int Bpixel   = B.pixelindex(x, y, z, true);
+                    OIIO_DASSERT(dstpixel >= 0);
+                    dstdd.merge_deep_pixels(dstpixel, Bdd, Bpixel);
+                    if (occlusion_cull)
+                        dstdd.occlusion_cull(dstpixel);
+                }
+    });
     return ok;
 }
 
@@ -364,7 +356,7 @@ ImageBufAlgo::deep_merge(const ImageBuf& A, const ImageBuf& B,
 
 bool
 ImageBufAlgo::deep_holdout(ImageBuf& dst, const ImageBuf& src,
-                           const ImageBuf& thresh, ROI roi, int /*nthreads*/)
+                           const ImageBuf& thresh, ROI roi, int nthreads)
 {
     pvt::LoggedTimer logtime("IBA::deep_holdout");
     if (!src.deep() || !thresh.deep()) {
@@ -378,6 +370,7 @@ ImageBufAlgo::deep_holdout(ImageBuf& dst, const ImageBuf& src,
         return false;
     }
 
+    nthreads = deep_parallel_prep(dst, nthreads);
     DeepData& dstdd(*dst.deepdata());
     const DeepData& srcdd(*src.deepdata());
     // First, reserve enough space in dst, to reduce the number of
@@ -396,37 +389,39 @@ ImageBufAlgo::deep_holdout(ImageBuf& dst, const ImageBuf& src,
     int Zchan     = dstdd.Z_channel();
     int Zbackchan = dstdd.Zback_channel();
     const DeepData& threshdd(*thresh.deepdata());
-    for (ImageBuf::Iterator<float> r(dst, roi); !r.done(); ++r) {
-        int x = r.x(), y = r.y(), z = r.z();
-        int srcpixel = src.pixelindex(x, y, z, true);
-        if (srcpixel < 0)
-            continue;  // Nothing in this pixel
-        int dstpixel = dst.pixelindex(x, y, z, true);
-        dstdd.copy_deep_pixel(dstpixel, srcdd, srcpixel);
-        int threshpixel = thresh.pixelindex(x, y, z, true);
-        if (threshpixel < 0)
-            continue;  // No threshold mask for this pixel
-        float zthresh = threshdd.opaque_z(threshpixel);
-        // Eliminate the samples that are entirely beyond the depth
-        // threshold. Do this before the split; that makes it less
-        // likely that the split will force a re-allocation.
-        for (int s = 0, n = dstdd.samples(dstpixel); s < n; ++s) {
-            if (dstdd.deep_value(dstpixel, Zchan, s) > zthresh) {
-                dstdd.set_samples(dstpixel, s);
-                break;
-            }
-        }
-        // Now split any samples that straddle the z.
-        if (dstdd.split(dstpixel, zthresh)) {
-            // If a split did occur, do another discard pass.
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        for (ImageBuf::Iterator<float> r(dst, roi); !r.done(); ++r) {
+            int x = r.x(), y = r.y(), z = r.z();
+            int srcpixel = src.pixelindex(x, y, z, true);
+            if (srcpixel < 0)
+                continue;  // Nothing in this pixel
+            int dstpixel = dst.pixelindex(x, y, z, true);
+            dstdd.copy_deep_pixel(dstpixel, srcdd, srcpixel);
+            int threshpixel = thresh.pixelindex(x, y, z, true);
+            if (threshpixel < 0)
+                continue;  // No threshold mask for this pixel
+            float zthresh = threshdd.opaque_z(threshpixel);
+            // Eliminate the samples that are entirely beyond the depth
+            // threshold. Do this before the split; that makes it less
+            // likely that the split will force a re-allocation.
             for (int s = 0, n = dstdd.samples(dstpixel); s < n; ++s) {
-                if (dstdd.deep_value(dstpixel, Zbackchan, s) > zthresh) {
+                if (dstdd.deep_value(dstpixel, Zchan, s) > zthresh) {
                     dstdd.set_samples(dstpixel, s);
                     break;
                 }
             }
+            // Now split any samples that straddle the z.
+            if (dstdd.split(dstpixel, zthresh)) {
+                // If a split did occur, do another discard pass.
+                for (int s = 0, n = dstdd.samples(dstpixel); s < n; ++s) {
+                    if (dstdd.deep_value(dstpixel, Zbackchan, s) > zthresh) {
+                        dstdd.set_samples(dstpixel, s);
+                        break;
+                    }
+                }
+            }
         }
-    }
+    });
     return true;
 }
 
@@ -444,4 +439,199 @@ ImageBufAlgo::deep_holdout(const ImageBuf& src, const ImageBuf& thresh, ROI roi,
 }
 
 
+
+bool
+ImageBufAlgo::deep_reduce(ImageBuf& dst, const ImageBuf& src, float ztolerance,
+                          float colortolerance, float opacity,
+                          DeepReduceStats* stats, ROI roi, int nthreads)
+{
+    pvt::LoggedTimer logtime("IBA::deep_reduce");
+    if (!src.deep()) {
+        dst.errorfmt("deep_reduce can only be performed on deep images");
+        return false;
+    }
+    if (!IBAprep(roi, &dst, &src, IBAprep_SUPPORT_DEEP))
+        return false;
+    if (!dst.deep()) {
+        dst.errorfmt("Cannot deep_reduce into a flat image");
+        return false;
+    }
+    if (src.deepdata()->Z_channel() < 0) {
+        dst.errorfmt("deep_reduce requires a Z channel");
+        return false;
+    }
+    nthreads = deep_parallel_prep(dst, nthreads);
+    if (!ImageBufAlgo::copy(dst, src, TypeUnknown, roi, nthreads))
+        return false;
+
+    // Sort out what each channel is. For each channel, alphachan[c] is
+    // the channel holding its alpha (c itself for an alpha), NOALPHA for
+    // channels that must match exactly for samples to merge, or DEPTH.
+    DeepData& dd(*dst.deepdata());
+    const ImageSpec& spec(dst.spec());
+    enum { NOALPHA = -1, DEPTH = -2 };
+    int nc        = dd.channels();
+    int Zchan     = dd.Z_channel();
+    int Zbackchan = dd.Zback_channel();
+    int Achan     = dd.A_channel();
+    int ARchan = dd.AR_channel(), AGchan = dd.AG_channel();
+    int ABchan = dd.AB_channel();
+    std::vector<int> alphachan(nc, NOALPHA);
+    for (int c = 0; c < nc; ++c) {
+        if (c == Zchan || c == Zbackchan)
+            alphachan[c] = DEPTH;
+        else if (dd.channeltype(c) == TypeDesc::UINT32)
+            alphachan[c] = NOALPHA;
+        else if (c == Achan || c == ARchan || c == AGchan || c == ABchan)
+            alphachan[c] = c;
+        else if (c == spec.channelindex("R"))
+            alphachan[c] = ARchan;
+        else if (c == spec.channelindex("G"))
+            alphachan[c] = AGchan;
+        else if (c == spec.channelindex("B"))
+            alphachan[c] = ABchan;
+        else
+            alphachan[c] = Achan;  // NOALPHA if there's no A channel
+    }
+    bool has_alpha = Achan >= 0
+                     || (ARchan >= 0 && AGchan >= 0 && ABchan >= 0);
+
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        auto alpha = [&](int pixel, int s) {
+            if (Achan >= 0)
+                return dd.deep_value(pixel, Achan, s);
+            return (dd.deep_value(pixel, ARchan, s)
+                    + dd.deep_value(pixel, AGchan, s)
+                    + dd.deep_value(pixel, ABchan, s))
+                   / 3.0f;
+        };
+        auto unpremult = [&](int pixel, int c, int s) {
+            float v = dd.deep_value(pixel, c, s);
+            float a = dd.deep_value(pixel, alphachan[c], s);
+            return a > 0.0f ? v / a : v;
+        };
+        // Can sample s be composited into sample t, just in front of it?
+        auto mergeable = [&](int pixel, int t, int s) {
+            if (dd.deep_value(pixel, Zchan, s)
+                > dd.deep_value(pixel, Zbackchan, t) + ztolerance)
+                return false;
+            for (int c = 0; c < nc; ++c) {
+                int ac = alphachan[c];
+                if (ac == DEPTH || ac == c)
+                    continue;
+                if (ac == NOALPHA) {
+                    bool same = (dd.channeltype(c) == TypeDesc::UINT32)
+                                    ? dd.deep_value_uint(pixel, c, s)
+                                          == dd.deep_value_uint(pixel, c, t)
+                                    : dd.deep_value(pixel, c, s)
+                                          == dd.deep_value(pixel, c, t);
+                    if (!same)
+                        return false;
+                } else if (std::abs(unpremult(pixel, c, s)
+                                    - unpremult(pixel, c, t))
+                           > colortolerance) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // Composite sample s into sample t, just in front of it.
+        auto merge = [&](int pixel, int t, int s) {
+            for (int pass = 0; pass < 2; ++pass) {
+                // Colors first, then the alphas they need
+                for (int c = 0; c < nc; ++c) {
+                    int ac = alphachan[c];
+                    if (ac < 0 || (ac == c) != (pass == 1))
+                        continue;
+                    float at = OIIO::clamp(dd.deep_value(pixel, ac, t), 0.0f,
+                                           1.0f);
+                    float v  = dd.deep_value(pixel, c, t)
+                              + (1.0f - at) * dd.deep_value(pixel, c, s);
+                    dd.set_deep_value(pixel, c, t, v);
+                }
+            }
+            float zf = std::min(dd.deep_value(pixel, Zchan, t),
+                                dd.deep_value(pixel, Zchan, s));
+            dd.set_deep_value(pixel, Zchan, t, zf);
+            // Without a Zback channel, Zback_channel() is Z itself, and the
+            // merged (point) sample stays at the front depth.
+            if (Zbackchan != Zchan) {
+                float zb = std::max(dd.deep_value(pixel, Zbackchan, t),
+                                    dd.deep_value(pixel, Zbackchan, s));
+                dd.set_deep_value(pixel, Zbackchan, t, zb);
+            }
+        };
+        auto reduce_pixel = [&](int pixel) {
+            int n = dd.samples(pixel);
+            if (n == 0)
+                return;
+            dd.sort(pixel);
+            // Drop everything behind the sample at which the accumulated
+            // opacity reaches the threshold.
+            float accum = 0.0f;
+            for (int s = 0; has_alpha && s < n - 1; ++s) {
+                accum += (1.0f - accum)
+                         * OIIO::clamp(alpha(pixel, s), 0.0f, 1.0f);
+                if (accum >= opacity)
+                    n = s + 1;
+            }
+            // Composite each sample into the one in front, if they are
+            // close enough, or else keep it.
+            int nout = 1;
+            for (int s = 1; s < n; ++s) {
+                if (mergeable(pixel, nout - 1, s)) {
+                    merge(pixel, nout - 1, s);
+                } else {
+                    if (s != nout)
+                        memcpy(dd.data_ptr(pixel, 0, nout),
+                               dd.data_ptr(pixel, 0, s), dd.samplesize());
+                    ++nout;
+                }
+            }
+            dd.set_samples(pixel, nout);
+        };
+
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y)
+                for (int x = roi.xbegin; x < roi.xend; ++x)
+                    reduce_pixel(dst.pixelindex(x, y, z, true));
+    });
+
+    if (stats) {
+        *stats = DeepReduceStats();
+        const DeepData& srcdd(*src.deepdata());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y)
+                for (int x = roi.xbegin; x < roi.xend; ++x) {
+                    int in  = srcdd.samples(src.pixelindex(x, y, z, true));
+                    int out = dd.samples(dst.pixelindex(x, y, z, true));
+                    stats->samples_in += in;
+                    stats->samples_out += out;
+                    stats->maxsamples_in  = std::max(stats->maxsamples_in, in);
+                    stats->maxsamples_out = std::max(stats->maxsamples_out,
+                                                     out);
+                }
+        stats->bytes_in  = stats->samples_in * int64_t(srcdd.samplesize());
+        stats->bytes_out = stats->samples_out * int64_t(dd.samplesize());
+    }
+    return true;
+}
+
+
+
+ImageBuf
+ImageBufAlgo::deep_reduce(const ImageBuf& src, float ztolerance,
+                          float colortolerance, float opacity,
+                          DeepReduceStats* stats, ROI roi, int nthreads)
+{
+    ImageBuf result;
+    bool ok = deep_reduce(result, src, ztolerance, colortolerance, opacity,
+                          stats, roi, nthreads);
+    if (!ok && !result.has_error())
+        result.errorfmt("ImageBufAlgo::deep_reduce error");
+    return result;
+}
+
+
 OIIO_NAMESPACE_END
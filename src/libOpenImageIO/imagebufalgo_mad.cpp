@@ -19,117 +19,96 @@ OIIO_NAMESPACE_BEGIN
 
 
 
-template<class Rtype, class ABCtype>
 static bool
 mad_impl(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, const ImageBuf& C,
          ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        if ((is_same<Rtype, float>::value || is_same<Rtype, half>::value)
-            && (is_same<ABCtype, float>::value || is_same<ABCtype, half>::value)
-            // && R.localpixels() // has to be, because it's writable
-            && A.localpixels() && B.localpixels()
-            && C.localpixels()
-            // && R.contains_roi(roi)  // has to be, because IBAPrep
-            && A.contains_roi(roi) && B.contains_roi(roi) && C.contains_roi(roi)
-            && roi.chbegin == 0 && roi.chend == R.nchannels()
-            && roi.chend == A.nchannels() && roi.chend == B.nchannels()
-            && roi.chend == C.nchannels()) {
-            // Special case when all inputs are either float or half, with in-
-            // memory contiguous data and we're operating on the full channel
-            // range: skip iterators: For these circumstances, we can operate on
-            // the raw memory very efficiently. Otherwise, we will need the
-            // magic of the the Iterators (and pay the price).
-            int nxvalues = roi.width() * R.nchannels();
-            for (int z = roi.zbegin; z < roi.zend; ++z)
-                for (int y = roi.ybegin; y < roi.yend; ++y) {
-                    Rtype* rraw = (Rtype*)R.pixeladdr(roi.xbegin, y, z);
-                    const ABCtype* araw
-                        = (const ABCtype*)A.pixeladdr(roi.xbegin, y, z);
-                    const ABCtype* braw
-                        = (const ABCtype*)B.pixeladdr(roi.xbegin, y, z);
-                    const ABCtype* craw
-                        = (const ABCtype*)C.pixeladdr(roi.xbegin, y, z);
-                    OIIO_DASSERT(araw && braw && craw);
-                    // The straightforward loop auto-vectorizes very well,
-                    // there's no benefit to using explicit SIMD here.
-                    for (int x = 0; x < nxvalues; ++x)
-                        rraw[x] = araw[x] * braw[x] + craw[x];
-                    // But if you did want to explicitly vectorize, this is
-                    // how it would look:
-                    // int simdend = nxvalues & (~3); // how many float4's?
-                    // for (int x = 0; x < simdend; x += 4) {
-                    //     simd::float4 a_simd(araw+x), b_simd(braw+x), c_simd(craw+x);
-                    //     simd::float4 r_simd = a_simd * b_simd + c_simd;
-                    //     r_simd.store (rraw+x);
-                    // }
-                    // for (int x = simdend; x < nxvalues; ++x)
-                    //     rraw[x] = araw[x] * braw[x] + craw[x];
-                }
-        } else {
-            ImageBuf::Iterator<Rtype> r(R, roi);
-            ImageBuf::ConstIterator<ABCtype> a(A, roi);
-            ImageBuf::ConstIterator<ABCtype> b(B, roi);
-            ImageBuf::ConstIterator<ABCtype> c(C, roi);
-            for (; !r.done(); ++r, ++a, ++b, ++c) {
-                for (int ch = roi.chbegin; ch < roi.chend; ++ch)
-                    r[ch] = a[ch] * b[ch] + c[ch];
+        // Row-at-a-time access refers directly to the buffers' memory when
+        // they are float, and converts a row at a time otherwise. Either
+        // way, the straightforward loop auto-vectorizes very well.
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        ImageBuf::RowReader<float> c(C, roi);
+        size_t nvalues = size_t(roi.width()) * size_t(roi.nchannels());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                const float* crow = c.row(y, z).data();
+                for (size_t i = 0; i < nvalues; ++i)
+                    rrow[i] = arow[i] * brow[i] + crow[i];
             }
-        }
     });
     return true;
 }
 
 
 
-template<class Rtype, class ABCtype>
 static bool
 mad_impl_ici(ImageBuf& R, const ImageBuf& A, cspan<float> b, const ImageBuf& C,
              ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<ABCtype> a(A, roi);
-        ImageBuf::ConstIterator<ABCtype> c(C, roi);
-        for (; !r.done(); ++r, ++a, ++c) {
-            for (int ch = roi.chbegin; ch < roi.chend; ++ch)
-                r[ch] = a[ch] * b[ch] + c[ch];
-        }
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> c(C, roi);
+        std::vector<float> brow = pvt::constant_row(b, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* crow = c.row(y, z).data();
+                for (size_t i = 0, n = brow.size(); i < n; ++i)
+                    rrow[i] = arow[i] * brow[i] + crow[i];
+            }
     });
     return true;
 }
 
 
 
-template<class Rtype, class Atype>
 static bool
 mad_impl_icc(ImageBuf& R, const ImageBuf& A, cspan<float> b, cspan<float> c,
              ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        for (; !r.done(); ++r, ++a)
-            for (int ch = roi.chbegin; ch < roi.chend; ++ch)
-                r[ch] = a[ch] * b[ch] + c[ch];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        std::vector<float> brow = pvt::constant_row(b, roi);
+        std::vector<float> crow = pvt::constant_row(c, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                for (size_t i = 0, n = brow.size(); i < n; ++i)
+                    rrow[i] = arow[i] * brow[i] + crow[i];
+            }
     });
     return true;
 }
 
 
 
-template<class Rtype, class Atype>
 static bool
 mad_impl_iic(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, cspan<float> c,
              ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        ImageBuf::ConstIterator<Atype> b(B, roi);
-        for (; !r.done(); ++r, ++a, ++b)
-            for (int ch = roi.chbegin; ch < roi.chend; ++ch)
-                r[ch] = a[ch] * b[ch] + c[ch];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        std::vector<float> crow = pvt::constant_row(c, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                for (size_t i = 0, n = crow.size(); i < n; ++i)
+                    rrow[i] = arow[i] * brow[i] + crow[i];
+            }
     });
     return true;
 }
@@ -159,56 +138,41 @@ ImageBufAlgo::mad(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_,
         return false;
     }
 
-    // To avoid the full cross-product of dst/A/B/C types, force any of
-    // A,B,C that are images to all be the same data type, copying if we
-    // have to.
+    // The kernels read and write any pixel types a row at a time, so there
+    // is no need to copy the inputs to a common type. But to match the
+    // established behavior, a dst that we allocate gets the merged type of
+    // the inputs rather than IBAprep's float for mixed input types.
+    bool dst_was_initialized = dst.initialized();
+    if (!IBAprep(roi, &dst, A, B ? B : C, C))
+        return false;
     TypeDesc abc_type = type_merge(A ? A->spec().format : TypeUnknown,
                                    B ? B->spec().format : TypeUnknown,
                                    C ? C->spec().format : TypeUnknown);
-    ImageBuf Anew, Bnew, Cnew;
-    if (A && A->spec().format != abc_type) {
-        Anew.copy(*A, abc_type);
-        A = &Anew;
-    }
-    if (B && B->spec().format != abc_type) {
-        Bnew.copy(*B, abc_type);
-        B = &Bnew;
-    }
-    if (C && C->spec().format != abc_type) {
-        Cnew.copy(*C, abc_type);
-        C = &Cnew;
+    if (!dst_was_initialized && dst.spec().format != abc_type) {
+        ImageSpec spec = dst.spec();
+        spec.set_format(abc_type);
+        dst.reset(spec, InitializePixels::No);
     }
 
-    if (!IBAprep(roi, &dst, A, B ? B : C, C))
-        return false;
-
     // Note: A is always an image. That leaves 4 cases to deal with.
     bool ok;
     if (B) {
         if (C) {
-            OIIO_DISPATCH_COMMON_TYPES2(ok, "mad", mad_impl, dst.spec().format,
-                                        abc_type, dst, *A, *B, *C, roi,
-                                        nthreads);
+            ok = mad_impl(dst, *A, *B, *C, roi, nthreads);
         } else {  // C not an image
             cspan<float> c(C_.val());
             IBA_FIX_PERCHAN_LEN_DEF(c, dst.nchannels());
-            OIIO_DISPATCH_COMMON_TYPES2(ok, "mad", mad_impl_iic,
-                                        dst.spec().format, abc_type, dst, *A,
-                                        *B, c, roi, nthreads);
+            ok = mad_impl_iic(dst, *A, *B, c, roi, nthreads);
         }
     } else {  // B is not an image
         cspan<float> b(B_.val());
         IBA_FIX_PERCHAN_LEN_DEF(b, dst.nchannels());
         if (C) {
-            OIIO_DISPATCH_COMMON_TYPES2(ok, "mad", mad_impl_ici,
-                                        dst.spec().format, abc_type, dst, *A, b,
-                                        *C, roi, nthreads);
+            ok = mad_impl_ici(dst, *A, b, *C, roi, nthreads);
         } else {  // C not an image
             cspan<float> c(C_.val());
             IBA_FIX_PERCHAN_LEN_DEF(c, dst.nchannels());
-            OIIO_DISPATCH_COMMON_TYPES2(ok, "mad", mad_impl_icc,
-                                        dst.spec().format, abc_type, dst, *A, b,
-                                        c, roi, nthreads);
+            ok = mad_impl_icc(dst, *A, b, c, roi, nthreads);
         }
     }
     return ok;
@@ -25,33 +25,43 @@
 OIIO_NAMESPACE_BEGIN
 
 
-template<class Rtype, class Atype, class Btype>
 static bool
 mul_impl(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, ROI roi,
          int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        ImageBuf::ConstIterator<Btype> b(B, roi);
-        for (; !r.done(); ++r, ++a, ++b)
-            for (int c = roi.chbegin; c < roi.chend; ++c)
-                r[c] = a[c] * b[c];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        size_t nvalues = size_t(roi.width()) * size_t(roi.nchannels());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                for (size_t i = 0; i < nvalues; ++i)
+                    rrow[i] = arow[i] * brow[i];
+            }
     });
     return true;
 }
 
 
 
-template<class Rtype, class Atype>
 static bool
 mul_impl(ImageBuf& R, const ImageBuf& A, cspan<float> b, ROI roi, int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        for (ImageBuf::Iterator<Rtype> r(R, roi); !r.done(); ++r, ++a)
-            for (int c = roi.chbegin; c < roi.chend; ++c)
-                r[c] = a[c] * b[c];
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        std::vector<float> brow = pvt::constant_row(b, roi);
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                for (size_t i = 0, n = brow.size(); i < n; ++i)
+                    rrow[i] = arow[i] * brow[i];
+            }
     });
     return true;
 }
@@ -93,11 +103,7 @@ ImageBufAlgo::mul(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
         const ImageBuf &A(A_.img()), &B(B_.img());
         if (!IBAprep(roi, &dst, &A, &B, IBAprep_CLAMP_MUTUAL_NCHANNELS))
             return false;
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES3(ok, "mul", mul_impl, dst.spec().format,
-                                    A.spec().format, B.spec().format, dst, A, B,
-                                    roi, nthreads);
-        return ok;
+        return mul_impl(dst, A, B, roi, nthreads);
     }
     if (A_.is_val() && B_.is_img())  // canonicalize to A_img, B_val
         A_.swap(B_);
@@ -113,10 +119,7 @@ ImageBufAlgo::mul(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             dst.deepdata()->set_all_samples(A.deepdata()->all_samples());
             return mul_impl_deep(dst, A, b, roi, nthreads);
         }
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES2(ok, "mul", mul_impl, dst.spec().format,
-                                    A.spec().format, dst, A, b, roi, nthreads);
-        return ok;
+        return mul_impl(dst, A, b, roi, nthreads);
     }
     // Remaining cases: error
     dst.errorfmt("ImageBufAlgo::mul(): at least one argument must be an image");
@@ -137,19 +140,22 @@ ImageBufAlgo::mul(Image_or_Const A, Image_or_Const B, ROI roi, int nthreads)
 
 
 
-template<class Rtype, class Atype, class Btype>
 static bool
 div_impl(ImageBuf& R, const ImageBuf& A, const ImageBuf& B, ROI roi,
          int nthreads)
 {
     ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
-        ImageBuf::Iterator<Rtype> r(R, roi);
-        ImageBuf::ConstIterator<Atype> a(A, roi);
-        ImageBuf::ConstIterator<Btype> b(B, roi);
-        for (; !r.done(); ++r, ++a, ++b)
-            for (int c = roi.chbegin; c < roi.chend; ++c) {
-                float v = b[c];
-                r[c]    = (v == 0.0f) ? 0.0f : (a[c] / v);
+        ImageBuf::RowWriter<float> r(R, roi);
+        ImageBuf::RowReader<float> a(A, roi);
+        ImageBuf::RowReader<float> b(B, roi);
+        size_t nvalues = size_t(roi.width()) * size_t(roi.nchannels());
+        for (int z = roi.zbegin; z < roi.zend; ++z)
+            for (int y = roi.ybegin; y < roi.yend; ++y) {
+                float* rrow       = r.row(y, z).data();
+                const float* arow = a.row(y, z).data();
+                const float* brow = b.row(y, z).data();
+                for (size_t i = 0; i < nvalues; ++i)
+                    rrow[i] = (brow[i] == 0.0f) ? 0.0f : (arow[i] / brow[i]);
             }
     });
     return true;
@@ -166,11 +172,7 @@ ImageBufAlgo::div(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
         const ImageBuf &A(A_.img()), &B(B_.img());
         if (!IBAprep(roi, &dst, &A, &B, IBAprep_CLAMP_MUTUAL_NCHANNELS))
             return false;
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES3(ok, "div", div_impl, dst.spec().format,
-                                    A.spec().format, B.spec().format, dst, A, B,
-                                    roi, nthreads);
-        return ok;
+        return div_impl(dst, A, B, roi, nthreads);
     }
     if (A_.is_val() && B_.is_img())  // canonicalize to A_img, B_val
         A_.swap(B_);
@@ -193,10 +195,7 @@ ImageBufAlgo::div(ImageBuf& dst, Image_or_Const A_, Image_or_Const B_, ROI roi,
             dst.deepdata()->set_all_samples(A.deepdata()->all_samples());
             return mul_impl_deep(dst, A, b, roi, nthreads);
         }
-        bool ok;
-        OIIO_DISPATCH_COMMON_TYPES2(ok, "div", mul_impl, dst.spec().format,
-                                    A.spec().format, dst, A, b, roi, nthreads);
-        return ok;
+        return mul_impl(dst, A, b, roi, nthreads);
     }
     // Remaining cases: error
     dst.errorfmt("ImageBufAlgo::div(): at least one argument must be an image");
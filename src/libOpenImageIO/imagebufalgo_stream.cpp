@@ -0,0 +1,438 @@
+// Copyright Contributors to the OpenImageIO project.
+// SPDX-License-Identifier: Apache-2.0
+// https://github.com/AcademySoftwareFoundation/OpenImageIO
+
+/// \file
+/// ImageBufAlgo::stream_pointwise and stream_deep -- apply ops to image
+/// files one band of scanlines at a time.
+
+
+#include <future>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <OpenImageIO/deepdata.h>
+#include <OpenImageIO/imagebuf.h>
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imageio.h>
+#include <OpenImageIO/thread.h>
+
+#include "imageio_pvt.h"
+
+
+OIIO_NAMESPACE_BEGIN
+
+
+namespace {
+
+static const ustring bandheight_us("bandheight");
+static const ustring format_us("format");
+
+
+// Read scanlines [ybegin,yend) of the first subimage of `in` into `band`,
+// as float. Tiled files are read by whole rows of tiles, so `ybegin`
+// must be tile-aligned (and yend too, unless it's the end of the image).
+static bool
+read_band(ImageInput& in, const ImageSpec& inspec, int ybegin, int yend,
+          ImageBuf& band)
+{
+    ImageSpec bandspec(inspec);
+    bandspec.y      = ybegin;
+    bandspec.height = yend - ybegin;
+    bandspec.set_format(TypeFloat);
+    bandspec.channelformats.clear();
+    bandspec.tile_width  = 0;
+    bandspec.tile_height = 0;
+    bandspec.tile_depth  = 1;
+    band.reset(bandspec, InitializePixels::No);
+    if (inspec.tile_width)
+        return in.read_tiles(0, 0, inspec.x, inspec.x + inspec.width, ybegin,
+                             yend, inspec.z, inspec.z + 1, 0,
+                             inspec.nchannels, TypeFloat, band.localpixels());
+    return in.read_scanlines(0, 0, ybegin, yend, inspec.z, 0, inspec.nchannels,
+                             TypeFloat, band.localpixels());
+}
+
+
+
+// Read scanlines [ybegin,yend) of the first subimage of the deep file `in`
+// into `band`. As long as the band height doesn't change, the ImageBuf is
+// just moved to the new position, and the reader re-initializes its
+// DeepData in place, which reuses the memory from the previous band.
+static bool
+read_deep_band(ImageInput& in, const ImageSpec& inspec, int ybegin, int yend,
+               ImageBuf& band)
+{
+    if (band.initialized() && band.spec().height == yend - ybegin) {
+        band.set_origin(inspec.x, ybegin, inspec.z);
+    } else {
+        ImageSpec bandspec(inspec);
+        bandspec.y           = ybegin;
+        bandspec.height      = yend - ybegin;
+        bandspec.tile_width  = 0;
+        bandspec.tile_height = 0;
+        bandspec.tile_depth  = 1;
+        band.reset(bandspec, InitializePixels::No);
+    }
+    DeepData& dd(*band.deepdata());
+    if (inspec.tile_width)
+        return in.read_native_deep_tiles(0, 0, inspec.x,
+                                         inspec.x + inspec.width, ybegin, yend,
+                                         inspec.z, inspec.z + 1, 0,
+                                         inspec.nchannels, dd);
+    return in.read_native_deep_scanlines(0, 0, ybegin, yend, inspec.z, 0,
+                                         inspec.nchannels, dd);
+}
+
+
+
+// Get the result ImageBuf of the previous band ready to be reused for
+// [ybegin,yend): move it and empty its deep pixels, keeping their memory.
+// If the height differs, start over with an uninitialized ImageBuf.
+static void
+reuse_result_band(ImageBuf& out, int ybegin, int yend)
+{
+    if (!out.initialized() || out.spec().height != yend - ybegin) {
+        out.reset();
+        return;
+    }
+    out.set_origin(out.spec().x, ybegin, out.spec().z);
+    if (out.deep()) {
+        DeepData& dd(*out.deepdata());
+        std::vector<unsigned int> none(dd.pixels(), 0);
+        dd.set_all_samples(none);
+    }
+}
+
+}  // namespace
+
+
+
+bool
+ImageBufAlgo::stream_pointwise(string_view outfilename,
+                               string_view infilename, cspan<PointwiseOp> ops,
+                               KWArgs options)
+{
+    using OIIO::pvt::errorfmt;
+    pvt::LoggedTimer logtime("IBA::stream_pointwise");
+
+    auto in = ImageInput::open(infilename);
+    if (!in)
+        return false;  // error is already in the global error
+    const ImageSpec inspec = in->spec();
+    if (inspec.deep || inspec.depth > 1) {
+        errorfmt("stream_pointwise: deep and volume images are not supported");
+        return false;
+    }
+
+    int bandheight = options.get_int(bandheight_us, 0);
+    if (bandheight <= 0)
+        bandheight = std::max(16, (1 << 22) / std::max(1, inspec.width));
+    if (inspec.tile_width)
+        bandheight = round_to_multiple(bandheight, inspec.tile_height);
+    bandheight = std::max(1, bandheight);
+    const int ybegin = inspec.y, yend = inspec.y + inspec.height;
+    const int nbands = (inspec.height + bandheight - 1) / bandheight;
+
+    // Apply the chain of ops to one band. The result is left in `out`.
+    auto compute = [&](const ImageBuf& band, ImageBuf& out) -> bool {
+        if (ops.empty()) {
+            out = band;
+            return true;
+        }
+        std::vector<ImageBuf> results(ops.size());
+        const ImageBuf* src = &band;
+        for (size_t i = 0; i < ops.size(); ++i) {
+            if (!ops[i](results[i], *src)) {
+                errorfmt("stream_pointwise: {}",
+                         results[i].has_error() ? results[i].geterror()
+                                                : "operation failed");
+                return false;
+            }
+            src = &results[i];
+        }
+        const ROI& bandroi(band.roi());
+        const ROI& outroi(results.back().roi());
+        if (outroi.xbegin != bandroi.xbegin || outroi.xend != bandroi.xend
+            || outroi.ybegin != bandroi.ybegin || outroi.yend != bandroi.yend
+            || !results.back().localpixels()) {
+            errorfmt("stream_pointwise: only pointwise operations that "
+                     "preserve the data window are allowed");
+            return false;
+        }
+        out = std::move(results.back());
+        return true;
+    };
+
+    // Open the output, with the channels and metadata that the ops produced
+    // for the first band, and the full geometry of the input.
+    std::unique_ptr<ImageOutput> out;
+    auto open_output = [&](const ImageBuf& firstband) -> bool {
+        ImageSpec outspec(firstband.spec());
+        outspec.y           = inspec.y;
+        outspec.height      = inspec.height;
+        outspec.full_x      = inspec.full_x;
+        outspec.full_y      = inspec.full_y;
+        outspec.full_width  = inspec.full_width;
+        outspec.full_height = inspec.full_height;
+        outspec.tile_width  = 0;
+        outspec.tile_height = 0;
+        outspec.tile_depth  = 1;
+        std::string fmt = options.get_string(format_us);
+        if (fmt.size()) {
+            outspec.set_format(TypeDesc(fmt));
+        } else if (outspec.nchannels == inspec.nchannels) {
+            outspec.format         = inspec.format;
+            outspec.channelformats = inspec.channelformats;
+        } else {
+            outspec.set_format(inspec.format);
+        }
+        out = ImageOutput::create(outfilename);
+        if (!out)
+            return false;  // error is already in the global error
+        if (!out->open(outfilename, outspec)) {
+            errorfmt("{}", out->geterror());
+            return false;
+        }
+        return true;
+    };
+
+    // Three stage pipeline: band k+1 is read, and band k-1 is written, on
+    // pool threads while band k is computed on this thread. The two sets of
+    // buffers alternate, so at most two input and two output bands exist.
+    // Error messages are thread-specific, so the read and write tasks
+    // return theirs (or an empty string for success).
+    thread_pool* pool = default_thread_pool();
+    ImageBuf inbands[2], outbands[2];
+    auto read_task = [&](int k) {
+        return pool->push([&, k](int /*id*/) -> std::string {
+            int y0 = ybegin + k * bandheight;
+            int y1 = std::min(y0 + bandheight, yend);
+            if (read_band(*in, inspec, y0, y1, inbands[k & 1]))
+                return std::string();
+            return in->geterror();
+        });
+    };
+    auto write_task = [&](const ImageBuf* result) {
+        return pool->push([&, result](int /*id*/) -> std::string {
+            const ImageSpec& spec(result->spec());
+            if (out->write_scanlines(spec.y, spec.y + spec.height, spec.z,
+                                     spec.format, result->localpixels()))
+                return std::string();
+            return out->geterror();
+        });
+    };
+    auto check = [&](std::future<std::string>& f) -> bool {
+        std::string err = f.get();
+        if (err.size())
+            errorfmt("{}", err);
+        return err.empty();
+    };
+
+    std::future<std::string> reading = read_task(0), writing;
+    bool ok = true;
+    for (int k = 0; k < nbands; ++k) {
+        if (!check(reading)) {
+            ok = false;
+            break;
+        }
+        if (k + 1 < nbands)
+            reading = read_task(k + 1);
+        ImageBuf& result(outbands[k & 1]);
+        ok = compute(inbands[k & 1], result);
+        if (ok && k == 0)
+            ok = open_output(result);
+        if (writing.valid())
+            ok &= check(writing);
+        if (!ok)
+            break;
+        writing = write_task(&result);
+    }
+    // Don't leave any tasks running that reference our local state.
+    if (reading.valid())
+        reading.wait();
+    if (writing.valid())
+        ok &= check(writing);
+    if (out && !out->close()) {
+        errorfmt("{}", out->geterror());
+        ok = false;
+    }
+    return ok;
+}
+
+
+
+bool
+ImageBufAlgo::stream_deep(string_view outfilename,
+                          cspan<std::string> infilenames,
+                          const DeepStreamOp& op, KWArgs options)
+{
+    using OIIO::pvt::errorfmt;
+    pvt::LoggedTimer logtime("IBA::stream_deep");
+
+    const int ninputs = int(infilenames.size());
+    if (ninputs < 1) {
+        errorfmt("stream_deep: no input files");
+        return false;
+    }
+    std::vector<std::unique_ptr<ImageInput>> in;
+    int tileheight = 1;
+    for (auto& name : infilenames) {
+        in.emplace_back(ImageInput::open(name));
+        if (!in.back())
+            return false;  // error is already in the global error
+        const ImageSpec& spec(in.back()->spec());
+        const ImageSpec& spec0(in[0]->spec());
+        if (!spec.deep || spec.depth > 1) {
+            errorfmt("stream_deep: {} is not a deep 2D image", name);
+            return false;
+        }
+        if (spec.x != spec0.x || spec.y != spec0.y || spec.width != spec0.width
+            || spec.height != spec0.height) {
+            errorfmt("stream_deep: {} and {} have different data windows",
+                     infilenames[0], name);
+            return false;
+        }
+        if (spec.tile_width)
+            tileheight = std::lcm(tileheight, spec.tile_height);
+    }
+    const ImageSpec inspec = in[0]->spec();
+
+    int bandheight = options.get_int(bandheight_us, 0);
+    if (bandheight <= 0)
+        bandheight = std::max(16, (1 << 20) / std::max(1, inspec.width));
+    bandheight = std::max(1, round_to_multiple(bandheight, tileheight));
+    const int ybegin = inspec.y, yend = inspec.y + inspec.height;
+    const int nbands = (inspec.height + bandheight - 1) / bandheight;
+
+    // Apply the op to one band of the inputs. The result is left in `out`,
+    // which may still hold the previous result in this slot.
+    auto compute = [&](cspan<ImageBuf> bands, ImageBuf& out) -> bool {
+        const ImageSpec& bandspec(bands[0].spec());
+        reuse_result_band(out, bandspec.y, bandspec.y + bandspec.height);
+        if (!op(out, bands)) {
+            errorfmt("stream_deep: {}", out.has_error() ? out.geterror()
+                                                        : "operation failed");
+            return false;
+        }
+        const ImageSpec& outspec(out.spec());
+        if (outspec.x != bandspec.x || outspec.width != bandspec.width
+            || outspec.y != bandspec.y || outspec.height != bandspec.height
+            || (!out.deep() && !out.localpixels())) {
+            errorfmt("stream_deep: only operations that preserve the data "
+                     "window are allowed");
+            return false;
+        }
+        return true;
+    };
+
+    // Open the output, deep or flat as the op made the first band, with
+    // the full geometry of the input.
+    std::unique_ptr<ImageOutput> out;
+    auto open_output = [&](const ImageBuf& firstband) -> bool {
+        ImageSpec outspec(firstband.spec());
+        outspec.y           = inspec.y;
+        outspec.height      = inspec.height;
+        outspec.full_x      = inspec.full_x;
+        outspec.full_y      = inspec.full_y;
+        outspec.full_width  = inspec.full_width;
+        outspec.full_height = inspec.full_height;
+        outspec.tile_width  = 0;
+        outspec.tile_height = 0;
+        outspec.tile_depth  = 1;
+        std::string fmt = options.get_string(format_us);
+        if (fmt.size())
+            outspec.set_format(TypeDesc(fmt));
+        out = ImageOutput::create(outfilename);
+        if (!out)
+            return false;  // error is already in the global error
+        if (outspec.deep && !out->supports("deepdata")) {
+            errorfmt("stream_deep: {} does not support deep images",
+                     out->format_name());
+            return false;
+        }
+        if (!out->open(outfilename, outspec)) {
+            errorfmt("{}", out->geterror());
+            return false;
+        }
+        return true;
+    };
+
+    // The same three stage pipeline as stream_pointwise: band k+1 of every
+    // input is read, and band k-1 is written, on pool threads while band k
+    // is computed (by ops that are themselves multithreaded) on this
+    // thread. Each of the two slots keeps its input and result ImageBufs
+    // from band to band, so their deep sample memory is reused.
+    thread_pool* pool = default_thread_pool();
+    std::vector<ImageBuf> inbands[2] = { std::vector<ImageBuf>(ninputs),
+                                         std::vector<ImageBuf>(ninputs) };
+    ImageBuf outbands[2];
+    auto read_task = [&](int k) {
+        return pool->push([&, k](int /*id*/) -> std::string {
+            int y0 = ybegin + k * bandheight;
+            int y1 = std::min(y0 + bandheight, yend);
+            for (int i = 0; i < ninputs; ++i)
+                if (!read_deep_band(*in[i], in[i]->spec(), y0, y1,
+                                    inbands[k & 1][i]))
+                    return in[i]->geterror();
+            return std::string();
+        });
+    };
+    auto write_task = [&](const ImageBuf* result) {
+        return pool->push([&, result](int /*id*/) -> std::string {
+            const ImageSpec& spec(result->spec());
+            bool ok = result->deep()
+                          ? out->write_deep_scanlines(spec.y,
+                                                      spec.y + spec.height,
+                                                      spec.z,
+                                                      *result->deepdata())
+                          : out->write_scanlines(spec.y, spec.y + spec.height,
+                                                 spec.z, spec.format,
+                                                 result->localpixels());
+            return ok ? std::string() : out->geterror();
+        });
+    };
+    auto check = [&](std::future<std::string>& f) -> bool {
+        std::string err = f.get();
+        if (err.size())
+            errorfmt("{}", err);
+        return err.empty();
+    };
+
+    std::future<std::string> reading = read_task(0), writing;
+    bool ok = true;
+    for (int k = 0; k < nbands; ++k) {
+        if (!check(reading)) {
+            ok = false;
+            break;
+        }
+        if (k + 1 < nbands)
+            reading = read_task(k + 1);
+        // The write of band k-2, from this same result slot, was finished
+        // before band k-1 was queued for writing.
+        ImageBuf& result(outbands[k & 1]);
+        ok = compute(inbands[k & 1], result);
+        if (ok && k == 0)
+            ok = open_output(result);
+        if (writing.valid())
+            ok &= check(writing);
+        if (!ok)
+            break;
+        writing = write_task(&result);
+    }
+    // Don't leave any tasks running that reference our local state.
+    if (reading.valid())
+        reading.wait();
+    if (writing.valid())
+        ok &= check(writing);
+    if (out && !out->close()) {
+        errorfmt("{}", out->geterror());
+        ok = false;
+    }
+    return ok;
+}
+
+
+OIIO_NAMESPACE_END
@@ -18,9 +18,13 @@
 #    include <opencv2/opencv.hpp>
 #endif
 
+#include <OpenImageIO/Imath.h>
 #include <OpenImageIO/argparse.h>
 #include <OpenImageIO/benchmark.h>
 #include <OpenImageIO/color.h>
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/filter.h>
+#include <OpenImageIO/hash.h>
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imagebufalgo_util.h>
@@ -282,6 +286,217 @@ test_copy()
 
 
 
+// A filter that hides its separability, to make resize use its original
+// per-pixel path.
+class NonSeparableFilter final : public Filter2D {
+public:
+    NonSeparableFilter(const Filter2D* f)
+        : Filter2D(f->width(), f->height())
+        , m_filter(f)
+    {
+    }
+    float operator()(float x, float y) const override
+    {
+        return (*m_filter)(x, y);
+    }
+    float xfilt(float x) const override { return m_filter->xfilt(x); }
+    float yfilt(float y) const override { return m_filter->yfilt(y); }
+    string_view name() const override { return m_filter->name(); }
+
+private:
+    const Filter2D* m_filter;
+};
+
+
+
+// Test ImageBufAlgo::resize
+void
+test_resize()
+{
+    std::cout << "test resize\n";
+
+    // Box-filtered 2x downsize of a gradient must be the 2x2 block averages,
+    // for all the channel counts with special cases and a general one, and
+    // for the common pixel types.
+    for (int nc : { 1, 2, 3, 4, 5 }) {
+        for (TypeDesc t : { TypeFloat, TypeHalf, TypeUInt8 }) {
+            ImageBuf A(ImageSpec(8, 6, nc, t));
+            for (int y = 0; y < 6; ++y) {
+                for (int x = 0; x < 8; ++x) {
+                    float pixel[5];
+                    for (int c = 0; c < nc; ++c)
+                        pixel[c] = (x + 8 * y + c) / 64.0f;
+                    A.setpixel(x, y, pixel, nc);
+                }
+            }
+            ImageBuf B(ImageSpec(4, 3, nc, t));
+            ImageBufAlgo::resize(B, A, "box", 0.0f);
+            float tol = (t == TypeUInt8) ? 1.0f / 255.0f : 1.0e-3f;
+            for (int y = 0; y < 3; ++y)
+                for (int x = 0; x < 4; ++x)
+                    for (int c = 0; c < nc; ++c) {
+                        float avg = (A.getchannel(2 * x, 2 * y, 0, c)
+                                     + A.getchannel(2 * x + 1, 2 * y, 0, c)
+                                     + A.getchannel(2 * x, 2 * y + 1, 0, c)
+                                     + A.getchannel(2 * x + 1, 2 * y + 1, 0,
+                                                    c))
+                                    / 4.0f;
+                        OIIO_CHECK_EQUAL_THRESH(B.getchannel(x, y, 0, c), avg,
+                                                tol);
+                    }
+        }
+    }
+
+    // A constant image stays constant with a wide filter, including at
+    // the edges where the filter footprint is clamped.
+    {
+        const float val[4] = { 0.25f, 0.5f, 0.75f, 1.0f };
+        ImageBuf A(ImageSpec(64, 48, 4, TypeFloat));
+        ImageBufAlgo::fill(A, val);
+        ImageBuf B = ImageBufAlgo::resize(A, "lanczos3", 0.0f,
+                                          ROI(0, 20, 0, 15, 0, 1, 0, 4));
+        auto stats = ImageBufAlgo::computePixelStats(B);
+        for (int c = 0; c < 4; ++c) {
+            OIIO_CHECK_EQUAL_THRESH(stats.min[c], val[c], 1.0e-5f);
+            OIIO_CHECK_EQUAL_THRESH(stats.max[c], val[c], 1.0e-5f);
+        }
+    }
+
+    // The separable path must match the original per-pixel one for a
+    // non-constant image, both for a source with overscan (whose pixels
+    // outside the display window the taps must use, not clamp away) and
+    // for one whose data window is smaller than its display window.
+    {
+        std::shared_ptr<Filter2D> lanczos(
+            Filter2D::create("lanczos3", 6.0f, 6.0f), Filter2D::destroy);
+        NonSeparableFilter nonsep(lanczos.get());
+        for (ROI data : { ROI(-10, 110, -10, 110, 0, 1, 0, 3),
+                          ROI(10, 90, 20, 80, 0, 1, 0, 3) }) {
+            ImageSpec spec(data, TypeFloat);
+            spec.full_x = spec.full_y = 0;
+            spec.full_width = spec.full_height = 100;
+            ImageBuf A(spec);
+            ImageBufAlgo::noise(A, "uniform", 0.0f, 1.0f, false, 1);
+            for (ROI dstroi : { ROI(0, 40, 0, 40), ROI(0, 160, 0, 130) }) {
+                ImageBuf B(ImageSpec(dstroi.width(), dstroi.height(), 3,
+                                     TypeFloat));
+                ImageBuf C(B.spec());
+                ImageBufAlgo::resize(B, A, lanczos.get());
+                ImageBufAlgo::resize(C, A, &nonsep);
+                auto comp = ImageBufAlgo::compare(B, C, 1.0e-4f, 1.0e-4f);
+                OIIO_CHECK_EQUAL(comp.nfail, 0);
+                OIIO_CHECK_LT(comp.maxerror, 1.0e-4);
+            }
+        }
+
+        // An roi entirely off one side of the source (in the overscan of
+        // the destination) sees only the source's edge pixels.
+        ImageBuf A(ImageSpec(100, 100, 3, TypeFloat));
+        ImageBufAlgo::noise(A, "uniform", 0.0f, 1.0f, false, 1);
+        ImageSpec spec(ROI(-30, 80, 0, 50, 0, 1, 0, 3), TypeFloat);
+        spec.full_x = spec.full_y = 0;
+        spec.full_width = spec.full_height = 50;
+        for (ROI roi : { ROI(60, 80, 0, 50, 0, 1, 0, 3),
+                         ROI(-30, -10, 0, 50, 0, 1, 0, 3) }) {
+            ImageBuf B(spec), C(spec);
+            OIIO_CHECK_ASSERT(ImageBufAlgo::resize(B, A, lanczos.get(), roi));
+            OIIO_CHECK_ASSERT(ImageBufAlgo::resize(C, A, &nonsep, roi));
+            auto comp = ImageBufAlgo::compare(B, C, 1.0e-4f, 1.0e-4f, roi);
+            OIIO_CHECK_EQUAL(comp.nfail, 0);
+        }
+    }
+
+    // Timing
+    Benchmarker bench;
+    for (TypeDesc t : { TypeFloat, TypeHalf, TypeUInt8 }) {
+        ImageBuf src(ImageSpec(2048, 2048, 4, t));
+        ImageBufAlgo::fill(src, { 0.1f, 0.2f, 0.3f, 1.0f });
+        ImageBuf dst(ImageSpec(512, 512, 4, t));
+        bench(Strutil::fmt::format("  IBA::resize {}[4] 2k->512 lanczos3 ", t),
+              [&]() { ImageBufAlgo::resize(dst, src, "lanczos3"); });
+    }
+}
+
+
+
+// Test ImageBufAlgo::fillholes_pushpull
+void
+test_fillholes_pushpull()
+{
+    std::cout << "test fillholes_pushpull\n";
+
+    // An opaque red square in a transparent image: the holes get filled
+    // with the only color there is, and the opaque part is unchanged.
+    for (int res : { 64, 37 }) {
+        ImageSpec spec(res, res, 4, TypeFloat);
+        spec.alpha_channel = 3;
+        ImageBuf src(spec);
+        ImageBufAlgo::zero(src);
+        ROI square(8, 20, 10, 24, 0, 1, 0, 4);
+        ImageBufAlgo::fill(src, { 1.0f, 0.0f, 0.0f, 1.0f }, square);
+        ImageBuf dst = ImageBufAlgo::fillholes_pushpull(src);
+        OIIO_CHECK_ASSERT(!dst.has_error());
+        auto stats = ImageBufAlgo::computePixelStats(dst);
+        OIIO_CHECK_EQUAL_THRESH(stats.min[0], 1.0f, 1.0e-5f);
+        OIIO_CHECK_EQUAL_THRESH(stats.max[1], 0.0f, 1.0e-5f);
+        OIIO_CHECK_EQUAL_THRESH(stats.max[2], 0.0f, 1.0e-5f);
+        OIIO_CHECK_EQUAL_THRESH(stats.min[3], 1.0f, 1.0e-5f);
+    }
+
+    // Timing
+    Benchmarker bench;
+    ImageSpec spec(2048, 2048, 4, TypeHalf);
+    spec.alpha_channel = 3;
+    ImageBuf src(spec);
+    ImageBufAlgo::checker(src, 64, 64, 1, { 0.5f, 0.25f, 0.125f, 1.0f },
+                          { 0.0f, 0.0f, 0.0f, 0.0f });
+    ImageBuf dst;
+    bench("  IBA::fillholes_pushpull half[4] 2k ",
+          [&]() { ImageBufAlgo::fillholes_pushpull(dst, src); });
+}
+
+
+
+// Test ImageBufAlgo::stream_pointwise
+void
+test_stream_pointwise()
+{
+    std::cout << "test stream_pointwise\n";
+    ImageBuf src(ImageSpec(64, 50, 4, TypeFloat));
+    ImageBufAlgo::fill(src, { 0.0f, 0.0f, 0.0f, 1.0f },
+                       { 1.0f, 1.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 1.0f, 1.0f },
+                       { 1.0f, 0.0f, 1.0f, 1.0f });
+    src.write("stream_in.exr");
+
+    // Scale by 0.5 and drop the alpha, in bands that don't evenly divide
+    // the image height.
+    using ImageBufAlgo::PointwiseOp;
+    PointwiseOp ops[] = {
+        [](ImageBuf& dst, const ImageBuf& src) {
+            return ImageBufAlgo::mul(dst, src, 0.5f);
+        },
+        [](ImageBuf& dst, const ImageBuf& src) {
+            return ImageBufAlgo::channels(dst, src, 3, {});
+        }
+    };
+    bool ok = ImageBufAlgo::stream_pointwise("stream_out.exr", "stream_in.exr",
+                                             ops, { { "bandheight", 16 } });
+    OIIO_CHECK_ASSERT(ok);
+    if (!ok)
+        std::cout << "  " << OIIO::geterror() << "\n";
+
+    ImageBuf result("stream_out.exr");
+    OIIO_CHECK_EQUAL(result.nchannels(), 3);
+    ImageBuf expected = ImageBufAlgo::channels(ImageBufAlgo::mul(src, 0.5f), 3,
+                                               {});
+    auto comp = ImageBufAlgo::compare(result, expected, 1.0e-6f, 1.0e-6f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+    Filesystem::remove("stream_in.exr");
+    Filesystem::remove("stream_out.exr");
+}
+
+
+
 // Test ImageBuf::crop
 void
 test_crop()
@@ -503,6 +718,31 @@ test_mad()
     ImageBufAlgo::mad(D, A, Bval, Cval);
     auto comp = ImageBufAlgo::compare(R, D, 1e-6f, 1e-6f);
     OIIO_CHECK_EQUAL(comp.maxerror, 0.0f);
+
+    // Mixed input types: the result is allocated as the merged type
+    ImageBuf Auint8 = ImageBufAlgo::copy(A, TypeUInt8);
+    ImageBuf Bhalf  = ImageBufAlgo::copy(B, TypeHalf);
+    ImageBuf E      = ImageBufAlgo::mad(Auint8, Bhalf, Cval);
+    OIIO_CHECK_EQUAL(E.spec().format, TypeHalf);
+    comp = ImageBufAlgo::compare(R, E, 0.02f, 0.02f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+
+    // Timing
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    for (TypeDesc t : { TypeFloat, TypeHalf, TypeUInt8 }) {
+        ImageSpec tspec(1000, 1000, 4, t);
+        ImageBuf X(tspec), Y(tspec), Z(tspec);
+        ImageBufAlgo::fill(X, Aval);
+        ImageBufAlgo::fill(Y, Bval);
+        ImageBufAlgo::fill(Z, Cval);
+        bench(Strutil::fmt::format("  IBA::add {}[4] ", t),
+              [&]() { ImageBufAlgo::add(Z, X, Y); });
+        bench(Strutil::fmt::format("  IBA::mul {}[4] by const ", t),
+              [&]() { ImageBufAlgo::mul(Z, X, Bval); });
+        bench(Strutil::fmt::format("  IBA::mad {}[4] ", t),
+              [&]() { ImageBufAlgo::mad(Z, X, Y, X); });
+    }
 }
 
 
@@ -637,6 +877,281 @@ test_zover()
 
 
 
+// Make a deep RGBA/Z/Zback image whose pixels have up to `maxsamples`
+// sorted samples, overlapping each other in odd pixels.
+static ImageBuf
+make_deep_image(int res, int maxsamples, int seed)
+{
+    ImageSpec spec(res, res, 6, TypeFloat);
+    spec.channelnames.assign({ "R", "G", "B", "A", "Z", "Zback" });
+    spec.z_channel = 4;
+    spec.deep      = true;
+    ImageBuf buf(spec);
+    for (int y = 0; y < res; ++y)
+        for (int x = 0; x < res; ++x) {
+            uint32_t h = bjhash::bjfinal(x, y, seed);
+            buf.set_deep_samples(x, y, 0, int(h % (maxsamples + 1)));
+        }
+    for (int y = 0; y < res; ++y)
+        for (int x = 0; x < res; ++x) {
+            float z = 1.0f + (bjhash::bjfinal(x, y, seed + 1) & 0xff) / 256.f;
+            for (int s = 0, n = buf.deep_samples(x, y, 0); s < n; ++s) {
+                uint32_t h = bjhash::bjfinal(x + s, y, seed + 2);
+                float a    = (s == 3) ? 1.0f : (h & 0xff) / 300.0f;
+                float zb   = z + 0.1f + ((h >> 8) & 0xff) / 256.0f;
+                float val[6] = { a * 0.5f, a * 0.25f, a, a, z, zb };
+                for (int c = 0; c < 6; ++c)
+                    buf.set_deep_value(x, y, 0, c, s, val[c]);
+                z = (x & 1) ? z + 0.5f * (zb - z) : zb + 0.05f;
+            }
+        }
+    return buf;
+}
+
+
+
+// Copy a make_deep_image() buffer with an extra "id" channel, rounding the
+// colors and alpha to half. If mixed, they're stored as half and id as a
+// uint, so the copy no longer has the all float/half layout; otherwise
+// every channel is float. Either way the values are the same, but only a
+// uint id is left alone by merging: a float one is treated as a color.
+static ImageBuf
+deep_copy_as(const ImageBuf& src, bool mixed)
+{
+    ImageSpec spec(src.spec().width, src.spec().height, 7, TypeFloat);
+    spec.channelnames.assign({ "R", "G", "B", "A", "Z", "Zback", "id" });
+    spec.z_channel = 4;
+    spec.deep      = true;
+    if (mixed)
+        spec.channelformats = { TypeHalf,  TypeHalf,  TypeHalf,  TypeHalf,
+                                TypeFloat, TypeFloat, TypeUInt32 };
+    ImageBuf buf(spec);
+    for (int y = 0; y < spec.height; ++y)
+        for (int x = 0; x < spec.width; ++x)
+            buf.set_deep_samples(x, y, 0, src.deep_samples(x, y, 0));
+    for (int y = 0; y < spec.height; ++y)
+        for (int x = 0; x < spec.width; ++x)
+            for (int s = 0, n = buf.deep_samples(x, y, 0); s < n; ++s) {
+                for (int c = 0; c < 6; ++c) {
+                    float v = src.deep_value(x, y, 0, c, s);
+                    buf.set_deep_value(x, y, 0, c, s,
+                                       c < 4 ? float(half(v)) : v);
+                }
+                if (mixed)
+                    buf.set_deep_value(x, y, 0, 6, s, uint32_t(7));
+                else
+                    buf.set_deep_value(x, y, 0, 6, s, 7.0f);
+            }
+    return buf;
+}
+
+
+
+// Test ImageBufAlgo::deep_merge, deep_holdout, and flatten
+void
+test_deep_merge()
+{
+    std::cout << "test deep_merge\n";
+
+    // Two coincident samples merge into one
+    ImageSpec spec(1, 1, 6, TypeFloat);
+    spec.channelnames.assign({ "R", "G", "B", "A", "Z", "Zback" });
+    spec.z_channel = 4;
+    spec.deep      = true;
+    ImageBuf A(spec), B(spec);
+    A.set_deep_samples(0, 0, 0, 1);
+    B.set_deep_samples(0, 0, 0, 1);
+    const float Aval[] = { 0.5f, 0.5f, 0.5f, 0.5f, 1.0f, 2.0f };
+    const float Bval[] = { 0.25f, 0.25f, 0.25f, 0.5f, 1.0f, 2.0f };
+    for (int c = 0; c < 6; ++c) {
+        A.set_deep_value(0, 0, 0, c, 0, Aval[c]);
+        B.set_deep_value(0, 0, 0, c, 0, Bval[c]);
+    }
+    ImageBuf R = ImageBufAlgo::deep_merge(A, B);
+    OIIO_CHECK_EQUAL(R.deep_samples(0, 0, 0), 1);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 0, 0), 0.5625f, 1e-5f);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 3, 0), 0.75f, 1e-5f);
+
+    // The threaded results should match the single threaded ones
+    ImageBuf DA = make_deep_image(128, 6, 1);
+    ImageBuf DB = make_deep_image(128, 6, 2);
+    ImageBuf merged1, mergedN, holdout1, holdoutN;
+    OIIO_CHECK_ASSERT(ImageBufAlgo::deep_merge(merged1, DA, DB, true, {}, 1));
+    OIIO_CHECK_ASSERT(ImageBufAlgo::deep_merge(mergedN, DA, DB, true, {}, 0));
+    OIIO_CHECK_ASSERT(ImageBufAlgo::deep_holdout(holdout1, DA, DB, {}, 1));
+    OIIO_CHECK_ASSERT(ImageBufAlgo::deep_holdout(holdoutN, DA, DB, {}, 0));
+    for (int y = 0; y < 128; ++y)
+        for (int x = 0; x < 128; ++x) {
+            OIIO_CHECK_EQUAL(merged1.deep_samples(x, y, 0),
+                             mergedN.deep_samples(x, y, 0));
+            OIIO_CHECK_EQUAL(holdout1.deep_samples(x, y, 0),
+                             holdoutN.deep_samples(x, y, 0));
+        }
+    auto comp = ImageBufAlgo::compare(ImageBufAlgo::flatten(merged1, {}, 1),
+                                      ImageBufAlgo::flatten(mergedN), 0.0f,
+                                      0.0f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+    comp = ImageBufAlgo::compare(ImageBufAlgo::flatten(holdout1, {}, 1),
+                                 ImageBufAlgo::flatten(holdoutN), 0.0f, 0.0f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+
+    // The float/half fast path of merging deep pixels should agree, sample
+    // by sample, with the general path taken for any other channel types.
+    // (Without occlusion culling, which would cut the pixels wherever the
+    // half-rounded alpha of the general path happens to reach 1.)
+    ImageBuf fmerged = ImageBufAlgo::deep_merge(deep_copy_as(DA, false),
+                                                deep_copy_as(DB, false), false);
+    ImageBuf mmerged = ImageBufAlgo::deep_merge(deep_copy_as(DA, true),
+                                                deep_copy_as(DB, true), false);
+    int nsamplefail = 0, nvaluefail = 0;
+    for (int y = 0; y < 128; ++y)
+        for (int x = 0; x < 128; ++x) {
+            int n = fmerged.deep_samples(x, y, 0);
+            if (n != mmerged.deep_samples(x, y, 0)) {
+                ++nsamplefail;
+                continue;
+            }
+            for (int s = 0; s < n; ++s)
+                for (int c = 0; c < 6; ++c) {  // not id, see deep_copy_as
+                    float f = fmerged.deep_value(x, y, 0, c, s);
+                    float m = mmerged.deep_value(x, y, 0, c, s);
+                    // The general path's colors are stored as half
+                    if (std::abs(f - m) > 2e-3f * std::max(1.0f, std::abs(f)))
+                        ++nvaluefail;
+                }
+        }
+    OIIO_CHECK_EQUAL(nsamplefail, 0);
+    OIIO_CHECK_EQUAL(nvaluefail, 0);
+
+    // Timing
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    DA = make_deep_image(512, 8, 3);
+    DB = make_deep_image(512, 8, 4);
+    bench("  IBA::deep_merge ", [&]() {
+        ImageBuf M = ImageBufAlgo::deep_merge(DA, DB);
+    });
+    bench("  IBA::deep_holdout ", [&]() {
+        ImageBuf H = ImageBufAlgo::deep_holdout(DA, DB);
+    });
+    bench("  IBA::flatten ", [&]() { ImageBuf F = ImageBufAlgo::flatten(DA); });
+}
+
+
+
+// Test ImageBufAlgo::deep_reduce
+void
+test_deep_reduce()
+{
+    std::cout << "test deep_reduce\n";
+
+    // Two abutting samples of the same color become one
+    ImageSpec spec(1, 1, 6, TypeFloat);
+    spec.channelnames.assign({ "R", "G", "B", "A", "Z", "Zback" });
+    spec.z_channel = 4;
+    spec.deep      = true;
+    ImageBuf A(spec);
+    A.set_deep_samples(0, 0, 0, 2);
+    const float vals[2][6] = { { 0.25f, 0.25f, 0.25f, 0.5f, 1.0f, 2.0f },
+                               { 0.25f, 0.25f, 0.25f, 0.5f, 2.0f, 3.0f } };
+    for (int s = 0; s < 2; ++s)
+        for (int c = 0; c < 6; ++c)
+            A.set_deep_value(0, 0, 0, c, s, vals[s][c]);
+    ImageBufAlgo::DeepReduceStats stats;
+    ImageBuf R = ImageBufAlgo::deep_reduce(A, 0.0f, 0.0f, 1.0f, &stats);
+    OIIO_CHECK_EQUAL(R.deep_samples(0, 0, 0), 1);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 0, 0), 0.375f, 1e-6f);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 3, 0), 0.75f, 1e-6f);
+    OIIO_CHECK_EQUAL(R.deep_value(0, 0, 0, 4, 0), 1.0f);
+    OIIO_CHECK_EQUAL(R.deep_value(0, 0, 0, 5, 0), 3.0f);
+    OIIO_CHECK_EQUAL(stats.samples_in, 2);
+    OIIO_CHECK_EQUAL(stats.samples_out, 1);
+    OIIO_CHECK_EQUAL(stats.bytes_out, int64_t(6 * sizeof(float)));
+
+    // Without Zback, samples are points: a merged sample keeps the front
+    // Z, and later samples are measured from there.
+    ImageSpec zspec(1, 1, 5, TypeFloat);
+    zspec.channelnames.assign({ "R", "G", "B", "A", "Z" });
+    zspec.z_channel = 4;
+    zspec.deep      = true;
+    ImageBuf Z(zspec);
+    const float zs[4] = { 1.0f, 1.05f, 1.08f, 1.5f };
+    Z.set_deep_samples(0, 0, 0, 4);
+    for (int s = 0; s < 4; ++s) {
+        const float zvals[5] = { 0.25f, 0.25f, 0.25f, 0.5f, zs[s] };
+        for (int c = 0; c < 5; ++c)
+            Z.set_deep_value(0, 0, 0, c, s, zvals[c]);
+    }
+    R = ImageBufAlgo::deep_reduce(Z, 0.1f, 0.0f, 1.0f);
+    OIIO_CHECK_EQUAL(R.deep_samples(0, 0, 0), 2);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 0, 0), 0.4375f, 1e-6f);
+    OIIO_CHECK_EQUAL_THRESH(R.deep_value(0, 0, 0, 3, 0), 0.875f, 1e-6f);
+    OIIO_CHECK_EQUAL(R.deep_value(0, 0, 0, 4, 0), 1.0f);
+    OIIO_CHECK_EQUAL(R.deep_value(0, 0, 0, 4, 1), 1.5f);
+
+    // Merging samples doesn't change the flattened color
+    ImageBuf D  = make_deep_image(128, 8, 5);
+    ImageBuf DR = ImageBufAlgo::deep_reduce(D, 0.1f, 10.0f, 1.0f, &stats);
+    OIIO_CHECK_ASSERT(stats.samples_out < stats.samples_in);
+    ROI rgba(0, 128, 0, 128, 0, 1, 0, 4);
+    auto comp = ImageBufAlgo::compare(ImageBufAlgo::flatten(D),
+                                      ImageBufAlgo::flatten(DR), 1.0e-5f,
+                                      1.0e-5f, rgba);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+}
+
+
+
+// Test ImageBufAlgo::stream_deep
+void
+test_stream_deep()
+{
+    std::cout << "test stream_deep\n";
+    ImageBuf A = make_deep_image(50, 6, 7);
+    ImageBuf B = make_deep_image(50, 6, 8);
+    A.write("stream_deepA.exr");
+    B.write("stream_deepB.exr");
+
+    // Flatten, in bands that don't evenly divide the image height
+    bool ok = ImageBufAlgo::stream_deep(
+        "stream_flat.exr", { "stream_deepA.exr" },
+        [](ImageBuf& dst, cspan<ImageBuf> src) {
+            return ImageBufAlgo::flatten(dst, src[0]);
+        },
+        { { "bandheight", 16 } });
+    OIIO_CHECK_ASSERT(ok);
+    if (!ok)
+        std::cout << "  " << OIIO::geterror() << "\n";
+    ImageBuf flat("stream_flat.exr");
+    auto comp = ImageBufAlgo::compare(flat, ImageBufAlgo::flatten(A), 1.0e-6f,
+                                      1.0e-6f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+
+    // Merge two deep files into a deep file
+    ok = ImageBufAlgo::stream_deep(
+        "stream_merged.exr", { "stream_deepA.exr", "stream_deepB.exr" },
+        [](ImageBuf& dst, cspan<ImageBuf> src) {
+            return ImageBufAlgo::deep_merge(dst, src[0], src[1]);
+        },
+        { { "bandheight", 16 } });
+    OIIO_CHECK_ASSERT(ok);
+    if (!ok)
+        std::cout << "  " << OIIO::geterror() << "\n";
+    ImageBuf merged("stream_merged.exr");
+    OIIO_CHECK_ASSERT(merged.deep());
+    ImageBuf expected = ImageBufAlgo::deep_merge(A, B);
+    comp = ImageBufAlgo::compare(ImageBufAlgo::flatten(merged),
+                                 ImageBufAlgo::flatten(expected), 1.0e-6f,
+                                 1.0e-6f);
+    OIIO_CHECK_EQUAL(comp.nfail, 0);
+
+    for (auto f : { "stream_deepA.exr", "stream_deepB.exr", "stream_flat.exr",
+                    "stream_merged.exr" })
+        Filesystem::remove(f);
+}
+
+
+
 // Tests ImageBufAlgo::compare
 void
 test_compare()
@@ -993,6 +1508,68 @@ test_IBAprep()
 
 
 
+// Test the "fast" warp against the default implementation
+void
+test_warp()
+{
+    std::cout << "test warp\n";
+    ImageBuf src(ImageSpec(256, 256, 3, TypeFloat));
+    ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 42);
+    ImageBufAlgo::fill(src, { 0.5f, 0.5f, 0.5f }, ROI(64, 192, 64, 192));
+
+    // A rotation that mostly preserves scale, and a shrinking rotation
+    Imath::M33f rot, shrink;
+    rot.translate(Imath::V2f(-128.0f, -128.0f));
+    rot.rotate(0.3f);
+    rot *= Imath::M33f().translate(Imath::V2f(128.0f, 128.0f));
+    shrink = rot * Imath::M33f().scale(Imath::V2f(0.4f, 0.4f));
+    for (auto M : { rot, shrink }) {
+        for (const char* filt : { "triangle", "catmull-rom", "lanczos3",
+                                  "disk" }) {
+            for (const char* wrap : { "black", "clamp" }) {
+                ImageBuf exact = ImageBufAlgo::warp(src, M,
+                                                    { { "filtername", filt },
+                                                      { "wrap", wrap } });
+                ImageBuf fast  = ImageBufAlgo::warp(src, M,
+                                                    { { "filtername", filt },
+                                                      { "wrap", wrap },
+                                                      { "fast", 1 } });
+                auto comp = ImageBufAlgo::compare(exact, fast, 1.0e-3f,
+                                                  1.0e-3f);
+                OIIO_CHECK_EQUAL(comp.nfail, 0);
+                if (comp.nfail)
+                    print("  {} wrap={}: max error {} at ({}, {})\n", filt,
+                          wrap, comp.maxerror, comp.maxx, comp.maxy);
+            }
+        }
+    }
+
+    // Timing
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    ImageBuf big(ImageSpec(2048, 2048, 4, TypeHalf));
+    ImageBufAlgo::noise(big, "uniform", 0.0f, 1.0f, false, 42);
+    Imath::M33f bigrot;
+    bigrot.translate(Imath::V2f(-1024.0f, -1024.0f));
+    bigrot.rotate(0.3f);
+    bigrot *= Imath::M33f().translate(Imath::V2f(1024.0f, 1024.0f));
+    ImageBuf dst(ImageSpec(2048, 2048, 4, TypeHalf));
+    for (const char* filt : { "triangle", "lanczos3" }) {
+        bench(Strutil::fmt::format("  IBA::warp half[4] 2k {} ", filt),
+              [&]() {
+                  ImageBufAlgo::warp(dst, big, bigrot,
+                                     { { "filtername", filt }, { "fast", 0 } });
+              });
+        bench(Strutil::fmt::format("  IBA::warp half[4] 2k {} fast ", filt),
+              [&]() {
+                  ImageBufAlgo::warp(dst, big, bigrot,
+                                     { { "filtername", filt }, { "fast", 1 } });
+              });
+    }
+}
+
+
+
 // Test extra validation checks done by `st_warp`
 void
 test_validate_st_warp_checks()
@@ -1169,6 +1746,71 @@ test_color_management()
 
 
 
+// Test the look-up colorconvert used for integer sources against the
+// float path that applies the processor to every pixel.
+static void
+test_colorconvert_lut()
+{
+    std::cout << "test colorconvert LUT\n";
+    ColorConfig config;
+    auto tolinear = config.createColorProcessor("srgb", "lin_srgb");
+    if (!tolinear)
+        tolinear = ColorConfig("ocio://default")
+                       .createColorProcessor("srgb", "lin_srgb");
+    // A matrix has channel crosstalk, so will use a 3D LUT
+    Imath::M44f M(0.8f, 0.1f, 0.1f, 0.0f, 0.2f, 0.7f, 0.1f, 0.0f, 0.05f,
+                  0.05f, 0.9f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+    auto matrix = config.createMatrixTransform(M);
+    OIIO_CHECK_ASSERT(tolinear && matrix);
+
+    ImageSpec fspec(640, 512, 4, TypeFloat);
+    for (auto& processor : { tolinear, matrix }) {
+        if (!processor)
+            continue;
+        for (TypeDesc t : { TypeUInt8, TypeUInt16 }) {
+            ImageBuf src(ImageSpec(640, 512, 4, t));
+            ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 1);
+            ImageBuf srcfloat = ImageBufAlgo::copy(src, TypeFloat);
+            ImageBuf looked(fspec), exact(fspec);
+            OIIO_CHECK_ASSERT(ImageBufAlgo::colorconvert(looked, src,
+                                                         processor.get(),
+                                                         false));
+            OIIO_CHECK_ASSERT(ImageBufAlgo::colorconvert(exact, srcfloat,
+                                                         processor.get(),
+                                                         false));
+            auto comp = ImageBufAlgo::compare(looked, exact, 1.0e-3f,
+                                              1.0e-3f);
+            OIIO_CHECK_EQUAL(comp.nfail, 0);
+        }
+    }
+
+    // Timing
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    ImageBuf src8(ImageSpec(2048, 2048, 4, TypeUInt8));
+    ImageBufAlgo::noise(src8, "uniform", 0.0f, 1.0f, false, 1);
+    ImageBuf srcf = ImageBufAlgo::copy(src8, TypeFloat);
+    ImageBuf dst8(src8.spec()), dstf(srcf.spec());
+    for (auto& processor : { tolinear, matrix }) {
+        if (!processor)
+            continue;
+        const char* name = processor == tolinear ? "srgb->linear" : "matrix";
+        bench(Strutil::fmt::format("  IBA::colorconvert {} uint8 (LUT) ",
+                                   name),
+              [&]() {
+                  ImageBufAlgo::colorconvert(dst8, src8, processor.get(),
+                                             false);
+              });
+        bench(Strutil::fmt::format("  IBA::colorconvert {} float ", name),
+              [&]() {
+                  ImageBufAlgo::colorconvert(dstf, srcf, processor.get(),
+                                             false);
+              });
+    }
+}
+
+
+
 static void
 test_yee()
 {
@@ -1204,6 +1846,9 @@ main(int argc, char** argv)
     test_zero_fill();
     test_copy();
     test_crop();
+    test_resize();
+    test_fillholes_pushpull();
+    test_stream_pointwise();
     test_paste();
     test_channel_append();
     test_add();
@@ -1215,6 +1860,9 @@ main(int argc, char** argv)
     test_over(TypeFloat);
     test_over(TypeHalf);
     test_zover();
+    test_deep_merge();
+    test_deep_reduce();
+    test_stream_deep();
     test_compare();
     test_isConstantColor();
     test_isConstantChannel();
@@ -1223,9 +1871,11 @@ main(int argc, char** argv)
     histogram_computation_test();
     test_maketx_from_imagebuf();
     test_IBAprep();
+    test_warp();
     test_validate_st_warp_checks();
     test_opencv();
     test_color_management();
+    test_colorconvert_lut();
     test_yee();
 
     benchmark_parallel_image(64, iterations * 64);
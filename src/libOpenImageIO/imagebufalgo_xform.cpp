@@ -7,7 +7,9 @@
 
 
 #include <cmath>
+#include <limits>
 #include <memory>
+#include <vector>
 
 #include <OpenImageIO/Imath.h>
 
@@ -17,6 +19,7 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imagebufalgo_util.h>
+#include <OpenImageIO/simd.h>
 #include <OpenImageIO/thread.h>
 
 #include <Imath/ImathBox.h>
@@ -28,6 +31,7 @@ namespace {
 
 static const ustring edgeclamp_us("edgeclamp");
 static const ustring exact_us("exact");
+static const ustring fast_us("fast");
 static const ustring fillmode_us("fillmode");
 static const ustring filtername_us("filtername");
 static const ustring filterptr_us("filterptr");
@@ -373,10 +377,329 @@ warp_(ImageBuf& dst, const ImageBuf& src, const Imath::M33f& M,
 
 
 
+namespace {
+
+// Lookup table for one axis of a separable filter, so that the fast warp
+// doesn't need a virtual call to evaluate the filter for every tap. Linear
+// interpolation of 256 samples per unit of filter space is well within the
+// precision of the result. The filter is taken to be zero outside of its
+// width.
+class FilterLUT {
+public:
+    FilterLUT(const Filter2D* filter, bool yaxis)
+        : m_radius(0.5f * (yaxis ? filter->height() : filter->width()))
+    {
+        int n = int(ceilf(2.0f * m_radius * res)) + 2;
+        m_table.resize(n);
+        for (int i = 0; i < n; ++i) {
+            float x    = std::min(float(i) / res - m_radius, m_radius);
+            m_table[i] = yaxis ? filter->yfilt(x) : filter->xfilt(x);
+        }
+    }
+
+    float operator()(float x) const
+    {
+        float f = (x + m_radius) * res;
+        if (!(f >= 0.0f && f < float(m_table.size() - 1)))
+            return 0.0f;
+        int i = int(f);
+        return lerp(m_table[i], m_table[i + 1], f - float(i));
+    }
+
+private:
+    static constexpr float res = 256.0f;
+    float m_radius;
+    std::vector<float> m_table;
+};
+
+
+
+// Where one output pixel samples the source, and with what footprint,
+// as computed by filtered_sample().
+struct WarpSample {
+    float s, t, ds_inv, dt_inv;
+    int smin, smax, tmin, tmax;
+    bool black;  // edgeclamp says this pixel is black
+};
+
+
+
+// Filtered sample of `nc` channels from a float copy `cache` of the source
+// region `cached`, for the general footprint of `ws`. Channels are
+// accumulated in a vfloat4 when there are no more than 4 of them (the
+// cache is padded so that the last pixel can be loaded as a vfloat4).
+static void
+sample_cached(const float* cache, const ROI& cached, int nc,
+              const WarpSample& ws, const Filter2D* filter,
+              const FilterLUT& xlut, const FilterLUT& ylut,
+              std::vector<float>& wx, std::vector<float>& wy, float* result)
+{
+    using namespace simd;
+    int nx = ws.smax - ws.smin, ny = ws.tmax - ws.tmin;
+    const size_t rowstride = size_t(cached.width()) * nc;
+    const float* p = cache + size_t(ws.tmin - cached.ybegin) * rowstride
+                     + size_t(ws.smin - cached.xbegin) * nc;
+    for (int c = 0; c < nc; ++c)
+        result[c] = 0.0f;
+    float total = 0.0f;
+    if (filter->separable()) {
+        wx.resize(nx);
+        wy.resize(ny);
+        float xtotal = 0.0f, ytotal = 0.0f;
+        for (int i = 0; i < nx; ++i) {
+            wx[i] = xlut(ws.ds_inv * (float(ws.smin + i) + 0.5f - ws.s));
+            xtotal += wx[i];
+        }
+        for (int j = 0; j < ny; ++j) {
+            wy[j] = ylut(ws.dt_inv * (float(ws.tmin + j) + 0.5f - ws.t));
+            ytotal += wy[j];
+        }
+        total = xtotal * ytotal;
+        if (total > 0.0f && nc <= 4) {
+            vfloat4 sum = vfloat4::Zero();
+            for (int j = 0; j < ny; ++j, p += rowstride) {
+                vfloat4 rowsum = vfloat4::Zero();
+                for (int i = 0; i < nx; ++i)
+                    rowsum = madd(vfloat4(p + i * nc), vfloat4(wx[i]), rowsum);
+                sum = madd(rowsum, vfloat4(wy[j]), sum);
+            }
+            sum *= vfloat4(1.0f / total);
+            sum.store(result, nc);
+            return;
+        }
+        if (total > 0.0f) {
+            for (int j = 0; j < ny; ++j, p += rowstride)
+                for (int i = 0; i < nx; ++i)
+                    for (int c = 0; c < nc; ++c)
+                        result[c] += wx[i] * wy[j] * p[i * nc + c];
+        }
+    } else {
+        for (int j = 0; j < ny; ++j, p += rowstride) {
+            float v = ws.dt_inv * (float(ws.tmin + j) + 0.5f - ws.t);
+            for (int i = 0; i < nx; ++i) {
+                float w = (*filter)(ws.ds_inv
+                                        * (float(ws.smin + i) + 0.5f - ws.s),
+                                    v);
+                for (int c = 0; c < nc; ++c)
+                    result[c] += w * p[i * nc + c];
+                total += w;
+            }
+        }
+    }
+    float scale = total > 0.0f ? 1.0f / total : 0.0f;
+    for (int c = 0; c < nc; ++c)
+        result[c] *= scale;
+}
+
+
+
+// Specialized filtered sample for pixels that are not minified (i.e., near-
+// identity warps) with a separable filter of even width TAPS that is zero at
+// its edges -- bilinear for TAPS=2 (triangle), bicubic for TAPS=4
+// (catmull-rom, mitchell, bspline, cubic). Only the TAPS x TAPS pixels that
+// can have nonzero weight are visited, with the loops fully unrolled. At
+// most 4 channels.
+template<int TAPS>
+static void
+sample_fixed(const float* cache, const ROI& cached, int nc,
+             const WarpSample& ws, const FilterLUT& xlut,
+             const FilterLUT& ylut, float* result)
+{
+    using namespace simd;
+    int x0 = ifloor(ws.s - 0.5f) - (TAPS / 2 - 1);
+    int y0 = ifloor(ws.t - 0.5f) - (TAPS / 2 - 1);
+    float wx[TAPS], wy[TAPS];
+    float xtotal = 0.0f, ytotal = 0.0f;
+    for (int i = 0; i < TAPS; ++i) {
+        wx[i] = xlut(float(x0 + i) + 0.5f - ws.s);
+        wy[i] = ylut(float(y0 + i) + 0.5f - ws.t);
+        xtotal += wx[i];
+        ytotal += wy[i];
+    }
+    float total = xtotal * ytotal;
+    if (!(total > 0.0f)) {
+        for (int c = 0; c < nc; ++c)
+            result[c] = 0.0f;
+        return;
+    }
+    const size_t rowstride = size_t(cached.width()) * nc;
+    const float* p         = cache + size_t(y0 - cached.ybegin) * rowstride
+                     + size_t(x0 - cached.xbegin) * nc;
+    vfloat4 sum = vfloat4::Zero();
+    for (int j = 0; j < TAPS; ++j, p += rowstride) {
+        vfloat4 rowsum = vfloat4::Zero();
+        for (int i = 0; i < TAPS; ++i)
+            rowsum = madd(vfloat4(p + i * nc), vfloat4(wx[i]), rowsum);
+        sum = madd(rowsum, vfloat4(wy[j]), sum);
+    }
+    sum *= vfloat4(1.0f / total);
+    sum.store(result, nc);
+}
+
+
+
+// If `filter` is separable, has equal even integer width and height no
+// larger than 4, and is zero at its edges, return its width (the number of
+// taps sample_fixed needs per axis for non-minified pixels), else 0.
+static int
+fixed_taps(const Filter2D* filter)
+{
+    float w = filter->width();
+    if (!filter->separable() || w != filter->height()
+        || (w != 2.0f && w != 4.0f))
+        return 0;
+    float r = 0.5f * w;
+    if (filter->xfilt(r) != 0.0f || filter->xfilt(-r) != 0.0f
+        || filter->yfilt(r) != 0.0f || filter->yfilt(-r) != 0.0f)
+        return 0;
+    return int(w);
+}
+
+}  // namespace
+
+
+
+// The "fast" warp. It computes the same filtered samples as warp_ (with the
+// same footprints and edge handling), but: visits the output in small
+// tiles, fetching the source region under each tile's footprints just once
+// as contiguous float data that stays in cache; evaluates separable filters
+// through lookup tables rather than calling the filter for every tap; and
+// uses unrolled bilinear/bicubic kernels for non-minified pixels. Tiles
+// whose footprint is too big to fetch (strong minification or perspective),
+// or that need a wrap mode other than black beyond the source data window,
+// fall back to the general per-pixel filtered_sample.
+template<typename SRCTYPE>
+static bool
+warp_fast_(ImageBuf& dst, const ImageBuf& src, const Imath::M33f& M,
+           const Filter2D* filter, ImageBuf::WrapMode wrap, bool edgeclamp,
+           ROI roi, int nthreads)
+{
+    const int tilesize         = 32;
+    const imagesize_t maxfetch = 16 * tilesize * tilesize;
+    const Imath::M33f Minv     = M.inverse();
+    const int nc               = roi.nchannels();
+    const FilterLUT xlut(filter, false), ylut(filter, true);
+    const int taps = (edgeclamp || nc > 4) ? 0 : fixed_taps(filter);
+    if (wrap == ImageBuf::WrapDefault)
+        wrap = ImageBuf::WrapBlack;
+
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        std::vector<WarpSample> samples(tilesize * tilesize);
+        std::vector<float> out(size_t(tilesize) * tilesize * nc);
+        std::vector<float> cache, wx, wy;
+        float* pel = OIIO_ALLOCA(float, src.nchannels());
+        for (int ty = roi.ybegin; ty < roi.yend; ty += tilesize) {
+            for (int tx = roi.xbegin; tx < roi.xend; tx += tilesize) {
+                ROI tile(tx, std::min(tx + tilesize, roi.xend), ty,
+                         std::min(ty + tilesize, roi.yend), roi.zbegin,
+                         roi.zend, roi.chbegin, roi.chend);
+                // First pass: find where each pixel of the tile samples
+                // the source, and the union of their footprints.
+                ROI footprint;
+                WarpSample* ws = samples.data();
+                for (int y = tile.ybegin; y < tile.yend; ++y) {
+                    for (int x = tile.xbegin; x < tile.xend; ++x, ++ws) {
+                        Dual2 xx(x + 0.5f, 1.0f, 0.0f);
+                        Dual2 yy(y + 0.5f, 0.0f, 1.0f);
+                        robust_multVecMatrix(Minv, xx, yy, xx, yy);
+                        // Same footprint as filtered_sample()
+                        float ds = std::max(1.0f, std::max(fabsf(xx.dx()),
+                                                           fabsf(xx.dy())));
+                        float dt = std::max(1.0f, std::max(fabsf(yy.dx()),
+                                                           fabsf(yy.dy())));
+                        float rad_s = 0.5f * ds * filter->width();
+                        float rad_t = 0.5f * dt * filter->width();
+                        ws->s       = xx.val();
+                        ws->t       = yy.val();
+                        ws->ds_inv  = 1.0f / ds;
+                        ws->dt_inv  = 1.0f / dt;
+                        ws->smin    = (int)floorf(ws->s - rad_s);
+                        ws->smax    = (int)ceilf(ws->s + rad_s);
+                        ws->tmin    = (int)floorf(ws->t - rad_t);
+                        ws->tmax    = (int)ceilf(ws->t + rad_t);
+                        ws->black   = false;
+                        if (edgeclamp) {
+                            ws->smin = clamp(ws->smin, src.xbegin(),
+                                             src.xend());
+                            ws->smax = clamp(ws->smax, src.xbegin(),
+                                             src.xend());
+                            ws->tmin = clamp(ws->tmin, src.ybegin(),
+                                             src.yend());
+                            ws->tmax = clamp(ws->tmax, src.ybegin(),
+                                             src.yend());
+                            ws->black = (ws->s < src.xbegin() - 1
+                                         || ws->s >= src.xend()
+                                         || ws->t < src.ybegin() - 1
+                                         || ws->t >= src.yend());
+                        }
+                        if (!ws->black && ws->smin < ws->smax
+                            && ws->tmin < ws->tmax)
+                            footprint = roi_union(footprint,
+                                                  ROI(ws->smin, ws->smax,
+                                                      ws->tmin, ws->tmax));
+                    }
+                }
+                footprint.zbegin  = 0;
+                footprint.zend    = 1;
+                footprint.chbegin = roi.chbegin;
+                footprint.chend   = roi.chend;
+                // Fetch the footprint as float, if it's not too big and
+                // anything outside the data window can read as black.
+                bool cached = footprint.defined()
+                              && footprint.npixels() <= maxfetch
+                              && (wrap == ImageBuf::WrapBlack
+                                  || src.contains_roi(footprint));
+                if (cached) {
+                    cache.resize(footprint.npixels() * nc + 4);
+                    src.get_pixels(footprint, TypeFloat, cache.data());
+                }
+                // Second pass: compute the filtered samples.
+                ws          = samples.data();
+                float* outp = out.data();
+                for (int y = tile.ybegin; y < tile.yend; ++y) {
+                    for (int x = tile.xbegin; x < tile.xend;
+                         ++x, ++ws, outp += nc) {
+                        if (ws->black || ws->smin >= ws->smax
+                            || ws->tmin >= ws->tmax) {
+                            for (int c = 0; c < nc; ++c)
+                                outp[c] = 0.0f;
+                        } else if (cached && taps == 2 && ws->ds_inv == 1.0f
+                                   && ws->dt_inv == 1.0f) {
+                            sample_fixed<2>(cache.data(), footprint, nc, *ws,
+                                            xlut, ylut, outp);
+                        } else if (cached && taps == 4 && ws->ds_inv == 1.0f
+                                   && ws->dt_inv == 1.0f) {
+                            sample_fixed<4>(cache.data(), footprint, nc, *ws,
+                                            xlut, ylut, outp);
+                        } else if (cached) {
+                            sample_cached(cache.data(), footprint, nc, *ws,
+                                          filter, xlut, ylut, wx, wy, outp);
+                        } else {
+                            Dual2 xx(x + 0.5f, 1.0f, 0.0f);
+                            Dual2 yy(y + 0.5f, 0.0f, 1.0f);
+                            robust_multVecMatrix(Minv, xx, yy, xx, yy);
+                            filtered_sample<SRCTYPE>(src, xx.val(), yy.val(),
+                                                     xx.dx(), yy.dx(), xx.dy(),
+                                                     yy.dy(), filter, wrap,
+                                                     edgeclamp, pel);
+                            for (int c = 0; c < nc; ++c)
+                                outp[c] = pel[roi.chbegin + c];
+                        }
+                    }
+                }
+                dst.set_pixels(tile, TypeFloat, out.data());
+            }
+        }
+    });
+    return true;
+}
+
+
+
 static bool
 warp_impl(ImageBuf& dst, const ImageBuf& src, const Imath::M33f& M,
           const Filter2D* filter, bool recompute_roi, ImageBuf::WrapMode wrap,
-          bool edgeclamp, ROI roi, int nthreads)
+          bool edgeclamp, ROI roi, int nthreads, bool fast = false)
 {
     pvt::LoggedTimer logtime("IBA::warp");
     ROI src_roi_full = src.roi_full();
@@ -406,6 +729,12 @@ warp_impl(ImageBuf& dst, const ImageBuf& src, const Imath::M33f& M,
     }
 
     bool ok;
+    if (fast) {
+        OIIO_DISPATCH_TYPES(ok, "warp", warp_fast_, src.spec().format, dst,
+                            src, M, filter, wrap, edgeclamp, dst_roi,
+                            nthreads);
+        return ok;
+    }
     OIIO_DISPATCH_COMMON_TYPES2(ok, "warp", warp_, dst.spec().format,
                                 src.spec().format, dst, src, M, filter, wrap,
                                 edgeclamp, dst_roi, nthreads);
@@ -467,7 +796,8 @@ ImageBufAlgo::warp(ImageBuf& dst, const ImageBuf& src, M33fParam M,
 {
     static const ustring recognized[] = { filtername_us,    filterwidth_us,
                                           wrap_us,          edgeclamp_us,
-                                          recompute_roi_us, filterptr_us };
+                                          recompute_roi_us, filterptr_us,
+                                          fast_us };
     IBA_check_optional(options, recognized);
 
     Filter2D::ref filterptr = get_filterptr_option(options);
@@ -492,9 +822,10 @@ ImageBufAlgo::warp(ImageBuf& dst, const ImageBuf& src, M33fParam M,
     }
     bool recompute_roi = options.get_int(recompute_roi_us, 0);
     bool edgeclamp     = options.get_int(edgeclamp_us, 0);
+    bool fast          = options.get_int(fast_us, 0);
 
     return warp_impl(dst, src, M, filterptr.get(), recompute_roi, wrap,
-                     edgeclamp, roi, nthreads);
+                     edgeclamp, roi, nthreads, fast);
 }
 
 
@@ -868,6 +1199,266 @@ resize_(ImageBuf& dst, const ImageBuf& src, const Filter2D* filter, ROI roi,
 }
 
 
+// Precomputed, normalized filter tap weights for one axis of a separable
+// resize. Output coordinate `begin+i` filters the source coordinates
+// [first[i], first[i]+taps) with weights w[i*stride ... i*stride+taps).
+// Each weight row is zero-padded out to `stride` (a multiple of 4) so the
+// inner loops can run at full SIMD width without a remainder.
+struct ResizeWeights {
+    int begin  = 0;  // first output coordinate
+    int taps   = 0;  // real number of filter taps
+    int stride = 0;  // taps, rounded up to a multiple of 4
+    std::vector<int> first;
+    std::vector<float> w;
+
+    const float* weights(int i) const { return w.data() + size_t(i) * stride; }
+};
+
+
+
+// Fill in the tap weights for output coordinates [begin,end) along one
+// axis. This computes exactly the same weights (and the same source
+// footprint) as the separable branch of resize_.
+static void
+compute_resize_weights(ResizeWeights& rw, const Filter2D* filter, bool yaxis,
+                       int begin, int end, float dstf, float dstfw, float srcf,
+                       float srcfw)
+{
+    float ratio     = dstfw / srcfw;
+    float filterrad = filter->width() / 2.0f;
+    int rad         = (int)ceilf(filterrad / ratio);
+    int n           = end - begin;
+    rw.begin        = begin;
+    rw.taps         = 2 * rad + 1;
+    rw.stride       = round_to_multiple(rw.taps, 4);
+    rw.first.resize(n);
+    rw.w.assign(size_t(n) * rw.stride, 0.0f);
+    float dstpixelsize = 1.0f / dstfw;
+    for (int i = 0; i < n; ++i) {
+        float s     = (begin + i - dstf + 0.5f) * dstpixelsize;
+        float srcxf = srcf + s * srcfw;
+        int src_x;
+        float frac  = floorfrac(srcxf, &src_x);
+        float* w    = rw.w.data() + size_t(i) * rw.stride;
+        float total = 0.0f;
+        for (int t = 0; t < rw.taps; ++t) {
+            float x = ratio * (t - rad - (frac - 0.5f));
+            w[t]    = yaxis ? filter->yfilt(x) : filter->xfilt(x);
+            total += w[t];
+        }
+        if (total != 0.0f) {
+            for (int t = 0; t < rw.taps; ++t)
+                w[t] /= total;
+        } else {
+            // Zero total weight means a zero result, as in resize_.
+            for (int t = 0; t < rw.taps; ++t)
+                w[t] = 0.0f;
+        }
+        rw.first[i] = src_x - rad;
+    }
+}
+
+
+
+// Horizontal pass of the separable resize: filter one source row `in`
+// (float, nchannels interleaved, whose first pixel is source column
+// `inx`) into `n` output pixels starting at output column `xbegin`.
+// NCH is the channel count for the specialized 1/3/4 channel cases, or 0
+// for the general case (which uses the run-time `nchannels`). The `in`
+// row must be padded with at least `stride-taps` pixels plus one float
+// past its end, so the SIMD loads never read out of bounds.
+template<int NCH>
+static void
+resize_hfilter(const float* in, int inx, float* out, int xbegin, int n,
+               const ResizeWeights& xw, int nchannels)
+{
+    using namespace simd;
+    int taps = xw.taps;
+    for (int i = 0; i < n; ++i) {
+        int ix         = xbegin - xw.begin + i;
+        const float* w = xw.weights(ix);
+        const float* p = in + size_t(xw.first[ix] - inx) * nchannels;
+        float* o       = out + size_t(i) * nchannels;
+        if (NCH == 1) {
+            // One channel: vectorize across the (padded) taps.
+            vfloat4 acc = vfloat4::Zero();
+            for (int t = 0; t < xw.stride; t += 4)
+                acc = madd(vfloat4(w + t), vfloat4(p + t), acc);
+            o[0] = reduce_add(acc);
+        } else if (NCH == 3 || NCH == 4) {
+            // 3 or 4 channels: one SIMD lane per channel.
+            vfloat4 acc = vfloat4::Zero();
+            for (int t = 0; t < taps; ++t, p += NCH)
+                acc = madd(vfloat4(w[t]), vfloat4(p), acc);
+            acc.store(o, NCH);
+        } else {
+            for (int c = 0; c < nchannels; ++c)
+                o[c] = 0.0f;
+            for (int t = 0; t < taps; ++t, p += nchannels)
+                for (int c = 0; c < nchannels; ++c)
+                    o[c] += w[t] * p[c];
+        }
+    }
+}
+
+
+
+// Vertical pass of the separable resize: out[i] = sum_j w[j]*rows[j][i]
+// for n contiguous floats.
+static void
+resize_vfilter(float* out, const float* const* rows, const float* w, int taps,
+               size_t n)
+{
+    using namespace simd;
+    memset(out, 0, n * sizeof(float));
+    for (int j = 0; j < taps; ++j) {
+        if (w[j] == 0.0f)
+            continue;
+        const float* r = rows[j];
+        vfloat4 wj(w[j]);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            madd(wj, vfloat4(r + i), vfloat4(out + i)).store(out + i);
+        for (; i < n; ++i)
+            out[i] += w[j] * r[i];
+    }
+}
+
+
+
+// Separable resize done as two passes: each needed source row is filtered
+// horizontally (once) into a float row of output width, and those rows
+// are then filtered vertically into the output scanlines. Each thread
+// keeps a ring of the last `ytaps` horizontally-filtered rows, so the
+// intermediate storage is bounded by ytaps scanlines per thread no matter
+// how large the source is, and a source row shared by consecutive output
+// rows is only filtered once. Edge handling matches resize_'s WrapClamp:
+// taps are clamped to the union of the source's data and full (display)
+// windows, so overscan pixels are used rather than clamped away, and are
+// black outside the data window. (resize_ wraps whole pixels, so it only
+// differs where taps run past the edge of an overscan data window.)
+template<typename DSTTYPE, typename SRCTYPE>
+static bool
+resize_separable_(ImageBuf& dst, const ImageBuf& src, const Filter2D* filter,
+                  ROI roi, int nthreads)
+{
+    const ImageSpec& srcspec(src.spec());
+    const ImageSpec& dstspec(dst.spec());
+    const int nchannels = dstspec.nchannels;
+    OIIO_DASSERT(src.nchannels() == nchannels && filter->separable());
+
+    // Precompute the tap weights for every output column and row of the
+    // whole roi, shared by all threads.
+    ResizeWeights xw, yw;
+    compute_resize_weights(xw, filter, false, roi.xbegin, roi.xend,
+                           float(dstspec.full_x), float(dstspec.full_width),
+                           float(srcspec.full_x), float(srcspec.full_width));
+    compute_resize_weights(yw, filter, true, roi.ybegin, roi.yend,
+                           float(dstspec.full_y), float(dstspec.full_height),
+                           float(srcspec.full_y), float(srcspec.full_height));
+
+    typedef void (*hfilter_t)(const float*, int, float*, int, int,
+                              const ResizeWeights&, int);
+    hfilter_t hfilter = nchannels == 1   ? resize_hfilter<1>
+                        : nchannels == 3 ? resize_hfilter<3>
+                        : nchannels == 4 ? resize_hfilter<4>
+                                         : resize_hfilter<0>;
+
+    const int srcx0 = std::min(srcspec.full_x, src.xbegin());
+    const int srcx1 = std::max(srcspec.full_x + srcspec.full_width,
+                               src.xend())
+                      - 1;
+    const int srcy0 = std::min(srcspec.full_y, src.ybegin());
+    const int srcy1 = std::max(srcspec.full_y + srcspec.full_height,
+                               src.yend())
+                      - 1;
+    const bool srcdirect = src.localpixels()
+                           && src.pixel_stride()
+                                  == stride_t(nchannels * sizeof(SRCTYPE));
+    const bool dstdirect = dst.localpixels()
+                           && dst.pixel_stride()
+                                  == stride_t(nchannels * sizeof(DSTTYPE));
+
+    ImageBufAlgo::parallel_image(roi, nthreads, [&](ROI roi) {
+        const int width     = roi.width();
+        const size_t rowlen = size_t(width) * nchannels;
+        const int z         = roi.zbegin;
+
+        // Source columns [xa,xb) are needed for this roi's columns.
+        int xa = xw.first[roi.xbegin - xw.begin];
+        int xb = xw.first[roi.xend - 1 - xw.begin] + xw.taps;
+        // The clamped (to the data and full windows) range we actually
+        // have to fetch.
+        int cxa = clamp(xa, srcx0, srcx1);
+        int cxb = clamp(xb - 1, srcx0, srcx1) + 1;
+        // Slot of cxa in srcrow. If the roi maps entirely past one edge of
+        // the source, [cxa,cxb) is just that edge pixel, outside [xa,xb),
+        // so it goes in the nearest slot and fills all the others.
+        int lo = clamp(cxa - xa, 0, xb - xa - (cxb - cxa));
+        std::unique_ptr<float[]> srcrow(
+            new float[size_t(xb - xa + xw.stride) * nchannels + 4]());
+        float* core = srcrow.get() + size_t(lo) * nchannels;
+
+        // Ring of horizontally filtered rows, keyed by clamped source row.
+        // The rows needed by any one output row are a contiguous range of
+        // at most ytaps values, so they never collide in a ring of ytaps.
+        const int ringsize = yw.taps;
+        std::unique_ptr<float[]> ring(new float[ringsize * rowlen]);
+        std::vector<int> ringrow(ringsize, std::numeric_limits<int>::min());
+        const float** rows = OIIO_ALLOCA(const float*, yw.taps);
+        std::unique_ptr<float[]> outrow(new float[rowlen]);
+
+        auto hrow = [&](int y) -> const float* {
+            int cy    = clamp(y, srcy0, srcy1);
+            int slot  = ((cy % ringsize) + ringsize) % ringsize;
+            float* hr = ring.get() + slot * rowlen;
+            if (ringrow[slot] == cy)
+                return hr;
+            // Fetch the source row, converted to float
+            if (srcdirect && cy >= src.ybegin() && cy < src.yend()
+                && cxa >= src.xbegin() && cxb <= src.xend()) {
+                convert_type((const SRCTYPE*)src.pixeladdr(cxa, cy, z), core,
+                             size_t(cxb - cxa) * nchannels);
+            } else {
+                src.get_pixels(ROI(cxa, cxb, cy, cy + 1, z, z + 1, 0,
+                                   nchannels),
+                               TypeFloat, core);
+            }
+            // Replicate the edge pixels for taps outside both windows
+            for (int i = 0; i < lo; ++i)
+                memcpy(srcrow.get() + size_t(i) * nchannels, core,
+                       nchannels * sizeof(float));
+            const float* last = core + size_t(cxb - cxa - 1) * nchannels;
+            for (int i = lo + cxb - cxa; i < xb - xa; ++i)
+                memcpy(srcrow.get() + size_t(i) * nchannels, last,
+                       nchannels * sizeof(float));
+            hfilter(srcrow.get(), xa, hr, roi.xbegin, width, xw, nchannels);
+            ringrow[slot] = cy;
+            return hr;
+        };
+
+        for (int y = roi.ybegin; y < roi.yend; ++y) {
+            int iy = y - yw.begin;
+            for (int j = 0; j < yw.taps; ++j)
+                rows[j] = hrow(yw.first[iy] + j);
+            resize_vfilter(outrow.get(), rows, yw.weights(iy), yw.taps,
+                           rowlen);
+            if (dstdirect) {
+                convert_type(outrow.get(),
+                             (DSTTYPE*)dst.pixeladdr(roi.xbegin, y, z),
+                             rowlen);
+            } else {
+                dst.set_pixels(ROI(roi.xbegin, roi.xend, y, y + 1, z, z + 1,
+                                   0, nchannels),
+                               TypeFloat, outrow.get());
+            }
+        }
+    });
+    return true;
+}
+
+
+
 
 static std::shared_ptr<Filter2D>
 get_resize_filter(string_view filtername, float fwidth, ImageBuf& dst,
@@ -953,9 +1544,16 @@ ImageBufAlgo::resize(ImageBuf& dst, const ImageBuf& src, KWArgs options,
 #endif
 
     bool ok;
-    OIIO_DISPATCH_COMMON_TYPES2(ok, "resize", resize_, dst.spec().format,
-                                src.spec().format, dst, src, filterptr.get(),
-                                roi, nthreads);
+    if (filterptr->separable() && src.nchannels() == dst.nchannels()) {
+        // Separable filters use the much faster two-pass implementation.
+        OIIO_DISPATCH_COMMON_TYPES2(ok, "resize", resize_separable_,
+                                    dst.spec().format, src.spec().format, dst,
+                                    src, filterptr.get(), roi, nthreads);
+    } else {
+        OIIO_DISPATCH_COMMON_TYPES2(ok, "resize", resize_, dst.spec().format,
+                                    src.spec().format, dst, src,
+                                    filterptr.get(), roi, nthreads);
+    }
     return ok;
 }
 
@@ -1521,6 +2119,13 @@ st_warp_(ImageBuf& dst, const ImageBuf& src, const ImageBuf& stbuf, int chan_s,
         const int nchannels = roi.chend - roi.chbegin;
         Acc_t* sample_accum = OIIO_ALLOCA(Acc_t, nchannels);
 
+        // For separable filters, evaluate the weights along each axis just
+        // once per output pixel, rather than calling the filter for every
+        // tap. Their products are exactly the 2D filter values.
+        const bool separable = filter->separable();
+        float* xweights      = OIIO_ALLOCA(float, 2 * filterrad_x + 3);
+        float* yweights      = OIIO_ALLOCA(float, 2 * filterrad_y + 3);
+
         ImageBuf::ConstIterator<SRCTYPE, Acc_t> src_iter(src);
         ImageBuf::ConstIterator<STTYPE> st_iter(stbuf, roi);
         ImageBuf::Iterator<DSTTYPE, Acc_t> out_iter(dst, roi);
@@ -1555,12 +2160,21 @@ st_warp_(ImageBuf& dst, const ImageBuf& src, const ImageBuf& stbuf, int chan_s,
                                     yend);
 
             src_iter.rerange(x_min, x_max + 1, y_min, y_max + 1, 0, 1);
+            if (separable) {
+                for (int x = x_min; x <= x_max; ++x)
+                    xweights[x - x_min] = filter->xfilt(x - src_x + 0.5f);
+                for (int y = y_min; y <= y_max; ++y)
+                    yweights[y - y_min] = filter->yfilt(y - src_y + 0.5f);
+            }
 
             memset(sample_accum, 0, nchannels * sizeof(Acc_t));
             float total_weight = 0.0f;
             for (; !src_iter.done(); ++src_iter) {
-                const float weight = (*filter)(src_iter.x() - src_x + 0.5f,
-                                               src_iter.y() - src_y + 0.5f);
+                const float weight
+                    = separable ? xweights[src_iter.x() - x_min]
+                                      * yweights[src_iter.y() - y_min]
+                                : (*filter)(src_iter.x() - src_x + 0.5f,
+                                            src_iter.y() - src_y + 0.5f);
                 total_weight += weight;
                 for (int idx = 0, chan = roi.chbegin; chan < roi.chend;
                      ++chan, ++idx) {
@@ -6,6 +6,8 @@
 // Tests related to ImageInput and ImageOutput
 /////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 #include <OpenImageIO/argparse.h>
@@ -14,8 +16,11 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/imageio.h>
+#include <OpenImageIO/plugin.h>
 #include <OpenImageIO/unittest.h>
 
+#include "imageio_pvt.h"
+
 using namespace OIIO;
 
 
@@ -524,13 +529,1048 @@ test_read_tricky_sizes()
 
 
 
+// Test the "oiio:reduce" hint on JPEG, whose reader can decode at 1/2, 1/4,
+// or 1/8 resolution, and time it against a full-resolution read.
+static void
+test_jpeg_reduce()
+{
+    print("Testing JPEG reduced resolution reads\n");
+    const char* filename = "tmp_reduce.jpg";
+    ImageSpec spec(2048, 1536, 3, TypeUInt8);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f }, { 0.9f, 0.2f, 0.4f },
+                       { 0.3f, 0.8f, 0.1f }, { 0.6f, 0.1f, 0.7f });
+    OIIO_CHECK_ASSERT(src.write(filename));
+
+    auto in = ImageInput::create("jpeg");
+    OIIO_CHECK_ASSERT(in && in->supports("reduce"));
+    in.reset();
+
+    // Requested factor -> the factor the reader can actually use
+    for (auto r : { std::make_pair(1, 1), std::make_pair(3, 2),
+                    std::make_pair(4, 4), std::make_pair(100, 8) }) {
+        ImageSpec config;
+        config.attribute("oiio:reduce", r.first);
+        ImageBuf buf(filename, 0, 0, nullptr, &config);
+        OIIO_CHECK_ASSERT(buf.read());
+        OIIO_CHECK_EQUAL(buf.spec().width, spec.width / r.second);
+        OIIO_CHECK_EQUAL(buf.spec().height, spec.height / r.second);
+        OIIO_CHECK_EQUAL(buf.spec().get_int_attribute("oiio:reduce", 1),
+                         r.second);
+        // Should look like the full image, resized
+        ImageBuf small = ImageBufAlgo::resize(src, "", 0.0f, buf.roi());
+        OIIO_CHECK_EQUAL(ImageBufAlgo::compare(small, buf, 0.05f, 0.05f)
+                             .nfail,
+                         0);
+    }
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(4);
+    for (int reduce : { 1, 2, 8 }) {
+        ImageSpec config;
+        config.attribute("oiio:reduce", reduce);
+        bench(Strutil::fmt::format("  jpeg read 2048x1536 reduce={}", reduce),
+              [&]() {
+                  ImageBuf buf(filename, 0, 0, nullptr, &config);
+                  buf.read();
+              });
+    }
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+// JPEG files with restart markers are decoded in parallel bands. That must
+// give exactly the same pixels as the sequential decode.
+static void
+test_jpeg_restart()
+{
+    print("Testing JPEG restart marker parallel reads\n");
+    const char* filename = "tmp_restart.jpg";
+    ImageSpec spec(2000, 1500, 3, TypeUInt8);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f }, { 0.9f, 0.2f, 0.4f },
+                       { 0.3f, 0.8f, 0.1f }, { 0.6f, 0.1f, 0.7f });
+    ImageBufAlgo::noise(src, "uniform", -0.1f, 0.1f);
+
+    auto read = [&](int nthreads, int ybegin, int yend) {
+        std::vector<unsigned char> pixels;
+        auto in = ImageInput::open(filename);
+        OIIO_CHECK_ASSERT(in);
+        if (in) {
+            in->threads(nthreads);
+            pixels.resize(size_t(yend - ybegin) * spec.scanline_bytes());
+            OIIO_CHECK_ASSERT(in->read_scanlines(0, 0, ybegin, yend, 0, 0, 3,
+                                                 TypeUInt8, pixels.data()));
+        }
+        return pixels;
+    };
+
+    for (const char* subsampling : { "4:2:0", "4:2:2", "4:4:4" }) {
+        for (int interval : { 1, 3 }) {
+            src.specmod().attribute("jpeg:subsampling", subsampling);
+            src.specmod().attribute("jpeg:restart_interval", interval);
+            OIIO_CHECK_ASSERT(src.write(filename));
+            auto serial   = read(1, 0, spec.height);
+            auto parallel = read(4, 0, spec.height);
+            OIIO_CHECK_ASSERT(serial == parallel);
+            // A range not aligned to the bands
+            auto part = read(4, 333, 1234);
+            OIIO_CHECK_ASSERT(std::equal(part.begin(), part.end(),
+                                         serial.begin()
+                                             + 333 * spec.scanline_bytes()));
+        }
+    }
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(4);
+    for (int interval : { 0, 1 }) {
+        src.specmod().attribute("jpeg:restart_interval", interval);
+        OIIO_CHECK_ASSERT(src.write(filename));
+        bench(Strutil::fmt::format("  jpeg read 2000x1500 restart={}",
+                                   interval),
+              [&]() { read(0, 0, spec.height); });
+    }
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Formats whose scanlines decode independently read multi-scanline requests
+// in parallel. Check that those match a serial read, including ranges that
+// don't start or end on a strip boundary.
+static void
+test_parallel_scanline_reads()
+{
+    print("Testing parallel scanline reads\n");
+    ImageSpec spec(1024, 768, 4, TypeUInt16);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f, 1.0f },
+                       { 0.9f, 0.2f, 0.4f, 0.5f }, { 0.3f, 0.8f, 0.1f, 0.7f },
+                       { 0.6f, 0.1f, 0.7f, 0.2f });
+    ImageBufAlgo::noise(src, "uniform", -0.1f, 0.1f);
+
+    for (const char* ext : { "sgi", "rla", "dpx", "iff" }) {
+        std::string filename = Strutil::fmt::format("tmp_parallel.{}", ext);
+        if (!src.write(filename)) {
+            print("  skipping {}: {}\n", ext, src.geterror());
+            continue;
+        }
+        auto read = [&](int nthreads, int ybegin, int yend) {
+            std::vector<uint16_t> pixels;
+            auto in = ImageInput::open(filename);
+            OIIO_CHECK_ASSERT(in);
+            if (in) {
+                in->threads(nthreads);
+                pixels.resize(size_t(yend - ybegin) * spec.width * 4);
+                OIIO_CHECK_ASSERT(in->read_scanlines(0, 0, ybegin, yend, 0, 0,
+                                                     4, TypeUInt16,
+                                                     pixels.data()));
+            }
+            return pixels;
+        };
+        auto serial   = read(1, 0, spec.height);
+        auto parallel = read(4, 0, spec.height);
+        OIIO_CHECK_ASSERT(serial == parallel);
+        auto part = read(4, 101, 555);
+        OIIO_CHECK_ASSERT(std::equal(part.begin(), part.end(),
+                                     serial.begin() + 101 * spec.width * 4));
+        if (!nodelete)
+            Filesystem::remove(filename);
+    }
+}
+
+
+
+// With "dpx:mmap", 10-bit DPX files opened by name are memory-mapped and
+// unpacked straight from the map. Check that against ordinary file reads
+// (the default), and time both.
+static void
+test_dpx_mmap()
+{
+    print("Testing DPX memory-mapped reads\n");
+    const char* filename = "tmp_mmap.dpx";
+    ImageSpec spec(2048, 1080, 3, TypeUInt16);
+    spec.attribute("oiio:BitsPerSample", 10);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f }, { 0.9f, 0.2f, 0.4f },
+                       { 0.3f, 0.8f, 0.1f }, { 0.6f, 0.1f, 0.7f });
+    ImageBufAlgo::noise(src, "uniform", -0.1f, 0.1f);
+    OIIO_CHECK_ASSERT(src.write(filename));
+
+    auto read = [&](int mmap, int ybegin, int yend) {
+        std::vector<uint16_t> pixels;
+        ImageSpec config;
+        config.attribute("dpx:mmap", mmap);
+        auto in = ImageInput::open(filename, &config);
+        OIIO_CHECK_ASSERT(in);
+        if (in) {
+            pixels.resize(size_t(yend - ybegin) * spec.width * 3);
+            OIIO_CHECK_ASSERT(in->read_scanlines(0, 0, ybegin, yend, 0, 0, 3,
+                                                 TypeUInt16, pixels.data()));
+        }
+        return pixels;
+    };
+    auto unmapped = read(0, 0, spec.height);
+    auto mapped   = read(1, 0, spec.height);
+    OIIO_CHECK_ASSERT(unmapped == mapped);
+    auto part = read(1, 17, 501);
+    OIIO_CHECK_ASSERT(std::equal(part.begin(), part.end(),
+                                 unmapped.begin() + 17 * spec.width * 3));
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(4);
+    bench("  dpx 10-bit read 2048x1080 file",
+          [&]() { read(0, 0, spec.height); });
+    bench("  dpx 10-bit read 2048x1080 mmap",
+          [&]() { read(1, 0, spec.height); });
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Check a packing against a buffer built by hand: `vals` are `reps` whole
+// groups of values followed by a partial group, which pack to the words of
+// `group` repeated `reps` times and then the words of `tail`. The words are
+// `wordbytes` (2 or 4) bytes each, in this machine's byte order or swapped.
+// This catches mistakes a pack/unpack round trip can't, such as values in
+// the wrong place or order within a word.
+template<typename PACK, typename UNPACK>
+static void
+check_packed_layout(string_view name, const std::vector<uint16_t>& vals,
+                    size_t reps, const std::vector<uint32_t>& group,
+                    const std::vector<uint32_t>& tail, int wordbytes,
+                    PACK pack, UNPACK unpack)
+{
+    for (int swap = 0; swap <= 1; ++swap) {
+        std::vector<unsigned char> expected;
+        auto append = [&](uint32_t w) {
+            unsigned char bytes[4];
+            if (wordbytes == 2) {
+                uint16_t h = swap ? OIIO::byteswap(uint16_t(w)) : uint16_t(w);
+                memcpy(bytes, &h, 2);
+            } else {
+                if (swap)
+                    w = OIIO::byteswap(w);
+                memcpy(bytes, &w, 4);
+            }
+            expected.insert(expected.end(), bytes, bytes + wordbytes);
+        };
+        for (size_t r = 0; r < reps; ++r)
+            for (uint32_t w : group)
+                append(w);
+        for (uint32_t w : tail)
+            append(w);
+
+        // Guard bytes past the end must not be touched
+        std::vector<unsigned char> packed(expected.size() + 16, 0xee);
+        pack(vals.data(), packed.data(), vals.size(), bool(swap));
+        bool match = std::equal(expected.begin(), expected.end(),
+                                packed.begin())
+                     && std::count(packed.begin() + expected.size(),
+                                   packed.end(), 0xee)
+                            == 16;
+        std::vector<uint16_t> unpacked(vals.size());
+        unpack(expected.data(), unpacked.data(), vals.size(), bool(swap));
+        match &= (unpacked == vals);
+        if (!match)
+            print("  {} swap={} does not match the reference layout\n", name,
+                  swap);
+        OIIO_CHECK_ASSERT(match);
+    }
+}
+
+
+
+// Known layouts of the 10- and 12-bit packings, by the DPX spec (and
+// libdpx's readers): filled words hold three 10-bit values, the first in the
+// highest bits, above 2 (method A) or 0 (method B) bits of padding; packed
+// data is a continuous stream of values, least significant bits first, in
+// 32-bit words; 12-bit filled method B is one value in the low 12 bits of
+// each 16-bit word.
+static void
+test_packed_layouts()
+{
+    const uint16_t v10[16] = { 0x001, 0x3ff, 0x155, 0x2aa, 0x000, 0x200,
+                               0x0f0, 0x30f, 0x123, 0x321, 0x3c3, 0x03c,
+                               0x1fe, 0x201, 0x0aa, 0x355 };
+    const uint16_t v12[8]  = { 0x001, 0xfff, 0x555, 0xaaa,
+                               0x800, 0x123, 0xfed, 0x0f0 };
+    // Enough whole groups for the SIMD paths, and a partial group after
+    const size_t reps = 5;
+    auto values = [&](const uint16_t* v, int bits, size_t groupsize,
+                      size_t tailsize) {
+        std::vector<uint16_t> r;
+        for (size_t i = 0; i < reps * groupsize + tailsize; ++i) {
+            unsigned x = v[i % groupsize];
+            r.push_back(uint16_t((x << (16 - bits)) | (x >> (2 * bits - 16))));
+        }
+        return r;
+    };
+
+    auto filled10 = values(v10, 10, 12, 7);
+    for (int pad : { 2, 0 }) {
+        auto pack = [=](const uint16_t* src, void* dst, size_t n, bool swap) {
+            pvt::pack_10bit_filled(src, dst, n, pad, swap);
+        };
+        auto unpack = [=](const void* src, uint16_t* dst, size_t n,
+                          bool swap) {
+            pvt::unpack_10bit_filled(src, dst, n, pad, swap);
+        };
+        if (pad == 2)
+            check_packed_layout("10-bit filled A", filled10, reps,
+                                { 0x007ff554, 0xaa800800, 0x3c30f48c,
+                                  0xc87c30f0 },
+                                { 0x007ff554, 0xaa800800, 0x3c000000 }, 4,
+                                pack, unpack);
+        else
+            check_packed_layout("10-bit filled B", filled10, reps,
+                                { 0x001ffd55, 0x2aa00200, 0x0f0c3d23,
+                                  0x321f0c3c },
+                                { 0x001ffd55, 0x2aa00200, 0x0f000000 }, 4,
+                                pack, unpack);
+    }
+
+    for (int bits : { 10, 12 }) {
+        auto pack = [=](const uint16_t* src, void* dst, size_t n, bool swap) {
+            pvt::pack_packed_bits(src, dst, n, bits, swap);
+        };
+        auto unpack = [=](const void* src, uint16_t* dst, size_t n,
+                          bool swap) {
+            pvt::unpack_packed_bits(src, dst, n, bits, swap);
+        };
+        if (bits == 10)
+            check_packed_layout("10-bit packed", values(v10, 10, 16, 7), reps,
+                                { 0x955ffc01, 0x080000aa, 0x8523c3cf,
+                                  0xfe0f3c3c, 0xd54aa805 },
+                                { 0x955ffc01, 0x080000aa, 0x0000000f }, 4,
+                                pack, unpack);
+        else
+            check_packed_layout("12-bit packed", values(v12, 12, 8, 5), reps,
+                                { 0x55fff001, 0x3800aaa5, 0x0f0fed12 },
+                                { 0x55fff001, 0x0800aaa5 }, 4, pack, unpack);
+    }
+
+    check_packed_layout(
+        "12-bit filled B", values(v12, 12, 8, 3), reps,
+        { 0x001, 0xfff, 0x555, 0xaaa, 0x800, 0x123, 0xfed, 0x0f0 },
+        { 0x001, 0xfff, 0x555 }, 2,
+        [](const uint16_t* src, void* dst, size_t n, bool swap) {
+            pvt::pack_12bit_filled(src, dst, n, swap);
+        },
+        [](const void* src, uint16_t* dst, size_t n, bool swap) {
+            pvt::unpack_12bit_filled(src, dst, n, swap);
+        });
+}
+
+
+
+// The 10- and 12-bit DPX/Cineon packing kernels: check that packing and
+// unpacking round-trips every layout (at odd lengths, to exercise the
+// partial groups at the ends), that DPX files written with each packing read
+// back the same, and time them.
+static void
+test_packed_pixels()
+{
+    print("Testing 10/12-bit packing\n");
+    const size_t n = 2048 * 3 + 5;
+    std::vector<uint16_t> vals(n), packed(n), unpacked(n);
+    for (size_t i = 0; i < n; ++i)
+        vals[i] = uint16_t(i * 2654435761u >> 7);
+    auto expected = [&](int bits) {
+        std::vector<uint16_t> r(n);
+        for (size_t i = 0; i < n; ++i) {
+            unsigned v = vals[i] >> (16 - bits);
+            r[i]       = uint16_t((v << (16 - bits)) | (v >> (2 * bits - 16)));
+        }
+        return r;
+    };
+    auto exp10 = expected(10), exp12 = expected(12);
+    test_packed_layouts();
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::us);
+    for (int swap = 0; swap <= 1; ++swap) {
+        for (int pad : { 2, 0 }) {
+            pvt::pack_10bit_filled(vals.data(), packed.data(), n, pad, swap);
+            pvt::unpack_10bit_filled(packed.data(), unpacked.data(), n, pad,
+                                     swap);
+            OIIO_CHECK_ASSERT(unpacked == exp10);
+            bench(Strutil::fmt::format("  unpack 10-bit filled {} swap={}",
+                                       pad ? "A" : "B", swap),
+                  [&]() {
+                      pvt::unpack_10bit_filled(packed.data(), unpacked.data(),
+                                               n, pad, swap);
+                  });
+            bench(Strutil::fmt::format("  pack 10-bit filled {} swap={}",
+                                       pad ? "A" : "B", swap),
+                  [&]() {
+                      pvt::pack_10bit_filled(vals.data(), packed.data(), n,
+                                             pad, swap);
+                  });
+        }
+        for (int bits : { 10, 12 }) {
+            pvt::pack_packed_bits(vals.data(), packed.data(), n, bits, swap);
+            pvt::unpack_packed_bits(packed.data(), unpacked.data(), n, bits,
+                                    swap);
+            OIIO_CHECK_ASSERT(unpacked == (bits == 10 ? exp10 : exp12));
+            bench(Strutil::fmt::format("  unpack {}-bit packed swap={}", bits,
+                                       swap),
+                  [&]() {
+                      pvt::unpack_packed_bits(packed.data(), unpacked.data(),
+                                              n, bits, swap);
+                  });
+            bench(Strutil::fmt::format("  pack {}-bit packed swap={}", bits,
+                                       swap),
+                  [&]() {
+                      pvt::pack_packed_bits(vals.data(), packed.data(), n,
+                                            bits, swap);
+                  });
+        }
+        pvt::pack_12bit_filled(vals.data(), packed.data(), n, swap);
+        pvt::unpack_12bit_filled(packed.data(), unpacked.data(), n, swap);
+        OIIO_CHECK_ASSERT(unpacked == exp12);
+        bench(Strutil::fmt::format("  unpack 12-bit filled B swap={}", swap),
+              [&]() {
+                  pvt::unpack_12bit_filled(packed.data(), unpacked.data(), n,
+                                           swap);
+              });
+    }
+
+    // Packing in place, as libdpx's writer does
+    packed = vals;
+    pvt::pack_packed_bits(packed.data(), packed.data(), n, 10, false);
+    pvt::unpack_packed_bits(packed.data(), unpacked.data(), n, 10, false);
+    OIIO_CHECK_ASSERT(unpacked == exp10);
+
+    // DPX files in each packing
+    const char* filename = "tmp_packing.dpx";
+    ImageSpec spec(317, 19, 3, TypeUInt16);
+    ImageBuf src(spec);
+    ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 1);
+    for (int bits : { 10, 12 }) {
+        for (const char* packing :
+             { "Packed", "Filled, method A", "Filled, method B" }) {
+            ImageBuf buf(spec, src.localpixels());
+            buf.specmod().attribute("oiio:BitsPerSample", bits);
+            buf.specmod().attribute("dpx:Packing", packing);
+            OIIO_CHECK_ASSERT(buf.write(filename));
+            ImageBuf reread(filename);
+            OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, reread,
+                                                   1.0f / (1 << bits), 0.0f)
+                                 .nfail,
+                             0);
+        }
+    }
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Reading a half EXR as float is decoded straight to the requested type.
+// Check that against ImageBuf's own conversion, for scanline and tiled
+// files, partial ranges, and non-contiguous strides. Conversions between
+// uint and half/float must still normalize, as OIIO always has.
+static void
+test_exr_read_convert()
+{
+    print("Testing EXR reads with type conversion\n");
+    int save_core = OIIO::get_int_attribute("openexr:core");
+    OIIO::attribute("openexr:core", 1);
+
+    const char* filename = "tmp_convert.exr";
+    ImageSpec spec(100, 70, 4, TypeHalf);
+    spec.attribute("compression", "zip");  // 16 scanlines per chunk
+    ImageBuf src(spec);
+    ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 1);
+    for (int tiled = 0; tiled < 2; ++tiled) {
+        if (tiled)
+            src.set_write_tiles(32, 32);
+        OIIO_CHECK_ASSERT(src.write(filename));
+        auto in = ImageInput::open(filename);
+        OIIO_CHECK_ASSERT(in);
+        if (!in)
+            continue;
+
+        // Whole image to float
+        ImageBuf fbuf(ImageSpec(spec.width, spec.height, 4, TypeFloat));
+        OIIO_CHECK_ASSERT(in->read_image(0, 0, 0, 4, TypeFloat,
+                                         fbuf.localpixels()));
+        OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, fbuf, 0.0f, 0.0f).nfail,
+                         0);
+
+        // Channels 1-2 into every other float of a wider buffer
+        std::vector<float> wide(size_t(spec.width) * spec.height * 4, -1.0f);
+        int y0 = tiled ? 32 : 3, y1 = tiled ? 64 : 37;
+        bool ok = tiled ? in->read_tiles(0, 0, 0, spec.width, y0, y1, 0, 1,
+                                         1, 3, TypeFloat, wide.data(),
+                                         4 * sizeof(float))
+                        : in->read_scanlines(0, 0, y0, y1, 0, 1, 3,
+                                             TypeFloat, wide.data(),
+                                             4 * sizeof(float));
+        OIIO_CHECK_ASSERT(ok);
+        bool match = true;
+        for (int y = y0; y < y1; ++y)
+            for (int x = 0; x < spec.width; ++x)
+                for (int c = 0; c < 4; ++c) {
+                    float v = wide[(size_t(y - y0) * spec.width + x) * 4 + c];
+                    match &= (c < 2 ? v == src.getchannel(x, y, 0, c + 1)
+                                    : v == -1.0f);
+                }
+        OIIO_CHECK_ASSERT(match);
+    }
+
+    // A half channel and a uint channel (as for object IDs), each read as
+    // the other's type, versus converting their native values.
+    ImageSpec mixedspec(64, 48, 2, TypeFloat);
+    mixedspec.channelformats = { TypeHalf, TypeUInt };
+    std::vector<float> vals(mixedspec.image_pixels() * 2);
+    for (size_t i = 0; i < vals.size(); ++i)
+        vals[i] = float((i * 7919) % 1000) / 999.0f;
+    for (int tiled = 0; tiled < 2; ++tiled) {
+        if (tiled)
+            mixedspec.tile_width = mixedspec.tile_height = 32;
+        auto out = ImageOutput::create(filename);
+        OIIO_CHECK_ASSERT(out && out->open(filename, mixedspec)
+                          && out->write_image(TypeFloat, vals.data())
+                          && out->close());
+        auto in = ImageInput::open(filename);
+        OIIO_CHECK_ASSERT(in);
+        if (!in)
+            continue;
+        size_t npixels = mixedspec.image_pixels();
+        for (int c = 0; c < 2; ++c) {
+            TypeDesc native = mixedspec.channelformats[c];
+            TypeDesc other  = c == 0 ? TypeUInt : TypeFloat;
+            std::vector<char> nativevals(npixels * native.size());
+            std::vector<char> expected(npixels * other.size());
+            std::vector<char> got(npixels * other.size());
+            OIIO_CHECK_ASSERT(in->read_image(0, 0, c, c + 1, native,
+                                             nativevals.data()));
+            OIIO_CHECK_ASSERT(in->read_image(0, 0, c, c + 1, other,
+                                             got.data()));
+            convert_pixel_values(native, nativevals.data(), other,
+                                 expected.data(), int(npixels));
+            OIIO_CHECK_ASSERT(got == expected);
+        }
+    }
+
+    OIIO::attribute("openexr:core", save_core);
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Measure the latency of small tile reads from an EXR, the access pattern of
+// ImageCache tile misses, using the OpenEXRCore-based reader. Also verify
+// that reading the tiles one at a time, or a subset of the channels, gives
+// the same pixels as the whole image.
+static void
+benchmark_exr_tile_reads()
+{
+    print("Benchmarking EXR tile reads\n");
+    int save_core = OIIO::get_int_attribute("openexr:core");
+    OIIO::attribute("openexr:core", 1);
+
+    const char* filename = "tmp_tilebench.exr";
+    const int res = 1024, tilesize = 64, nchans = 4;
+    ImageSpec spec(res, res, nchans, TypeHalf);
+    spec.tile_width  = tilesize;
+    spec.tile_height = tilesize;
+    spec.attribute("compression", "zip");
+    ImageBuf src(spec);
+    ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 1);
+    OIIO_CHECK_ASSERT(src.write(filename));
+
+    auto in = ImageInput::open(filename);
+    OIIO_CHECK_ASSERT(in);
+    if (!in)
+        return;
+    std::vector<half> all(size_t(res) * res * nchans);
+    OIIO_CHECK_ASSERT(in->read_image(0, 0, 0, nchans, TypeHalf, all.data()));
+    ImageBuf reread(spec, all.data());
+    OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, reread, 0.0f, 0.0f).nfail, 0);
+
+    // Individual tiles, and a channel subset after a full-channel read, must
+    // match the corresponding region of the whole image.
+    std::vector<half> tile(size_t(tilesize) * tilesize * nchans);
+    bool tiles_ok = true;
+    for (int y = 0; y < res; y += tilesize) {
+        for (int x = 0; x < res; x += tilesize) {
+            in->read_tile(x, y, 0, TypeHalf, tile.data());
+            for (int j = 0; j < tilesize; ++j)
+                tiles_ok &= !memcmp(&tile[size_t(j) * tilesize * nchans],
+                                    &all[(size_t(y + j) * res + x) * nchans],
+                                    tilesize * nchans * sizeof(half));
+        }
+    }
+    OIIO_CHECK_ASSERT(tiles_ok);
+    std::vector<half> chan1(size_t(tilesize) * tilesize);
+    in->read_tiles(0, 0, tilesize, 2 * tilesize, 0, tilesize, 0, 1, 1, 2,
+                   TypeHalf, chan1.data());
+    OIIO_CHECK_EQUAL(chan1[0], all[tilesize * nchans + 1]);
+    OIIO_CHECK_EQUAL(chan1.back(),
+                     all[(size_t(tilesize - 1) * res + 2 * tilesize - 1)
+                             * nchans
+                         + 1]);
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::us);
+    int t = 0, ntiles = (res / tilesize) * (res / tilesize);
+    bench("  exr read_tile 64x64 half RGBA", [&]() {
+        int x = (t % (res / tilesize)) * tilesize;
+        int y = (t / (res / tilesize)) * tilesize;
+        in->read_tile(x, y, 0, TypeHalf, tile.data());
+        t = (t + 1) % ntiles;
+    });
+    std::vector<float> ftile(tile.size());
+    bench("  exr read_tile 64x64 half->float RGBA", [&]() {
+        int x = (t % (res / tilesize)) * tilesize;
+        int y = (t / (res / tilesize)) * tilesize;
+        in->read_tile(x, y, 0, TypeFloat, ftile.data());
+        t = (t + 1) % ntiles;
+    });
+    std::vector<half> band(size_t(res) * tilesize * nchans);
+    bench("  exr read_tiles 1024x64 band", [&]() {
+        int y = (t % (res / tilesize)) * tilesize;
+        in->read_tiles(0, 0, 0, res, y, y + tilesize, 0, 1, 0, nchans,
+                       TypeHalf, band.data());
+        ++t;
+    });
+    bench("  exr read_image 1024x1024", [&]() {
+        in->read_image(0, 0, 0, nchans, TypeHalf, all.data());
+    });
+
+    in.reset();
+    OIIO::attribute("openexr:core", save_core);
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Write the same image with the OpenEXR C++ library and with the parallel
+// core-library writer, check that the core writer's files read back
+// losslessly, and compare write throughput.
+static void
+benchmark_exr_writes()
+{
+    print("Benchmarking EXR writes\n");
+    int save_core_output = OIIO::get_int_attribute("openexr:core_output");
+
+    const char* filename = "tmp_writebench.exr";
+    const int res = 1024, nchans = 4;
+    ImageSpec spec(res, res, nchans, TypeHalf);
+    ImageBuf src(spec);
+    ImageBufAlgo::noise(src, "uniform", 0.0f, 1.0f, false, 1);
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(4);
+    for (const char* compression : { "zip", "dwaa" }) {
+        for (int tilesize : { 0, 64 }) {
+            ImageSpec wspec = spec;
+            wspec.tile_width = wspec.tile_height = tilesize;
+            wspec.attribute("compression", compression);
+            ImageBuf buf(wspec, src.localpixels());
+            bool lossless = Strutil::starts_with(compression, "zip");
+            OIIO::attribute("openexr:core_output", 1);
+            OIIO_CHECK_ASSERT(buf.write(filename));
+            ImageBuf reread(filename);
+            OIIO_CHECK_ASSERT(reread.read(0, 0, true, TypeHalf));
+            OIIO_CHECK_EQUAL(reread.spec().tile_width, tilesize);
+            OIIO_CHECK_EQUAL(reread.spec().get_string_attribute("compression"),
+                             compression);
+            OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, reread,
+                                                   lossless ? 0.0f : 0.1f,
+                                                   lossless ? 0.0f : 0.1f)
+                                 .nfail,
+                             0);
+            for (int core = 0; core <= 1; ++core) {
+                OIIO::attribute("openexr:core_output", core);
+                bench(Strutil::fmt::format("  exr write {} {} {}", compression,
+                                           tilesize ? "tiled" : "scanline",
+                                           core ? "core" : "c++"),
+                      [&]() { buf.write(filename); });
+            }
+        }
+    }
+
+    OIIO::attribute("openexr:core_output", save_core_output);
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Write a TIFF one scanline or one tile per call, as streaming writers do,
+// with and without compressing in the thread pool. Check that both read
+// back exactly (including the short last strip), and compare throughput.
+static void
+benchmark_tiff_streaming_writes()
+{
+    print("Benchmarking streaming TIFF writes\n");
+    const char* filename = "tmp_writebench.tif";
+    ImageSpec spec(2048, 1001, 3, TypeUInt16);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f }, { 0.9f, 0.2f, 0.4f },
+                       { 0.3f, 0.8f, 0.1f }, { 0.6f, 0.1f, 0.7f });
+    ImageBufAlgo::noise(src, "gaussian", 0.0f, 0.02f, false, 1);
+
+    auto write = [&](int tilesize, int multithread) {
+        ImageSpec wspec = spec;
+        wspec.tile_width = wspec.tile_height = tilesize;
+        wspec.attribute("compression", "zip");
+        wspec.attribute("tiff:multithread", multithread);
+        auto out = ImageOutput::create(filename);
+        if (!out || !out->open(filename, wspec))
+            return false;
+        bool ok = true;
+        if (tilesize) {
+            ImageBuf tile;
+            for (int y = 0; ok && y < spec.height; y += tilesize) {
+                for (int x = 0; ok && x < spec.width; x += tilesize) {
+                    ROI roi(x, x + tilesize, y, y + tilesize, 0, 1, 0, 3);
+                    tile = ImageBufAlgo::cut(src, roi);
+                    ok &= out->write_tile(x, y, 0, TypeUInt16,
+                                          tile.localpixels());
+                }
+            }
+        } else {
+            for (int y = 0; ok && y < spec.height; ++y)
+                ok &= out->write_scanline(y, 0, TypeUInt16,
+                                          src.pixeladdr(0, y));
+        }
+        return out->close() && ok;
+    };
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(4);
+    for (int tilesize : { 0, 64 }) {
+        for (int multithread = 0; multithread <= 1; ++multithread) {
+            OIIO_CHECK_ASSERT(write(tilesize, multithread));
+            ImageBuf reread(filename);
+            OIIO_CHECK_EQUAL(reread.spec().tile_width, tilesize);
+            OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, reread, 0.0f, 0.0f)
+                                 .nfail,
+                             0);
+            bench(Strutil::fmt::format("  tiff write 2k RGB16 one {} {}",
+                                       tilesize ? "tile" : "scanline",
+                                       multithread ? "pool" : "libtiff"),
+                  [&]() { write(tilesize, multithread); });
+        }
+    }
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// Compare PNG write throughput and file size between libpng's own encoder
+// and the "png:parallel" one, checking that the latter round-trips.
+static void
+benchmark_png_writes()
+{
+    print("Benchmarking PNG writes\n");
+    const char* filename = "tmp_writebench.png";
+    ImageSpec spec(2048, 2048, 3, TypeUInt16);
+    ImageBuf src(spec);
+    // Smooth gradients with a little noise, more like a real image than
+    // pure noise (which won't compress at all).
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f }, { 0.9f, 0.2f, 0.4f },
+                       { 0.3f, 0.8f, 0.1f }, { 0.6f, 0.1f, 0.7f });
+    ImageBufAlgo::noise(src, "gaussian", 0.0f, 0.02f, false, 1);
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::ms);
+    bench.iterations(2);
+    for (int filter : { 0, int(0xf8) /* all filters, adaptive */ }) {
+        for (int parallel = 0; parallel <= 1; ++parallel) {
+            ImageBuf buf(spec, src.localpixels());
+            buf.specmod().attribute("png:filter", filter);
+            buf.specmod().attribute("png:parallel", parallel);
+            OIIO_CHECK_ASSERT(buf.write(filename));
+            ImageBuf reread(filename);
+            OIIO_CHECK_EQUAL(ImageBufAlgo::compare(src, reread, 0.0f, 0.0f)
+                                 .nfail,
+                             0);
+            bench(Strutil::fmt::format("  png write 2k RGB16 filter={} {}",
+                                       filter, parallel ? "parallel"
+                                                        : "libpng"),
+                  [&]() { buf.write(filename); });
+            print("    size {} KB\n", Filesystem::file_size(filename) / 1024);
+        }
+    }
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
+// A file whose extension is missing or wrong should still be opened by the
+// right reader, found from its magic number rather than by trying every
+// reader in turn -- even with try_all_readers turned off.
+static void
+test_sniff_format()
+{
+    print("Testing format detection by magic number\n");
+    const char* filename = "tmp_sniff.png";
+    ImageSpec spec(64, 64, 3, TypeUInt8);
+    ImageBuf src(spec);
+    ImageBufAlgo::fill(src, { 0.1f, 0.5f, 0.9f });
+    OIIO_CHECK_ASSERT(src.write(filename));
+    const char* misnamed = "tmp_sniff_png.jpg";
+    const char* noext    = "tmp_sniff_png";
+    OIIO_CHECK_ASSERT(Filesystem::copy(filename, misnamed));
+    OIIO_CHECK_ASSERT(Filesystem::copy(filename, noext));
+
+    int try_all = 1;
+    OIIO::getattribute("try_all_readers", try_all);
+    OIIO::attribute("try_all_readers", 0);
+    for (const char* f : { filename, misnamed, noext }) {
+        auto in = ImageInput::open(f);
+        OIIO_CHECK_ASSERT(in);
+        if (in) {
+            OIIO_CHECK_EQUAL(in->format_name(), std::string("png"));
+            OIIO_CHECK_EQUAL(in->spec().width, spec.width);
+        }
+        // create() without opening must sniff too
+        in = ImageInput::create(f);
+        OIIO_CHECK_ASSERT(in && in->format_name() == std::string("png"));
+    }
+    // From an IOProxy, with no file to go by
+    std::vector<unsigned char> bytes(Filesystem::file_size(filename));
+    OIIO_CHECK_EQUAL(Filesystem::read_bytes(filename, bytes.data(),
+                                            bytes.size()),
+                     bytes.size());
+    Filesystem::IOMemReader memreader(bytes);
+    auto in = ImageInput::open(noext, nullptr, &memreader);
+    OIIO_CHECK_ASSERT(in && in->format_name() == std::string("png"));
+    in.reset();
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::us);
+    for (const char* f : { filename, misnamed, noext })
+        bench(Strutil::fmt::format("  open {}", f),
+              [&]() { ImageInput::open(f); });
+    // Looking up a reader by name no longer takes a lock
+    bench("  create png", [&]() { ImageInput::create("png"); });
+    OIIO::attribute("try_all_readers", try_all);
+    if (!nodelete) {
+        Filesystem::remove(filename);
+        Filesystem::remove(misnamed);
+        Filesystem::remove(noext);
+    }
+}
+
+
+
+#ifdef IMAGEINOUT_TEST_PLUGIN
+// Copy the test plugin DSO into directory `dir` as the plugin for format
+// `name`, and return its path as a plugin search of `dir` will see it.
+static std::string
+install_test_plugin(const std::string& dir, const std::string& name)
+{
+    Filesystem::create_directory(dir);
+    std::string dso = Strutil::fmt::format("{}/{}.imageio.{}", dir, name,
+                                           Plugin::plugin_extension());
+    OIIO_CHECK_ASSERT(Filesystem::copy(IMAGEINOUT_TEST_PLUGIN, dso));
+    std::vector<std::string> entries;
+    Filesystem::get_directory_entries(dir, entries);
+    for (const auto& e : entries)
+        if (Filesystem::filename(e) == Filesystem::filename(dso))
+            return e;
+    return dso;
+}
+
+
+
+// The plugin cache line for a DSO as it is now, declaring a reader with
+// the given extensions, or not a usable plugin if `extensions` is empty.
+static std::string
+plugin_cache_line(const std::string& dso, string_view extensions)
+{
+    return Strutil::fmt::format("{}\t{}\t{}\t{}\t{}\t\t\t\n", dso,
+                                int64_t(Filesystem::last_write_time(dso)),
+                                Filesystem::file_size(dso),
+                                extensions.size() ? "r" : "-", extensions);
+}
+
+
+
+// Writing and reading the plugin cache, and loading plugins it declares.
+static void
+test_plugin_cache()
+{
+    print("Testing the plugin cache\n");
+    const std::string dir = "tmp_plugincache";
+    Filesystem::create_directory(dir);
+    const std::string header
+        = Strutil::fmt::format("OpenImageIO plugin cache {} {}",
+                               OIIO_VERSION_STRING, OIIO_PLUGIN_VERSION);
+    std::string text;
+
+    // A plugin not in the cache is loaded, and what it declares is written
+    // to the cache.
+    {
+        std::string dso   = install_test_plugin(dir + "/new", "cachetest_new");
+        std::string cache = dir + "/new.txt";
+        OIIO::attribute("plugin_cache", cache);
+        auto in = ImageInput::create("cachetest_new", dir + "/new");
+        OIIO_CHECK_ASSERT(in && in->format_name() == std::string("cachetest"));
+        OIIO_CHECK_ASSERT(Filesystem::read_text_file(cache, text));
+        OIIO_CHECK_ASSERT(Strutil::starts_with(text, header + "\n"));
+        OIIO_CHECK_ASSERT(
+            Strutil::contains(text, plugin_cache_line(dso, "cachetest_new")));
+    }
+
+    // A plugin the cache knows is declared from the cache, and loaded when
+    // its reader is first needed. Only the cache claims the extension
+    // "ctcached", so finding the reader by it proves the cache was used.
+    {
+        std::string dso    = install_test_plugin(dir + "/cached",
+                                                 "cachetest_cached");
+        std::string cache  = dir + "/cached.txt";
+        std::string cached = header + "\n" + plugin_cache_line(dso, "ctcached");
+        OIIO_CHECK_ASSERT(Filesystem::write_text_file(cache, cached));
+        std::string image = dir + "/image.ctcached";
+        OIIO_CHECK_ASSERT(Filesystem::write_text_file(image, "CACHETEST\n"));
+        OIIO::attribute("plugin_cache", cache);
+        auto in = ImageInput::create(image, true, nullptr, dir + "/cached");
+        OIIO_CHECK_ASSERT(in && in->format_name() == std::string("cachetest"));
+        if (in) {
+            unsigned char pixels[4] = {};
+            OIIO_CHECK_ASSERT(
+                in->read_image(0, 0, 0, 1, TypeUInt8, pixels));
+            OIIO_CHECK_EQUAL(int(pixels[3]), 3);
+        }
+        // Nothing new was learned, so the cache is left alone
+        OIIO_CHECK_ASSERT(Filesystem::read_text_file(cache, text));
+        OIIO_CHECK_EQUAL(text, cached);
+    }
+
+    // Lines of a corrupt cache that can't be used are ignored, and the
+    // cache is rewritten with what the plugin really declares.
+    {
+        std::string dso   = install_test_plugin(dir + "/corrupt",
+                                                "cachetest_corrupt");
+        std::string cache = dir + "/corrupt.txt";
+        std::string corrupt
+            = Strutil::fmt::format("{}\ngarbage\na\tb\tc\n"
+                                   "{}\tnotatime\t{}\tr\tctcorrupt\t\t\t\n",
+                                   header, dso, Filesystem::file_size(dso));
+        OIIO_CHECK_ASSERT(Filesystem::write_text_file(cache, corrupt));
+        OIIO::attribute("plugin_cache", cache);
+        auto in = ImageInput::create("cachetest_corrupt", dir + "/corrupt");
+        OIIO_CHECK_ASSERT(in && in->format_name() == std::string("cachetest"));
+        OIIO_CHECK_ASSERT(Filesystem::read_text_file(cache, text));
+        OIIO_CHECK_EQUAL(text, header + "\n"
+                                   + plugin_cache_line(dso,
+                                                       "cachetest_corrupt"));
+    }
+
+    // A cache written by another version is replaced, not believed.
+    {
+        std::string dso   = install_test_plugin(dir + "/stale",
+                                                "cachetest_stale");
+        std::string cache = dir + "/stale.txt";
+        OIIO_CHECK_ASSERT(Filesystem::write_text_file(
+            cache, "OpenImageIO plugin cache 0.0.0 0\n"
+                       + plugin_cache_line(dso, "ctstale")));
+        OIIO::attribute("plugin_cache", cache);
+        auto in = ImageInput::create("cachetest_stale", dir + "/stale");
+        OIIO_CHECK_ASSERT(in && in->format_name() == std::string("cachetest"));
+        OIIO_CHECK_ASSERT(Filesystem::read_text_file(cache, text));
+        OIIO_CHECK_EQUAL(text, header + "\n"
+                                   + plugin_cache_line(dso, "cachetest_stale"));
+    }
+
+    // A plugin for another plugin API version is cached as not usable, but
+    // a DSO that doesn't load at all isn't cached, so it's tried again by
+    // the next process.
+    {
+        std::string dso    = install_test_plugin(dir + "/unusable",
+                                                 "cachetest_oldapi");
+        std::string broken = Strutil::fmt::format(
+            "{}/unusable/cachetest_broken.imageio.{}", dir,
+            Plugin::plugin_extension());
+        OIIO_CHECK_ASSERT(Filesystem::write_text_file(broken, "not a DSO"));
+        std::string cache = dir + "/unusable.txt";
+        OIIO::attribute("plugin_cache", cache);
+        int try_all = 1;
+        OIIO::getattribute("try_all_readers", try_all);
+        OIIO::attribute("try_all_readers", 0);
+        OIIO_CHECK_ASSERT(!ImageInput::create("cachetest_oldapi",
+                                              dir + "/unusable"));
+        OIIO::geterror();  // clear the error from the failed create
+        OIIO::attribute("try_all_readers", try_all);
+        OIIO_CHECK_ASSERT(Filesystem::read_text_file(cache, text));
+        OIIO_CHECK_EQUAL(text, header + "\n" + plugin_cache_line(dso, ""));
+    }
+
+    OIIO::attribute("plugin_cache", "");
+    if (!nodelete)
+        Filesystem::remove_all(dir);
+}
+#endif
+
+
+
+// Time to the first ImageInput::open() in this process, which includes
+// cataloging the plugins, compared with later opens. This must run before
+// anything else in the test touches the plugins.
+static void
+benchmark_first_open()
+{
+    print("Benchmarking time to first open\n");
+    const char* filename = "tmp_first_open.pgm";
+    OIIO_CHECK_ASSERT(
+        Filesystem::write_text_file(filename, "P2\n2 2\n255\n0 64\n128 255\n"));
+    Timer timer;
+    auto in = ImageInput::open(filename);
+    double first = timer();
+    OIIO_CHECK_ASSERT(in && in->spec().width == 2);
+    in.reset();
+    print("  first open: {:.2f} ms\n", first * 1000.0);
+
+    Benchmarker bench;
+    bench.units(Benchmarker::Unit::us);
+    bench("  later opens", [&]() { ImageInput::open(filename); });
+    if (!nodelete)
+        Filesystem::remove(filename);
+}
+
+
+
 int
 main(int argc, char* argv[])
 {
     getargs(argc, argv);
 
+    benchmark_first_open();
     test_all_formats();
     test_read_tricky_sizes();
+    test_jpeg_reduce();
+    test_jpeg_restart();
+    test_parallel_scanline_reads();
+    test_dpx_mmap();
+    test_packed_pixels();
+    test_exr_read_convert();
+    benchmark_exr_tile_reads();
+    benchmark_exr_writes();
+    benchmark_png_writes();
+    benchmark_tiff_streaming_writes();
+    test_sniff_format();
+#ifdef IMAGEINOUT_TEST_PLUGIN
+    test_plugin_cache();
+#endif
 
     return unit_test_failures;
 }
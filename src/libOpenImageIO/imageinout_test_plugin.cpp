@@ -0,0 +1,73 @@
+// Copyright Contributors to the OpenImageIO project.
+// SPDX-License-Identifier: Apache-2.0
+// https://github.com/AcademySoftwareFoundation/OpenImageIO
+
+/////////////////////////////////////////////////////////////////////////
+// A minimal format plugin, built as a DSO so that imageinout_test can
+// exercise loading plugins through the plugin cache. The same reader is
+// declared under several format names, because each case in the test needs
+// a format that the process hasn't seen yet.
+/////////////////////////////////////////////////////////////////////////
+
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imageio.h>
+
+
+
+OIIO_PLUGIN_NAMESPACE_BEGIN
+
+
+// Reads a 2x2 one-channel image from any file that starts with "CACHETEST".
+class CacheTestInput final : public ImageInput {
+public:
+    const char* format_name(void) const override { return "cachetest"; }
+    bool valid_file(const std::string& filename) const override
+    {
+        char magic[9];
+        return Filesystem::read_bytes(filename, magic, 9) == 9
+               && string_view(magic, 9) == "CACHETEST";
+    }
+    bool open(const std::string& name, ImageSpec& newspec) override
+    {
+        if (!valid_file(name)) {
+            errorfmt("\"{}\" is not a cachetest file", name);
+            return false;
+        }
+        m_spec  = ImageSpec(2, 2, 1, TypeUInt8);
+        newspec = m_spec;
+        return true;
+    }
+    bool close() override { return true; }
+    bool read_native_scanline(int /*subimage*/, int /*miplevel*/, int y,
+                              int /*z*/, void* data) override
+    {
+        unsigned char* d = (unsigned char*)data;
+        for (int x = 0; x < m_spec.width; ++x)
+            d[x] = (unsigned char)(y * m_spec.width + x);
+        return true;
+    }
+};
+
+
+
+#define CACHETEST_FORMAT(name, version)                          \
+    OIIO_EXPORT int name##_imageio_version = version;            \
+    OIIO_EXPORT ImageInput* name##_input_imageio_create()        \
+    {                                                            \
+        return new CacheTestInput;                               \
+    }                                                            \
+    OIIO_EXPORT const char* name##_input_extensions[] = { #name, \
+                                                          nullptr };
+
+OIIO_PLUGIN_EXPORTS_BEGIN
+
+CACHETEST_FORMAT(cachetest_new, OIIO_PLUGIN_VERSION)
+CACHETEST_FORMAT(cachetest_cached, OIIO_PLUGIN_VERSION)
+CACHETEST_FORMAT(cachetest_corrupt, OIIO_PLUGIN_VERSION)
+CACHETEST_FORMAT(cachetest_stale, OIIO_PLUGIN_VERSION)
+// Built for a plugin API version that no OIIO will ever have
+CACHETEST_FORMAT(cachetest_oldapi, -1)
+
+OIIO_PLUGIN_EXPORTS_END
+
+OIIO_PLUGIN_NAMESPACE_END
@@ -6,6 +6,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <tsl/robin_map.h>
@@ -495,6 +496,63 @@ ImageInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
 
 
 
+bool
+ImageInput::read_native_scanlines_parallel(
+    int ybegin, int yend, int rowsperstrip, void* data,
+    function_view<bool(int y0, int y1, void* buf)> decode)
+{
+    size_t ystride = m_spec.scanline_bytes(true);
+    int ytop       = m_spec.y;
+    int ybottom    = m_spec.y + m_spec.height;
+    rowsperstrip   = std::max(rowsperstrip, 1);
+    yend           = std::min(yend, ybottom);
+    if (ybegin < ytop || ybegin >= yend)
+        return ybegin == yend;
+    int64_t sbegin = (ybegin - ytop) / rowsperstrip;
+    int64_t send   = (yend - ytop + rowsperstrip - 1) / rowsperstrip;
+
+    // Each task decodes a run of whole strips. Only the first and last
+    // strips of the range may stick out of it, and those are decoded into
+    // scratch memory and then trimmed.
+    std::mutex mutex;
+    std::vector<std::string> errors;
+    bool ok = true;
+    parallel_for_chunked(
+        sbegin, send, 0,
+        [&](int64_t s0, int64_t s1) {
+            int y0 = ytop + int(s0) * rowsperstrip;
+            int y1 = std::min(ytop + int(s1) * rowsperstrip, ybottom);
+            bool r;
+            if (y0 >= ybegin && y1 <= yend) {
+                r = decode(y0, y1, (char*)data + (y0 - ybegin) * ystride);
+            } else {
+                std::unique_ptr<char[]> buf(new char[(y1 - y0) * ystride]);
+                r = decode(y0, y1, buf.get());
+                int c0 = std::max(y0, ybegin);
+                int c1 = std::min(y1, yend);
+                if (r)
+                    memcpy((char*)data + (c0 - ybegin) * ystride,
+                           buf.get() + (c0 - y0) * ystride,
+                           (c1 - c0) * ystride);
+            }
+            if (!r) {
+                // Error messages are kept per thread, so gather them up to
+                // be reissued from the calling thread.
+                std::string err = geterror();
+                std::lock_guard<std::mutex> lock(mutex);
+                ok = false;
+                if (err.size())
+                    errors.push_back(err);
+            }
+        },
+        paropt(threads()).minitems(1));
+    for (auto& err : errors)
+        errorfmt("{}", err);
+    return ok;
+}
+
+
+
 bool
 ImageInput::read_tile(int x, int y, int z, TypeDesc format, void* data,
                       stride_t xstride, stride_t ystride, stride_t zstride)
@@ -1272,6 +1330,25 @@ ImageInput::ioread(void* buf, size_t itemsize, size_t nitems)
 
 
 
+bool
+ImageInput::iopread(void* buf, size_t size, int64_t offset)
+{
+    Filesystem::IOProxy*& m_io(m_impl->m_io);
+    size_t n = m_io->pread(buf, size, offset);
+    if (n != size) {
+        if (offset < 0 || uint64_t(offset) + n >= m_io->size())
+            ImageInput::errorfmt("Read error: hit end of file in {} reader",
+                                 format_name());
+        else
+            ImageInput::errorfmt(
+                "Read error at position {}, could only read {}/{} bytes {}",
+                offset, n, size, m_io->error());
+    }
+    return n == size;
+}
+
+
+
 bool
 ImageInput::ioseek(int64_t pos, int origin)
 {
@@ -48,14 +48,18 @@ atomic_int oiio_try_all_readers(1);
 #endif
 // Should we use "Exr core C library"?
 int openexr_core(OIIO_OPENEXR_CORE_DEFAULT);
+int openexr_core_output(0);
 int tiff_half(0);
 int tiff_multithread(1);
 int dds_bc5normal(0);
+int color_fast_transfer(1);
 int limit_channels(1024);
 int limit_imagesize_MB(std::min(32 * 1024,
                                 int(Sysutil::physical_memory() >> 20)));
 ustring font_searchpath(Sysutil::getenv("OPENIMAGEIO_FONTS"));
 ustring plugin_searchpath(OIIO_DEFAULT_PLUGIN_SEARCHPATH);
+ustring plugin_cache_file(Sysutil::getenv("OIIO_PLUGIN_CACHE"));
+ustring colorproc_cache_dir(Sysutil::getenv("OIIO_COLOR_PROCESSOR_CACHE"));
 std::string format_list;         // comma-separated list of all formats
 std::string input_format_list;   // comma-separated list of readable formats
 std::string output_format_list;  // comma-separated list of writable formats
@@ -399,6 +403,10 @@ attribute(string_view name, TypeDesc type, const void* val)
         plugin_searchpath = ustring(*(const char**)val);
         return true;
     }
+    if (name == "plugin_cache" && type == TypeString) {
+        plugin_cache_file = ustring(*(const char**)val);
+        return true;
+    }
     if (name == "exr_threads" && type == TypeInt) {
         oiio_exr_threads = OIIO::clamp(*(const int*)val, -1, maxthreads);
         return true;
@@ -407,6 +415,10 @@ attribute(string_view name, TypeDesc type, const void* val)
         openexr_core = *(const int*)val;
         return true;
     }
+    if (name == "openexr:core_output" && type == TypeInt) {
+        openexr_core_output = *(const int*)val;
+        return true;
+    }
     if (name == "tiff:half" && type == TypeInt) {
         tiff_half = *(const int*)val;
         return true;
@@ -419,6 +431,14 @@ attribute(string_view name, TypeDesc type, const void* val)
         dds_bc5normal = *(const int*)val;
         return true;
     }
+    if (name == "color:fast_transfer" && type == TypeInt) {
+        color_fast_transfer = *(const int*)val;
+        return true;
+    }
+    if (name == "color:processor_cache" && type == TypeString) {
+        colorproc_cache_dir = ustring(*(const char**)val);
+        return true;
+    }
     if (name == "limits:channels" && type == TypeInt) {
         limit_channels = *(const int*)val;
         return true;
@@ -498,6 +518,10 @@ getattribute(string_view name, TypeDesc type, void* val)
         *(ustring*)val = plugin_searchpath;
         return true;
     }
+    if (name == "plugin_cache" && type == TypeString) {
+        *(ustring*)val = plugin_cache_file;
+        return true;
+    }
     if (name == "format_list" && type == TypeString) {
         if (format_list.empty())
             pvt::catalog_all_plugins(plugin_searchpath.string());
@@ -555,6 +579,10 @@ getattribute(string_view name, TypeDesc type, void* val)
         *(int*)val = openexr_core;
         return true;
     }
+    if (name == "openexr:core_output" && type == TypeInt) {
+        *(int*)val = openexr_core_output;
+        return true;
+    }
     if (name == "tiff:half" && type == TypeInt) {
         *(int*)val = tiff_half;
         return true;
@@ -575,6 +603,14 @@ getattribute(string_view name, TypeDesc type, void* val)
         *(int*)val = dds_bc5normal;
         return true;
     }
+    if (name == "color:fast_transfer" && type == TypeInt) {
+        *(int*)val = color_fast_transfer;
+        return true;
+    }
+    if (name == "color:processor_cache" && type == TypeString) {
+        *(ustring*)val = colorproc_cache_dir;
+        return true;
+    }
     if (name == "oiio:print_uncaught_errors" && type == TypeInt) {
         *(int*)val = oiio_print_uncaught_errors;
         return true;
@@ -673,6 +709,18 @@ getattribute(string_view name, TypeDesc type, void* val)
         *(float*)val = IB_total_image_read_time;
         return true;
     }
+    if (name == "color:processor_cache_hits" && type == TypeInt64) {
+        *(long long*)val = colorproc_cache_hits;
+        return true;
+    }
+    if (name == "color:processor_cache_misses" && type == TypeInt64) {
+        *(long long*)val = colorproc_cache_misses;
+        return true;
+    }
+    if (name == "color:processor_cache_bytes" && type == TypeInt64) {
+        *(long long*)val = colorproc_cache_bytes;
+        return true;
+    }
     return false;
 }
 
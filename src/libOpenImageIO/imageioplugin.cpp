@@ -2,11 +2,15 @@
 // SPDX-License-Identifier: Apache-2.0
 // https://github.com/AcademySoftwareFoundation/OpenImageIO
 
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
+#include <ctime>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <OpenImageIO/dassert.h>
@@ -45,8 +49,99 @@ static std::map<std::string, std::string> extension_to_format_map;
 // This should be guarded by imageio_mutex.
 static std::vector<ustring> format_list_vector;
 
-// Which format names and extensions are procedural (not reading from files)
-static std::set<std::string> procedural_plugins;
+// Which format names and extensions are procedural (not reading from
+// files), filled in as each one is asked about.
+static std::map<std::string, bool> procedural_plugins;
+
+// Plugin search paths that have already been scanned
+static std::set<std::string> searched_paths;
+
+// What a DSO plugin declares, as recorded in the plugin cache so that later
+// processes needn't load the plugin to find out.
+struct PluginInfo {
+    std::time_t mtime = 0;      // The DSO's time and size, to tell if it
+    uint64_t size     = 0;      //   changed since it was cached
+    bool input        = false;  // has a reader
+    bool output       = false;  // has a writer
+    std::vector<std::string> input_extensions;
+    std::vector<std::string> output_extensions;
+    std::vector<std::string> input_signatures;
+    std::string lib_version;
+};
+
+// Map DSO path to what it declares, read from and written to the file named
+// by the "plugin_cache" attribute.
+static std::map<std::string, PluginInfo> plugin_cache;
+static std::string plugin_cache_read;  // the file plugin_cache came from
+static bool plugin_cache_dirty = false;
+
+// Stand-ins for the creators of formats whose plugins were found in the
+// plugin cache, which aren't loaded until a reader or writer is needed.
+// They are only compared against, never called, but have distinct bodies
+// so that the linker can't fold them into one function.
+static ImageInput*
+deferred_input_create()
+{
+    errorfmt("ImageInput plugin was not loaded");
+    return nullptr;
+}
+
+static ImageOutput*
+deferred_output_create()
+{
+    errorfmt("ImageOutput plugin was not loaded");
+    return nullptr;
+}
+
+// A plugin whose loading was deferred, and once loaded (or found not to
+// load after all), its creators.
+struct DeferredPlugin {
+    std::string path;
+    bool loaded                         = false;
+    ImageInput::Creator input_creator   = nullptr;
+    ImageOutput::Creator output_creator = nullptr;
+};
+
+// Map format name to its deferred plugin
+static std::map<std::string, DeferredPlugin> deferred_plugins;
+// Map the format names and extensions that lead to the stand-in creators to
+// the name of the format that declared them.
+static std::map<std::string, std::string> deferred_input_keys;
+static std::map<std::string, std::string> deferred_output_keys;
+
+// A magic number that identifies a file format: `bytes` found at `offset`
+// from the start of the file.
+struct Signature {
+    size_t offset;
+    std::string bytes;
+};
+
+// Map format name to the magic numbers its reader recognizes
+static std::map<std::string, std::vector<Signature>> format_signatures;
+
+// An immutable copy of the catalog, so that ImageInput::create() and
+// ImageOutput::create() can look up the creators without taking
+// imageio_mutex once the plugins have been inventoried.
+struct PluginCatalog {
+    struct Reader {
+        std::string name;
+        ImageInput::Creator creator;
+        std::vector<Signature> signatures;
+    };
+    std::unordered_map<std::string, ImageInput::Creator> input_formats;
+    std::unordered_map<std::string, ImageOutput::Creator> output_formats;
+    std::unordered_map<std::string, std::string> deferred_input_keys;
+    std::unordered_map<std::string, std::string> deferred_output_keys;
+    std::vector<Reader> readers;  // in format_list_vector order
+    size_t signature_bytes = 0;   // file bytes needed to test all signatures
+};
+
+// The current catalog snapshot, or nullptr if a format has been declared
+// since it was made. Snapshots are tiny and only remade when plugins are
+// added, so old ones are kept alive (in all_catalogs, guarded by
+// imageio_mutex) for the benefit of any thread still using them.
+static std::atomic<const PluginCatalog*> current_catalog(nullptr);
+static std::vector<std::unique_ptr<PluginCatalog>> all_catalogs;
 
 static std::string pattern = Strutil::fmt::format(".imageio.{}",
                                                   Plugin::plugin_extension());
@@ -79,11 +174,16 @@ declare_imageio_format_locked(const std::string& format_name,
             std::string ext = Strutil::lower(*e);
             if (input_formats.find(ext) == input_formats.end()) {
                 input_formats[ext] = input_creator;
+                if (input_creator == deferred_input_create)
+                    deferred_input_keys[ext] = format_name;
                 add_if_missing(all_extensions, ext);
             }
         }
-        if (input_formats.find(format_name) == input_formats.end())
+        if (input_formats.find(format_name) == input_formats.end()) {
             input_formats[format_name] = input_creator;
+            if (input_creator == deferred_input_create)
+                deferred_input_keys[format_name] = format_name;
+        }
     }
 
     // Look for output creator and list of supported extensions
@@ -92,11 +192,16 @@ declare_imageio_format_locked(const std::string& format_name,
             std::string ext = Strutil::lower(*e);
             if (output_formats.find(ext) == output_formats.end()) {
                 output_formats[ext] = output_creator;
+                if (output_creator == deferred_output_create)
+                    deferred_output_keys[ext] = format_name;
                 add_if_missing(all_extensions, ext);
             }
         }
-        if (output_formats.find(format_name) == output_formats.end())
+        if (output_formats.find(format_name) == output_formats.end()) {
             output_formats[format_name] = output_creator;
+            if (output_creator == deferred_output_create)
+                deferred_output_keys[format_name] = format_name;
+        }
     }
 
     // Populate the extension -> format name map
@@ -138,6 +243,89 @@ declare_imageio_format_locked(const std::string& format_name,
         library_list += Strutil::fmt::format("{}:{}", format_name, lib_version);
         // std::cout << format_name << ": " << lib_version << "\n";
     }
+    current_catalog.store(nullptr, std::memory_order_release);
+}
+
+
+
+// Register the magic numbers recognized by a format's reader, given as a
+// nullptr-terminated list of "offset:hexbytes" strings (for example,
+// "0:89504e47"). Ownership of imageio_mutex is implied.
+static void
+declare_imageio_signatures_locked(const std::string& format_name,
+                                  const char** signatures)
+{
+    auto& sigs = format_signatures[Strutil::lower(format_name)];
+    for (const char** s = signatures; s && *s; ++s) {
+        string_view str(*s);
+        int offset = 0;
+        if (!Strutil::parse_int(str, offset) || offset < 0
+            || !Strutil::parse_char(str, ':') || str.empty()
+            || (str.size() & 1)) {
+            OIIO::debugfmt("Malformed signature \"{}\" for format {}\n", *s,
+                           format_name);
+            continue;
+        }
+        std::string bytes;
+        for (size_t i = 0; i < str.size(); i += 2)
+            bytes += char(Strutil::stoi(str.substr(i, 2), nullptr, 16));
+        sigs.push_back({ size_t(offset), std::move(bytes) });
+    }
+    current_catalog.store(nullptr, std::memory_order_release);
+}
+
+
+
+static void
+declare_imageio_signatures(const std::string& format_name,
+                           const char** signatures)
+{
+    std::lock_guard<std::recursive_mutex> lock(pvt::imageio_mutex);
+    declare_imageio_signatures_locked(format_name, signatures);
+}
+
+
+
+// Return the current catalog snapshot, making a new one if formats have been
+// declared since the last. Only that rebuild takes imageio_mutex.
+static const PluginCatalog*
+plugin_catalog()
+{
+    const PluginCatalog* catalog = current_catalog.load(
+        std::memory_order_acquire);
+    if (catalog)
+        return catalog;
+    std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
+    catalog = current_catalog.load(std::memory_order_acquire);
+    if (catalog)
+        return catalog;  // another thread beat us to it
+    std::unique_ptr<PluginCatalog> newcatalog(new PluginCatalog);
+    newcatalog->input_formats.insert(input_formats.begin(),
+                                     input_formats.end());
+    newcatalog->output_formats.insert(output_formats.begin(),
+                                      output_formats.end());
+    newcatalog->deferred_input_keys.insert(deferred_input_keys.begin(),
+                                           deferred_input_keys.end());
+    newcatalog->deferred_output_keys.insert(deferred_output_keys.begin(),
+                                            deferred_output_keys.end());
+    for (const auto& f : format_list_vector) {
+        auto plugin = input_formats.find(f.string());
+        if (plugin == input_formats.end() || !plugin->second)
+            continue;  // format that's output only
+        PluginCatalog::Reader reader { f.string(), plugin->second, {} };
+        auto sigs = format_signatures.find(f.string());
+        if (sigs != format_signatures.end())
+            reader.signatures = sigs->second;
+        for (const auto& sig : reader.signatures)
+            newcatalog->signature_bytes
+                = std::max(newcatalog->signature_bytes,
+                           sig.offset + sig.bytes.size());
+        newcatalog->readers.push_back(std::move(reader));
+    }
+    catalog = newcatalog.get();
+    all_catalogs.push_back(std::move(newcatalog));
+    current_catalog.store(catalog, std::memory_order_release);
+    return catalog;
 }
 
 
@@ -180,9 +368,84 @@ is_imageio_format_name(string_view name)
 
 
 
+// Open a plugin DSO, returning its handle if it was built for this version
+// of the plugin API, or nullptr if not. If `wrong_version` is not null, it
+// is set to whether the DSO opened but isn't a plugin for this version, as
+// opposed to not opening at all.
+static Plugin::Handle
+open_plugin(const std::string& format_name, const std::string& plugin_fullpath,
+            bool* wrong_version = nullptr)
+{
+    if (wrong_version)
+        *wrong_version = false;
+    Plugin::Handle handle = Plugin::open(plugin_fullpath);
+    if (!handle) {
+        return nullptr;
+    }
+
+    std::string version_function = format_name + "_imageio_version";
+    int* plugin_version          = (int*)Plugin::getsym(handle,
+                                                        version_function.c_str());
+    if (!plugin_version || *plugin_version != OIIO_PLUGIN_VERSION) {
+        Plugin::close(handle);
+        if (wrong_version)
+            *wrong_version = true;
+        return nullptr;
+    }
+    return handle;
+}
+
+
+
+static std::vector<std::string>
+string_list(const char** list)
+{
+    std::vector<std::string> result;
+    for (const char** s = list; s && *s; ++s)
+        result.emplace_back(*s);
+    return result;
+}
+
+
+
+// Declare a format from what the plugin cache says its plugin declares,
+// with stand-in creators, leaving the plugin itself unloaded for now.
+static void
+declare_deferred_plugin(const std::string& format_name,
+                        const std::string& plugin_fullpath,
+                        const PluginInfo& info)
+{
+    if (!info.input && !info.output)
+        return;  // not useful
+    plugin_filepaths[format_name]      = plugin_fullpath;
+    deferred_plugins[format_name].path = plugin_fullpath;
+
+    auto c_strs = [](const std::vector<std::string>& list) {
+        std::vector<const char*> result;
+        for (const auto& s : list)
+            result.push_back(s.c_str());
+        result.push_back(nullptr);
+        return result;
+    };
+    auto input_extensions  = c_strs(info.input_extensions);
+    auto output_extensions = c_strs(info.output_extensions);
+    auto input_signatures  = c_strs(info.input_signatures);
+    declare_imageio_format_locked(
+        format_name, info.input ? deferred_input_create : nullptr,
+        input_extensions.data(),
+        info.output ? deferred_output_create : nullptr,
+        output_extensions.data(),
+        info.lib_version.size() ? info.lib_version.c_str() : nullptr);
+    if (info.input)
+        declare_imageio_signatures_locked(format_name,
+                                          input_signatures.data());
+}
+
+
+
 static void
 catalog_plugin(const std::string& format_name,
-               const std::string& plugin_fullpath)
+               const std::string& plugin_fullpath, bool use_cache)
 {
     // Remember the plugin
     std::map<std::string, std::string>::const_iterator found_path;
@@ -200,16 +463,37 @@ catalog_plugin(const std::string& format_name,
         return;
     }
 
-    Plugin::Handle handle = Plugin::open(plugin_fullpath);
-    if (!handle) {
-        return;
+    // If the plugin cache knows this DSO, and it hasn't changed since, we
+    // can declare its format without loading it.
+    PluginInfo info;
+    if (use_cache) {
+        info.mtime  = Filesystem::last_write_time(plugin_fullpath);
+        info.size   = Filesystem::file_size(plugin_fullpath);
+        auto cached = plugin_cache.find(plugin_fullpath);
+        if (cached != plugin_cache.end() && cached->second.mtime == info.mtime
+            && cached->second.size == info.size) {
+            declare_deferred_plugin(format_name, plugin_fullpath,
+                                    cached->second);
+            return;
+        }
     }
 
-    std::string version_function = format_name + "_imageio_version";
-    int* plugin_version          = (int*)Plugin::getsym(handle,
-                                                        version_function.c_str());
-    if (!plugin_version || *plugin_version != OIIO_PLUGIN_VERSION) {
-        Plugin::close(handle);
+    bool wrong_version    = false;
+    Plugin::Handle handle = open_plugin(format_name, plugin_fullpath,
+                                        &wrong_version);
+    if (use_cache) {
+        // Remember what we learn below, including that the DSO is a plugin
+        // for another version, which won't change until the DSO does. But
+        // a DSO that didn't open at all (a missing dependency, say) may
+        // open next time, so forget anything stale and try it again then.
+        if (handle || wrong_version) {
+            plugin_cache[plugin_fullpath] = info;
+            plugin_cache_dirty            = true;
+        } else if (plugin_cache.erase(plugin_fullpath)) {
+            plugin_cache_dirty = true;
+        }
+    }
+    if (!handle) {
         return;
     }
 
@@ -233,18 +517,205 @@ catalog_plugin(const std::string& format_name,
         = (const char**)Plugin::getsym(handle,
                                        format_name + "_output_extensions");
 
-    if (input_creator || output_creator)
+    // Signatures are optional for plugins built outside of OIIO
+    const char** input_signatures
+        = (const char**)Plugin::getsym(handle,
+                                       format_name + "_input_signatures",
+                                       false);
+    const char* lib_version = plugin_lib_version ? plugin_lib_version()
+                                                 : NULL;
+
+    if (use_cache) {
+        info.input             = input_creator != nullptr;
+        info.output            = output_creator != nullptr;
+        info.input_extensions  = string_list(input_extensions);
+        info.output_extensions = string_list(output_extensions);
+        info.input_signatures  = string_list(input_signatures);
+        info.lib_version       = lib_version ? lib_version : "";
+        plugin_cache[plugin_fullpath] = info;
+    }
+
+    if (input_creator || output_creator) {
         declare_imageio_format_locked(format_name, input_creator,
                                       input_extensions, output_creator,
-                                      output_extensions,
-                                      plugin_lib_version ? plugin_lib_version()
-                                                         : NULL);
-    else
+                                      output_extensions, lib_version);
+        if (input_creator)
+            declare_imageio_signatures_locked(format_name, input_signatures);
+    } else
         Plugin::close(handle);  // not useful
 }
 
 
 
+// Load a plugin whose loading was deferred (if it hasn't been already) and
+// return what became of it.
+static DeferredPlugin
+load_deferred_plugin(const std::string& format_name)
+{
+    std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
+    auto found = deferred_plugins.find(format_name);
+    if (found == deferred_plugins.end())
+        return DeferredPlugin();
+    DeferredPlugin& plugin = found->second;
+    if (plugin.loaded)
+        return plugin;
+    plugin.loaded = true;
+    if (Plugin::Handle handle = open_plugin(format_name, plugin.path)) {
+        plugin_handles[format_name] = handle;
+        plugin.input_creator        = (ImageInput::Creator)
+            Plugin::getsym(handle, format_name + "_input_imageio_create");
+        plugin.output_creator = (ImageOutput::Creator)
+            Plugin::getsym(handle, format_name + "_output_imageio_create");
+    } else {
+        OIIO::debugfmt("OpenImageIO WARNING: could not load plugin \"{}\", "
+                       "which the plugin cache says is format {}\n",
+                       plugin.path, format_name);
+    }
+    // Swap the real creators in for the stand-ins. If the plugin didn't
+    // load after all, the format is left with no reader or writer.
+    for (auto k = deferred_input_keys.begin();
+         k != deferred_input_keys.end();) {
+        if (k->second == format_name) {
+            input_formats[k->first] = plugin.input_creator;
+            k                       = deferred_input_keys.erase(k);
+        } else
+            ++k;
+    }
+    for (auto k = deferred_output_keys.begin();
+         k != deferred_output_keys.end();) {
+        if (k->second == format_name) {
+            output_formats[k->first] = plugin.output_creator;
+            k                        = deferred_output_keys.erase(k);
+        } else
+            ++k;
+    }
+    current_catalog.store(nullptr, std::memory_order_release);
+    return plugin;
+}
+
+
+
+// Given the creator the catalog has for a name or extension, return the
+// real one, loading a deferred plugin if that's what it leads to.
+static ImageInput::Creator
+input_creator(const PluginCatalog& catalog, const std::string& key,
+              ImageInput::Creator creator)
+{
+    if (creator != deferred_input_create)
+        return creator;
+    auto found = catalog.deferred_input_keys.find(key);
+    return found != catalog.deferred_input_keys.end()
+               ? load_deferred_plugin(found->second).input_creator
+               : nullptr;
+}
+
+
+
+static ImageOutput::Creator
+output_creator(const PluginCatalog& catalog, const std::string& key,
+               ImageOutput::Creator creator)
+{
+    if (creator != deferred_output_create)
+        return creator;
+    auto found = catalog.deferred_output_keys.find(key);
+    return found != catalog.deferred_output_keys.end()
+               ? load_deferred_plugin(found->second).output_creator
+               : nullptr;
+}
+
+
+
+static ImageInput::Creator
+reader_creator(const PluginCatalog::Reader& reader)
+{
+    if (reader.creator != deferred_input_create)
+        return reader.creator;
+    return load_deferred_plugin(reader.name).input_creator;
+}
+
+
+
+// The plugin cache is a text file. After a header line, each line describes
+// one DSO, as tab-separated fields: path, modification time, size, "r"
+// and/or "w" (or "-" if it's not a usable plugin), comma-separated input
+// extensions, output extensions, and input signatures, and library version.
+static std::string
+plugin_cache_header()
+{
+    return Strutil::fmt::format("OpenImageIO plugin cache {} {}",
+                                OIIO_VERSION_STRING, OIIO_PLUGIN_VERSION);
+}
+
+
+
+static void
+read_plugin_cache(const std::string& filename)
+{
+    plugin_cache.clear();
+    plugin_cache_read  = filename;
+    plugin_cache_dirty = false;
+    std::string text;
+    if (!Filesystem::exists(filename)
+        || !Filesystem::read_text_file(filename, text))
+        return;
+    auto lines = Strutil::splitsv(text, "\n");
+    if (lines.empty() || lines[0] != plugin_cache_header()) {
+        plugin_cache_dirty = true;  // from another version; replace it
+        return;
+    }
+    for (size_t i = 1; i < lines.size(); ++i) {
+        auto fields = Strutil::splitsv(lines[i], "\t");
+        if (fields.size() != 8)
+            continue;
+        PluginInfo info;
+        info.mtime             = Strutil::from_string<int64_t>(fields[1]);
+        info.size              = Strutil::from_string<uint64_t>(fields[2]);
+        info.input             = Strutil::contains(fields[3], "r");
+        info.output            = Strutil::contains(fields[3], "w");
+        info.input_extensions  = Strutil::splits(fields[4], ",");
+        info.output_extensions = Strutil::splits(fields[5], ",");
+        info.input_signatures  = Strutil::splits(fields[6], ",");
+        info.lib_version       = fields[7];
+        plugin_cache[fields[0]] = std::move(info);
+    }
+}
+
+
+
+static void
+write_plugin_cache(const std::string& filename)
+{
+    std::string text = plugin_cache_header() + "\n";
+    for (const auto& p : plugin_cache) {
+        const PluginInfo& info = p.second;
+        if (!Filesystem::exists(p.first))
+            continue;  // Don't remember DSOs that are gone
+        text += Strutil::fmt::format(
+            "{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n", p.first, int64_t(info.mtime),
+            info.size,
+            info.input || info.output
+                ? std::string(info.input ? "r" : "") + (info.output ? "w" : "")
+                : std::string("-"),
+            Strutil::join(info.input_extensions, ","),
+            Strutil::join(info.output_extensions, ","),
+            Strutil::join(info.input_signatures, ","), info.lib_version);
+    }
+    // Write to a temporary name and rename, so that other processes never
+    // see a partial file.
+    std::string err;
+    std::string tmpfile = Strutil::fmt::format("{}.{}.tmp", filename,
+                                               Filesystem::unique_path());
+    if (Filesystem::write_text_file(tmpfile, text)
+        && Filesystem::rename(tmpfile, filename, err)) {
+        plugin_cache_dirty = false;
+    } else {
+        Filesystem::remove(tmpfile, err);
+        OIIO::debugfmt("Could not write plugin cache {}: {}\n", filename, err);
+    }
+}
+
+
+
 #ifdef EMBED_PLUGINS
 
 // Make extern declarations for the input and output create routines and
@@ -256,10 +727,12 @@ catalog_plugin(const std::string& format_name,
         ImageOutput* name##_output_imageio_create();   \
         extern const char* name##_output_extensions[]; \
         extern const char* name##_input_extensions[];  \
+        extern const char* name##_input_signatures[];  \
         extern const char* name##_imageio_library_version();
 #    define PLUGENTRY_RO(name)                        \
         ImageInput* name##_input_imageio_create();    \
         extern const char* name##_input_extensions[]; \
+        extern const char* name##_input_signatures[]; \
         extern const char* name##_imageio_library_version();
 #    define PLUGENTRY_WO(name)                         \
         ImageOutput* name##_output_imageio_create();   \
@@ -319,12 +792,14 @@ catalog_builtin_plugins()
             #name, (ImageInput::Creator)name##_input_imageio_create,     \
             name##_input_extensions,                                     \
             (ImageOutput::Creator)name##_output_imageio_create,          \
-            name##_output_extensions, name##_imageio_library_version())
+            name##_output_extensions, name##_imageio_library_version()); \
+        declare_imageio_signatures(#name, name##_input_signatures)
 #define DECLAREPLUG_RO(name)                                             \
         declare_imageio_format(                                          \
             #name, (ImageInput::Creator)name##_input_imageio_create,     \
             name##_input_extensions, nullptr, nullptr,                   \
-            name##_imageio_library_version())
+            name##_imageio_library_version());                           \
+        declare_imageio_signatures(#name, name##_input_signatures)
 #define DECLAREPLUG_WO(name)                                             \
         declare_imageio_format(                                          \
             #name, nullptr, nullptr,                                     \
@@ -467,9 +942,17 @@ pvt::catalog_all_plugins(std::string searchpath)
     static std::once_flag builtin_flag;
     std::call_once(builtin_flag, catalog_builtin_plugins);
 
-    std::unique_lock<std::recursive_mutex> lock(imageio_mutex);
+    std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
     append_if_env_exists(searchpath, "OIIO_LIBRARY_PATH", true);
 
+    // Each searchpath only needs to be looked through once.
+    if (!searched_paths.insert(searchpath).second)
+        return;
+
+    std::string cachefile = pvt::plugin_cache_file.string();
+    if (cachefile.size() && cachefile != plugin_cache_read)
+        read_plugin_cache(cachefile);
+
     size_t patlen = pattern.length();
     std::vector<std::string> dirs;
     Filesystem::searchpath_split(searchpath, dirs, true);
@@ -483,21 +966,13 @@ pvt::catalog_all_plugins(std::string searchpath)
                 && (found == leaf.length() - patlen)) {
                 std::string pluginname(leaf.begin(),
                                        leaf.begin() + leaf.length() - patlen);
-                catalog_plugin(pluginname, full_filename);
+                catalog_plugin(pluginname, full_filename, cachefile.size());
             }
         }
     }
 
-    // Inventory the procedural plugins
-    auto current_input_formats = input_formats;  // do a copy
-    for (auto&& f : current_input_formats) {
-        lock.unlock();
-        // ImageInput::create will take a lock of imageio_mutex
-        auto inp = ImageInput::create(f.first);
-        lock.lock();
-        if (inp->supports("procedural"))
-            procedural_plugins.insert(f.first);
-    }
+    if (cachefile.size() && plugin_cache_dirty)
+        write_plugin_cache(cachefile);
 }
 
 
@@ -505,15 +980,33 @@ pvt::catalog_all_plugins(std::string searchpath)
 bool
 pvt::is_procedural_plugin(const std::string& name)
 {
-    std::unique_lock<std::recursive_mutex> lock(imageio_mutex);
-
-    if (!format_list_vector.size()) {
-        lock.unlock();
+    const PluginCatalog* catalog = plugin_catalog();
+    if (catalog->readers.empty()) {
         // catalog_all_plugins() will lock imageio_mutex.
         pvt::catalog_all_plugins(pvt::plugin_searchpath.string());
-        lock.lock();
+        catalog = plugin_catalog();
+    }
+    auto found = catalog->input_formats.find(name);
+    if (found == catalog->input_formats.end())
+        return false;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
+        auto known = procedural_plugins.find(name);
+        if (known != procedural_plugins.end())
+            return known->second;
+    }
+    // Ask the reader, the first time we're asked about each format name or
+    // extension, rather than making one of every reader (and loading every
+    // plugin) up front.
+    bool procedural = false;
+    if (auto create_function = input_creator(*catalog, name, found->second)) {
+        std::unique_ptr<ImageInput> inp(create_function());
+        procedural = inp && inp->supports("procedural");
     }
-    return procedural_plugins.find(name) != procedural_plugins.end();
+    std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
+    procedural_plugins[name] = procedural;
+    return procedural;
 }
 
 
@@ -535,40 +1028,36 @@ ImageOutput::create(string_view filename, Filesystem::IOProxy* ioproxy,
         format = filename;
     }
 
+    // See if it's already in the table.  If not, scan all plugins we can
+    // find to populate the table.
+    Strutil::to_lower(format);
+    const PluginCatalog* catalog = plugin_catalog();
+    auto found                   = catalog->output_formats.find(format);
+    if (found == catalog->output_formats.end()) {
+        // catalog_all_plugins() will lock imageio_mutex
+        catalog_all_plugins(plugin_searchpath.size()
+                                ? plugin_searchpath
+                                : string_view(pvt::plugin_searchpath));
+        catalog = plugin_catalog();
+        found   = catalog->output_formats.find(format);
+    }
     ImageOutput::Creator create_function = nullptr;
-    {  // scope the lock:
-        std::unique_lock<std::recursive_mutex> lock(imageio_mutex);
-
-        // See if it's already in the table.  If not, scan all plugins we can
-        // find to populate the table.
-        Strutil::to_lower(format);
-        OutputPluginMap::const_iterator found = output_formats.find(format);
-        if (found == output_formats.end()) {
-            lock.unlock();
-            // catalog_all_plugins() will lock imageio_mutex
-            catalog_all_plugins(plugin_searchpath.size()
-                                    ? plugin_searchpath
-                                    : string_view(pvt::plugin_searchpath));
-            lock.lock();
-            found = output_formats.find(format);
-        }
-        if (found != output_formats.end()) {
-            create_function = found->second;
-        } else {
-            if (output_formats.empty()) {
-                // This error is so fundamental, we echo it to stderr in
-                // case the app is too dumb to do so.
-                const char* msg
-                    = "ImageOutput::create() could not find any ImageOutput plugins!  Perhaps you need to set OIIO_LIBRARY_PATH.\n";
-                Strutil::print(stderr, "{}", msg);
-                OIIO::pvt::errorfmt("{}", msg);
-            } else
-                OIIO::pvt::errorfmt(
-                    "OpenImageIO could not find a format writer for \"{}\". "
-                    "Is it a file format that OpenImageIO doesn't know about?\n",
-                    filename);
-            return out;
-        }
+    if (found != catalog->output_formats.end())
+        create_function = output_creator(*catalog, format, found->second);
+    if (!create_function) {
+        if (catalog->output_formats.empty()) {
+            // This error is so fundamental, we echo it to stderr in
+            // case the app is too dumb to do so.
+            const char* msg
+                = "ImageOutput::create() could not find any ImageOutput plugins!  Perhaps you need to set OIIO_LIBRARY_PATH.\n";
+            Strutil::print(stderr, "{}", msg);
+            OIIO::pvt::errorfmt("{}", msg);
+        } else
+            OIIO::pvt::errorfmt(
+                "OpenImageIO could not find a format writer for \"{}\". "
+                "Is it a file format that OpenImageIO doesn't know about?\n",
+                filename);
+        return out;
     }
 
     OIIO_ASSERT(create_function != nullptr);
@@ -641,6 +1130,84 @@ ImageInput::create(const std::string& filename, bool do_open,
 
 
 
+// Create an ImageInput with create_function and check that it can read the
+// file, returning it (opened only if do_open) if so. If not, return nullptr
+// and put any error the reader gave in `error`.
+static std::unique_ptr<ImageInput>
+try_reader(ImageInput::Creator create_function, string_view filename,
+           bool do_open, const ImageSpec* config, Filesystem::IOProxy* ioproxy,
+           std::string& error)
+{
+    std::unique_ptr<ImageInput> in(create_function());
+    if (!do_open && in && in->valid_file(filename)) {
+        // Special case: we don't need to return the file
+        // already opened, and this ImageInput says that the
+        // file is the right type.
+        return in;
+    }
+    ImageSpec tmpspec;
+    bool ok = false;
+    if (in) {
+        in->set_ioproxy(ioproxy);
+        if (config)
+            ok = in->open(filename, tmpspec, *config);
+        else
+            ok = in->open(filename, tmpspec);
+    }
+    if (ok) {
+        // It worked
+        if (!do_open)
+            in->close();
+        return in;
+    }
+    if (in) {
+        error = in->geterror();
+        if (pvt::oiio_print_debug > 1)
+            OIIO::debugfmt(
+                "ImageInput::create: \"{}\" did not open using format \"{}\".\n",
+                filename, in->format_name());
+    }
+    return nullptr;
+}
+
+
+
+// Return the creator of the first reader (in format_list_vector order) whose
+// signature matches the start of the file or ioproxy, or nullptr if none do.
+static ImageInput::Creator
+sniff_format(const PluginCatalog& catalog, string_view filename,
+             Filesystem::IOProxy* ioproxy)
+{
+    if (!catalog.signature_bytes)
+        return nullptr;
+    std::unique_ptr<Filesystem::IOProxy> file;
+    if (!ioproxy) {
+        if (!Filesystem::is_regular(filename))
+            return nullptr;
+        file.reset(new Filesystem::IOFile(filename, Filesystem::IOProxy::Read));
+        ioproxy = file.get();
+    }
+    if (!ioproxy->opened() || ioproxy->mode() != Filesystem::IOProxy::Read)
+        return nullptr;
+    std::string header(catalog.signature_bytes, '\0');
+    header.resize(ioproxy->pread(&header[0], header.size(), 0));
+    for (const auto& reader : catalog.readers) {
+        for (const auto& sig : reader.signatures) {
+            if (sig.offset + sig.bytes.size() <= header.size()
+                && !header.compare(sig.offset, sig.bytes.size(), sig.bytes)) {
+                if (pvt::oiio_print_debug > 1)
+                    OIIO::debugfmt(
+                        "ImageInput::create: \"{}\" looks like format \"{}\".\n",
+                        filename, reader.name);
+                return reader_creator(reader);
+            }
+        }
+    }
+    return nullptr;
+}
+
+
+
 std::unique_ptr<ImageInput>
 ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
                    Filesystem::IOProxy* ioproxy, string_view plugin_searchpath)
@@ -676,26 +1243,22 @@ ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
         format = filename;
     }
 
-    ImageInput::Creator create_function = nullptr;
-    {  // scope the lock:
-        std::unique_lock<std::recursive_mutex> lock(imageio_mutex);
-
-        // See if it's already in the table.  If not, scan all plugins we can
-        // find to populate the table.
-        Strutil::to_lower(format);
-        InputPluginMap::const_iterator found = input_formats.find(format);
-        if (found == input_formats.end()) {
-            if (plugin_searchpath.empty())
-                plugin_searchpath = pvt::plugin_searchpath;
-            lock.unlock();
-            // catalog_all_plugins() will lock imageio_mutex.
-            catalog_all_plugins(plugin_searchpath);
-            lock.lock();
-            found = input_formats.find(format);
-        }
-        if (found != input_formats.end())
-            create_function = found->second;
+    // See if it's already in the table.  If not, scan all plugins we can
+    // find to populate the table.
+    Strutil::to_lower(format);
+    const PluginCatalog* catalog = plugin_catalog();
+    auto found                   = catalog->input_formats.find(format);
+    if (found == catalog->input_formats.end()) {
+        if (plugin_searchpath.empty())
+            plugin_searchpath = pvt::plugin_searchpath;
+        // catalog_all_plugins() will lock imageio_mutex.
+        catalog_all_plugins(plugin_searchpath);
+        catalog = plugin_catalog();
+        found   = catalog->input_formats.find(format);
     }
+    ImageInput::Creator create_function = nullptr;
+    if (found != catalog->input_formats.end())
+        create_function = input_creator(*catalog, format, found->second);
 
     // Remember which prototypes we've already tried, so we don't double dip.
     std::vector<ImageInput::Creator> formats_tried;
@@ -707,40 +1270,33 @@ ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
         // when somebody will have an incorrectly-named file, let's
         // deal with it robustly.
         formats_tried.push_back(create_function);
-        in = std::unique_ptr<ImageInput>(create_function());
-        if (!do_open && in && in->valid_file(filename)) {
-            // Special case: we don't need to return the file
-            // already opened, and this ImageInput says that the
-            // file is the right type.
-            return in;
-        }
-        ImageSpec tmpspec;
-        bool ok = false;
-        if (in) {
-            in->set_ioproxy(ioproxy);
-            if (config)
-                ok = in->open(filename, tmpspec, *config);
-            else
-                ok = in->open(filename, tmpspec);
-        }
-        if (ok) {
-            // It worked
-            if (!do_open)
-                in->close();
+        in = try_reader(create_function, filename, do_open, config, ioproxy,
+                        specific_error);
+        if (in)
             return in;
-        } else {
-            // Oops, it failed.  Apparently, this file can't be
-            // opened with this II.  Clear create_function to force
-            // the code below to check every plugin we know.
-            create_function = nullptr;
-            if (in) {
-                specific_error = in->geterror();
-                if (pvt::oiio_print_debug > 1)
-                    OIIO::debugfmt(
-                        "ImageInput::create: \"{}\" did not open using format \"{}\".\n",
-                        filename, in->format_name());
-            }
-            in.reset();
+        // Oops, it failed.  Apparently, this file can't be opened with
+        // this II.  Clear create_function to force the code below to look
+        // for another reader.
+        create_function = nullptr;
+    }
+
+    if (!create_function) {
+        // The extension didn't lead to a reader that could open the file.
+        // Before resorting to trying every reader in turn, see if the first
+        // bytes of the file are the magic number of a format we know.
+        ImageInput::Creator sniffed = sniff_format(*catalog, filename,
+                                                   ioproxy);
+        if (sniffed
+            && std::find(formats_tried.begin(), formats_tried.end(), sniffed)
+                   == formats_tried.end()) {
+            formats_tried.push_back(sniffed);
+            std::string sniffed_error;
+            in = try_reader(sniffed, filename, do_open, config, ioproxy,
+                            sniffed_error);
+            if (in)
+                return in;
+            if (specific_error.empty())
+                specific_error = sniffed_error;
         }
     }
 
@@ -755,21 +1311,19 @@ ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
         if (config)
             myconfig = *config;
         myconfig.attribute("nowait", (int)1);
-        std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
-        for (auto f : format_list_vector) {
-            auto plugin = input_formats.find(f.string());
-            if (plugin == input_formats.end() || !plugin->second)
-                continue;  // format that's output only
+        for (const auto& reader : catalog->readers) {
+            ImageInput::Creator create_function = reader_creator(reader);
+            if (!create_function)
+                continue;  // plugin that failed to load
             // If we already tried this create function, don't do it again
             if (std::find(formats_tried.begin(), formats_tried.end(),
-                          plugin->second)
+                          create_function)
                 != formats_tried.end())
                 continue;
-            formats_tried.push_back(plugin->second);  // remember
+            formats_tried.push_back(create_function);  // remember
 
             ImageSpec tmpspec;
             try {
-                ImageInput::Creator create_function = plugin->second;
                 in = std::unique_ptr<ImageInput>(create_function());
             } catch (...) {
                 // Safety in case the ctr throws an exception
@@ -782,7 +1336,7 @@ ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
                 if (pvt::oiio_print_debug > 1)
                     OIIO::debugfmt(
                         "ImageInput::create: \"{}\" did not open using format \"{}\" {} [valid_file was false].\n",
-                        filename, plugin->first, in->format_name());
+                        filename, reader.name, in->format_name());
                 in.reset();
                 continue;
             }
@@ -796,20 +1350,19 @@ ImageInput::create(string_view filename, bool do_open, const ImageSpec* config,
                 if (pvt::oiio_print_debug > 1)
                     OIIO::debugfmt(
                         "ImageInput::create: \"{}\" succeeded using format \"{}\".\n",
-                        filename, plugin->first);
+                        filename, reader.name);
                 return in;
             }
             if (pvt::oiio_print_debug > 1)
                 OIIO::debugfmt(
                     "ImageInput::create: \"{}\" did not open using format \"{}\" {}.\n",
-                    filename, plugin->first, in->format_name());
+                    filename, reader.name, in->format_name());
             in.reset();
         }
     }
 
     if (!create_function) {
-        std::lock_guard<std::recursive_mutex> lock(imageio_mutex);
-        if (input_formats.empty()) {
+        if (catalog->input_formats.empty()) {
             // This error is so fundamental, we echo it to stderr in
             // case the app is too dumb to do so.
             const char* msg
@@ -0,0 +1,402 @@
+// Copyright Contributors to the OpenImageIO project.
+// SPDX-License-Identifier: Apache-2.0
+// https://github.com/AcademySoftwareFoundation/OpenImageIO
+
+// Pack and unpack the 10- and 12-bit layouts used by DPX and Cineon.
+// See the descriptions in imageio_pvt.h.
+
+#include <cstring>
+
+#include <OpenImageIO/dassert.h>
+#include <OpenImageIO/fmath.h>
+#include <OpenImageIO/simd.h>
+
+#include "imageio_pvt.h"
+
+OIIO_NAMESPACE_BEGIN
+
+using simd::vbool4;
+using simd::vint4;
+
+
+namespace {
+
+// Expand a 10- or 12-bit value to 16 bits, the way libdpx and libcineon
+// do, by replicating the high bits into the low ones.
+inline uint16_t
+expand_bits(uint32_t v, int bits)
+{
+    return uint16_t((v << (16 - bits)) | (v >> (2 * bits - 16)));
+}
+
+template<int BITS>
+OIIO_FORCEINLINE vint4
+expand_bits(const vint4& v)
+{
+    return (v << (16 - BITS)) | simd::srl(v, 2 * BITS - 16);
+}
+
+
+// Byte-swap each 32-bit lane.
+OIIO_FORCEINLINE vint4
+byteswap(const vint4& w)
+{
+    return (w << 24) | ((w << 8) & vint4(0xff0000))
+           | (simd::srl(w, 8) & vint4(0xff00)) | simd::srl(w, 24);
+}
+
+
+inline uint32_t
+load_word(const unsigned char* p, bool swap)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return swap ? OIIO::byteswap(w) : w;
+}
+
+
+inline void
+store_word(unsigned char* p, uint32_t w, bool swap)
+{
+    if (swap)
+        w = OIIO::byteswap(w);
+    memcpy(p, &w, sizeof(w));
+}
+
+
+
+// Bit position within its word of each of the three values of a filled
+// 10-bit word.
+inline int
+filled_shift(int i, int padbits)
+{
+    return (2 - i) * 10 + padbits;
+}
+
+
+// Multipliers that move datum i of a filled word up to the top 10 bits
+// (a per-lane left shift, which simd.h only has in uniform form).
+inline vint4
+filled_mul(int i0, int i1, int i2, int i3, int padbits)
+{
+    return vint4(1 << (22 - filled_shift(i0, padbits)),
+                 1 << (22 - filled_shift(i1, padbits)),
+                 1 << (22 - filled_shift(i2, padbits)),
+                 1 << (22 - filled_shift(i3, padbits)));
+}
+
+// Multipliers that move a 10-bit value up to the place of datum i.
+inline vint4
+filled_place(int i0, int i1, int i2, int i3, int padbits)
+{
+    return vint4(1 << filled_shift(i0, padbits), 1 << filled_shift(i1, padbits),
+                 1 << filled_shift(i2, padbits),
+                 1 << filled_shift(i3, padbits));
+}
+
+
+
+// "Packed" data: a continuous bit stream of BITS-bit values, least
+// significant first, in 32-bit words. A group of WORDS words holds exactly
+// VALUES values. We process four groups at once, one per SIMD lane, so
+// that every shift is the same across lanes.
+template<int BITS> struct PackedGroup {
+    static constexpr int VALUES = BITS == 10 ? 16 : 8;
+    static constexpr int WORDS  = VALUES * BITS / 32;
+    static constexpr uint32_t MASK = (1u << BITS) - 1;
+};
+
+
+template<int BITS>
+void
+unpack_packed_groups(const unsigned char* src, uint16_t* dst, size_t ngroups,
+                     bool swap)
+{
+    using G = PackedGroup<BITS>;
+    constexpr int stride = G::WORDS * 4;
+    for (; ngroups >= 4; ngroups -= 4) {
+        vint4 w[G::WORDS];
+        for (int k = 0; k < G::WORDS; ++k) {
+            w[k] = vint4(int(load_word(src + k * 4, false)),
+                         int(load_word(src + stride + k * 4, false)),
+                         int(load_word(src + 2 * stride + k * 4, false)),
+                         int(load_word(src + 3 * stride + k * 4, false)));
+            if (swap)
+                w[k] = byteswap(w[k]);
+        }
+        vint4 v[G::VALUES];
+        for (int j = 0; j < G::VALUES; ++j) {
+            int bit = j * BITS, k = bit / 32, off = bit % 32;
+            vint4 d = simd::srl(w[k], off);
+            if (off + BITS > 32)
+                d |= w[k + 1] << (32 - off);
+            v[j] = expand_bits<BITS>(d & vint4(G::MASK));
+        }
+        for (int j = 0; j < G::VALUES; j += 4) {
+            vint4 a = v[j], b = v[j + 1], c = v[j + 2], d = v[j + 3];
+            simd::transpose(a, b, c, d);
+            a.store(dst + j);
+            b.store(dst + G::VALUES + j);
+            c.store(dst + 2 * G::VALUES + j);
+            d.store(dst + 3 * G::VALUES + j);
+        }
+        src += 4 * stride;
+        dst += 4 * G::VALUES;
+    }
+    for (size_t i = 0, n = ngroups * G::VALUES; i < n; ++i) {
+        size_t bit = i * BITS, k = bit / 32, off = bit % 32;
+        uint64_t d = load_word(src + k * 4, swap);
+        if (off + BITS > 32)
+            d |= uint64_t(load_word(src + k * 4 + 4, swap)) << 32;
+        dst[i] = expand_bits(uint32_t(d >> off) & G::MASK, BITS);
+    }
+}
+
+
+template<int BITS>
+void
+pack_packed_groups(const uint16_t* src, unsigned char* dst, size_t ngroups,
+                   bool swap)
+{
+    using G = PackedGroup<BITS>;
+    constexpr int stride = G::WORDS * 4;
+    for (; ngroups >= 4; ngroups -= 4) {
+        // Load everything before storing anything, so that packing in
+        // place (dst == src) is safe.
+        vint4 v[G::VALUES];
+        for (int j = 0; j < G::VALUES; j += 4) {
+            vint4 a(src + j), b(src + G::VALUES + j),
+                c(src + 2 * G::VALUES + j), d(src + 3 * G::VALUES + j);
+            simd::transpose(a, b, c, d);
+            v[j]     = simd::srl(a, 16 - BITS);
+            v[j + 1] = simd::srl(b, 16 - BITS);
+            v[j + 2] = simd::srl(c, 16 - BITS);
+            v[j + 3] = simd::srl(d, 16 - BITS);
+        }
+        vint4 w[G::WORDS];
+        for (int k = 0; k < G::WORDS; ++k)
+            w[k] = vint4::Zero();
+        for (int j = 0; j < G::VALUES; ++j) {
+            int bit = j * BITS, k = bit / 32, off = bit % 32;
+            w[k] |= v[j] << off;
+            if (off + BITS > 32)
+                w[k + 1] |= simd::srl(v[j], 32 - off);
+        }
+        for (int k = 0; k < G::WORDS; ++k) {
+            if (swap)
+                w[k] = byteswap(w[k]);
+            for (int g = 0; g < 4; ++g)
+                store_word(dst + g * stride + k * 4, uint32_t(w[k][g]),
+                           false);
+        }
+        src += 4 * G::VALUES;
+        dst += 4 * stride;
+    }
+    for (size_t g = 0; g < ngroups; ++g) {
+        uint32_t w[G::WORDS] = {};
+        for (int j = 0; j < G::VALUES; ++j) {
+            uint32_t v = uint32_t(src[j]) >> (16 - BITS);
+            int bit = j * BITS, k = bit / 32, off = bit % 32;
+            w[k] |= v << off;
+            if (off + BITS > 32)
+                w[k + 1] |= v >> (32 - off);
+        }
+        for (int k = 0; k < G::WORDS; ++k)
+            store_word(dst + k * 4, w[k], swap);
+        src += G::VALUES;
+        dst += stride;
+    }
+}
+
+
+
+template<int BITS>
+void
+unpack_packed(const void* src_, uint16_t* dst, size_t n, bool swap)
+{
+    using G = PackedGroup<BITS>;
+    const unsigned char* src = (const unsigned char*)src_;
+    size_t ngroups           = n / G::VALUES;
+    unpack_packed_groups<BITS>(src, dst, ngroups, swap);
+    // A partial group at the end: copy what's left of the words and unpack
+    // a whole group from that.
+    if (size_t rem = n % G::VALUES) {
+        size_t words = (rem * BITS + 31) / 32;
+        unsigned char last[G::WORDS * 4] = {};
+        memcpy(last, src + ngroups * G::WORDS * 4, words * 4);
+        uint16_t vals[G::VALUES];
+        unpack_packed_groups<BITS>(last, vals, 1, swap);
+        memcpy(dst + ngroups * G::VALUES, vals, rem * sizeof(uint16_t));
+    }
+}
+
+
+template<int BITS>
+void
+pack_packed(const uint16_t* src, void* dst_, size_t n, bool swap)
+{
+    using G = PackedGroup<BITS>;
+    unsigned char* dst = (unsigned char*)dst_;
+    size_t ngroups     = n / G::VALUES;
+    size_t rem         = n % G::VALUES;
+    // Copy out any partial group first, in case we're packing in place.
+    uint16_t vals[G::VALUES] = {};
+    memcpy(vals, src + ngroups * G::VALUES, rem * sizeof(uint16_t));
+    pack_packed_groups<BITS>(src, dst, ngroups, swap);
+    if (rem) {
+        unsigned char last[G::WORDS * 4];
+        pack_packed_groups<BITS>(vals, last, 1, swap);
+        memcpy(dst + ngroups * G::WORDS * 4, last, (rem * BITS + 31) / 32 * 4);
+    }
+}
+
+}  // namespace
+
+
+
+void
+pvt::unpack_10bit_filled(const void* src_, uint16_t* dst, size_t n,
+                         int padbits, bool swap)
+{
+    const unsigned char* src = (const unsigned char*)src_;
+    size_t i                 = 0;
+    // Four words make twelve values, as three vectors of four:
+    //   [A0 B0 C0 A1] [B1 C1 A2 B2] [C2 A3 B3 C3]
+    // Each lane selects its word, shifts its datum to the top with a
+    // multiply, then shifts it down to the bottom.
+    const vint4 mul0 = filled_mul(0, 1, 2, 0, padbits);
+    const vint4 mul1 = filled_mul(1, 2, 0, 1, padbits);
+    const vint4 mul2 = filled_mul(2, 0, 1, 2, padbits);
+    for (; i + 12 <= n; i += 12, src += 16) {
+        vint4 w;
+        w.load((const int*)src);
+        if (swap)
+            w = byteswap(w);
+        vint4 a = simd::srl(simd::shuffle<0, 0, 0, 1>(w) * mul0, 22);
+        vint4 b = simd::srl(simd::shuffle<1, 1, 2, 2>(w) * mul1, 22);
+        vint4 c = simd::srl(simd::shuffle<2, 3, 3, 3>(w) * mul2, 22);
+        expand_bits<10>(a).store(dst + i);
+        expand_bits<10>(b).store(dst + i + 4);
+        expand_bits<10>(c).store(dst + i + 8);
+    }
+    for (; i < n; src += 4) {
+        uint32_t w = load_word(src, swap);
+        for (int d = 0; d < 3 && i < n; ++d, ++i)
+            dst[i] = expand_bits((w >> filled_shift(d, padbits)) & 0x3ff, 10);
+    }
+}
+
+
+
+void
+pvt::pack_10bit_filled(const uint16_t* src, void* dst_, size_t n,
+                       int padbits, bool swap)
+{
+    unsigned char* dst = (unsigned char*)dst_;
+    size_t i           = 0;
+    // The reverse of unpack_10bit_filled: shift the values of vectors
+    // [A0 B0 C0 A1] [B1 C1 A2 B2] [C2 A3 B3 C3] into place with a multiply,
+    // then gather the three parts of each word and combine them. All loads
+    // precede the stores, so packing in place is safe.
+    const vint4 mul0 = filled_place(0, 1, 2, 0, padbits);
+    const vint4 mul1 = filled_place(1, 2, 0, 1, padbits);
+    const vint4 mul2 = filled_place(2, 0, 1, 2, padbits);
+    const vbool4 lane0(true, false, false, false);
+    const vbool4 lane1(false, true, false, false);
+    const vbool4 lane2(false, false, true, false);
+    const vbool4 lane3(false, false, false, true);
+    for (; i + 12 <= n; i += 12, dst += 16) {
+        vint4 a = simd::srl(vint4(src + i), 6) * mul0;
+        vint4 b = simd::srl(vint4(src + i + 4), 6) * mul1;
+        vint4 c = simd::srl(vint4(src + i + 8), 6) * mul2;
+        // Words are [A0|B0|C0, A1|B1|C1, A2|B2|C2, A3|B3|C3]
+        vint4 x = blend(blend(simd::shuffle<0, 3, 0, 0>(a),
+                              simd::shuffle<2>(b), lane2),
+                        simd::shuffle<1>(c), lane3);
+        vint4 y = blend(blend(simd::shuffle<0, 0, 3, 3>(b),
+                              simd::shuffle<1>(a), lane0),
+                        simd::shuffle<2>(c), lane3);
+        vint4 z = blend(blend(simd::shuffle<0, 0, 0, 3>(c),
+                              simd::shuffle<2>(a), lane0),
+                        simd::shuffle<1>(b), lane1);
+        vint4 w = x | y | z;
+        if (swap)
+            w = byteswap(w);
+        w.store((int*)dst);
+    }
+    for (; i < n; dst += 4) {
+        uint32_t w = 0;
+        for (int d = 0; d < 3 && i < n; ++d, ++i)
+            w |= uint32_t(src[i] >> 6) << filled_shift(d, padbits);
+        store_word(dst, w, swap);
+    }
+}
+
+
+
+void
+pvt::unpack_packed_bits(const void* src, uint16_t* dst, size_t n, int bits,
+                        bool swap)
+{
+    OIIO_DASSERT(bits == 10 || bits == 12);
+    if (bits == 10)
+        unpack_packed<10>(src, dst, n, swap);
+    else
+        unpack_packed<12>(src, dst, n, swap);
+}
+
+
+
+void
+pvt::pack_packed_bits(const uint16_t* src, void* dst, size_t n, int bits,
+                      bool swap)
+{
+    OIIO_DASSERT(bits == 10 || bits == 12);
+    if (bits == 10)
+        pack_packed<10>(src, dst, n, swap);
+    else
+        pack_packed<12>(src, dst, n, swap);
+}
+
+
+
+void
+pvt::unpack_12bit_filled(const void* src_, uint16_t* dst, size_t n,
+                         bool swap)
+{
+    const uint16_t* src = (const uint16_t*)src_;
+    size_t i            = 0;
+    for (; i + 4 <= n; i += 4) {
+        vint4 v(src + i);
+        if (swap)
+            v = (v << 8) | simd::srl(v, 8);
+        // Like libdpx, don't mask off the unused high bits before
+        // expanding, only after.
+        ((v << 4) | simd::srl(v & vint4(0xffff), 8)).store(dst + i);
+    }
+    for (; i < n; ++i) {
+        uint16_t v = swap ? OIIO::byteswap(src[i]) : src[i];
+        dst[i]     = uint16_t((v << 4) | (v >> 8));
+    }
+}
+
+
+
+void
+pvt::pack_12bit_filled(const uint16_t* src, void* dst_, size_t n, bool swap)
+{
+    uint16_t* dst = (uint16_t*)dst_;
+    size_t i      = 0;
+    for (; i + 4 <= n; i += 4) {
+        vint4 v = simd::srl(vint4(src + i), 4);
+        if (swap)
+            v = (v << 8) | simd::srl(v, 8);
+        v.store(dst + i);
+    }
+    for (; i < n; ++i) {
+        uint16_t v = src[i] >> 4;
+        dst[i]     = swap ? OIIO::byteswap(v) : v;
+    }
+}
+
+OIIO_NAMESPACE_END
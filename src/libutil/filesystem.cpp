@@ -29,6 +29,7 @@
 #    include <sys/types.h>
 #    include <sys/utime.h>
 #else
+#    include <sys/mman.h>
 #    include <sys/stat.h>
 #    include <sys/types.h>
 #    include <unistd.h>
@@ -1377,4 +1378,90 @@ Filesystem::IOMemReader::pread(void* buf, size_t size, int64_t offset)
 }
 
 
+
+Filesystem::IOMemMapFile::IOMemMapFile(string_view filename)
+    : IOMemReader(nullptr, 0)
+{
+    m_filename = filename;
+#ifdef _WIN32
+    std::wstring wname = Strutil::utf8_to_utf16wstring(filename);
+    HANDLE file = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        m_mode = Closed;
+        error(Strutil::fmt::format("could not open (error {})",
+                                   GetLastError()));
+        return;
+    }
+    LARGE_INTEGER size;
+    size.QuadPart = 0;
+    GetFileSizeEx(file, &size);
+    if (size.QuadPart > 0) {
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0,
+                                       nullptr);
+        if (m_mapping)
+            m_map = MapViewOfFile((HANDLE)m_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!m_map) {
+            m_mode = Closed;
+            error(Strutil::fmt::format("could not map file (error {})",
+                                       GetLastError()));
+        }
+    }
+    CloseHandle(file);  // the mapping keeps its own reference
+    if (m_map)
+        m_buf = cspan<unsigned char>((const unsigned char*)m_map,
+                                     size_t(size.QuadPart));
+#else
+    int fd = ::open(m_filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        m_mode = Closed;
+        error(std::strerror(errno));
+        if (fd >= 0)
+            ::close(fd);
+        return;
+    }
+    if (st.st_size > 0) {
+        void* map = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE,
+                         fd, 0);
+        if (map == MAP_FAILED) {
+            m_mode = Closed;
+            error(std::strerror(errno));
+        } else {
+            m_map = map;
+            m_buf = cspan<unsigned char>((const unsigned char*)m_map,
+                                         size_t(st.st_size));
+        }
+    }
+    ::close(fd);  // the mapping keeps its own reference
+#endif
+}
+
+
+Filesystem::IOMemMapFile::~IOMemMapFile()
+{
+    close();
+}
+
+
+void
+Filesystem::IOMemMapFile::close()
+{
+#ifdef _WIN32
+    if (m_map)
+        UnmapViewOfFile(m_map);
+    if (m_mapping)
+        CloseHandle((HANDLE)m_mapping);
+#else
+    if (m_map)
+        munmap(m_map, m_buf.size());
+#endif
+    m_map     = nullptr;
+    m_mapping = nullptr;
+    m_buf     = cspan<unsigned char>();
+    m_mode    = Closed;
+}
+
+
 OIIO_NAMESPACE_END
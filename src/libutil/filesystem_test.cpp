@@ -590,6 +590,24 @@ test_mem_proxies()
         10, 13, 14, 13, 14, 15, 16, 17, 18, 19
     };
     OIIO_CHECK_ASSERT(output_buf == ref_buf);
+
+    // Memory-mapped file reads
+    Filesystem::write_binary_file("oiio-testmmap.bin", input_buf);
+    {
+        Filesystem::IOMemMapFile mm("oiio-testmmap.bin");
+        OIIO_CHECK_ASSERT(mm.opened());
+        OIIO_CHECK_EQUAL(mm.size(), input_buf.size());
+        OIIO_CHECK_ASSERT(std::equal(input_buf.begin(), input_buf.end(),
+                                     mm.buffer().begin()));
+        OIIO_CHECK_EQUAL(mm.pread(b, 2, 8), 2);
+        OIIO_CHECK_EQUAL(int(b[0]), 18);
+        mm.close();
+        OIIO_CHECK_ASSERT(!mm.opened());
+    }
+    Filesystem::remove("oiio-testmmap.bin");
+    Filesystem::IOMemMapFile missing("oiio-no-such-file.bin");
+    OIIO_CHECK_ASSERT(!missing.opened());
+    OIIO_CHECK_ASSERT(missing.error().size());
 }
 
 
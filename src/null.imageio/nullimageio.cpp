@@ -115,6 +115,7 @@ null_input_imageio_create()
 }
 
 OIIO_EXPORT const char* null_input_extensions[] = { "null", "nul", nullptr };
+OIIO_EXPORT const char* null_input_signatures[] = { nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -4624,6 +4624,29 @@ UNARY_IMAGE_OP(flatten, ImageBufAlgo::flatten);
 
 
 
+// --deepreduce
+OIIOTOOL_OP(deepreduce, 1, [&](OiiotoolOp& op, span<ImageBuf*> img) {
+    float ztol    = op.options().get_float("ztol", 0.0f);
+    float ctol    = op.options().get_float("ctol", 0.0f);
+    float opacity = op.options().get_float("opacity", 1.0f);
+    ImageBufAlgo::DeepReduceStats stats;
+    bool ok = ImageBufAlgo::deep_reduce(*img[0], *img[1], ztol, ctol, opacity,
+                                        &stats);
+    if (ok && (ot.verbose || op.options().get_int("stats"))) {
+        print("  deepreduce: {} -> {} samples ({:.1f}%), {} -> {},"
+              " max samples/pixel {} -> {}\n",
+              stats.samples_in, stats.samples_out,
+              stats.samples_in ? 100.0 * stats.samples_out / stats.samples_in
+                               : 100.0,
+              Strutil::memformat(stats.bytes_in),
+              Strutil::memformat(stats.bytes_out), stats.maxsamples_in,
+              stats.maxsamples_out);
+    }
+    return ok;
+});
+
+
+
 static void
 action_fill(Oiiotool& ot, cspan<const char*> argv)
 {
@@ -4900,6 +4923,13 @@ input_file(Oiiotool& ot, cspan<const char*> argv)
                                                     ot.printinfo_format);
     TypeDesc input_dataformat(fileoptions.get_string("type"));
     std::string channel_set = fileoptions["ch"];
+    // Reduced resolution request just for this file, on top of any other
+    // input configuration.
+    int reduce             = fileoptions.get_int("reduce", 1);
+    bool config_set        = ot.input_config_set || reduce > 1;
+    ImageSpec input_config = ot.input_config;
+    if (reduce > 1)
+        input_config.attribute("oiio:reduce", reduce);
 
     for (int i = 0; i < argv.size(); i++) {  // FIXME: this loop is pointless
         OTScopedTimer timer(ot, command);
@@ -4913,12 +4943,12 @@ input_file(Oiiotool& ot, cspan<const char*> argv)
             break;
         }
         int exists = 1;
-        if (ot.input_config_set) {
+        if (config_set) {
             // User has set some input configuration, so seed the cache with
             // that information.
             ustring fn(filename);
             ot.imagecache->invalidate(fn, true);
-            bool ok = ot.imagecache->add_file(fn, nullptr, &ot.input_config);
+            bool ok = ot.imagecache->add_file(fn, nullptr, &input_config);
             if (!ok) {
                 ot.error("read",
                          ot.format_read_error(filename,
@@ -4987,8 +5017,8 @@ input_file(Oiiotool& ot, cspan<const char*> argv)
             if (ot.debug || ot.verbose)
                 std::cout << "Reading " << filename << "\n";
             ot.push(ImageRecRef(new ImageRec(filename, ot.imagecache)));
-            if (ot.input_config_set)
-                ot.curimg->configspec(ot.input_config);
+            if (config_set)
+                ot.curimg->configspec(input_config);
             ot.curimg->input_dataformat(input_dataformat);
             if (readnow)
                 ot.read(ReadNoCache, channel_set);
@@ -6229,7 +6259,7 @@ Oiiotool::getargs(int argc, char* argv[])
 
     ap.separator("Commands that read images:");
     ap.arg("-i %s:FILENAME")
-      .help("Input file (options: autocc=, ch=, info=, infoformat=, now=, type=, unpremult=)")
+      .help("Input file (options: autocc=, ch=, info=, infoformat=, now=, reduce=, type=, unpremult=)")
       .OTACTION(input_file);
     ap.arg("--iconfig %s:NAME %s:VALUE")
       .help("Sets input config attribute (options: type=...)")
@@ -6664,6 +6694,9 @@ Oiiotool::getargs(int argc, char* argv[])
     ap.arg("--flatten")
       .help("Flatten deep image to non-deep")
       .OTACTION(action_flatten);
+    ap.arg("--deepreduce")
+      .help("Reduce the samples of a deep image (options: ztol=0, ctol=0, opacity=1, stats=0)")
+      .OTACTION(action_deepreduce);
 
     ap.separator("Image stack manipulation:");
     ap.arg("--dup")
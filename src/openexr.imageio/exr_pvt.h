@@ -240,4 +240,32 @@ private:
 
 
 
+#ifdef OIIO_USE_EXR_C_API
+// Pixel writer for a single-part, single-level, non-deep OpenEXR file
+// through the OpenEXRCore API, used by OpenEXROutput when the
+// "openexr:core_output" attribute is set. Chunks are compressed in parallel
+// on the OIIO thread pool and written to the file in chunk order. The
+// header (including all metadata) is the one OpenEXROutput built for the
+// C++ library. Data passed in is always in the native format and
+// contiguous by pixel. Implemented in exroutput_c.cpp.
+class OpenEXRCoreWriter {
+public:
+    virtual ~OpenEXRCoreWriter() {}
+    virtual bool write_scanlines(int ybegin, int yend, const void* data) = 0;
+    virtual bool write_tiles(int xbegin, int xend, int ybegin, int yend,
+                             const void* data, stride_t ystride)
+        = 0;
+    virtual bool close() = 0;
+
+    // Start the file and write its header. Return nullptr (after reporting
+    // the error to `out`) upon failure.
+    static std::unique_ptr<OpenEXRCoreWriter>
+    create(ImageOutput* out, const std::string& filename,
+           Filesystem::IOProxy* io, const ImageSpec& spec,
+           const Imf::Header& header, int nthreads);
+};
+#endif
+
+
+
 OIIO_PLUGIN_NAMESPACE_END
@@ -128,6 +128,18 @@ public:
     bool read_native_scanlines(int subimage, int miplevel, int ybegin, int yend,
                                int z, int chbegin, int chend,
                                void* data) override;
+    using ImageInput::read_scanlines;
+    bool read_scanlines(int subimage, int miplevel, int ybegin, int yend,
+                        int z, int chbegin, int chend, TypeDesc format,
+                        void* data, stride_t xstride = AutoStride,
+                        stride_t ystride = AutoStride) override;
+    using ImageInput::read_tiles;
+    bool read_tiles(int subimage, int miplevel, int xbegin, int xend,
+                    int ybegin, int yend, int zbegin, int zend, int chbegin,
+                    int chend, TypeDesc format, void* data,
+                    stride_t xstride = AutoStride,
+                    stride_t ystride = AutoStride,
+                    stride_t zstride = AutoStride) override;
     bool read_native_tile(int subimage, int miplevel, int x, int y, int z,
                           void* data) override;
     bool read_native_tiles(int subimage, int miplevel, int xbegin, int xend,
@@ -220,6 +232,19 @@ private:
 
     bool valid_file(const std::string& filename, Filesystem::IOProxy* io) const;
 
+    // Decode scanlines or whole tiles into `data` with the given strides.
+    // If `format` is TypeUnknown, each channel keeps its native type,
+    // otherwise OpenEXRCore converts to `format` (which must be one of the
+    // types it supports) as it unpacks. For tiles, ystride may be
+    // AutoStride, meaning the buffer is a row of whole tiles.
+    bool decode_scanlines(int subimage, int miplevel, int ybegin, int yend,
+                          int chbegin, int chend, TypeDesc format, void* data,
+                          stride_t xstride, stride_t ystride);
+    bool decode_tiles(int subimage, int miplevel, int xbegin, int xend,
+                      int ybegin, int yend, int zbegin, int zend, int chbegin,
+                      int chend, TypeDesc format, void* data, stride_t xstride,
+                      stride_t ystride);
+
     // Fill in with 'missing' color/pattern.
     bool check_fill_missing(int xbegin, int xend, int ybegin, int yend,
                             int zbegin, int zend, int chbegin, int chend,
@@ -239,6 +264,46 @@ private:
         exr_decode_pipeline_t* decoder;
     };
     friend class DecoderDestroyer;
+
+    // A decode pipeline plus scratch memory that outlives a single chunk.
+    // Once initialized for a part, subsequent chunks of that part only
+    // need exr_decoding_update, which reuses the channel table and the
+    // packed/unpacked/decompression buffers of the previous chunk.
+    struct DecoderSlot {
+        exr_decode_pipeline_t decoder = EXR_DECODE_PIPELINE_INITIALIZER;
+        int part                      = -1;  ///< -1 if not initialized
+        std::vector<uint8_t> scratch;        ///< Partial-chunk buffer
+
+        // Prepare to decode the chunk `cinfo` of `part`, and clear all
+        // channel destinations.
+        exr_result_t start(exr_const_context_t ctx, int part,
+                           const exr_chunk_info_t& cinfo);
+        void reset(exr_const_context_t ctx);
+    };
+
+    // Idle decoders, kept across read calls. Each worker thread checks one
+    // out for the duration of its task, so in steady state there is about
+    // one per thread that has ever read from this file.
+    spin_mutex m_decoders_mutex;
+    std::vector<std::unique_ptr<DecoderSlot>> m_decoders;
+
+    // Helper to check a DecoderSlot out of the pool for the duration of a
+    // scope, returning it upon exit (or destroying it if it failed).
+    class DecoderLease {
+    public:
+        DecoderLease(OpenEXRCoreInput* in);
+        ~DecoderLease();
+        DecoderSlot* operator->() const { return m_slot.get(); }
+        exr_decode_pipeline_t& decoder() const { return m_slot->decoder; }
+        void failed() { m_slot->reset(m_in->m_exr_context); }
+
+    private:
+        OpenEXRCoreInput* m_in;
+        std::unique_ptr<DecoderSlot> m_slot;
+    };
+    friend class DecoderLease;
+
+    void clear_decoders();
 };
 
 
@@ -785,6 +850,56 @@ TypeDesc_from_ImfPixelType(exr_pixel_type_t ptype)
 
 
 
+// The exr_pixel_type_t that OpenEXRCore can unpack directly into for a
+// requested data type, or EXR_PIXEL_LAST_TYPE if it can't.
+static exr_pixel_type_t
+exr_pixeltype(TypeDesc format)
+{
+    if (format == TypeDesc::UINT)
+        return EXR_PIXEL_UINT;
+    if (format == TypeDesc::HALF)
+        return EXR_PIXEL_HALF;
+    if (format == TypeDesc::FLOAT)
+        return EXR_PIXEL_FLOAT;
+    return EXR_PIXEL_LAST_TYPE;
+}
+
+
+
+// Will the OpenEXRCore unpacker give the same values as OIIO's own
+// conversion, for channels [chbegin,chend) of `spec` read as `format`? It
+// casts between uint and half/float numerically, where OIIO normalizes, so
+// only half <-> float conversions (or none at all) qualify.
+static bool
+core_converts_like_oiio(const ImageSpec& spec, int chbegin, int chend,
+                        TypeDesc format)
+{
+    if (exr_pixeltype(format) == EXR_PIXEL_LAST_TYPE)
+        return false;
+    bool format_is_float = (format == TypeDesc::HALF
+                            || format == TypeDesc::FLOAT);
+    for (int c = chbegin; c < chend; ++c) {
+        TypeDesc cf = spec.channelformat(c);
+        if (cf != format
+            && !(format_is_float
+                 && (cf == TypeDesc::HALF || cf == TypeDesc::FLOAT)))
+            return false;
+    }
+    return true;
+}
+
+
+
+// Ask the decoder to convert this channel to `format` as it unpacks.
+static void
+set_user_type(exr_coding_channel_info_t& chan, TypeDesc format)
+{
+    chan.user_data_type        = exr_pixeltype(format);
+    chan.user_bytes_per_element = int8_t(format.size());
+}
+
+
+
 // Used to hold channel information for sorting into canonical order
 struct CChanNameHolder {
     string_view fullname;    // layer.suffix
@@ -1109,9 +1224,84 @@ OpenEXRCoreInput::spec_dimensions(int subimage, int miplevel)
 
 
 
+exr_result_t
+OpenEXRCoreInput::DecoderSlot::start(exr_const_context_t ctx, int part,
+                                     const exr_chunk_info_t& cinfo)
+{
+    exr_result_t rv;
+    if (this->part == part) {
+        rv = exr_decoding_update(ctx, part, &cinfo, &decoder);
+    } else {
+        reset(ctx);
+        rv = exr_decoding_initialize(ctx, part, &cinfo, &decoder);
+    }
+    if (rv != EXR_ERR_SUCCESS) {
+        reset(ctx);
+        return rv;
+    }
+    this->part = part;
+    // The previous user may have pointed a different subset of channels
+    // at its own buffer, or asked for a different output type.
+    for (int dc = 0; dc < decoder.channel_count; ++dc) {
+        exr_coding_channel_info_t& chan = decoder.channels[dc];
+        chan.decode_to_ptr              = nullptr;
+        chan.user_data_type             = chan.data_type;
+        chan.user_bytes_per_element     = chan.bytes_per_element;
+    }
+    return rv;
+}
+
+
+
+void
+OpenEXRCoreInput::DecoderSlot::reset(exr_const_context_t ctx)
+{
+    exr_decoding_destroy(ctx, &decoder);
+    decoder = EXR_DECODE_PIPELINE_INITIALIZER;
+    part    = -1;
+}
+
+
+
+OpenEXRCoreInput::DecoderLease::DecoderLease(OpenEXRCoreInput* in)
+    : m_in(in)
+{
+    {
+        spin_lock lock(in->m_decoders_mutex);
+        if (in->m_decoders.size()) {
+            m_slot = std::move(in->m_decoders.back());
+            in->m_decoders.pop_back();
+        }
+    }
+    if (!m_slot)
+        m_slot.reset(new DecoderSlot);
+}
+
+
+
+OpenEXRCoreInput::DecoderLease::~DecoderLease()
+{
+    spin_lock lock(m_in->m_decoders_mutex);
+    m_in->m_decoders.push_back(std::move(m_slot));
+}
+
+
+
+void
+OpenEXRCoreInput::clear_decoders()
+{
+    spin_lock lock(m_decoders_mutex);
+    for (auto& d : m_decoders)
+        d->reset(m_exr_context);
+    m_decoders.clear();
+}
+
+
+
 bool
 OpenEXRCoreInput::close()
 {
+    clear_decoders();
     exr_finish(&m_exr_context);
     init();  // Reset to initial state
     return true;
@@ -1166,14 +1356,64 @@ OpenEXRCoreInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
         return false;
     }
 
+    const ImageSpec& spec = init_part(subimage, miplevel);
+    chend                 = clamp(chend, chbegin + 1, spec.nchannels);
+    stride_t pixelbytes   = spec.pixel_bytes(chbegin, chend, true);
+    return decode_scanlines(subimage, miplevel, ybegin, yend, chbegin, chend,
+                            TypeUnknown, data, pixelbytes,
+                            pixelbytes * spec.width);
+}
+
+
+
+bool
+OpenEXRCoreInput::read_scanlines(int subimage, int miplevel, int ybegin,
+                                 int yend, int z, int chbegin, int chend,
+                                 TypeDesc format, void* data, stride_t xstride,
+                                 stride_t ystride)
+{
+    // Conversions that the OpenEXRCore unpacker does just as OIIO would are
+    // decoded straight into the caller's buffer. Anything else (including the
+    // missing-tile fill, which writes native values) goes through the
+    // generic read-native-then-convert path.
+    ImageSpec spec;
+    if (m_exr_context && m_missingcolor.empty()
+        && exr_pixeltype(format) != EXR_PIXEL_LAST_TYPE)
+        spec = spec_dimensions(subimage, miplevel);  // thread-safe
+    if (spec.undefined() || spec.tile_width
+        || !core_converts_like_oiio(spec, chbegin,
+                                    std::min(chend, spec.nchannels), format))
+        return ImageInput::read_scanlines(subimage, miplevel, ybegin, yend, z,
+                                          chbegin, chend, format, data,
+                                          xstride, ystride);
+
+    chend            = clamp(chend, chbegin + 1, spec.nchannels);
+    stride_t zstride = AutoStride;
+    spec.auto_stride(xstride, ystride, zstride, format, chend - chbegin,
+                     spec.width, spec.height);
+    return decode_scanlines(subimage, miplevel, ybegin, yend, chbegin, chend,
+                            format, data, xstride, ystride);
+}
+
+
+
+bool
+OpenEXRCoreInput::decode_scanlines(int subimage, int miplevel, int ybegin,
+                                   int yend, int chbegin, int chend,
+                                   TypeDesc format, void* data,
+                                   stride_t xstride, stride_t ystride)
+{
     // NB: to prevent locking, we use the SUBIMAGE spec, so the mip
     // information is not valid!!!! instead, we will use the library
     // which has an internal thread-safe cache of the sizes if needed
     const ImageSpec& spec = init_part(subimage, miplevel);
 
-    chend = clamp(chend, chbegin + 1, spec.nchannels);
-
-    size_t pixelbytes    = spec.pixel_bytes(chbegin, chend, true);
+    // Partial chunks are decoded contiguously into scratch space, using
+    // the same per-pixel layout as the caller's buffer.
+    bool native          = (format == TypeUnknown);
+    int nchans           = chend - chbegin;
+    size_t pixelbytes    = native ? spec.pixel_bytes(chbegin, chend, true)
+                                  : format.size() * nchans;
     size_t scanlinebytes = (size_t)spec.width * pixelbytes;
 
     int32_t scansperchunk;
@@ -1196,52 +1436,57 @@ OpenEXRCoreInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
         [&](int64_t yb, int64_t ye) {
             int y             = std::max(int(yb), ybegin);
             uint8_t* linedata = static_cast<uint8_t*>(data)
-                                + scanlinebytes * (y - ybegin);
-            std::unique_ptr<uint8_t[]> fullchunk;
-            int nlines = scansperchunk;
+                                + ystride * (y - ybegin);
+            int nlines        = scansperchunk;
+            stride_t cxstride = xstride, cystride = ystride;
             exr_chunk_info_t cinfo;
-            exr_decode_pipeline_t decoder = EXR_DECODE_PIPELINE_INITIALIZER;
-            DecoderDestroyer dd(m_exr_context, &decoder);
-            // Note: the decoder will be destroyed by dd exiting scope
-            uint8_t* cdata = linedata;
+            DecoderLease lease(this);
+            exr_decode_pipeline_t& decoder = lease.decoder();
+            uint8_t* cdata                 = linedata;
             // handle scenario where caller asked us to read a scanline
             // that isn't aligned to a chunk boundary
             int invalid = (y - spec.y) % scansperchunk;
             if (invalid != 0) {
                 // Our first scanline, ybegin, is not on a chunk boundary.
                 // We'll need to "back up" and read a whole chunk.
-                fullchunk.reset(new uint8_t[scanlinebytes * scansperchunk]);
-                nlines = scansperchunk - invalid;
-                cdata  = fullchunk.get();
-                y      = y - invalid;
+                lease->scratch.resize(scanlinebytes * scansperchunk);
+                nlines   = scansperchunk - invalid;
+                cdata    = lease->scratch.data();
+                cxstride = pixelbytes;
+                cystride = scanlinebytes;
+                y        = y - invalid;
             } else if ((y + scansperchunk) > yend && yend < endy) {
                 // ybegin is at a chunk boundary, but yend is not (and isn't
                 // the special case of it encompassing the end of the image,
                 // which is not at a chunk boundary). We'll need to read a
                 // full chunk and use only part of it.
-                fullchunk.reset(new uint8_t[scanlinebytes * scansperchunk]);
-                nlines = yend - y;
-                cdata  = fullchunk.get();
+                lease->scratch.resize(scanlinebytes * scansperchunk);
+                nlines   = yend - y;
+                cdata    = lease->scratch.data();
+                cxstride = pixelbytes;
+                cystride = scanlinebytes;
             } else {
                 // We need a full aligned chunk. Everything is already set up.
             }
             exr_result_t rv = exr_read_scanline_chunk_info(m_exr_context,
                                                            subimage, y, &cinfo);
             if (rv == EXR_ERR_SUCCESS)
-                rv = exr_decoding_initialize(m_exr_context, subimage, &cinfo,
-                                             &decoder);
+                rv = lease->start(m_exr_context, subimage, cinfo);
             if (rv == EXR_ERR_SUCCESS) {
                 size_t chanoffset = 0;
                 for (int c = chbegin; c < chend; ++c) {
-                    size_t chanbytes  = spec.channelformat(c).size();
+                    size_t chanbytes  = native ? spec.channelformat(c).size()
+                                               : format.size();
                     string_view cname = spec.channel_name(c);
                     for (int dc = 0; dc < decoder.channel_count; ++dc) {
                         exr_coding_channel_info_t& curchan
                             = decoder.channels[dc];
                         if (cname == curchan.channel_name) {
                             curchan.decode_to_ptr     = cdata + chanoffset;
-                            curchan.user_pixel_stride = pixelbytes;
-                            curchan.user_line_stride  = scanlinebytes;
+                            curchan.user_pixel_stride = cxstride;
+                            curchan.user_line_stride  = cystride;
+                            if (!native)
+                                set_user_type(curchan, format);
                             chanoffset += chanbytes;
                             break;
                         }
@@ -1253,12 +1498,15 @@ OpenEXRCoreInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
             if (rv == EXR_ERR_SUCCESS)
                 rv = exr_decoding_run(m_exr_context, subimage, &decoder);
             if (rv != EXR_ERR_SUCCESS) {
+                lease.failed();
                 ok = false;
             } else if (cdata != linedata) {
                 y += invalid;
                 nlines = std::min(nlines, yend - y);
-                memcpy(linedata, cdata + invalid * scanlinebytes,
-                       nlines * scanlinebytes);
+                copy_image(nchans, spec.width, nlines, 1,
+                           cdata + invalid * scanlinebytes, pixelbytes,
+                           pixelbytes, scanlinebytes, AutoStride, linedata,
+                           xstride, ystride, AutoStride);
             }
         },
         threads());
@@ -1338,14 +1586,13 @@ OpenEXRCoreInput::read_native_tile(int subimage, int miplevel, int x, int y,
                                   scanlinebytes);
 
     exr_chunk_info_t cinfo;
-    exr_decode_pipeline_t decoder = EXR_DECODE_PIPELINE_INITIALIZER;
-    DecoderDestroyer dd(m_exr_context, &decoder);
-    // Note: the decoder will be destroyed by dd exiting scope
+    DecoderLease lease(this);
+    exr_decode_pipeline_t& decoder = lease.decoder();
 
     rv = exr_read_tile_chunk_info(m_exr_context, subimage, tx, ty, miplevel,
                                   miplevel, &cinfo);
     if (rv == EXR_ERR_SUCCESS)
-        rv = exr_decoding_initialize(m_exr_context, subimage, &cinfo, &decoder);
+        rv = lease->start(m_exr_context, subimage, cinfo);
     if (rv != EXR_ERR_SUCCESS) {
         return check_fill_missing(x, std::min(levw, x + tilew), y,
                                   std::min(levh, y + tileh), z, z + spec.depth,
@@ -1383,6 +1630,7 @@ OpenEXRCoreInput::read_native_tile(int subimage, int miplevel, int x, int y,
     if (rv == EXR_ERR_SUCCESS)
         rv = exr_decoding_run(m_exr_context, subimage, &decoder);
     if (rv != EXR_ERR_SUCCESS) {
+        lease.failed();
         return check_fill_missing(x, std::min(levw, x + tilew), y,
                                   std::min(levh, y + tileh), z, z + spec.depth,
                                   0, spec.nchannels, data, pixelbytes,
@@ -1422,6 +1670,53 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
         return false;
     }
 
+    const ImageSpec& spec = init_part(subimage, miplevel);
+    chend                 = clamp(chend, chbegin + 1, spec.nchannels);
+    return decode_tiles(subimage, miplevel, xbegin, xend, ybegin, yend, zbegin,
+                        zend, chbegin, chend, TypeUnknown, data,
+                        spec.pixel_bytes(chbegin, chend, true), AutoStride);
+}
+
+
+
+bool
+OpenEXRCoreInput::read_tiles(int subimage, int miplevel, int xbegin, int xend,
+                             int ybegin, int yend, int zbegin, int zend,
+                             int chbegin, int chend, TypeDesc format,
+                             void* data, stride_t xstride, stride_t ystride,
+                             stride_t zstride)
+{
+    // Like read_scanlines, decode straight to the requested type when the
+    // OpenEXRCore unpacker can, and the range is made of whole tiles (or
+    // ends at the image edge).
+    ImageSpec spec;
+    if (m_exr_context && m_missingcolor.empty()
+        && exr_pixeltype(format) != EXR_PIXEL_LAST_TYPE)
+        spec = spec_dimensions(subimage, miplevel);  // thread-safe
+    if (spec.undefined() || spec.depth > 1
+        || !spec.valid_tile_range(xbegin, xend, ybegin, yend, zbegin, zend)
+        || !core_converts_like_oiio(spec, chbegin,
+                                    std::min(chend, spec.nchannels), format))
+        return ImageInput::read_tiles(subimage, miplevel, xbegin, xend, ybegin,
+                                      yend, zbegin, zend, chbegin, chend,
+                                      format, data, xstride, ystride, zstride);
+
+    chend = clamp(chend, chbegin + 1, spec.nchannels);
+    spec.auto_stride(xstride, ystride, zstride, format, chend - chbegin,
+                     xend - xbegin, yend - ybegin);
+    return decode_tiles(subimage, miplevel, xbegin, xend, ybegin, yend, zbegin,
+                        zend, chbegin, chend, format, data, xstride, ystride);
+}
+
+
+
+bool
+OpenEXRCoreInput::decode_tiles(int subimage, int miplevel, int xbegin,
+                               int xend, int ybegin, int yend, int zbegin,
+                               int zend, int chbegin, int chend,
+                               TypeDesc format, void* data, stride_t xstride,
+                               stride_t ystride)
+{
     // NB: to prevent locking, we use the SUBIMAGE spec, so the mip
     // information not valid!!!! instead, we will use the library
     // which has an internal thread-safe cache of the sizes
@@ -1430,21 +1725,22 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
     int32_t tilew = spec.tile_width;
     int32_t tileh = spec.tile_height;
 
-    chend          = clamp(chend, chbegin + 1, spec.nchannels);
+    bool native    = (format == TypeUnknown);
     int firstxtile = (xbegin - spec.x) / tilew;
     int firstytile = (ybegin - spec.y) / tileh;
 
-    size_t pixelbytes = spec.pixel_bytes(chbegin, chend, true);
+    // For native reads, the caller's buffer holds whole tiles.
+    size_t pixelbytes = xstride;
+    if (ystride == AutoStride)
+        ystride = stride_t(tilew) * xstride
+                  * ((xend - xbegin + tilew - 1) / tilew);
 
     int32_t levw, levh;
     exr_result_t rv = exr_get_level_sizes(m_exr_context, subimage, miplevel,
                                           miplevel, &levw, &levh);
     if (rv != EXR_ERR_SUCCESS)
         return check_fill_missing(xbegin, xend, ybegin, yend, zbegin, zend,
-                                  chbegin, chend, data, pixelbytes,
-                                  size_t(tilew) * pixelbytes
-                                      * size_t((xend - xbegin + tilew - 1)
-                                               / tilew));
+                                  chbegin, chend, data, pixelbytes, ystride);
 
     xend        = std::min(xend, spec.x + levw);
     yend        = std::min(yend, spec.y + levh);
@@ -1452,7 +1748,7 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
     int nxtiles = (xend - xbegin + tilew - 1) / tilew;
     int nytiles = (yend - ybegin + tileh - 1) / tileh;
 
-    size_t scanlinebytes = size_t(nxtiles) * size_t(tilew) * pixelbytes;
+    size_t scanlinebytes = ystride;
 
     DBGEXR(
         "exr rnt {}:{}:{} ({}-{}|{}x{})[{}-{}] -> t {}, {} n {}, {} pb {} sb {} tsz {}x{}\n",
@@ -1468,22 +1764,21 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
             int curxtile         = firstxtile + tx;
             uint8_t* tilesetdata = static_cast<uint8_t*>(data);
             tilesetdata += ty * tileh * scanlinebytes;
-            exr_chunk_info_t cinfo;
-            exr_decode_pipeline_t decoder = EXR_DECODE_PIPELINE_INITIALIZER;
-            DecoderDestroyer dd(m_exr_context, &decoder);
-            // Note: the decoder will be destroyed by dd exiting scope
             uint8_t* curtilestart = tilesetdata + tx * tilew * pixelbytes;
+            exr_chunk_info_t cinfo;
+            DecoderLease lease(this);
+            exr_decode_pipeline_t& decoder = lease.decoder();
             exr_result_t rv = exr_read_tile_chunk_info(m_exr_context, subimage,
                                                        curxtile, curytile,
                                                        miplevel, miplevel,
                                                        &cinfo);
             if (rv == EXR_ERR_SUCCESS)
-                rv = exr_decoding_initialize(m_exr_context, subimage, &cinfo,
-                                             &decoder);
+                rv = lease->start(m_exr_context, subimage, cinfo);
             if (rv == EXR_ERR_SUCCESS) {
                 size_t chanoffset = 0;
                 for (int c = chbegin; c < chend; ++c) {
-                    size_t chanbytes  = spec.channelformat(c).size();
+                    size_t chanbytes  = native ? spec.channelformat(c).size()
+                                               : format.size();
                     string_view cname = spec.channel_name(c);
                     for (int dc = 0; dc < decoder.channel_count; ++dc) {
                         exr_coding_channel_info_t& curchan
@@ -1492,6 +1787,8 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
                             curchan.decode_to_ptr = curtilestart + chanoffset;
                             curchan.user_pixel_stride = pixelbytes;
                             curchan.user_line_stride  = scanlinebytes;
+                            if (!native)
+                                set_user_type(curchan, format);
                             chanoffset += chanbytes;
                             break;
                         }
@@ -1502,6 +1799,8 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
             }
             if (rv == EXR_ERR_SUCCESS)
                 rv = exr_decoding_run(m_exr_context, subimage, &decoder);
+            if (rv != EXR_ERR_SUCCESS)
+                lease.failed();
             if (rv != EXR_ERR_SUCCESS
                 && !check_fill_missing(xbegin + tx * tilew,
                                        xbegin + (tx + 1) * tilew,
@@ -1516,7 +1815,7 @@ OpenEXRCoreInput::read_native_tiles(int subimage, int miplevel, int xbegin,
 
     if (!ok) {
         // FIXME: Please see the long comment at the end of
-        // read_native_scanlines.
+        // decode_scanlines.
         geterror(true);  // clear the error, issue our own
         errorfmt("Some tiles were missing or corrupted");
         return false;
@@ -1954,7 +2253,7 @@ OpenEXRCoreInput::read_native_deep_tiles(int subimage, int miplevel, int xbegin,
 
     if (!ok) {
         // FIXME: Please see the long comment at the end of
-        // read_native_scanlines.
+        // decode_scanlines.
         geterror(true);  // clear the error, issue our own
         errorfmt("Some tiles were missing or corrupted");
         return false;
@@ -69,6 +69,8 @@ OIIO_PRAGMA_VISIBILITY_POP
 #include <OpenImageIO/sysutil.h>
 #include <OpenImageIO/thread.h>
 
+#include "imageio_pvt.h"
+
 OIIO_PLUGIN_NAMESPACE_BEGIN
 
 
@@ -160,6 +162,9 @@ private:
     std::vector<Imf::Header> m_headers;
     Filesystem::IOProxy* m_io = nullptr;
     std::unique_ptr<Filesystem::IOProxy> m_local_io;
+#ifdef OIIO_USE_EXR_C_API
+    std::unique_ptr<OpenEXRCoreWriter> m_core_writer;
+#endif
 
     // Initialize private members to pre-opened state
     void init(void)
@@ -179,6 +184,9 @@ private:
         m_subimagespecs.shrink_to_fit();
         m_headers.clear();
         m_headers.shrink_to_fit();
+#ifdef OIIO_USE_EXR_C_API
+        m_core_writer.reset();
+#endif
         m_io = nullptr;
         m_local_io.reset();
     }
@@ -401,6 +409,18 @@ OpenEXROutput::open(const std::string& name, const ImageSpec& userspec,
                          e.size() ? e : std::string("unknown error"));
                 return false;
             }
+#ifdef OIIO_USE_EXR_C_API
+            // Single-level flat files may use the OpenEXR core library,
+            // which lets us compress chunks in parallel on our own threads.
+            if (pvt::openexr_core_output && m_levelmode == Imf::ONE_LEVEL
+                && m_headers[m_subimage].lineOrder() != Imf::DECREASING_Y) {
+                m_core_writer = OpenEXRCoreWriter::create(this, name, m_io,
+                                                          m_spec,
+                                                          m_headers[m_subimage],
+                                                          threads());
+                return m_core_writer != nullptr;
+            }
+#endif
             m_output_stream.reset(new OpenEXROutputStream(name.c_str(), m_io));
             if (m_spec.tile_width) {
                 m_output_tiled.reset(
@@ -1328,6 +1348,11 @@ OpenEXROutput::close()
         return true;
     }
 
+    bool ok = true;
+#ifdef OIIO_USE_EXR_C_API
+    if (m_core_writer)
+        ok = m_core_writer->close();
+#endif
     m_output_scanline.reset();
     m_output_tiled.reset();
     m_scanline_output_part.reset();
@@ -1335,8 +1360,8 @@ OpenEXROutput::close()
     m_output_multipart.reset();
     m_output_stream.reset();
 
-    init();       // re-initialize
-    return true;  // How can we fail?
+    init();  // re-initialize
+    return ok;
 }
 
 
@@ -1463,6 +1488,20 @@ OpenEXROutput::write_scanlines(int ybegin, int yend, int z, TypeDesc format,
                                const void* data, stride_t xstride,
                                stride_t ystride)
 {
+#ifdef OIIO_USE_EXR_C_API
+    if (m_core_writer && !m_spec.tile_width) {
+        yend = std::min(yend, spec().y + spec().height);
+        if (format == TypeUnknown && xstride == AutoStride)
+            xstride = (stride_t)m_spec.pixel_bytes(true);
+        stride_t zstride = AutoStride;
+        m_spec.auto_stride(xstride, ystride, zstride, format, m_spec.nchannels,
+                           m_spec.width, m_spec.height);
+        data = to_native_rectangle(m_spec.x, m_spec.x + m_spec.width, ybegin,
+                                   yend, z, z + 1, format, data, xstride,
+                                   ystride, zstride, m_scratch);
+        return m_core_writer->write_scanlines(ybegin, yend, data);
+    }
+#endif
     if (!(m_output_scanline || m_scanline_output_part)) {
         errorfmt("called OpenEXROutput::write_scanlines without an open file");
         return false;
@@ -1577,7 +1616,11 @@ OpenEXROutput::write_tiles(int xbegin, int xend, int ybegin, int yend,
 {
     //    std::cerr << "exr::write_tiles " << xbegin << ' ' << xend
     //              << ' ' << ybegin << ' ' << yend << "\n";
-    if (!(m_output_tiled || m_tiled_output_part)) {
+    bool core_tiled = false;
+#ifdef OIIO_USE_EXR_C_API
+    core_tiled = (m_core_writer && m_spec.tile_width);
+#endif
+    if (!(m_output_tiled || m_tiled_output_part || core_tiled)) {
         errorfmt("called OpenEXROutput::write_tiles without an open file");
         return false;
     }
@@ -1601,6 +1644,11 @@ OpenEXROutput::write_tiles(int xbegin, int xend, int ybegin, int yend,
                        (xend - xbegin), (yend - ybegin));
     data = to_native_rectangle(xbegin, xend, ybegin, yend, zbegin, zend, format,
                                data, xstride, ystride, zstride, m_scratch);
+#ifdef OIIO_USE_EXR_C_API
+    if (core_tiled)
+        return m_core_writer->write_tiles(xbegin, xend, ybegin, yend, data,
+                                          (xend - xbegin) * pixelbytes);
+#endif
 
     // clamp to the image edge
     xend           = std::min(xend, m_spec.x + m_spec.width);
@@ -0,0 +1,720 @@
+// Copyright Contributors to the OpenImageIO project.
+// SPDX-License-Identifier: Apache-2.0
+// https://github.com/AcademySoftwareFoundation/OpenImageIO
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <OpenImageIO/Imath.h>
+#include <OpenImageIO/platform.h>
+
+#include "exr_pvt.h"
+
+#include <OpenEXR/openexr.h>
+
+// The way that OpenEXR uses dynamic casting for attributes requires
+// temporarily suspending "hidden" symbol visibility mode.
+OIIO_PRAGMA_VISIBILITY_PUSH
+OIIO_PRAGMA_WARNING_PUSH
+OIIO_GCC_PRAGMA(GCC diagnostic ignored "-Wunused-parameter")
+#include <OpenEXR/ImfBoxAttribute.h>
+#include <OpenEXR/ImfChromaticitiesAttribute.h>
+#include <OpenEXR/ImfDoubleAttribute.h>
+#include <OpenEXR/ImfEnvmapAttribute.h>
+#include <OpenEXR/ImfFloatAttribute.h>
+#include <OpenEXR/ImfFloatVectorAttribute.h>
+#include <OpenEXR/ImfHeader.h>
+#include <OpenEXR/ImfIntAttribute.h>
+#include <OpenEXR/ImfKeyCodeAttribute.h>
+#include <OpenEXR/ImfMatrixAttribute.h>
+#include <OpenEXR/ImfRationalAttribute.h>
+#include <OpenEXR/ImfStringAttribute.h>
+#include <OpenEXR/ImfStringVectorAttribute.h>
+#include <OpenEXR/ImfTileDescriptionAttribute.h>
+#include <OpenEXR/ImfTimeCodeAttribute.h>
+#include <OpenEXR/ImfVecAttribute.h>
+OIIO_PRAGMA_WARNING_POP
+OIIO_PRAGMA_VISIBILITY_POP
+
+#include <OpenImageIO/dassert.h>
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/fmath.h>
+#include <OpenImageIO/imageio.h>
+#include <OpenImageIO/parallel.h>
+#include <OpenImageIO/strutil.h>
+#include <OpenImageIO/thread.h>
+
+OIIO_PLUGIN_NAMESPACE_BEGIN
+
+
+namespace {
+
+class OpenEXRCoreWriterImpl final : public OpenEXRCoreWriter {
+public:
+    OpenEXRCoreWriterImpl(ImageOutput* out, Filesystem::IOProxy* io,
+                          const ImageSpec& spec, int nthreads);
+    ~OpenEXRCoreWriterImpl() override { close(); }
+    bool open(const std::string& filename, const Imf::Header& header);
+    bool write_scanlines(int ybegin, int yend, const void* data) override;
+    bool write_tiles(int xbegin, int xend, int ybegin, int yend,
+                     const void* data, stride_t ystride) override;
+    bool close() override;
+
+private:
+    // One chunk to encode: a block of scanlines starting at y, or the
+    // tile (tx,ty), whose first pixel is at `data`.
+    struct ChunkJob {
+        int64_t index;  ///< Chunk index within the part
+        int y;          ///< First scanline (scanline files)
+        int tx, ty;     ///< Tile indices (tiled files)
+        const uint8_t* data;
+        stride_t ystride;
+    };
+
+    // An encode pipeline that, once initialized, is reused for later
+    // chunks via exr_encoding_update. It is checked out of the pool while
+    // a chunk is being compressed, and stays checked out (parked in
+    // m_ready) until its compressed chunk has been written.
+    struct EncoderSlot {
+        exr_encode_pipeline_t encoder = EXR_ENCODE_PIPELINE_INITIALIZER;
+        bool initialized              = false;
+        // The library's write routine, which we call ourselves in order.
+        exr_result_t (*write_fn)(exr_encode_pipeline_t*) = nullptr;
+
+        exr_result_t start(exr_const_context_t ctx,
+                           const exr_chunk_info_t& cinfo);
+        void reset(exr_const_context_t ctx);
+    };
+
+    ImageOutput* m_out;
+    Filesystem::IOProxy* m_io;
+    ImageSpec m_spec;  ///< Dimensions and channels only
+    int m_nthreads;
+    exr_context_t m_ctx = nullptr;
+    bool m_tiled;
+    int m_scansperchunk = 1;
+    int m_nxtiles       = 0;
+    stride_t m_pixelbytes;
+    stride_t m_scanlinebytes;
+    std::vector<size_t> m_chanoffset;  ///< Byte offset of each channel
+
+    // Scanlines of a chunk that has only been partially supplied so far.
+    std::vector<uint8_t> m_linebuf;
+    int m_linebuf_y    = 0;  ///< First scanline of the buffered chunk
+    int m_linebuf_rows = 0;  ///< How many of its scanlines we have
+
+    spin_mutex m_encoders_mutex;
+    std::vector<std::unique_ptr<EncoderSlot>> m_encoders;
+
+    // Reorder queue: compressed chunks wait here until every chunk before
+    // them has been written. Whichever thread finds the next chunk ready
+    // becomes the (only) writer until it runs out of consecutive chunks.
+    std::mutex m_ready_mutex;
+    std::map<int64_t, std::unique_ptr<EncoderSlot>> m_ready;
+    int64_t m_next_chunk = 0;
+    bool m_writing       = false;
+    std::atomic<bool> m_failed { false };
+
+    std::unique_ptr<EncoderSlot> acquire_encoder();
+    void release_encoder(std::unique_ptr<EncoderSlot>&& slot);
+    void encode_chunk(const ChunkJob& job);
+    void enqueue(int64_t index, std::unique_ptr<EncoderSlot>&& slot);
+    exr_result_t write_chunk(std::unique_ptr<EncoderSlot>&& slot);
+    bool encode_chunks(cspan<ChunkJob> jobs);
+    bool set_attributes(const Imf::Header& header);
+};
+
+
+
+// Called by exr_encoding_run in place of the library's write routine. The
+// chunk is left compressed in the pipeline, to be written in order later.
+exr_result_t
+defer_write_chunk(exr_encode_pipeline_t* /*encode*/)
+{
+    return EXR_ERR_SUCCESS;
+}
+
+
+
+int64_t
+oiio_exr_write_func(exr_const_context_t ctxt, void* userdata,
+                    const void* buffer, uint64_t sz, uint64_t offset,
+                    exr_stream_error_func_ptr_t error_cb)
+{
+    auto io = static_cast<Filesystem::IOProxy*>(userdata);
+    if (!io)
+        return -1;
+    size_t nwritten = io->pwrite(buffer, sz, int64_t(offset));
+    if (nwritten != sz) {
+        std::string err = io->error();
+        error_cb(ctxt, EXR_ERR_WRITE_IO, "Could not write to file: \"%s\" (%s)",
+                 io->filename().c_str(),
+                 err.empty() ? "<unknown error>" : err.c_str());
+        return -1;
+    }
+    return int64_t(nwritten);
+}
+
+
+
+// Errors can be raised on any worker thread, where an ImageOutput error
+// would not be seen by the caller, so we only pass them on for debugging
+// and issue our own summary from the calling thread.
+void
+oiio_exr_write_error_handler(exr_const_context_t /*ctxt*/, exr_result_t code,
+                             const char* msg)
+{
+    OIIO::debugfmt("EXR write error ({}): {}\n",
+                   exr_get_error_code_as_string(code),
+                   msg ? msg : exr_get_default_error_message(code));
+}
+
+}  // namespace
+
+
+
+exr_result_t
+OpenEXRCoreWriterImpl::EncoderSlot::start(exr_const_context_t ctx,
+                                          const exr_chunk_info_t& cinfo)
+{
+    exr_result_t rv;
+    if (initialized) {
+        rv = exr_encoding_update(ctx, 0, &cinfo, &encoder);
+    } else {
+        rv          = exr_encoding_initialize(ctx, 0, &cinfo, &encoder);
+        initialized = (rv == EXR_ERR_SUCCESS);
+    }
+    if (rv != EXR_ERR_SUCCESS)
+        reset(ctx);
+    return rv;
+}
+
+
+
+void
+OpenEXRCoreWriterImpl::EncoderSlot::reset(exr_const_context_t ctx)
+{
+    exr_encoding_destroy(ctx, &encoder);
+    encoder     = EXR_ENCODE_PIPELINE_INITIALIZER;
+    initialized = false;
+    write_fn    = nullptr;
+}
+
+
+
+OpenEXRCoreWriterImpl::OpenEXRCoreWriterImpl(ImageOutput* out,
+                                             Filesystem::IOProxy* io,
+                                             const ImageSpec& spec,
+                                             int nthreads)
+    : m_out(out)
+    , m_io(io)
+    , m_nthreads(nthreads)
+{
+    m_spec.copy_dimensions(spec);
+    m_tiled         = (spec.tile_width > 0);
+    m_pixelbytes    = m_spec.pixel_bytes(true);
+    m_scanlinebytes = m_pixelbytes * m_spec.width;
+    m_chanoffset.resize(m_spec.nchannels);
+    for (int c = 0; c < m_spec.nchannels; ++c)
+        m_chanoffset[c] = m_spec.pixel_bytes(0, c, true);
+}
+
+
+
+std::unique_ptr<OpenEXRCoreWriter>
+OpenEXRCoreWriter::create(ImageOutput* out, const std::string& filename,
+                          Filesystem::IOProxy* io, const ImageSpec& spec,
+                          const Imf::Header& header, int nthreads)
+{
+    std::unique_ptr<OpenEXRCoreWriterImpl> w(
+        new OpenEXRCoreWriterImpl(out, io, spec, nthreads));
+    if (!w->open(filename, header))
+        return nullptr;
+    return w;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::open(const std::string& filename,
+                            const Imf::Header& header)
+{
+    exr_context_initializer_t cinit = EXR_DEFAULT_CONTEXT_INITIALIZER;
+    cinit.user_data                 = m_io;
+    cinit.write_fn                  = oiio_exr_write_func;
+    cinit.error_handler_fn          = oiio_exr_write_error_handler;
+    exr_result_t rv = exr_start_write(&m_ctx, filename.c_str(),
+                                      EXR_WRITE_FILE_DIRECTLY, &cinit);
+    if (rv != EXR_ERR_SUCCESS) {
+        m_out->errorfmt("Could not open \"{}\" ({})", filename,
+                        exr_get_default_error_message(rv));
+        m_ctx = nullptr;
+        return false;
+    }
+
+    int part = 0;
+    rv       = exr_add_part(m_ctx, header.hasName() ? header.name().c_str()
+                                                    : nullptr,
+                            m_tiled ? EXR_STORAGE_TILED : EXR_STORAGE_SCANLINE,
+                            &part);
+    if (rv == EXR_ERR_SUCCESS && !set_attributes(header))
+        rv = EXR_ERR_INVALID_ATTR;
+    if (rv == EXR_ERR_SUCCESS)
+        rv = exr_write_header(m_ctx);
+    if (rv != EXR_ERR_SUCCESS) {
+        m_out->errorfmt("Could not write OpenEXR header for \"{}\" ({})",
+                        filename, exr_get_default_error_message(rv));
+        exr_finish(&m_ctx);
+        return false;
+    }
+
+    if (m_tiled) {
+        m_nxtiles = (m_spec.width + m_spec.tile_width - 1) / m_spec.tile_width;
+    } else {
+        int32_t spc = 1;
+        exr_get_scanlines_per_chunk(m_ctx, 0, &spc);
+        m_scansperchunk = std::max(1, int(spc));
+        m_linebuf.resize(m_scanlinebytes * m_scansperchunk);
+    }
+    return true;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::set_attributes(const Imf::Header& header)
+{
+    // Required attributes, channels, and tiling
+    const Imath::Box2i& dispw(header.displayWindow());
+    const Imath::Box2i& dataw(header.dataWindow());
+    exr_attr_box2i_t displayWindow = { { dispw.min.x, dispw.min.y },
+                                       { dispw.max.x, dispw.max.y } };
+    exr_attr_box2i_t dataWindow    = { { dataw.min.x, dataw.min.y },
+                                       { dataw.max.x, dataw.max.y } };
+    exr_attr_v2f_t swc = { header.screenWindowCenter().x,
+                           header.screenWindowCenter().y };
+    exr_result_t rv    = exr_initialize_required_attr(
+        m_ctx, 0, &displayWindow, &dataWindow, header.pixelAspectRatio(), &swc,
+        header.screenWindowWidth(), exr_lineorder_t(header.lineOrder()),
+        exr_compression_t(header.compression()));
+    for (auto c = header.channels().begin();
+         rv == EXR_ERR_SUCCESS && c != header.channels().end(); ++c) {
+        const Imf::Channel& chan(c.channel());
+        rv = exr_add_channel(m_ctx, 0, c.name(), exr_pixel_type_t(chan.type),
+                             chan.pLinear ? EXR_PERCEPTUALLY_LINEAR
+                                          : EXR_PERCEPTUALLY_LOGARITHMIC,
+                             chan.xSampling, chan.ySampling);
+    }
+    if (rv == EXR_ERR_SUCCESS && header.hasTileDescription()) {
+        const Imf::TileDescription& td(header.tileDescription());
+        rv = exr_set_tile_descriptor(m_ctx, 0, td.xSize, td.ySize,
+                                     exr_tile_level_mode_t(td.mode),
+                                     exr_tile_round_mode_t(td.roundingMode));
+    }
+#if OPENEXR_CODED_VERSION >= 30103
+    if (rv == EXR_ERR_SUCCESS)
+        rv = exr_set_zip_compression_level(m_ctx, 0,
+                                           header.zipCompressionLevel());
+#endif
+    if (rv != EXR_ERR_SUCCESS)
+        return false;
+
+    // Everything else is metadata that OpenEXROutput already translated
+    // into the header for the C++ library.
+    for (auto a = header.begin(); a != header.end(); ++a) {
+        string_view name(a.name());
+        string_view type(a.attribute().typeName());
+        const Imf::Attribute& attr(a.attribute());
+        const char* n = a.name();
+        if (name == "channels" || name == "compression" || name == "dataWindow"
+            || name == "displayWindow" || name == "lineOrder"
+            || name == "pixelAspectRatio" || name == "screenWindowCenter"
+            || name == "screenWindowWidth" || name == "tiles"
+            || name == "name" || name == "type")
+            continue;
+        if (name == "dwaCompressionLevel" && type == "float") {
+            const auto& f(static_cast<const Imf::FloatAttribute&>(attr));
+            rv = exr_set_dwa_compression_level(m_ctx, 0, f.value());
+        } else if (type == "int") {
+            const auto& i(static_cast<const Imf::IntAttribute&>(attr));
+            rv = exr_attr_set_int(m_ctx, 0, n, i.value());
+        } else if (type == "float") {
+            rv = exr_attr_set_float(
+                m_ctx, 0, n,
+                static_cast<const Imf::FloatAttribute&>(attr).value());
+        } else if (type == "double") {
+            rv = exr_attr_set_double(
+                m_ctx, 0, n,
+                static_cast<const Imf::DoubleAttribute&>(attr).value());
+        } else if (type == "string") {
+            rv = exr_attr_set_string(
+                m_ctx, 0, n,
+                static_cast<const Imf::StringAttribute&>(attr).value().c_str());
+        } else if (type == "stringvector") {
+            const auto& sv(
+                static_cast<const Imf::StringVectorAttribute&>(attr).value());
+            std::vector<const char*> ptrs;
+            for (const auto& s : sv)
+                ptrs.push_back(s.c_str());
+            rv = exr_attr_set_string_vector(m_ctx, 0, n, int32_t(ptrs.size()),
+                                            ptrs.data());
+        } else if (type == "floatvector") {
+            const auto& fv(
+                static_cast<const Imf::FloatVectorAttribute&>(attr).value());
+            rv = exr_attr_set_float_vector(m_ctx, 0, n, int32_t(fv.size()),
+                                           fv.data());
+        } else if (type == "v2i") {
+            const auto& v(static_cast<const Imf::V2iAttribute&>(attr).value());
+            exr_attr_v2i_t ev = { v.x, v.y };
+            rv                = exr_attr_set_v2i(m_ctx, 0, n, &ev);
+        } else if (type == "v2f") {
+            const auto& v(static_cast<const Imf::V2fAttribute&>(attr).value());
+            exr_attr_v2f_t ev = { v.x, v.y };
+            rv                = exr_attr_set_v2f(m_ctx, 0, n, &ev);
+        } else if (type == "v2d") {
+            const auto& v(static_cast<const Imf::V2dAttribute&>(attr).value());
+            exr_attr_v2d_t ev = { v.x, v.y };
+            rv                = exr_attr_set_v2d(m_ctx, 0, n, &ev);
+        } else if (type == "v3i") {
+            const auto& v(static_cast<const Imf::V3iAttribute&>(attr).value());
+            exr_attr_v3i_t ev = { v.x, v.y, v.z };
+            rv                = exr_attr_set_v3i(m_ctx, 0, n, &ev);
+        } else if (type == "v3f") {
+            const auto& v(static_cast<const Imf::V3fAttribute&>(attr).value());
+            exr_attr_v3f_t ev = { v.x, v.y, v.z };
+            rv                = exr_attr_set_v3f(m_ctx, 0, n, &ev);
+        } else if (type == "v3d") {
+            const auto& v(static_cast<const Imf::V3dAttribute&>(attr).value());
+            exr_attr_v3d_t ev = { v.x, v.y, v.z };
+            rv                = exr_attr_set_v3d(m_ctx, 0, n, &ev);
+        } else if (type == "m33f") {
+            exr_attr_m33f_t m;
+            memcpy(m.m, &static_cast<const Imf::M33fAttribute&>(attr).value(),
+                   sizeof(m.m));
+            rv = exr_attr_set_m33f(m_ctx, 0, n, &m);
+        } else if (type == "m33d") {
+            exr_attr_m33d_t m;
+            memcpy(m.m, &static_cast<const Imf::M33dAttribute&>(attr).value(),
+                   sizeof(m.m));
+            rv = exr_attr_set_m33d(m_ctx, 0, n, &m);
+        } else if (type == "m44f") {
+            exr_attr_m44f_t m;
+            memcpy(m.m, &static_cast<const Imf::M44fAttribute&>(attr).value(),
+                   sizeof(m.m));
+            rv = exr_attr_set_m44f(m_ctx, 0, n, &m);
+        } else if (type == "m44d") {
+            exr_attr_m44d_t m;
+            memcpy(m.m, &static_cast<const Imf::M44dAttribute&>(attr).value(),
+                   sizeof(m.m));
+            rv = exr_attr_set_m44d(m_ctx, 0, n, &m);
+        } else if (type == "box2i") {
+            const auto& b(
+                static_cast<const Imf::Box2iAttribute&>(attr).value());
+            exr_attr_box2i_t eb = { { b.min.x, b.min.y },
+                                    { b.max.x, b.max.y } };
+            rv                  = exr_attr_set_box2i(m_ctx, 0, n, &eb);
+        } else if (type == "box2f") {
+            const auto& b(
+                static_cast<const Imf::Box2fAttribute&>(attr).value());
+            exr_attr_box2f_t eb = { { b.min.x, b.min.y },
+                                    { b.max.x, b.max.y } };
+            rv                  = exr_attr_set_box2f(m_ctx, 0, n, &eb);
+        } else if (type == "rational") {
+            const auto& r(
+                static_cast<const Imf::RationalAttribute&>(attr).value());
+            exr_attr_rational_t er = { r.n, r.d };
+            rv = exr_attr_set_rational(m_ctx, 0, n, &er);
+        } else if (type == "timecode") {
+            const auto& t(
+                static_cast<const Imf::TimeCodeAttribute&>(attr).value());
+            exr_attr_timecode_t et = { t.timeAndFlags(), t.userData() };
+            rv = exr_attr_set_timecode(m_ctx, 0, n, &et);
+        } else if (type == "keycode") {
+            const auto& k(
+                static_cast<const Imf::KeyCodeAttribute&>(attr).value());
+            exr_attr_keycode_t ek = { k.filmMfcCode(),   k.filmType(),
+                                      k.prefix(),        k.count(),
+                                      k.perfOffset(),    k.perfsPerFrame(),
+                                      k.perfsPerCount() };
+            rv = exr_attr_set_keycode(m_ctx, 0, n, &ek);
+        } else if (type == "chromaticities") {
+            const auto& c(
+                static_cast<const Imf::ChromaticitiesAttribute&>(attr).value());
+            exr_attr_chromaticities_t ec = { c.red.x,   c.red.y,  c.green.x,
+                                             c.green.y, c.blue.x, c.blue.y,
+                                             c.white.x, c.white.y };
+            rv = exr_attr_set_chromaticities(m_ctx, 0, n, &ec);
+        } else if (type == "envmap") {
+            rv = exr_attr_set_envmap(
+                m_ctx, 0, n,
+                exr_envmap_t(
+                    static_cast<const Imf::EnvmapAttribute&>(attr).value()));
+        } else {
+            OIIO::debugfmt("OpenEXR core output: skipping {} attribute {}\n",
+                           type, name);
+        }
+        if (rv != EXR_ERR_SUCCESS) {
+            m_out->errorfmt("Could not set OpenEXR attribute \"{}\" ({})",
+                            name, exr_get_default_error_message(rv));
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+std::unique_ptr<OpenEXRCoreWriterImpl::EncoderSlot>
+OpenEXRCoreWriterImpl::acquire_encoder()
+{
+    std::unique_ptr<EncoderSlot> slot;
+    {
+        spin_lock lock(m_encoders_mutex);
+        if (m_encoders.size()) {
+            slot = std::move(m_encoders.back());
+            m_encoders.pop_back();
+        }
+    }
+    if (!slot)
+        slot.reset(new EncoderSlot);
+    return slot;
+}
+
+
+
+void
+OpenEXRCoreWriterImpl::release_encoder(std::unique_ptr<EncoderSlot>&& slot)
+{
+    spin_lock lock(m_encoders_mutex);
+    m_encoders.push_back(std::move(slot));
+}
+
+
+
+void
+OpenEXRCoreWriterImpl::encode_chunk(const ChunkJob& job)
+{
+    std::unique_ptr<EncoderSlot> slot = acquire_encoder();
+    exr_encode_pipeline_t& encoder(slot->encoder);
+    exr_chunk_info_t cinfo;
+    exr_result_t rv = m_tiled
+                          ? exr_write_tile_chunk_info(m_ctx, 0, job.tx, job.ty,
+                                                      0, 0, &cinfo)
+                          : exr_write_scanline_chunk_info(m_ctx, 0, job.y,
+                                                          &cinfo);
+    if (rv == EXR_ERR_SUCCESS)
+        rv = slot->start(m_ctx, cinfo);
+    if (rv == EXR_ERR_SUCCESS) {
+        // Point each channel (in the file's sorted order) at its place in
+        // our interleaved pixels.
+        for (int dc = 0; dc < encoder.channel_count; ++dc) {
+            exr_coding_channel_info_t& curchan = encoder.channels[dc];
+            for (int c = 0; c < m_spec.nchannels; ++c) {
+                if (m_spec.channel_name(c) == curchan.channel_name) {
+                    curchan.encode_from_ptr   = job.data + m_chanoffset[c];
+                    curchan.user_pixel_stride = m_pixelbytes;
+                    curchan.user_line_stride  = job.ystride;
+                    break;
+                }
+            }
+        }
+        rv = exr_encoding_choose_default_routines(m_ctx, 0, &encoder);
+    }
+    if (rv == EXR_ERR_SUCCESS) {
+        slot->write_fn   = encoder.write_fn;
+        encoder.write_fn = defer_write_chunk;
+        rv               = exr_encoding_run(m_ctx, 0, &encoder);
+    }
+    if (rv != EXR_ERR_SUCCESS) {
+        m_failed = true;
+        slot->reset(m_ctx);
+        release_encoder(std::move(slot));
+        return;
+    }
+    enqueue(job.index, std::move(slot));
+}
+
+
+
+void
+OpenEXRCoreWriterImpl::enqueue(int64_t index,
+                               std::unique_ptr<EncoderSlot>&& slot)
+{
+    std::unique_lock<std::mutex> lock(m_ready_mutex);
+    m_ready.emplace(index, std::move(slot));
+    if (m_writing)
+        return;  // The current writer will get to it
+    m_writing = true;
+    while (!m_ready.empty() && m_ready.begin()->first == m_next_chunk) {
+        std::unique_ptr<EncoderSlot> next = std::move(m_ready.begin()->second);
+        m_ready.erase(m_ready.begin());
+        lock.unlock();
+        exr_result_t rv = write_chunk(std::move(next));
+        lock.lock();
+        if (rv != EXR_ERR_SUCCESS)
+            m_failed = true;
+        ++m_next_chunk;
+    }
+    m_writing = false;
+}
+
+
+
+exr_result_t
+OpenEXRCoreWriterImpl::write_chunk(std::unique_ptr<EncoderSlot>&& slot)
+{
+    exr_result_t rv = slot->write_fn(&slot->encoder);
+    if (rv != EXR_ERR_SUCCESS)
+        slot->reset(m_ctx);
+    release_encoder(std::move(slot));
+    return rv;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::encode_chunks(cspan<ChunkJob> jobs)
+{
+    // Compress in batches of a few chunks per thread. That bounds how many
+    // compressed chunks can be waiting in the reorder queue for a slow
+    // predecessor, while still giving every thread work.
+    int nthreads = m_nthreads ? m_nthreads : OIIO::get_int_attribute("threads");
+    int64_t batch = 4 * std::max(1, nthreads);
+    for (int64_t b = 0; b < int64_t(jobs.size()) && !m_failed; b += batch) {
+        int64_t e = std::min(int64_t(jobs.size()), b + batch);
+        parallel_for(
+            b, e, [&](int64_t i) { encode_chunk(jobs[i]); },
+            paropt(m_nthreads).minitems(1));
+    }
+    return !m_failed;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::write_scanlines(int ybegin, int yend, const void* data)
+{
+    const int endy = m_spec.y + m_spec.height;
+    yend           = std::min(yend, endy);
+    auto d         = static_cast<const uint8_t*>(data);
+    std::vector<ChunkJob> jobs;
+    while (ybegin < yend) {
+        int chunkstart = m_spec.y
+                         + round_down_to_multiple(ybegin - m_spec.y,
+                                                  m_scansperchunk);
+        int chunkend   = std::min(chunkstart + m_scansperchunk, endy);
+        int64_t index  = (chunkstart - m_spec.y) / m_scansperchunk;
+        if (!m_linebuf_rows && ybegin == chunkstart && yend >= chunkend) {
+            // Whole chunk: encode straight from the caller's buffer.
+            jobs.push_back({ index, chunkstart, 0, 0, d, m_scanlinebytes });
+            d += (chunkend - ybegin) * m_scanlinebytes;
+            ybegin = chunkend;
+            continue;
+        }
+        // Partial chunk: accumulate scanlines until we have all of them.
+        if (!m_linebuf_rows)
+            m_linebuf_y = chunkstart;
+        if (ybegin != m_linebuf_y + m_linebuf_rows) {
+            m_out->errorfmt("OpenEXR scanlines must be written in order");
+            return false;
+        }
+        int n = std::min(yend, chunkend) - ybegin;
+        memcpy(&m_linebuf[(ybegin - chunkstart) * m_scanlinebytes], d,
+               n * m_scanlinebytes);
+        d += n * m_scanlinebytes;
+        ybegin += n;
+        m_linebuf_rows += n;
+        if (m_linebuf_y + m_linebuf_rows == chunkend) {
+            // The chunk is complete. Encode it (and anything before it)
+            // now, so that m_linebuf is free for the next one.
+            jobs.push_back(
+                { index, chunkstart, 0, 0, m_linebuf.data(), m_scanlinebytes });
+            m_linebuf_rows = 0;
+            if (!encode_chunks(jobs))
+                break;
+            jobs.clear();
+        }
+    }
+    if (!encode_chunks(jobs)) {
+        m_out->errorfmt("Some scanline chunks could not be written");
+        return false;
+    }
+    return true;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::write_tiles(int xbegin, int xend, int ybegin, int yend,
+                                   const void* data, stride_t ystride)
+{
+    const int tilew = m_spec.tile_width, tileh = m_spec.tile_height;
+    xend            = std::min(xend, m_spec.x + m_spec.width);
+    yend            = std::min(yend, m_spec.y + m_spec.height);
+    int firstxtile  = (xbegin - m_spec.x) / tilew;
+    int firstytile  = (ybegin - m_spec.y) / tileh;
+    int nxtiles     = (xend - xbegin + tilew - 1) / tilew;
+    int nytiles     = (yend - ybegin + tileh - 1) / tileh;
+    std::vector<ChunkJob> jobs;
+    jobs.reserve(size_t(nxtiles) * size_t(nytiles));
+    for (int ty = 0; ty < nytiles; ++ty) {
+        for (int tx = 0; tx < nxtiles; ++tx) {
+            int tilex = firstxtile + tx, tiley = firstytile + ty;
+            auto d    = static_cast<const uint8_t*>(data)
+                     + ty * tileh * ystride + tx * tilew * m_pixelbytes;
+            jobs.push_back({ int64_t(tiley) * m_nxtiles + tilex, 0, tilex,
+                             tiley, d, ystride });
+        }
+    }
+    if (!encode_chunks(jobs)) {
+        m_out->errorfmt("Some tiles could not be written");
+        return false;
+    }
+    return true;
+}
+
+
+
+bool
+OpenEXRCoreWriterImpl::close()
+{
+    if (!m_ctx)
+        return true;
+    bool ok = !m_failed;
+    if (m_linebuf_rows) {
+        // The caller never supplied the end of the last chunk. Write what
+        // we have, padded with zeroes.
+        memset(&m_linebuf[m_linebuf_rows * m_scanlinebytes], 0,
+               m_linebuf.size() - m_linebuf_rows * m_scanlinebytes);
+        ChunkJob job = { (m_linebuf_y - m_spec.y) / m_scansperchunk,
+                         m_linebuf_y, 0, 0, m_linebuf.data(),
+                         m_scanlinebytes };
+        m_linebuf_rows = 0;
+        ok &= encode_chunks(cspan<ChunkJob>(&job, 1));
+    }
+    // Chunks still waiting are past a gap left by chunks that were never
+    // written. Write them in order anyway; the library will complain if
+    // the file's line order doesn't allow it.
+    for (auto& r : m_ready)
+        ok &= (write_chunk(std::move(r.second)) == EXR_ERR_SUCCESS);
+    m_ready.clear();
+    for (auto& e : m_encoders)
+        e->reset(m_ctx);
+    m_encoders.clear();
+    exr_result_t rv = exr_finish(&m_ctx);
+    m_ctx           = nullptr;
+    if (!ok || rv != EXR_ERR_SUCCESS) {
+        m_out->errorfmt("Failed OpenEXR write: {}",
+                        rv != EXR_ERR_SUCCESS
+                            ? exr_get_default_error_message(rv)
+                            : "some chunks could not be written");
+        return false;
+    }
+    return true;
+}
+
+
+OIIO_PLUGIN_NAMESPACE_END
@@ -589,6 +589,7 @@ openvdb_input_imageio_create()
 }
 
 OIIO_EXPORT const char* openvdb_input_extensions[] = { "vdb", nullptr };
+OIIO_EXPORT const char* openvdb_input_signatures[] = { nullptr };
 
 OIIO_EXPORT int openvdb_imageio_version = OIIO_PLUGIN_VERSION;
 
@@ -749,6 +749,20 @@ write_rows(png_structp& sp, png_byte* data, int nrows = 0, stride_t ystride = 0)
 
 
 
+/// Write a whole chunk of already-encoded data, bypassing libpng's own
+/// row compression (used for IDAT data that we deflate ourselves).
+inline bool
+write_chunk(png_structp& sp, const char* name, const void* data, size_t len)
+{
+    if (setjmp(png_jmpbuf(sp))) {  // NOLINT(cert-err52-cpp)
+        return false;
+    }
+    png_write_chunk(sp, (png_bytep)name, (png_bytep)data, len);
+    return true;
+}
+
+
+
 /// Helper function - error-catching wrapper for png_write_end
 inline void
 write_end(png_structp& sp, png_infop& ip)
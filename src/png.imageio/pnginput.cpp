@@ -104,6 +104,8 @@ png_imageio_library_version()
 }
 
 OIIO_EXPORT const char* png_input_extensions[] = { "png", nullptr };
+OIIO_EXPORT const char* png_input_signatures[] = { "0:89504e470d0a1a0a",
+                                                   nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
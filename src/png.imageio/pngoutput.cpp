@@ -2,11 +2,17 @@
 // SPDX-License-Identifier: BSD-3-Clause and Apache-2.0
 // https://github.com/AcademySoftwareFoundation/OpenImageIO
 
+#include <atomic>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iostream>
+#include <limits>
+#include <memory>
+
+#include <OpenImageIO/parallel.h>
 
 #include "png_pvt.h"
 
@@ -44,7 +50,7 @@ private:
     png_structp m_png;       ///< PNG read structure pointer
     png_infop m_info;        ///< PNG image info structure pointer
     unsigned int m_dither;
-    int m_color_type;      ///< PNG color model type
+    int m_color_type;  ///< PNG color model type
     bool m_convert_alpha;  ///< Do we deassociate alpha?
     bool m_need_swap;      ///< Do we need to swap bytes?
     float m_gamma;         ///< Gamma to use for alpha conversion
@@ -53,6 +59,20 @@ private:
     std::vector<unsigned char> m_tilebuffer;
     bool m_err = false;
 
+    // State for parallel encoding, where we filter and deflate the rows
+    // ourselves, in independent segments, and libpng only writes chunks.
+    bool m_parallel = false;
+    int m_zlevel;                          ///< zlib compression level
+    int m_zstrategy;                       ///< zlib compression strategy
+    int m_filter;                          ///< "png:filter" value
+    int m_batchrows;                       ///< Rows to encode at once
+    int m_segrows;                         ///< Rows per deflate segment
+    int m_rows_done;                       ///< Rows already encoded
+    std::vector<unsigned char> m_pending;  ///< Rows not yet encoded
+    std::vector<unsigned char> m_prevrow;  ///< Last encoded (raw) row
+    std::vector<unsigned char> m_dict;     ///< Last 32k of filtered data
+    uLong m_adler;                         ///< Checksum of filtered data
+
     // Initialize private members to pre-opened state
     void init(void)
     {
@@ -63,9 +83,25 @@ private:
         m_gamma         = 1.0;
         m_pngtext.clear();
         ioproxy_clear();
-        m_err = false;
+        m_err      = false;
+        m_parallel = false;
+        std::vector<unsigned char>().swap(m_pending);
+        std::vector<unsigned char>().swap(m_prevrow);
+        std::vector<unsigned char>().swap(m_dict);
     }
 
+    // Queue native, big-endian rows for the parallel encoder, encoding
+    // each batch as it fills.
+    bool queue_rows(const unsigned char* data, int nrows);
+    // Filter and deflate the pending rows, and write them as IDAT chunks.
+    // If `last`, also terminate the zlib stream.
+    bool encode_pending(bool last);
+    // Write a row filtered by PNG filter type `type` (0-4) into `out`,
+    // which is one byte longer than the row, for the filter type.
+    void filter_row(int type, const unsigned char* row,
+                    const unsigned char* prev, unsigned char* out,
+                    size_t rowbytes, int bpp);
+
     // Add a parameter to the output
     bool put_parameter(const std::string& name, TypeDesc type,
                        const void* data);
@@ -154,39 +190,33 @@ PNGOutput::open(const std::string& name, const ImageSpec& userspec,
 
     png_set_write_fn(m_png, this, PngWriteCallback, PngFlushCallback);
 
-    png_set_compression_level(
-        m_png, std::max(std::min(m_spec.get_int_attribute(
+    m_zlevel = std::max(std::min(m_spec.get_int_attribute(
                                      "png:compressionLevel",
                                      6 /* medium speed vs size tradeoff */),
                                  Z_BEST_COMPRESSION),
-                        Z_NO_COMPRESSION));
+                        Z_NO_COMPRESSION);
+    m_zstrategy             = Z_DEFAULT_STRATEGY;
     std::string compression = m_spec.get_string_attribute("compression");
-    if (compression.empty()) {
-        png_set_compression_strategy(m_png, Z_DEFAULT_STRATEGY);
-    } else if (Strutil::iequals(compression, "default")) {
-        png_set_compression_strategy(m_png, Z_DEFAULT_STRATEGY);
-    } else if (Strutil::iequals(compression, "filtered")) {
-        png_set_compression_strategy(m_png, Z_FILTERED);
+    if (Strutil::iequals(compression, "filtered")) {
+        m_zstrategy = Z_FILTERED;
     } else if (Strutil::iequals(compression, "huffman")) {
-        png_set_compression_strategy(m_png, Z_HUFFMAN_ONLY);
+        m_zstrategy = Z_HUFFMAN_ONLY;
     } else if (Strutil::iequals(compression, "rle")) {
-        png_set_compression_strategy(m_png, Z_RLE);
+        m_zstrategy = Z_RLE;
     } else if (Strutil::iequals(compression, "fixed")) {
-        png_set_compression_strategy(m_png, Z_FIXED);
+        m_zstrategy = Z_FIXED;
     } else if (Strutil::iequals(compression, "pngfast")) {
-        png_set_compression_strategy(m_png, Z_DEFAULT_STRATEGY);
-        png_set_compression_level(m_png, Z_BEST_SPEED);
+        m_zlevel = Z_BEST_SPEED;
     } else if (Strutil::iequals(compression, "none")) {
-        png_set_compression_strategy(m_png, Z_NO_COMPRESSION);
-        png_set_compression_level(m_png, 0);
-    } else {
-        png_set_compression_strategy(m_png, Z_DEFAULT_STRATEGY);
+        m_zlevel = 0;
     }
+    png_set_compression_level(m_png, m_zlevel);
+    png_set_compression_strategy(m_png, m_zstrategy);
 
     m_need_swap = (m_spec.format == TypeDesc::UINT16 && littleendian());
 
-    png_set_filter(m_png, 0,
-                   spec().get_int_attribute("png:filter", PNG_NO_FILTERS));
+    m_filter = spec().get_int_attribute("png:filter", PNG_NO_FILTERS);
+    png_set_filter(m_png, 0, m_filter);
     // https://www.w3.org/TR/PNG-Encoders.html#E.Filter-selection
     // https://www.w3.org/TR/PNG-Rationale.html#R.Filtering
     // The official advice is to PNG_NO_FILTER for palette or < 8 bpp
@@ -234,6 +264,27 @@ PNGOutput::open(const std::string& name, const ImageSpec& userspec,
     if (m_spec.tile_width && m_spec.tile_height)
         m_tilebuffer.resize(m_spec.image_bytes());
 
+    // With "png:parallel", we encode the pixel data ourselves: rows are
+    // filtered, then deflated in independent segments of about 128 KB
+    // (each primed with the 32 KB that precede it, as pigz does), on the
+    // thread pool. The segments are joined by sync flushes into a single
+    // standard zlib stream. We batch a few segments per thread at a time.
+    m_parallel = m_spec.get_int_attribute("png:parallel", 0) != 0;
+    if (m_parallel) {
+        size_t rowbytes = m_spec.scanline_bytes();
+        int nthreads    = threads() ? threads()
+                                    : OIIO::get_int_attribute("threads");
+        m_segrows       = std::max(1, int((128 * 1024) / (rowbytes + 1)));
+        m_batchrows     = m_segrows * 4 * std::max(1, nthreads);
+        m_rows_done     = 0;
+        m_adler         = adler32(0L, Z_NULL, 0);
+        m_pending.clear();
+        m_pending.reserve(size_t(std::min(m_batchrows, m_spec.height))
+                          * rowbytes);
+        m_prevrow.assign(rowbytes, 0);
+        m_dict.clear();
+    }
+
     return true;
 }
 
@@ -256,13 +307,19 @@ PNGOutput::close()
         std::vector<unsigned char>().swap(m_tilebuffer);
     }
 
-    if (m_png) {
+    if (m_png && m_parallel) {
+        // Finish the zlib stream (even if we never got all the rows), and
+        // end the file ourselves, since libpng never saw any IDAT.
+        if (m_rows_done < m_spec.height)
+            ok &= encode_pending(true);
+        ok &= PNG_pvt::write_chunk(m_png, "IEND", nullptr, 0) && !m_err;
+    } else if (m_png) {
         PNG_pvt::write_end(m_png, m_info);
-        if (m_png || m_info)
-            PNG_pvt::destroy_write_struct(m_png, m_info);
-        m_png  = nullptr;
-        m_info = nullptr;
     }
+    if (m_png || m_info)
+        PNG_pvt::destroy_write_struct(m_png, m_info);
+    m_png  = nullptr;
+    m_info = nullptr;
 
     init();  // re-initialize
     return ok;
@@ -270,6 +327,218 @@ PNGOutput::close()
 
 
 
+bool
+PNGOutput::queue_rows(const unsigned char* data, int nrows)
+{
+    size_t rowbytes = m_spec.scanline_bytes();
+    nrows           = std::min(nrows, m_spec.height - m_rows_done
+                                          - int(m_pending.size() / rowbytes));
+    while (nrows > 0) {
+        int pending = int(m_pending.size() / rowbytes);
+        int n       = std::min(nrows, m_batchrows - pending);
+        m_pending.insert(m_pending.end(), data, data + n * rowbytes);
+        data += n * rowbytes;
+        nrows -= n;
+        pending += n;
+        bool last = (m_rows_done + pending == m_spec.height);
+        if ((pending == m_batchrows || last) && !encode_pending(last))
+            return false;
+    }
+    return true;
+}
+
+
+
+void
+PNGOutput::filter_row(int type, const unsigned char* row,
+                      const unsigned char* prev, unsigned char* out,
+                      size_t rowbytes, int bpp)
+{
+    *out++ = (unsigned char)type;
+    switch (type) {
+    case PNG_FILTER_VALUE_SUB:
+        for (size_t i = 0; i < rowbytes; ++i)
+            out[i] = row[i] - (i >= size_t(bpp) ? row[i - bpp] : 0);
+        break;
+    case PNG_FILTER_VALUE_UP:
+        for (size_t i = 0; i < rowbytes; ++i)
+            out[i] = row[i] - prev[i];
+        break;
+    case PNG_FILTER_VALUE_AVG:
+        for (size_t i = 0; i < rowbytes; ++i) {
+            int a  = i >= size_t(bpp) ? row[i - bpp] : 0;
+            out[i] = row[i] - (unsigned char)((a + prev[i]) / 2);
+        }
+        break;
+    case PNG_FILTER_VALUE_PAETH:
+        for (size_t i = 0; i < rowbytes; ++i) {
+            int a = i >= size_t(bpp) ? row[i - bpp] : 0;
+            int b = prev[i];
+            int c = i >= size_t(bpp) ? prev[i - bpp] : 0;
+            int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b);
+            int pc = std::abs(p - c);
+            int pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+            out[i]   = row[i] - (unsigned char)pred;
+        }
+        break;
+    default: memcpy(out, row, rowbytes); break;
+    }
+}
+
+
+
+bool
+PNGOutput::encode_pending(bool last)
+{
+    const size_t rowbytes = m_spec.scanline_bytes();
+    const size_t outbytes = rowbytes + 1;  // filter type byte + row
+    const int bpp         = std::max(1, int(m_spec.pixel_bytes()));
+    const int nrows       = int(m_pending.size() / rowbytes);
+    const int nsegs       = std::max(last ? 1 : 0,
+                                     (nrows + m_segrows - 1) / m_segrows);
+
+    // The filters to choose from, as a PNG_FILTER_* mask. Like libpng, a
+    // value 0-4 requests that one filter type.
+    int mask = m_filter & PNG_ALL_FILTERS;
+    if (m_filter >= PNG_FILTER_VALUE_NONE && m_filter < PNG_FILTER_VALUE_LAST)
+        mask = PNG_FILTER_NONE << m_filter;
+    if (!mask)
+        mask = PNG_FILTER_NONE;
+
+    // Filter the rows. Each depends only on its own and the previous raw
+    // row, so we can do them in any order.
+    std::vector<unsigned char> filtered(size_t(nrows) * outbytes);
+    parallel_for(
+        0, nrows,
+        [&](int y) {
+            const unsigned char* row  = &m_pending[y * rowbytes];
+            const unsigned char* prev = y ? row - rowbytes : m_prevrow.data();
+            unsigned char* out        = &filtered[y * outbytes];
+            if (!(mask & (mask - 1))) {  // Just one filter type allowed
+                int type = 0;
+                while (!(mask & (PNG_FILTER_NONE << type)))
+                    ++type;
+                filter_row(type, row, prev, out, rowbytes, bpp);
+                return;
+            }
+            // Adaptive: use the filter that yields the smallest sum of
+            // absolute values (as signed bytes), the usual heuristic.
+            std::unique_ptr<unsigned char[]> trial(new unsigned char[outbytes]);
+            uint64_t bestsum = std::numeric_limits<uint64_t>::max();
+            for (int type = 0; type < PNG_FILTER_VALUE_LAST; ++type) {
+                if (!(mask & (PNG_FILTER_NONE << type)))
+                    continue;
+                filter_row(type, row, prev, trial.get(), rowbytes, bpp);
+                uint64_t sum = 0;
+                for (size_t i = 1; i < outbytes; ++i)
+                    sum += std::abs(int(int8_t(trial[i])));
+                if (sum < bestsum) {
+                    bestsum = sum;
+                    memcpy(out, trial.get(), outbytes);
+                }
+            }
+        },
+        paropt(threads()).minitems(16));
+
+    // Deflate each segment independently, as a raw deflate stream primed
+    // with the data preceding it, ending in a sync flush so that the
+    // segments can simply be concatenated.
+    std::vector<std::vector<unsigned char>> compressed(nsegs);
+    std::vector<uLong> adlers(nsegs);
+    std::atomic<bool> zok(true);
+    parallel_for(
+        0, nsegs,
+        [&](int seg) {
+            size_t begin = size_t(seg) * m_segrows * outbytes;
+            size_t end   = std::min(filtered.size(),
+                                    begin + size_t(m_segrows) * outbytes);
+            bool final   = last && seg == nsegs - 1;
+            z_stream zs;
+            memset(&zs, 0, sizeof(zs));
+            if (deflateInit2(&zs, m_zlevel, Z_DEFLATED, -MAX_WBITS, 8,
+                             m_zstrategy)
+                != Z_OK) {
+                zok = false;
+                return;
+            }
+            const size_t dictsize = 32 * 1024;
+            if (seg) {
+                size_t d = std::min(begin, dictsize);
+                deflateSetDictionary(&zs, &filtered[begin - d], uInt(d));
+            } else if (m_dict.size()) {
+                deflateSetDictionary(&zs, m_dict.data(), uInt(m_dict.size()));
+            }
+            std::vector<unsigned char>& out(compressed[seg]);
+            out.resize(deflateBound(&zs, uLong(end - begin)) + 16);
+            zs.next_in   = (Bytef*)(filtered.data() + begin);
+            zs.avail_in  = uInt(end - begin);
+            zs.next_out  = out.data();
+            zs.avail_out = uInt(out.size());
+            int r        = deflate(&zs, final ? Z_FINISH : Z_SYNC_FLUSH);
+            if (r != (final ? Z_STREAM_END : Z_OK) || zs.avail_in)
+                zok = false;
+            out.resize(zs.total_out);
+            deflateEnd(&zs);
+            adlers[seg] = adler32(adler32(0L, Z_NULL, 0),
+                                  filtered.data() + begin, uInt(end - begin));
+        },
+        paropt(threads()).minitems(1));
+    if (!zok) {
+        errorfmt("PNG compression error");
+        return false;
+    }
+
+    // Write the segments in order, as IDAT chunks. The first one carries
+    // the zlib header, and the last one the checksum of all the data.
+    for (int seg = 0; seg < nsegs; ++seg) {
+        std::vector<unsigned char>& out(compressed[seg]);
+        size_t seglen = std::min(filtered.size() - seg * m_segrows * outbytes,
+                                 size_t(m_segrows) * outbytes);
+        m_adler       = adler32_combine(m_adler, adlers[seg], seglen);
+        if (m_rows_done == 0 && seg == 0) {
+            // Same header zlib itself would write for this level/strategy
+            int flevel = (m_zstrategy >= Z_HUFFMAN_ONLY || m_zlevel < 2) ? 0
+                         : (m_zlevel < 6)                                ? 1
+                         : (m_zlevel == 6)                               ? 2
+                                                                         : 3;
+            unsigned int header = ((Z_DEFLATED + (7 << 4)) << 8)
+                                  | (flevel << 6);
+            header += 31 - (header % 31);
+            unsigned char h[2] = { (unsigned char)(header >> 8),
+                                   (unsigned char)(header & 0xff) };
+            out.insert(out.begin(), h, h + 2);
+        }
+        if (last && seg == nsegs - 1) {
+            for (int shift = 24; shift >= 0; shift -= 8)
+                out.push_back((unsigned char)(m_adler >> shift));
+        }
+        if (!PNG_pvt::write_chunk(m_png, "IDAT", out.data(), out.size())
+            || m_err) {
+            errorfmt("PNG library error");
+            return false;
+        }
+    }
+
+    // Remember what the next batch depends on.
+    if (nrows) {
+        memcpy(m_prevrow.data(), &m_pending[(nrows - 1) * rowbytes],
+               rowbytes);
+        const size_t dictsize = 32 * 1024;
+        if (filtered.size() >= dictsize) {
+            m_dict.assign(filtered.end() - dictsize, filtered.end());
+        } else {
+            m_dict.insert(m_dict.end(), filtered.begin(), filtered.end());
+            if (m_dict.size() > dictsize)
+                m_dict.erase(m_dict.begin(), m_dict.end() - dictsize);
+        }
+    }
+    m_rows_done += nrows;
+    m_pending.clear();
+    return true;
+}
+
+
+
 template<class T>
 void
 PNGOutput::deassociateAlpha(T* data, size_t npixels, int channels,
@@ -348,6 +617,8 @@ PNGOutput::write_scanline(int y, int z, TypeDesc format, const void* data,
     if (m_need_swap)
         swap_endian((unsigned short*)data, m_spec.width * m_spec.nchannels);
 
+    if (m_parallel)
+        return queue_rows((const unsigned char*)data, 1);
     if (!PNG_pvt::write_row(m_png, (png_byte*)data)) {
         errorfmt("PNG library error");
         return false;
@@ -415,6 +686,8 @@ PNGOutput::write_scanlines(int ybegin, int yend, int z, TypeDesc format,
     if (m_need_swap)
         swap_endian((unsigned short*)data, nvals);
 
+    if (m_parallel)
+        return queue_rows((const unsigned char*)data, yend - ybegin);
     if (!PNG_pvt::write_rows(m_png, (png_byte*)data, yend - ybegin,
                              stride_t(m_spec.width) * m_spec.nchannels
                                  * m_spec.format.size())) {
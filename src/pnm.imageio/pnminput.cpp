@@ -100,6 +100,11 @@ pnm_imageio_library_version()
 
 OIIO_EXPORT const char* pnm_input_extensions[] = { "ppm", "pgm", "pbm",
                                                    "pnm", "pfm", nullptr };
+// Magic numbers: "P1" .. "P6", "Pf", "PF"
+OIIO_EXPORT const char* pnm_input_signatures[] = { "0:5031", "0:5032", "0:5033",
+                                                   "0:5034", "0:5035", "0:5036",
+                                                   "0:5066", "0:5046",
+                                                   nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
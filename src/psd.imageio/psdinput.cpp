@@ -544,6 +544,8 @@ psd_imageio_library_version()
 
 OIIO_EXPORT const char* psd_input_extensions[] = { "psd", "pdd", "psb",
                                                    nullptr };
+// Magic numbers: "8BPS"
+OIIO_EXPORT const char* psd_input_signatures[] = { "0:38425053", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -90,6 +90,8 @@ ptex_imageio_library_version()
 }
 
 OIIO_EXPORT const char* ptex_input_extensions[] = { "ptex", "ptx", nullptr };
+// Magic numbers: "Ptex"
+OIIO_EXPORT const char* ptex_input_signatures[] = { "0:50746578", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
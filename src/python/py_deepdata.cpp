@@ -103,6 +103,8 @@ declare_deepdata(py::module& m)
             },
             "pixel"_a)
         .def("set_capacity", &DeepData::set_capacity, "pixel"_a, "nsamples"_a)
+        .def("set_chunked", &DeepData::set_chunked, "pixels_per_chunk"_a)
+        .def("chunked", [](const DeepData& dd) { return dd.chunked(); })
         .def("insert_samples", &DeepData::insert_samples, "pixel"_a,
              "samplepos"_a, "nsamples"_a = 1)
         .def("erase_samples", &DeepData::erase_samples, "pixel"_a,
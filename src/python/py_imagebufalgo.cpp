@@ -330,6 +330,28 @@ IBA_deep_holdout_ret(const ImageBuf& src, const ImageBuf& holdout, ROI roi,
 
 
 
+bool
+IBA_deep_reduce(ImageBuf& dst, const ImageBuf& src, float ztolerance,
+                float colortolerance, float opacity, ROI roi, int nthreads)
+{
+    py::gil_scoped_release gil;
+    return ImageBufAlgo::deep_reduce(dst, src, ztolerance, colortolerance,
+                                     opacity, nullptr, roi, nthreads);
+}
+
+
+
+ImageBuf
+IBA_deep_reduce_ret(const ImageBuf& src, float ztolerance,
+                    float colortolerance, float opacity, ROI roi, int nthreads)
+{
+    py::gil_scoped_release gil;
+    return ImageBufAlgo::deep_reduce(src, ztolerance, colortolerance, opacity,
+                                     nullptr, roi, nthreads);
+}
+
+
+
 bool
 IBA_copy(ImageBuf& dst, const ImageBuf& src, TypeDesc convert, ROI roi,
          int nthreads)
@@ -2464,6 +2486,12 @@ declare_imagebufalgo(py::module& m)
                     "holdout"_a, "roi"_a = ROI::All(), "nthreads"_a = 0)
         .def_static("deep_holdout", IBA_deep_holdout_ret, "src"_a, "holdout"_a,
                     "roi"_a = ROI::All(), "nthreads"_a = 0)
+        .def_static("deep_reduce", IBA_deep_reduce, "dst"_a, "src"_a,
+                    "ztolerance"_a = 0.0f, "colortolerance"_a = 0.0f,
+                    "opacity"_a = 1.0f, "roi"_a = ROI::All(), "nthreads"_a = 0)
+        .def_static("deep_reduce", IBA_deep_reduce_ret, "src"_a,
+                    "ztolerance"_a = 0.0f, "colortolerance"_a = 0.0f,
+                    "opacity"_a = 1.0f, "roi"_a = ROI::All(), "nthreads"_a = 0)
 
         .def_static("copy", IBA_copy, "dst"_a, "src"_a,
                     "convert"_a = TypeUnknown, "roi"_a = ROI::All(),
@@ -159,6 +159,7 @@ r3d_input_imageio_create()
 }
 
 OIIO_EXPORT const char* r3d_input_extensions[] = { "r3d", nullptr };
+OIIO_EXPORT const char* r3d_input_signatures[] = { nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
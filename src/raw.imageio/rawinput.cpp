@@ -61,7 +61,7 @@ public:
     const char* format_name(void) const override { return "raw"; }
     int supports(string_view feature) const override
     {
-        return (feature == "exif"
+        return (feature == "exif" || feature == "reduce"
                 /* not yet? || feature == "iptc"*/);
     }
     bool open(const std::string& name, ImageSpec& newspec) override;
@@ -241,6 +241,7 @@ OIIO_EXPORT const char* raw_input_extensions[]
         "pxn", "raf", "raw", "rdc", "sr2", "srf", "x3f",  "arw", "3fr", "cine",
         "ia",  "kc2", "mef", "nrw", "qtk", "rw2", "sti",  "rwl", "srw", "drf",
         "dsc", "ptx", "cap", "iiq", "rwz", "cr3", nullptr };
+OIIO_EXPORT const char* raw_input_signatures[] = { nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -438,9 +439,13 @@ RawInput::open_raw(bool unpack, const std::string& name,
     }
     m_processor->adjust_sizes_info_only();
 
-    // Process image at half size if "raw:half_size" is not 0
+    // Process image at half size if "raw:half_size" is not 0, or if the
+    // caller asked for "oiio:reduce" of 2 or more (half size skips the
+    // demosaic entirely, which is the bulk of the cost).
     m_processor->imgdata.params.half_size
-        = config.get_int_attribute("raw:half_size", 0);
+        = config.get_int_attribute("raw:half_size",
+                                   config.get_int_attribute("oiio:reduce", 1)
+                                       >= 2);
     int div = m_processor->imgdata.params.half_size == 0 ? 1 : 2;
 
     // Set file information
@@ -449,6 +454,8 @@ RawInput::open_raw(bool unpack, const std::string& name,
                        m_processor->imgdata.idata.colors, TypeDesc::UINT16);
     // Move the exif attribs we already read into the spec we care about
     m_spec.extra_attribs.swap(exifspec.extra_attribs);
+    if (div > 1)
+        m_spec.attribute("oiio:reduce", div);
 
     // Output 16 bit images
     m_processor->imgdata.params.output_bps = 16;
@@ -40,22 +40,19 @@ public:
     bool close() override;
     bool read_native_scanline(int subimage, int miplevel, int y, int z,
                               void* data) override;
+    bool read_native_scanlines(int subimage, int miplevel, int ybegin,
+                               int yend, int z, void* data) override;
 
 private:
-    std::string m_filename;            ///< Stash the filename
-    RLAHeader m_rla;                   ///< Wavefront RLA header
-    std::vector<unsigned char> m_buf;  ///< Buffer the image pixels
-    int m_subimage;                    ///< Current subimage index
-    std::vector<uint32_t> m_sot;       ///< Scanline offsets table
-    int m_stride;                      ///< Number of bytes a contig pixel takes
+    std::string m_filename;       ///< Stash the filename
+    RLAHeader m_rla;              ///< Wavefront RLA header
+    int m_subimage;               ///< Current subimage index
+    std::vector<uint32_t> m_sot;  ///< Scanline offsets table
+    int m_stride;                 ///< Number of bytes a contig pixel takes
 
     /// Reset everything to initial state
     ///
-    void init()
-    {
-        ioproxy_clear();
-        m_buf.clear();
-    }
+    void init() { ioproxy_clear(); }
 
     /// Helper: read buf[0..nitems-1], swap endianness if necessary
     template<typename T> bool read(T* buf, size_t nitems = 1)
@@ -78,11 +75,17 @@ private:
     ///
     inline bool read_header();
 
+    /// Helper: decode native scanlines [ybegin,yend) into data. It reads
+    /// only with pread, so may be called concurrently.
+    bool decode_scanlines(int ybegin, int yend, unsigned char* data);
+
     /// Helper: read and decode a single channel group consisting of
     /// channels [first_channel .. first_channel+num_channels-1], which
-    /// all share the same number of significant bits.
+    /// all share the same number of significant bits, from file position
+    /// pos (which is advanced past it), into the scanline buf.
     bool decode_channel_group(int first_channel, short num_channels,
-                              short num_bits, int y);
+                              short num_bits, int y, int64_t& pos,
+                              unsigned char* buf);
 
     /// Helper: decode a span of n RLE-encoded bytes from encoded[0..elen-1]
     /// into buf[0],buf[stride],buf[2*stride]...buf[(n-1)*stride].
@@ -138,6 +141,7 @@ rla_imageio_library_version()
 }
 
 OIIO_EXPORT const char* rla_input_extensions[] = { "rla", nullptr };
+OIIO_EXPORT const char* rla_input_signatures[] = { nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -509,7 +513,8 @@ RLAInput::decode_rle_span(unsigned char* buf, int n, int stride,
 
 bool
 RLAInput::decode_channel_group(int first_channel, short num_channels,
-                               short num_bits, int y)
+                               short num_bits, int y, int64_t& pos,
+                               unsigned char* buf)
 {
     // Some preliminaries -- figure out various sizes and offsets
     int chsize;         // size of the channels in this group, in bytes
@@ -541,17 +546,21 @@ RLAInput::decode_channel_group(int first_channel, short num_channels,
     for (int c = 0; c < num_channels; ++c) {
         // Read the length
         uint16_t lenu16;  // number of encoded bytes
-        if (!read(&lenu16)) {
+        if (!iopread(&lenu16, sizeof(lenu16), pos)) {
             errorfmt("Read error: couldn't read RLE record length");
             return false;
         }
+        if (littleendian())
+            swap_endian(&lenu16);
         size_t length = lenu16;
+        pos += sizeof(lenu16);
         // Read the encoded RLE record
         encoded.resize(length);
-        if (!length || !read(&encoded[0], length)) {
+        if (!length || !iopread(&encoded[0], length, pos)) {
             errorfmt("Read error: couldn't read RLE data span");
             return false;
         }
+        pos += length;
 
         if (chantype == TypeDesc::FLOAT) {
             // Special case -- float data is just dumped raw, no RLE
@@ -562,7 +571,7 @@ RLAInput::decode_channel_group(int first_channel, short num_channels,
                 return false;
             }
             for (int x = 0; x < m_spec.width; ++x)
-                *((float*)&m_buf[offset + c * chsize + x * pixelsize])
+                *((float*)&buf[offset + c * chsize + x * pixelsize])
                     = ((float*)&encoded[0])[x];
             continue;
         }
@@ -572,7 +581,7 @@ RLAInput::decode_channel_group(int first_channel, short num_channels,
         // and strides to decode_rle_span.
         size_t eoffset = 0;
         for (int bytes = 0; bytes < chsize && length > 0; ++bytes) {
-            size_t e = decode_rle_span(&m_buf[offset + c * chsize + bytes],
+            size_t e = decode_rle_span(&buf[offset + c * chsize + bytes],
                                        m_spec.width, pixelsize,
                                        &encoded[eoffset], length);
             if (!e)
@@ -587,17 +596,17 @@ RLAInput::decode_channel_group(int first_channel, short num_channels,
     if (littleendian()) {
         if (chsize == 2) {
             if (num_channels == m_spec.nchannels)
-                swap_endian((uint16_t*)&m_buf[0], num_channels * m_spec.width);
+                swap_endian((uint16_t*)&buf[0], num_channels * m_spec.width);
             else
                 for (int x = 0; x < m_spec.width; ++x)
-                    swap_endian((uint16_t*)&m_buf[offset + x * pixelsize],
+                    swap_endian((uint16_t*)&buf[offset + x * pixelsize],
                                 num_channels);
         } else if (chsize == 4 && chantype != TypeDesc::FLOAT) {
             if (num_channels == m_spec.nchannels)
-                swap_endian((uint32_t*)&m_buf[0], num_channels * m_spec.width);
+                swap_endian((uint32_t*)&buf[0], num_channels * m_spec.width);
             else
                 for (int x = 0; x < m_spec.width; ++x)
-                    swap_endian((uint32_t*)&m_buf[offset + x * pixelsize],
+                    swap_endian((uint32_t*)&buf[offset + x * pixelsize],
                                 num_channels);
         }
     }
@@ -611,28 +620,28 @@ RLAInput::decode_channel_group(int first_channel, short num_channels,
     } else if (num_bits == 10) {
         // fast, common case -- use templated hard-code
         for (int x = 0; x < m_spec.width; ++x) {
-            uint16_t* b = (uint16_t*)(&m_buf[offset + x * pixelsize]);
+            uint16_t* b = (uint16_t*)(&buf[offset + x * pixelsize]);
             for (int c = 0; c < num_channels; ++c)
                 b[c] = bit_range_convert<10, 16>(b[c]);
         }
     } else if (num_bits < 8) {
         // rare case, use slow code to make this clause short and simple
         for (int x = 0; x < m_spec.width; ++x) {
-            uint8_t* b = (uint8_t*)&m_buf[offset + x * pixelsize];
+            uint8_t* b = (uint8_t*)&buf[offset + x * pixelsize];
             for (int c = 0; c < num_channels; ++c)
                 b[c] = bit_range_convert(b[c], num_bits, 8);
         }
     } else if (num_bits > 8 && num_bits < 16) {
         // rare case, use slow code to make this clause short and simple
         for (int x = 0; x < m_spec.width; ++x) {
-            uint16_t* b = (uint16_t*)&m_buf[offset + x * pixelsize];
+            uint16_t* b = (uint16_t*)&buf[offset + x * pixelsize];
             for (int c = 0; c < num_channels; ++c)
                 b[c] = bit_range_convert(b[c], num_bits, 16);
         }
     } else if (num_bits > 16 && num_bits < 32) {
         // rare case, use slow code to make this clause short and simple
         for (int x = 0; x < m_spec.width; ++x) {
-            uint32_t* b = (uint32_t*)&m_buf[offset + x * pixelsize];
+            uint32_t* b = (uint32_t*)&buf[offset + x * pixelsize];
             for (int c = 0; c < num_channels; ++c)
                 b[c] = bit_range_convert(b[c], num_bits, 32);
         }
@@ -649,39 +658,63 @@ RLAInput::read_native_scanline(int subimage, int miplevel, int y, int /*z*/,
     lock_guard lock(*this);
     if (!seek_subimage(subimage, miplevel))
         return false;
+    return decode_scanlines(y, y + 1, (unsigned char*)data);
+}
 
-    // By convention, RLA images store their images bottom-to-top.
-    y = m_spec.height - (y - m_spec.y) - 1;
 
-    // Seek to scanline start, based on the scanline offset table
-    ioseek(m_sot[y]);
 
-    // Now decode and interleave the channels.
-    // The channels are non-interleaved (i.e. rrrrrgggggbbbbb...).
-    // Color first, then matte, then auxiliary channels.  We can't
-    // decode all in one shot, though, because the data type and number
-    // of significant bits may be may be different for each class of
-    // channels, so we deal with them separately and interleave into
-    // our buffer as we go.
-    size_t size = m_spec.scanline_bytes(true);
-    m_buf.resize(size);
-    if (m_rla.NumOfColorChannels > 0)
-        if (!decode_channel_group(0, m_rla.NumOfColorChannels,
-                                  m_rla.NumOfChannelBits, y))
-            return false;
-    if (m_rla.NumOfMatteChannels > 0)
-        if (!decode_channel_group(m_rla.NumOfColorChannels,
-                                  m_rla.NumOfMatteChannels,
-                                  m_rla.NumOfMatteBits, y))
-            return false;
-    if (m_rla.NumOfAuxChannels > 0)
-        if (!decode_channel_group(m_rla.NumOfColorChannels
-                                      + m_rla.NumOfMatteChannels,
-                                  m_rla.NumOfAuxChannels, m_rla.NumOfAuxBits,
-                                  y))
-            return false;
+bool
+RLAInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
+                                int yend, int /*z*/, void* data)
+{
+    lock_guard lock(*this);
+    if (!seek_subimage(subimage, miplevel))
+        return false;
+
+    // The scanline offset table lets us decode big ranges in parallel.
+    return read_native_scanlines_parallel(ybegin, yend, 1, data,
+                                          [&](int y0, int y1, void* buf) {
+                                              return decode_scanlines(
+                                                  y0, y1, (unsigned char*)buf);
+                                          });
+}
 
-    memcpy(data, &m_buf[0], size);
+
+
+bool
+RLAInput::decode_scanlines(int ybegin, int yend, unsigned char* data)
+{
+    size_t size = m_spec.scanline_bytes(true);
+    for (int yy = ybegin; yy < yend; ++yy, data += size) {
+        // By convention, RLA images store their images bottom-to-top.
+        int y = m_spec.height - (yy - m_spec.y) - 1;
+
+        // Scanline start, based on the scanline offset table
+        int64_t pos = m_sot[y];
+
+        // Now decode and interleave the channels.
+        // The channels are non-interleaved (i.e. rrrrrgggggbbbbb...).
+        // Color first, then matte, then auxiliary channels.  We can't
+        // decode all in one shot, though, because the data type and number
+        // of significant bits may be may be different for each class of
+        // channels, so we deal with them separately and interleave into
+        // our buffer as we go.
+        if (m_rla.NumOfColorChannels > 0)
+            if (!decode_channel_group(0, m_rla.NumOfColorChannels,
+                                      m_rla.NumOfChannelBits, y, pos, data))
+                return false;
+        if (m_rla.NumOfMatteChannels > 0)
+            if (!decode_channel_group(m_rla.NumOfColorChannels,
+                                      m_rla.NumOfMatteChannels,
+                                      m_rla.NumOfMatteBits, y, pos, data))
+                return false;
+        if (m_rla.NumOfAuxChannels > 0)
+            if (!decode_channel_group(m_rla.NumOfColorChannels
+                                          + m_rla.NumOfMatteChannels,
+                                      m_rla.NumOfAuxChannels,
+                                      m_rla.NumOfAuxBits, y, pos, data))
+                return false;
+    }
     return true;
 }
 
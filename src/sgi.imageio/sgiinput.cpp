@@ -25,6 +25,8 @@ public:
     bool close(void) override;
     bool read_native_scanline(int subimage, int miplevel, int y, int z,
                               void* data) override;
+    bool read_native_scanlines(int subimage, int miplevel, int ybegin,
+                               int yend, int z, void* data) override;
 
 private:
     std::string m_filename;
@@ -48,6 +50,12 @@ private:
     // Return true if ok, false if there was a read error.
     bool read_offset_tables();
 
+    // Decode scanlines [ybegin,yend) into data. Every scanline of every
+    // channel is found from the offset tables (or computed, for verbatim
+    // files), so this only uses pread and may be called concurrently.
+    // Return true if ok, false if there was a read error.
+    bool decode_scanlines(int ybegin, int yend, unsigned char* data);
+
     // read channel scanline data from file, uncompress it and save the data to
     // 'out' buffer; 'out' should be allocate before call to this method.
     // Return true if ok, false if there was a read error.
@@ -76,6 +84,7 @@ sgi_input_imageio_create()
 
 OIIO_EXPORT const char* sgi_input_extensions[] = { "sgi", "rgb",  "rgba", "bw",
                                                    "int", "inta", nullptr };
+OIIO_EXPORT const char* sgi_input_signatures[] = { "0:01da", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -180,55 +189,77 @@ SgiInput::read_native_scanline(int subimage, int miplevel, int y, int /*z*/,
     if (!seek_subimage(subimage, miplevel))
         return false;
 
-    if (y < 0 || y > m_spec.height)
+    if (y < 0 || y >= m_spec.height)
         return false;
 
-    y = m_spec.height - y - 1;
+    return decode_scanlines(y, y + 1, (unsigned char*)data);
+}
+
+
+
+bool
+SgiInput::read_native_scanlines(int subimage, int miplevel, int ybegin,
+                                int yend, int /*z*/, void* data)
+{
+    lock_guard lock(*this);
+    if (!seek_subimage(subimage, miplevel))
+        return false;
+
+    // Scanlines are independent, so big ranges can be decoded in parallel.
+    return read_native_scanlines_parallel(ybegin, yend, 1, data,
+                                          [&](int y0, int y1, void* buf) {
+                                              return decode_scanlines(
+                                                  y0, y1, (unsigned char*)buf);
+                                          });
+}
+
+
 
+bool
+SgiInput::decode_scanlines(int ybegin, int yend, unsigned char* data)
+{
     ptrdiff_t bpc = m_sgi_header.bpc;
     std::vector<std::vector<unsigned char>> channeldata(m_spec.nchannels);
-    if (m_sgi_header.storage == sgi_pvt::RLE) {
-        // reading and uncompressing first channel (red in RGBA images)
-        for (int c = 0; c < m_spec.nchannels; ++c) {
-            // offset for this scanline/channel
-            ptrdiff_t off             = y + c * m_spec.height;
-            ptrdiff_t scanline_offset = start_tab[off];
-            ptrdiff_t scanline_length = length_tab[off];
-            channeldata[c].resize(m_spec.width * bpc);
-            uncompress_rle_channel(scanline_offset, scanline_length,
-                                   &(channeldata[c][0]));
-        }
-    } else {
-        // non-RLE case -- just read directly into our channel data
+    for (int c = 0; c < m_spec.nchannels; ++c)
+        channeldata[c].resize(m_spec.width * bpc);
+
+    for (int yy = ybegin; yy < yend; ++yy, data += m_spec.scanline_bytes()) {
+        int y = m_spec.height - yy - 1;
         for (int c = 0; c < m_spec.nchannels; ++c) {
             // offset for this scanline/channel
-            ptrdiff_t off             = y + c * m_spec.height;
-            ptrdiff_t scanline_offset = sgi_pvt::SGI_HEADER_LEN
-                                        + off * m_spec.width * bpc;
-            ioseek(scanline_offset);
-            channeldata[c].resize(m_spec.width * bpc);
-            if (!ioread(&(channeldata[c][0]), 1, m_spec.width * bpc))
-                return false;
+            ptrdiff_t off = y + c * m_spec.height;
+            if (m_sgi_header.storage == sgi_pvt::RLE) {
+                // N.B. Malformed RLE is reported, but has never been fatal
+                uncompress_rle_channel(start_tab[off], length_tab[off],
+                                       &(channeldata[c][0]));
+            } else {
+                // non-RLE case -- just read directly into our channel data
+                ptrdiff_t scanline_offset = sgi_pvt::SGI_HEADER_LEN
+                                            + off * m_spec.width * bpc;
+                if (!iopread(&(channeldata[c][0]), m_spec.width * bpc,
+                             scanline_offset))
+                    return false;
+            }
         }
-    }
 
-    if (m_spec.nchannels == 1) {
-        // If just one channel, no interleaving is necessary, just memcpy
-        memcpy(data, &(channeldata[0][0]), channeldata[0].size());
-    } else {
-        unsigned char* cdata = (unsigned char*)data;
-        for (int x = 0; x < m_spec.width; ++x) {
-            for (int c = 0; c < m_spec.nchannels; ++c) {
-                *cdata++ = channeldata[c][x * bpc];
-                if (bpc == 2)
-                    *cdata++ = channeldata[c][x * bpc + 1];
+        if (m_spec.nchannels == 1) {
+            // If just one channel, no interleaving is necessary, just memcpy
+            memcpy(data, &(channeldata[0][0]), channeldata[0].size());
+        } else {
+            unsigned char* cdata = data;
+            for (int x = 0; x < m_spec.width; ++x) {
+                for (int c = 0; c < m_spec.nchannels; ++c) {
+                    *cdata++ = channeldata[c][x * bpc];
+                    if (bpc == 2)
+                        *cdata++ = channeldata[c][x * bpc + 1];
+                }
             }
         }
-    }
 
-    // Swap endianness if needed
-    if (bpc == 2 && littleendian())
-        swap_endian((unsigned short*)data, m_spec.width * m_spec.nchannels);
+        // Swap endianness if needed
+        if (bpc == 2 && littleendian())
+            swap_endian((unsigned short*)data, m_spec.width * m_spec.nchannels);
+    }
 
     return true;
 }
@@ -242,8 +273,7 @@ SgiInput::uncompress_rle_channel(int scanline_off, int scanline_len,
     int bpc = m_sgi_header.bpc;
     std::unique_ptr<unsigned char[]> rle_scanline(
         new unsigned char[scanline_len]);
-    ioseek(scanline_off);
-    if (!ioread(&rle_scanline[0], 1, scanline_len))
+    if (!iopread(&rle_scanline[0], scanline_len, scanline_off))
         return false;
     int limit = m_spec.width;
     int i     = 0;
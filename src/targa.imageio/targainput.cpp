@@ -144,6 +144,7 @@ targa_input_imageio_create()
 OIIO_EXPORT int targa_imageio_version = OIIO_PLUGIN_VERSION;
 
 OIIO_EXPORT const char* targa_input_extensions[] = { "tga", "tpic", nullptr };
+OIIO_EXPORT const char* targa_input_signatures[] = { nullptr };
 
 OIIO_EXPORT const char*
 targa_imageio_library_version()
@@ -511,6 +511,10 @@ tiff_input_imageio_create()
 
 OIIO_EXPORT const char* tiff_input_extensions[]
     = { "tif", "tiff", "tx", "env", "sm", "vsm", nullptr };
+// Magic numbers: classic and BigTIFF, both byte orders
+OIIO_EXPORT const char* tiff_input_signatures[] = { "0:49492a00", "0:4d4d002a",
+                                                    "0:49492b00", "0:4d4d002b",
+                                                    nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
@@ -7,6 +7,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <memory>
 
@@ -108,7 +110,25 @@ private:
     unsigned int m_bitspersample;  ///< Of the *file*, not the client's view
     int m_outputchans;             // Number of channels for the output
     bool m_convert_rgb_to_cmyk;
-    bool m_bigtiff;  // force bigtiff
+    bool m_bigtiff;         // force bigtiff
+    bool m_compress_async;  // compress write_scanline/tile in the pool
+
+    // A strip or tile whose compression was handed to the thread pool. It
+    // waits in m_compress_queue until it can be written to the file in the
+    // order it was submitted.
+    struct CompressJob {
+        std::vector<unsigned char> raw;  // uncompressed (freed when done)
+        std::unique_ptr<char[]> compressed;
+        unsigned long compressed_len = 0;
+        uint32_t index               = 0;  // strip or tile number
+        int nitems                   = 0;  // scanlines or tiles it holds
+        bool ok                      = true;
+        std::future<void> done;  // not valid() if compressed synchronously
+    };
+    std::deque<std::unique_ptr<CompressJob>> m_compress_queue;
+    std::vector<unsigned char> m_stripbuf;  // scanlines of the next strip
+    int m_stripbuf_y;                       // first of them (file relative)
+    int m_stripbuf_rows;                    // how many we have
 
     // Initialize private members to pre-opened state
     void init(void)
@@ -123,6 +143,11 @@ private:
         m_outputchans         = 0;
         m_convert_rgb_to_cmyk = false;
         m_bigtiff             = false;
+        m_compress_async      = false;
+        m_compress_queue.clear();
+        m_stripbuf.clear();
+        m_stripbuf_y    = 0;
+        m_stripbuf_rows = 0;
         ioproxy_clear();
     }
 
@@ -192,6 +217,27 @@ private:
                             int channels, int width, int height,
                             unsigned long* compressed_size, bool* ok);
 
+    // Can strips or tiles be compressed by our own zlib calls on the
+    // thread pool and written raw? Only deflate with the horizontal
+    // predictor on contiguous 8 or 16 bit data, which covers most
+    // real-world cases.
+    bool can_compress_in_pool();
+
+    // Streaming writes: add one native scanline to m_stripbuf, submitting
+    // the strip for compression once it is full.
+    bool queue_scanline(int y, int z, const void* data);
+    // Compress job->raw (a width x height block) on the thread pool, queue
+    // it, and write whatever finished strips or tiles are at the front of
+    // the queue.
+    bool queue_compression(std::unique_ptr<CompressJob> job, int width,
+                           int height);
+    // Write the compressed strips or tiles at the front of the queue, in
+    // order, as long as they are done. If `all` is true (or the queue is
+    // too long), wait for them. On failure the queue is discarded.
+    bool write_compressed(bool all);
+    // Compress and write everything still pending.
+    bool finish_compression();
+
     int tile_index(int x, int y, int z)
     {
         int xtile   = (x - m_spec.x) / m_spec.tile_width;
@@ -459,6 +505,9 @@ bool
 TIFFOutput::open(const std::string& name, const ImageSpec& userspec,
                  OpenMode mode)
 {
+    // Finish writing the prior subimage (or file)
+    if (!finish_compression())
+        return false;
     closetif();
 
     if (!check_open(mode, userspec,
@@ -940,6 +989,10 @@ TIFFOutput::open(const std::string& name, const ImageSpec& userspec,
                    ? m_spec.get_int_attribute("oiio:dither", 0)
                    : 0;
 
+    // Compress strips or tiles written one call at a time in the thread
+    // pool, too, as they fill, writing them out in order as they finish.
+    m_compress_async = can_compress_in_pool();
+
     return true;
 }
 
@@ -1172,9 +1225,33 @@ TIFFOutput::write_exif_data()
 bool
 TIFFOutput::close()
 {
+    bool ok = finish_compression();
     closetif();
-    init();       // re-initialize
-    return true;  // How can we fail?
+    init();  // re-initialize
+    return ok;
+}
+
+
+
+bool
+TIFFOutput::finish_compression()
+{
+    // A partial strip is left only if the caller didn't write every
+    // scanline. Write it anyway, as libtiff would have.
+    bool ok = true;
+    if (m_stripbuf_rows) {
+        auto job = std::make_unique<CompressJob>();
+        job->raw.assign(m_stripbuf.begin(),
+                        m_stripbuf.begin()
+                            + m_stripbuf_rows * m_spec.scanline_bytes(true));
+        job->index  = m_stripbuf_y / m_rowsperstrip;
+        job->nitems = m_stripbuf_rows;
+        ok &= queue_compression(std::move(job), m_spec.width,
+                                m_stripbuf_rows);
+        m_stripbuf_rows = 0;
+    }
+    ok &= write_compressed(true);
+    return ok;
 }
 
 
@@ -1245,6 +1322,8 @@ TIFFOutput::write_scanline(int y, int z, TypeDesc format, const void* data,
 {
     m_spec.auto_stride(xstride, format, spec().nchannels);
     data = to_native_scanline(format, data, xstride, m_scratch, m_dither, y, z);
+    if (m_compress_async)
+        return queue_scanline(y, z, data);
 
     // Handle weird photometric/color spaces
     std::vector<unsigned char> cmyk;
@@ -1332,6 +1411,159 @@ TIFFOutput::compress_one_strip(void* uncompressed_buf, size_t strip_bytes,
 
 
 
+bool
+TIFFOutput::can_compress_in_pool()
+{
+    thread_pool* pool = default_thread_pool();
+    return
+        // not palette or cmyk color separated conversions
+        (m_photometric != PHOTOMETRIC_SEPARATED
+         && m_photometric != PHOTOMETRIC_PALETTE)
+        // no non-multiple-of-8 bits per sample
+        && (spec().format.size() * 8 == m_bitspersample)
+        // contig planarconfig only
+        && m_planarconfig == PLANARCONFIG_CONTIG
+        // only deflate/zip compression with horizontal predictor
+        && m_compression == COMPRESSION_ADOBE_DEFLATE
+        && m_predictor == PREDICTOR_HORIZONTAL
+        // only uint8, uint16
+        && (m_spec.format == TypeUInt8 || m_spec.format == TypeUInt16)
+        // only if we're threading
+        && pool->size() > 1
+        // only if this ImageOutput wasn't asked to be single-threaded
+        && this->threads() != 1
+        // and not if the feature is turned off
+        && m_spec.get_int_attribute("tiff:multithread",
+                                    OIIO::get_int_attribute("tiff:multithread"));
+}
+
+
+
+bool
+TIFFOutput::queue_scanline(int y, int z, const void* data)
+{
+    y -= m_spec.y;
+    if (m_stripbuf_rows == 0) {
+        if (y % m_rowsperstrip) {
+            errorfmt("TIFF scanlines must be written in order (y={},z={})",
+                     y + m_spec.y, z);
+            return false;
+        }
+        m_stripbuf_y = y;
+        m_stripbuf.resize(m_spec.scanline_bytes(true) * m_rowsperstrip);
+    } else if (y != m_stripbuf_y + m_stripbuf_rows) {
+        errorfmt("TIFF scanlines must be written in order (y={},z={})",
+                 y + m_spec.y, z);
+        return false;
+    }
+    size_t scanline_bytes = m_spec.scanline_bytes(true);
+    memcpy(m_stripbuf.data() + m_stripbuf_rows * scanline_bytes, data,
+           scanline_bytes);
+    ++m_stripbuf_rows;
+    if (m_stripbuf_rows < m_rowsperstrip && y + 1 < m_spec.height)
+        return true;  // strip isn't full yet
+
+    int rows = m_stripbuf_rows;
+    auto job = std::make_unique<CompressJob>();
+    m_stripbuf.resize(rows * scanline_bytes);
+    job->raw    = std::move(m_stripbuf);
+    job->index  = m_stripbuf_y / m_rowsperstrip;
+    job->nitems = rows;
+    m_stripbuf.clear();
+    m_stripbuf_rows = 0;
+    return queue_compression(std::move(job), m_spec.width, rows);
+}
+
+
+
+bool
+TIFFOutput::queue_compression(std::unique_ptr<CompressJob> job, int width,
+                              int height)
+{
+    unsigned long cbound = compressBound((uLong)job->raw.size());
+    job->compressed.reset(new char[cbound]);
+    CompressJob* j = job.get();
+    auto compress  = [this, j, cbound, width, height](int /*id*/) {
+        compress_one_strip(j->raw.data(), j->raw.size(), j->compressed.get(),
+                           cbound, m_spec.nchannels, width, height,
+                           &j->compressed_len, &j->ok);
+        j->raw = std::vector<unsigned char>();  // free it right away
+    };
+    // Don't enter the thread pool recursively
+    thread_pool* pool = default_thread_pool();
+    if (pool->is_worker())
+        compress(0);
+    else
+        j->done = pool->push(compress);
+    m_compress_queue.push_back(std::move(job));
+    return write_compressed(false);
+}
+
+
+
+bool
+TIFFOutput::write_compressed(bool all)
+{
+    // Allow a couple of jobs per thread in flight before waiting on them
+    thread_pool* pool = default_thread_pool();
+    size_t maxqueue   = all ? 0 : size_t(2 * pool->size());
+    const std::chrono::milliseconds no_wait(0);
+    bool ok = true;
+    while (!m_compress_queue.empty()) {
+        CompressJob& job(*m_compress_queue.front());
+        if (job.done.valid()) {
+            if (job.done.wait_for(no_wait) != std::future_status::ready) {
+                if (ok && m_compress_queue.size() <= maxqueue)
+                    break;  // not done yet, check again next time
+                // Run other pool tasks while we wait
+                while (job.done.wait_for(no_wait) != std::future_status::ready)
+                    if (!pool->run_one_task(std::this_thread::get_id()))
+                        std::this_thread::yield();
+            }
+            job.done.get();
+        }
+        if (ok && !job.ok) {
+            errorfmt("Compression error");
+            ok = false;
+        }
+        if (ok) {
+            tmsize_t r = m_spec.tile_width
+                             ? TIFFWriteRawTile(m_tif, job.index,
+                                                job.compressed.get(),
+                                                tmsize_t(job.compressed_len))
+                             : TIFFWriteRawStrip(m_tif, job.index,
+                                                 job.compressed.get(),
+                                                 tmsize_t(job.compressed_len));
+            if (r < 0) {
+                std::string err = oiio_tiff_last_error();
+                errorfmt("TIFFWriteRaw{} failed writing {} {}: {}",
+                         m_spec.tile_width ? "Tile" : "Strip",
+                         m_spec.tile_width ? "tile" : "strip", job.index,
+                         err.size() ? err.c_str() : "unknown error");
+                ok = false;
+            }
+        }
+        // After a failure, keep going only to wait for (and discard) the
+        // jobs still running.
+        m_checkpointItems += job.nitems;
+        m_compress_queue.pop_front();
+    }
+    if (!ok)
+        return false;
+
+    // Should we checkpoint? Only if we have enough scanlines or tiles and
+    // enough time has passed.
+    if (m_checkpointTimer() > DEFAULT_CHECKPOINT_INTERVAL_SECONDS
+        && m_checkpointItems >= MIN_SCANLINES_OR_TILES_PER_CHECKPOINT) {
+        TIFFCheckpointDirectory(m_tif);
+        m_checkpointTimer.lap();
+        m_checkpointItems = 0;
+    }
+    return true;
+}
+
+
+
 bool
 TIFFOutput::write_scanlines(int ybegin, int yend, int z, TypeDesc format,
                             const void* data, stride_t xstride,
@@ -1352,26 +1584,12 @@ TIFFOutput::write_scanlines(int ybegin, int yend, int z, TypeDesc format,
         && is_strip_boundary(yend)
         // and more than one, or no point parallelizing
         && nstrips > 1
-        // and not palette or cmyk color separated conversions
-        && (m_photometric != PHOTOMETRIC_SEPARATED
-            && m_photometric != PHOTOMETRIC_PALETTE)
-        // no non-multiple-of-8 bits per sample
-        && (spec().format.size() * 8 == m_bitspersample)
-        // contig planarconfig only
-        && m_planarconfig == PLANARCONFIG_CONTIG
-        // only deflate/zip compression with horizontal predictor
-        && m_compression == COMPRESSION_ADOBE_DEFLATE
-        && m_predictor == PREDICTOR_HORIZONTAL
-        // only uint8, uint16
-        && (m_spec.format == TypeUInt8 || m_spec.format == TypeUInt16)
-        // only if we're threading and don't enter the thread pool recursively!
-        && pool->size() > 1
+        // not in the middle of a strip begun by write_scanline
+        && m_stripbuf_rows == 0
+        // don't enter the thread pool recursively!
         && !pool->is_worker()
-        // only if this ImageInput wasn't asked to be single-threaded
-        && this->threads() != 1
-        // and not if the feature is turned off
-        && m_spec.get_int_attribute("tiff:multithread",
-                                    OIIO::get_int_attribute("tiff:multithread"));
+        // and a layout we know how to compress ourselves
+        && can_compress_in_pool();
 
     // If we're not parallelizing, just call the parent class default
     // implementation of write_scanlines, which will loop over the scanlines
@@ -1383,6 +1601,10 @@ TIFFOutput::write_scanlines(int ybegin, int yend, int z, TypeDesc format,
 
     // From here on, we're only dealing with the parallelizeable case...
 
+    // Strips queued by earlier write_scanline calls come first.
+    if (!write_compressed(true))
+        return false;
+
     // First, do the native data type conversion and contiguization. By
     // doing the whole chunk, it will be parallelized.
     std::vector<unsigned char> nativebuf;
@@ -1493,6 +1715,15 @@ TIFFOutput::write_tile(int x, int y, int z, TypeDesc format, const void* data,
     z -= m_spec.z;
     data = to_native_tile(format, data, xstride, ystride, zstride, m_scratch,
                           m_dither, x, y, z);
+    if (m_compress_async) {
+        auto job = std::make_unique<CompressJob>();
+        job->raw.assign((const unsigned char*)data,
+                        (const unsigned char*)data + m_spec.tile_bytes(true));
+        job->index  = tile_index(x + m_spec.x, y + m_spec.y, z + m_spec.z);
+        job->nitems = 1;
+        return queue_compression(std::move(job), m_spec.tile_width,
+                                 m_spec.tile_height * m_spec.tile_depth);
+    }
     size_t tile_vals = spec().tile_pixels() * m_outputchans;
 
     // Handle weird photometric/color spaces
@@ -1582,24 +1813,10 @@ TIFFOutput::write_tiles(int xbegin, int xend, int ybegin, int yend, int zbegin,
     bool parallelize =
         // more than one tile, or no point parallelizing
         ntiles > 1
-        // and not palette or cmyk color separated conversions
-        && (m_photometric != PHOTOMETRIC_SEPARATED
-            && m_photometric != PHOTOMETRIC_PALETTE)
-        // no non-multiple-of-8 bits per sample
-        && (spec().format.size() * 8 == m_bitspersample)
-        // contig planarconfig only
-        && m_planarconfig == PLANARCONFIG_CONTIG
-        // only deflate/zip compression with horizontal predictor
-        && m_compression == COMPRESSION_ADOBE_DEFLATE
-        && m_predictor == PREDICTOR_HORIZONTAL
-        // only uint8, uint16
-        && (m_spec.format == TypeUInt8 || m_spec.format == TypeUInt16)
-        // only if we're threading and don't enter the thread pool recursively!
-        && pool->size() > 1
+        // don't enter the thread pool recursively!
         && !pool->is_worker()
-        // and not if the feature is turned off
-        && m_spec.get_int_attribute("tiff:multithread",
-                                    OIIO::get_int_attribute("tiff:multithread"));
+        // and a layout we know how to compress ourselves
+        && can_compress_in_pool();
 
     // If we're not parallelizing, just call the parent class default
     // implementation of write_tiles, which will loop over the tiles and
@@ -1612,6 +1829,10 @@ TIFFOutput::write_tiles(int xbegin, int xend, int ybegin, int yend, int zbegin,
 
     // From here on, we're only dealing with the parallelizeable case...
 
+    // Tiles queued by earlier write_tile calls come first.
+    if (!write_compressed(true))
+        return false;
+
     // Allocate various temporary space we need
     stride_t tile_bytes = (stride_t)m_spec.tile_bytes(true);
     std::vector<std::vector<unsigned char>> tilebuf(ntiles);
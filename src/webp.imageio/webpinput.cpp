@@ -394,6 +394,8 @@ webp_input_imageio_create()
 }
 
 OIIO_EXPORT const char* webp_input_extensions[] = { "webp", nullptr };
+// Magic numbers: "WEBP" inside "RIFF"
+OIIO_EXPORT const char* webp_input_signatures[] = { "8:57454250", nullptr };
 
 OIIO_PLUGIN_EXPORTS_END
 
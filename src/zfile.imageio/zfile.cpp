@@ -136,6 +136,7 @@ zfile_input_imageio_create()
 }
 
 OIIO_EXPORT const char* zfile_input_extensions[] = { "zfile", nullptr };
+OIIO_EXPORT const char* zfile_input_signatures[] = { nullptr };
 
 OIIO_EXPORT ImageOutput*
 zfile_output_imageio_create()